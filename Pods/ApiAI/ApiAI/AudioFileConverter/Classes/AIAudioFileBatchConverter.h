@@ -0,0 +1,91 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+// Default cap on the buffer memory of all running conversions together.
+#define AI_BATCH_DEFAULT_MAXIMUM_BUFFERED_BYTES (32 * 1024 * 1024)
+
+/*
+ Snapshot of a batch run; sizes refer to the source files.
+ */
+@interface AIAudioFileBatchProgress : NSObject
+
+@property(nonatomic, assign, readonly) NSUInteger totalFileCount;
+@property(nonatomic, assign, readonly) NSUInteger completedFileCount;
+@property(nonatomic, assign, readonly) NSUInteger failedFileCount;
+
+// Conversions that were cancelled, running or not yet started. They are not counted as completed, and the bytes of
+// a file cancelled part way through are not counted either.
+@property(nonatomic, assign, readonly) NSUInteger cancelledFileCount;
+
+@property(nonatomic, assign, readonly) unsigned long long totalBytes;
+@property(nonatomic, assign, readonly) unsigned long long completedBytes;
+
+// Buffer memory reserved by the conversions running at the time of the snapshot.
+@property(nonatomic, assign, readonly) unsigned long long bufferedBytes;
+
+@property(nonatomic, assign, readonly) NSTimeInterval elapsedTime;
+
+// Source bytes converted per second of wall time since start.
+@property(nonatomic, assign, readonly) double bytesPerSecond;
+
+@property(nonatomic, assign, readonly) double fractionCompleted;
+
+@end
+
+typedef void(^AIAudioFileBatchProgressHandler)(AIAudioFileBatchProgress *progress);
+
+// failedOperations holds the finished AIAudioFileConvertOperation objects that have an error; cancelled ones are
+// only counted in cancelledFileCount.
+typedef void(^AIAudioFileBatchCompletionHandler)(AIAudioFileBatchProgress *progress, NSArray *failedOperations);
+
+/*
+ Converts many files with a fixed number of concurrent conversions and a global cap on their buffer memory.
+ 
+ Conversions start in the order they were added. A conversion waits until a worker is free and its
+ estimatedBufferedBytes fit under maximumBufferedBytes together with everything already running; a conversion
+ larger than the whole cap runs alone. Each file is converted sequentially, since the batch already keeps every
+ core busy.
+ */
+@interface AIAudioFileBatchConverter : NSObject
+
+// One conversion per core and AI_BATCH_DEFAULT_MAXIMUM_BUFFERED_BYTES.
+- (instancetype)init;
+- (instancetype)initWithMaximumConcurrentConversions:(NSUInteger)maximumConcurrentConversions
+                                maximumBufferedBytes:(unsigned long long)maximumBufferedBytes;
+
+@property(nonatomic, assign, readonly) NSUInteger maximumConcurrentConversions;
+@property(nonatomic, assign, readonly) unsigned long long maximumBufferedBytes;
+
+// Called on the main queue each time a conversion finishes.
+@property(nonatomic, copy) AIAudioFileBatchProgressHandler progressHandler;
+
+- (void)addConversionWithSourceFileURL:(NSURL *)sourceFileURL destinationFileURL:(NSURL *)destinationFileURL;
+
+// The completion handler is called on the main queue once every conversion added so far has finished or the batch
+// was cancelled.
+- (void)startWithCompletionHandler:(AIAudioFileBatchCompletionHandler)completionHandler;
+
+- (void)cancel;
+
+@end
@@ -0,0 +1,273 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import "AIAudioFileBatchConverter.h"
+#import "AIAudioFileConvertOperation.h"
+
+@interface AIAudioFileBatchProgress ()
+
+@property(nonatomic, assign) NSUInteger totalFileCount;
+@property(nonatomic, assign) NSUInteger completedFileCount;
+@property(nonatomic, assign) NSUInteger failedFileCount;
+@property(nonatomic, assign) NSUInteger cancelledFileCount;
+
+@property(nonatomic, assign) unsigned long long totalBytes;
+@property(nonatomic, assign) unsigned long long completedBytes;
+@property(nonatomic, assign) unsigned long long bufferedBytes;
+
+@property(nonatomic, assign) NSTimeInterval elapsedTime;
+
+@end
+
+@implementation AIAudioFileBatchProgress
+
+- (double)bytesPerSecond
+{
+    return _elapsedTime > 0 ? _completedBytes / _elapsedTime : 0;
+}
+
+- (double)fractionCompleted
+{
+    if (_totalBytes > 0) {
+        return (double)_completedBytes / _totalBytes;
+    }
+    
+    return _totalFileCount > 0 ? (double)_completedFileCount / _totalFileCount : 1;
+}
+
+@end
+
+@interface AIAudioFileBatchJob : NSObject
+
+@property(nonatomic, copy) NSURL *sourceFileURL;
+@property(nonatomic, copy) NSURL *destinationFileURL;
+@property(nonatomic, assign) unsigned long long sourceBytes;
+
+@end
+
+@implementation AIAudioFileBatchJob
+
+@end
+
+@interface AIAudioFileBatchConverter ()
+
+@property(nonatomic, strong) NSOperationQueue *operationQueue;
+@property(nonatomic, strong) NSMutableArray *pendingJobs;
+@property(nonatomic, strong) NSMutableArray *failedOperations;
+@property(nonatomic, strong) AIAudioFileBatchProgress *progress;
+@property(nonatomic, copy) AIAudioFileBatchCompletionHandler completionHandler;
+@property(nonatomic, strong) NSDate *startDate;
+
+@end
+
+@implementation AIAudioFileBatchConverter
+{
+    // Every piece of scheduling state is only touched on this queue.
+    dispatch_queue_t stateQueue;
+    NSUInteger _runningCount;
+    BOOL _started;
+    BOOL _cancelled;
+}
+
+- (instancetype)init
+{
+    return [self initWithMaximumConcurrentConversions:[NSProcessInfo processInfo].activeProcessorCount
+                                 maximumBufferedBytes:AI_BATCH_DEFAULT_MAXIMUM_BUFFERED_BYTES];
+}
+
+- (instancetype)initWithMaximumConcurrentConversions:(NSUInteger)maximumConcurrentConversions
+                                maximumBufferedBytes:(unsigned long long)maximumBufferedBytes
+{
+    self = [super init];
+    if (self) {
+        _maximumConcurrentConversions = MAX(maximumConcurrentConversions, 1);
+        _maximumBufferedBytes = maximumBufferedBytes;
+        
+        stateQueue = dispatch_queue_create("ai.api.batch-converter", DISPATCH_QUEUE_SERIAL);
+        
+        self.operationQueue = [[NSOperationQueue alloc] init];
+        _operationQueue.maxConcurrentOperationCount = (NSInteger)_maximumConcurrentConversions;
+        
+        self.pendingJobs = [NSMutableArray array];
+        self.failedOperations = [NSMutableArray array];
+        self.progress = [[AIAudioFileBatchProgress alloc] init];
+    }
+    
+    return self;
+}
+
+- (void)addConversionWithSourceFileURL:(NSURL *)sourceFileURL destinationFileURL:(NSURL *)destinationFileURL
+{
+    AIAudioFileBatchJob *job = [[AIAudioFileBatchJob alloc] init];
+    job.sourceFileURL = sourceFileURL;
+    job.destinationFileURL = destinationFileURL;
+    job.sourceBytes = [[[NSFileManager defaultManager] attributesOfItemAtPath:sourceFileURL.path error:nil] fileSize];
+    
+    dispatch_async(stateQueue, ^{
+        if (_cancelled) {
+            return;
+        }
+        
+        [_pendingJobs addObject:job];
+        
+        _progress.totalFileCount++;
+        _progress.totalBytes += job.sourceBytes;
+        
+        if (_started) {
+            [self scheduleJobs];
+        }
+    });
+}
+
+- (void)startWithCompletionHandler:(AIAudioFileBatchCompletionHandler)completionHandler
+{
+    dispatch_async(stateQueue, ^{
+        if (_started) {
+            return;
+        }
+        
+        _started = YES;
+        
+        self.completionHandler = completionHandler;
+        self.startDate = [NSDate date];
+        
+        [self scheduleJobs];
+        [self finishIfDone];
+    });
+}
+
+- (void)cancel
+{
+    dispatch_async(stateQueue, ^{
+        _cancelled = YES;
+        
+        _progress.cancelledFileCount += _pendingJobs.count;
+        [_pendingJobs removeAllObjects];
+        [_operationQueue cancelAllOperations];
+        
+        [self finishIfDone];
+    });
+}
+
+// Starts pending jobs in order while a worker is free and the next job fits in the memory budget.
+- (void)scheduleJobs
+{
+    while (_pendingJobs.count > 0 && _runningCount < _maximumConcurrentConversions) {
+        AIAudioFileBatchJob *job = _pendingJobs.firstObject;
+        
+        AIAudioFileConvertOperation *operation =
+        [[AIAudioFileConvertOperation alloc] initWithSourceFileURL:job.sourceFileURL
+                                             andDestinationFileURL:job.destinationFileURL];
+        operation.allowsParallelConversion = NO;
+        
+        unsigned long long bufferedBytes = operation.estimatedBufferedBytes;
+        
+        if (_runningCount > 0 && _progress.bufferedBytes + bufferedBytes > _maximumBufferedBytes) {
+            break;
+        }
+        
+        [_pendingJobs removeObjectAtIndex:0];
+        
+        _runningCount++;
+        _progress.bufferedBytes += bufferedBytes;
+        
+        __weak typeof(self) selfWeak = self;
+        __weak AIAudioFileConvertOperation *operationWeak = operation;
+        dispatch_queue_t queue = stateQueue;
+        
+        operation.completionBlock = ^{
+            AIAudioFileConvertOperation *finishedOperation = operationWeak;
+            
+            dispatch_async(queue, ^{
+                [selfWeak finishJob:job operation:finishedOperation bufferedBytes:bufferedBytes];
+            });
+        };
+        
+        [_operationQueue addOperation:operation];
+    }
+}
+
+- (void)finishJob:(AIAudioFileBatchJob *)job operation:(AIAudioFileConvertOperation *)operation bufferedBytes:(unsigned long long)bufferedBytes
+{
+    _runningCount--;
+    _progress.bufferedBytes -= bufferedBytes;
+    
+    // A cancelled conversion finishes without an error and leaves a truncated file behind.
+    if (operation.isCancelled) {
+        _progress.cancelledFileCount++;
+    } else {
+        _progress.completedFileCount++;
+        _progress.completedBytes += job.sourceBytes;
+        
+        if (operation.error) {
+            _progress.failedFileCount++;
+            [_failedOperations addObject:operation];
+        }
+    }
+    
+    AIAudioFileBatchProgress *snapshot = [self progressSnapshot];
+    AIAudioFileBatchProgressHandler progressHandler = self.progressHandler;
+    
+    if (progressHandler) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            progressHandler(snapshot);
+        });
+    }
+    
+    [self scheduleJobs];
+    [self finishIfDone];
+}
+
+- (void)finishIfDone
+{
+    if (!_started || _runningCount > 0 || _pendingJobs.count > 0 || !_completionHandler) {
+        return;
+    }
+    
+    AIAudioFileBatchCompletionHandler completionHandler = self.completionHandler;
+    AIAudioFileBatchProgress *snapshot = [self progressSnapshot];
+    NSArray *failedOperations = [_failedOperations copy];
+    
+    self.completionHandler = nil;
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completionHandler(snapshot, failedOperations);
+    });
+}
+
+- (AIAudioFileBatchProgress *)progressSnapshot
+{
+    AIAudioFileBatchProgress *snapshot = [[AIAudioFileBatchProgress alloc] init];
+    
+    snapshot.totalFileCount = _progress.totalFileCount;
+    snapshot.completedFileCount = _progress.completedFileCount;
+    snapshot.failedFileCount = _progress.failedFileCount;
+    snapshot.cancelledFileCount = _progress.cancelledFileCount;
+    snapshot.totalBytes = _progress.totalBytes;
+    snapshot.completedBytes = _progress.completedBytes;
+    snapshot.bufferedBytes = _progress.bufferedBytes;
+    snapshot.elapsedTime = _startDate ? -[_startDate timeIntervalSinceNow] : 0;
+    
+    return snapshot;
+}
+
+@end
@@ -21,13 +21,54 @@
 
 #import <Foundation/Foundation.h>
 
+// How long the conversions must have been idle before the shared buffer pools release their memory.
+#define AI_BUFFER_POOL_IDLE_TRIM_SECONDS 30
+
+// Counters of the buffer pools shared by all conversions, since launch. A hit reused a pooled block, a miss
+// allocated one and a failure could not; the byte counts are for the time of the call, except the high-water mark.
+typedef struct _AIAudioFileBufferPoolStatistics {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long failures;
+    unsigned long long outstandingBytes;
+    unsigned long long highWaterBytes;
+    unsigned long long retainedBytes;
+} AIAudioFileBufferPoolStatistics;
+
+// Receives the converted WAV stream block by block on the operation's thread. Return NO to stop the conversion.
+typedef BOOL(^AIAudioFileConvertOutputHandler)(NSData *data);
+
 @interface AIAudioFileConvertOperation : NSOperation
 
 - (instancetype)initWithSourceFileURL:(NSURL *)sourceFileURL andDestinationFileURL:(NSURL *)destinationFileURL;
 
+// Streams the converted file instead of writing it to disk. The WAV header comes first and carries unknown sizes,
+// followed by the samples in the order they are produced. The handler may block to apply back pressure.
+- (instancetype)initWithSourceFileURL:(NSURL *)sourceFileURL outputHandler:(AIAudioFileConvertOutputHandler)outputHandler;
+
 @property(nonatomic, copy, readonly) NSURL *sourceFileURL;
 @property(nonatomic, copy, readonly) NSURL *destinationFileURL;
+@property(nonatomic, copy, readonly) AIAudioFileConvertOutputHandler outputHandler;
 
 @property(nonatomic, copy, readonly) NSError *error;
 
+// Whether the streamed output starts with a WAV header. Default is YES; turn it off to re-encode the raw samples.
+@property(nonatomic, assign) BOOL outputIncludesWAVHeader;
+
+// Convert long uncompressed sources in segments on all cores. Default is YES. Ignored when streaming to an output handler.
+@property(nonatomic, assign) BOOL allowsParallelConversion;
+
+// Upper bound of the buffer memory the conversion holds while running, given the current settings.
+@property(nonatomic, assign, readonly) unsigned long long estimatedBufferedBytes;
+
+// Whether the file is audio AudioToolbox can read that is not already a 16 kHz mono 16-bit PCM WAV file, the format
+// conversion produces. Files that cannot be opened are reported as not needing conversion.
++ (BOOL)needsConversionOfFileURL:(NSURL *)fileURL;
+
++ (AIAudioFileBufferPoolStatistics)bufferPoolStatistics;
+
+// Frees the blocks the pools keep for reuse. Done automatically under memory pressure and once no conversion has
+// run for AI_BUFFER_POOL_IDLE_TRIM_SECONDS.
++ (void)trimBufferPools;
+
 @end
@@ -21,11 +21,40 @@
 
 #import "AIAudioFileConvertOperation.h"
 #import "AIAudioFileConvertOperationTypes.h"
+#include "AIAudioFilePacketSource.hpp"
+#include "AIMappedPacketSource.hpp"
+#include "AIParallelConverter.hpp"
+#include "AIWAVWriter.hpp"
+
+#include <atomic>
+#include <memory>
+
+// Conversions running right now, and how many have started, so that an idle trim scheduled when the last one
+// finished can tell whether another ran in the meantime.
+static std::atomic<unsigned> AIRunningConversionCount(0);
+static std::atomic<unsigned> AIStartedConversionCount(0);
+
+static dispatch_source_t AIMemoryPressureSource;
+
+// Hands the converted stream to the output handler. There is nothing to seek back to, so the sizes stay unknown.
+class AIOutputHandlerWAVOutput : public AIWAVOutput {
+public:
+    
+    AIOutputHandlerWAVOutput(AIAudioFileConvertOutputHandler handler) : handler(handler) {}
+    
+    virtual bool write(const void *bytes, size_t length)
+    {
+        return handler([NSData dataWithBytes:bytes length:length]);
+    }
+    
+private:
+    
+    AIAudioFileConvertOutputHandler handler;
+};
 
 @interface AIAudioFileConvertOperation ()
 
 @property(nonatomic, assign) AudioFileID sourceFileID;
-@property(nonatomic, assign) AudioFileID destinationFileID;
 
 @property(nonatomic, assign) AudioStreamBasicDescription sourceStreamDescription;
 @property(nonatomic, assign) AudioStreamBasicDescription destinationStreamDescription;
@@ -38,6 +67,94 @@
 @end
 
 @implementation AIAudioFileConvertOperation
+{
+    std::unique_ptr<AIWAVOutput> _destination;
+    std::unique_ptr<AIWAVWriter> _writer;
+}
+
++ (void)initialize
+{
+    if (self != [AIAudioFileConvertOperation class]) return;
+    
+    // On iOS memory pressure comes with the memory warnings; pooled blocks are the first thing to give back.
+    AIMemoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                    DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                    dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    dispatch_source_set_event_handler(AIMemoryPressureSource, ^{
+        [AIAudioFileConvertOperation trimBufferPools];
+    });
+    dispatch_resume(AIMemoryPressureSource);
+}
+
++ (BOOL)needsConversionOfFileURL:(NSURL *)fileURL
+{
+    AudioFileID file = NULL;
+    if (AudioFileOpenURL((__bridge CFURLRef)fileURL, kAudioFileReadPermission, 0, &file) != noErr) {
+        return NO;
+    }
+    
+    AudioFileTypeID fileType = 0;
+    UInt32 fileTypeSize = sizeof(fileType);
+    AudioStreamBasicDescription format = {0};
+    UInt32 formatSize = sizeof(format);
+    
+    OSStatus status = AudioFileGetProperty(file, kAudioFilePropertyFileFormat, &fileTypeSize, &fileType);
+    if (status == noErr) {
+        status = AudioFileGetProperty(file, kAudioFilePropertyDataFormat, &formatSize, &format);
+    }
+    
+    AudioFileClose(file);
+    
+    if (status != noErr) {
+        return NO;
+    }
+    
+    BOOL converted = fileType == kAudioFileWAVEType && format.mFormatID == kAudioFormatLinearPCM &&
+                     format.mSampleRate == 16000. && format.mChannelsPerFrame == 1 && format.mBitsPerChannel == 16 &&
+                     (format.mFormatFlags & kLinearPCMFormatFlagIsSignedInteger) &&
+                     !(format.mFormatFlags & kLinearPCMFormatFlagIsBigEndian);
+    
+    return !converted;
+}
+
++ (AIAudioFileBufferPoolStatistics)bufferPoolStatistics
+{
+    AIBufferPoolStatistics shared = AIBufferPool::getSharedStatistics();
+    
+    AIAudioFileBufferPoolStatistics statistics;
+    statistics.hits = shared.hits;
+    statistics.misses = shared.misses;
+    statistics.failures = shared.failures;
+    statistics.outstandingBytes = shared.outstandingBytes;
+    statistics.highWaterBytes = shared.highWaterBytes;
+    statistics.retainedBytes = shared.retainedBytes;
+    
+    return statistics;
+}
+
++ (void)trimBufferPools
+{
+    AIBufferPool::trimSharedPools();
+}
+
++ (void)conversionDidStart
+{
+    AIRunningConversionCount++;
+    AIStartedConversionCount++;
+}
+
++ (void)conversionDidEnd
+{
+    if (--AIRunningConversionCount > 0) return;
+    
+    unsigned started = AIStartedConversionCount;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(AI_BUFFER_POOL_IDLE_TRIM_SECONDS * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        if (AIRunningConversionCount == 0 && AIStartedConversionCount == started) {
+            [AIAudioFileConvertOperation trimBufferPools];
+        }
+    });
+}
 
 - (instancetype)initWithSourceFileURL:(NSURL *)sourceFileURL andDestinationFileURL:(NSURL *)destinationFileURL
 {
@@ -58,96 +175,241 @@
         destination.mFormatFlags = kLinearPCMFormatFlagIsPacked | kLinearPCMFormatFlagIsSignedInteger;
         
         _destinationStreamDescription = destination;
+        
+        _allowsParallelConversion = YES;
+        _outputIncludesWAVHeader = YES;
     }
     
     return self;
 }
 
-- (void)main
+- (instancetype)initWithSourceFileURL:(NSURL *)sourceFileURL outputHandler:(AIAudioFileConvertOutputHandler)outputHandler
 {
-    @try {
-        AIXThrowIfError(AudioFileOpenURL((__bridge CFURLRef)_sourceFileURL, kAudioFileReadPermission, 0, &_sourceFileID), @"Cannot Open Source File");
-        
-        AudioStreamBasicDescription source;
-        
-        UInt32 size = sizeof(source);
-        AudioFileGetProperty(_sourceFileID, kAudioFilePropertyDataFormat, &size, &source);
-        
-        _sourceStreamDescription = source;
-        
-        AIXThrowIfError(AudioFileCreateWithURL((__bridge CFURLRef)_destinationFileURL,
-                                               kAudioFileWAVEType,
-                                               &_destinationStreamDescription,
-                                               kAudioFileFlags_EraseFile,
-                                               &_destinationFileID), @"Cannot Open Destination File");
-        
-        AIXThrowIfError(AudioConverterNew(&_sourceStreamDescription,
-                                          &_destinationStreamDescription,
-                                          &_audioConverter), @"Cannot create AudioConverter");
+    self = [self initWithSourceFileURL:sourceFileURL andDestinationFileURL:nil];
+    if (self) {
+        _outputHandler = [outputHandler copy];
+    }
+    
+    return self;
+}
+
+- (unsigned long long)estimatedBufferedBytes
+{
+    // Packet and decode buffers, an output buffer that holds at most twice as many frames at two bytes each when
+    // upsampling 8-bit sources, and the WAV writer's buffer.
+    unsigned long long bytes = 2 * AI_BUFFER_SIZE + 4 * AI_BUFFER_SIZE + AI_WAV_WRITER_BUFFER_SIZE;
+    
+    if (_allowsParallelConversion && !_outputHandler && AIWorkPool::sharedPool().getWorkerCount() > 0) {
+        // Only mapped sources long enough for several segments are converted in parallel; main decides the same
+        // way. Mapping the file reads no more than its header.
+        AIMappedPacketSource source(_sourceFileURL.fileSystemRepresentation);
         
-        {
-            AudioStreamBasicDescription actualSourceStreamDescription;
-            UInt32 size = sizeof(actualSourceStreamDescription);
-            AIXThrowIfError(AudioConverterGetProperty(_audioConverter,
-                                                      kAudioConverterCurrentInputStreamDescription,
-                                                      &size,
-                                                      &actualSourceStreamDescription), @"Cannot get actual source description");
-            _actualSourceStreamDescription = actualSourceStreamDescription;
+        if (source.isOpen()) {
+            AIParallelConverter converter(source.getFormat(), _destinationStreamDescription.mSampleRate);
+            
+            if (converter.getSegmentCount(source.getPacketCount()) > 1) {
+                // One segment buffer for every thread that takes part in AIWorkPool::apply.
+                size_t segmentBytes = AIBufferPool::sharedPool(converter.getSegmentBufferBytes()).getBlockSize();
+                bytes += (AIWorkPool::sharedPool().getWorkerCount() + 1) * segmentBytes;
+            }
         }
+    }
+    
+    return bytes;
+}
+
+// Returns NO when the output handler asked to stop.
+- (BOOL)writeSamples:(const SInt16 *)samples count:(UInt32)count
+{
+    if (!_writer->append(samples, count * _destinationStreamDescription.mBytesPerPacket)) {
+        AIXThrowIfError(_destination->getError(), @"Cannot Write Data To Destination File");
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (void)convertSequentiallyWithDataProcessInfo:(AIDataProcessInfo &)dataProcessInfo sourceFormat:(const AIPCMFormat &)sourceFormat
+{
+    AIConversionEngine engine(sourceFormat, _destinationStreamDescription.mSampleRate);
+    
+    UInt32 bytesPerFrame = sourceFormat.getBytesPerFrame();
+    UInt32 framesPerRead = AI_BUFFER_SIZE / bytesPerFrame;
+    
+    AIPooledBuffer decodeBuffer(AIBufferPool::sharedPool(AI_BUFFER_SIZE));
+    AIPooledBuffer outputBuffer(AIBufferPool::sharedPool(sizeof(SInt16) * engine.getMaxOutputFrames(framesPerRead)));
+    
+    if (!decodeBuffer.get() || !outputBuffer.get()) {
+        AIXThrowIfError(kAudio_MemFullError, @"Cannot Allocate Conversion Buffers");
+    }
+    
+    while (true) {
+        UInt32 inputFrames = framesPerRead;
+        const void *input = NULL;
         
-        {
-            AudioStreamBasicDescription actualDestinationStreamDescription;
-            UInt32 size = sizeof(actualDestinationStreamDescription);
-            AIXThrowIfError(AudioConverterGetProperty(_audioConverter,
-                                                      kAudioConverterCurrentOutputStreamDescription,
-                                                      &size,
-                                                      &actualDestinationStreamDescription), @"Cannot get actual destination description")
-            _actualDestinationStreamDescription = actualDestinationStreamDescription;
+        if (_audioConverter) {
+            AudioBufferList fillBufList;
+            fillBufList.mNumberBuffers = 1;
+            fillBufList.mBuffers[0].mNumberChannels = sourceFormat.channels;
+            fillBufList.mBuffers[0].mDataByteSize = AI_BUFFER_SIZE;
+            fillBufList.mBuffers[0].mData = decodeBuffer.get();
+            
+            AIXThrowIfError(AudioConverterFillComplexBuffer(_audioConverter,
+                                                            AIEncoderDataProc,
+                                                            (void *)&dataProcessInfo,
+                                                            &inputFrames,
+                                                            &fillBufList,
+                                                            NULL), @"Cannot Fill Audio Converter");
+            
+            input = decodeBuffer.get();
+        } else {
+            UInt32 ioNumBytes = 0;
+            
+            AIXThrowIfError(dataProcessInfo.readPackets(&inputFrames, &ioNumBytes), @"Cannot Read Data From Source File");
+            
+            inputFrames = ioNumBytes / bytesPerFrame;
+            input = dataProcessInfo.getBuffer();
         }
         
-        UInt32 sizePerPacket;
+        SInt16 *output = (SInt16 *)outputBuffer.get();
+        UInt32 ioOutputDataPackets = (UInt32)(inputFrames ? engine.process(input, inputFrames, output) : engine.flush(output));
         
-        size = sizeof(sizePerPacket);
-        AIXThrowIfError(AudioFileGetProperty(_sourceFileID,
-                                             kAudioFilePropertyPacketSizeUpperBound,
-                                             &size,
-                                             &sizePerPacket), @"Cannot get packet size from sourcef file");
+        if (ioOutputDataPackets > 0 && ![self writeSamples:output count:ioOutputDataPackets]) {
+            break;
+        }
         
-        AIDataProcessInfo dataProcessInfo(sizePerPacket, _sourceFileID);
+        if (inputFrames == 0 || [self isCancelled]) break;
+    }
+}
+
+- (void)convertMappedSource:(const AIMappedPacketSource &)source withConverter:(AIParallelConverter &)converter
+{
+    OSStatus status = noErr;
+    
+    bool converted = converter.convert(source.getData(),
+                      source.getPacketCount(),
+                      AIWorkPool::sharedPool(),
+                      [&](uint64_t outputFrame, const int16_t *samples, size_t count) {
+                          UInt32 bytesPerPacket = _destinationStreamDescription.mBytesPerPacket;
+                          if (!_writer->writeAt(outputFrame * bytesPerPacket, samples, count * bytesPerPacket)) {
+                              status = _destination->getError();
+                          }
+                          return status == noErr;
+                      },
+                      [&]() -> bool {
+                          return [self isCancelled];
+                      });
+    
+    AIXThrowIfError(status, @"Cannot Write Data To Destination File");
+    
+    if (!converted && ![self isCancelled]) {
+        AIXThrowIfError(kAudio_MemFullError, @"Cannot Allocate Conversion Buffers");
+    }
+}
+
+- (void)main
+{
+    [AIAudioFileConvertOperation conversionDidStart];
+    
+    @try {
+        // Uncompressed files are mapped and read in place. Everything else goes through AudioFile, and
+        // compressed sources are decoded by AudioConverter; downmixing and resampling happen in AIConversionEngine.
+        AIMappedPacketSource mappedSource(_sourceFileURL.fileSystemRepresentation);
+        std::unique_ptr<AIAudioFilePacketSource> fileSource;
         
-        SInt64 outputFilePos = 0;
+        AIPacketSource *packetSource = &mappedSource;
+        AIPCMFormat sourceFormat;
+        UInt32 sizePerPacket;
         
-        while (true) {
-            AudioBufferList fillBufList;
-            fillBufList.mNumberBuffers = 1;
-            fillBufList.mBuffers[0].mNumberChannels = _actualDestinationStreamDescription.mChannelsPerFrame;
+        if (mappedSource.isOpen()) {
+            sourceFormat = mappedSource.getFormat();
+            sizePerPacket = sourceFormat.getBytesPerFrame();
+        } else {
+            AIXThrowIfError(AudioFileOpenURL((__bridge CFURLRef)_sourceFileURL, kAudioFileReadPermission, 0, &_sourceFileID), @"Cannot Open Source File");
             
-            char *buffer = (char *)malloc(sizeof(char) * AI_BUFFER_SIZE);
-            fillBufList.mBuffers[0].mDataByteSize = AI_BUFFER_SIZE / _actualDestinationStreamDescription.mBytesPerPacket;
-            fillBufList.mBuffers[0].mData = buffer;
+            AudioStreamBasicDescription source;
             
-            UInt32 ioOutputDataPackets = AI_BUFFER_SIZE / _actualDestinationStreamDescription.mBytesPerPacket;
+            UInt32 size = sizeof(source);
+            AudioFileGetProperty(_sourceFileID, kAudioFilePropertyDataFormat, &size, &source);
             
-            AIXThrowIfError(AudioConverterFillComplexBuffer(_audioConverter,
-                                                            AIEncoderDataProc,
-                                                            (void *)&dataProcessInfo,
-                                                            &ioOutputDataPackets,
-                                                            &fillBufList,
-                                                            NULL), @"Cannot Fill Audio Converter");
+            _sourceStreamDescription = source;
             
-            AIXThrowIfError(AudioFileWritePackets(_destinationFileID,
-                                                  false,
-                                                  fillBufList.mBuffers[0].mDataByteSize,
-                                                  NULL,
-                                                  outputFilePos,
-                                                  &ioOutputDataPackets,
-                                                  buffer), @"Cannot Write Data To Destination File");
+            size = sizeof(sizePerPacket);
+            AIXThrowIfError(AudioFileGetProperty(_sourceFileID,
+                                                 kAudioFilePropertyPacketSizeUpperBound,
+                                                 &size,
+                                                 &sizePerPacket), @"Cannot get packet size from sourcef file");
             
-            outputFilePos += ioOutputDataPackets;
+            fileSource.reset(new AIAudioFilePacketSource(_sourceFileID, sizePerPacket, AI_BUFFER_SIZE));
+            packetSource = fileSource.get();
             
-            free(buffer);
+            if (!AIPCMFormatFromStreamDescription(_sourceStreamDescription, &sourceFormat)) {
+                AudioStreamBasicDescription decoded = AIDecodedStreamDescription(_sourceStreamDescription);
+                
+                AIXThrowIfError(AudioConverterNew(&_sourceStreamDescription,
+                                                  &decoded,
+                                                  &_audioConverter), @"Cannot create AudioConverter");
+                
+                {
+                    AudioStreamBasicDescription actualSourceStreamDescription;
+                    UInt32 size = sizeof(actualSourceStreamDescription);
+                    AIXThrowIfError(AudioConverterGetProperty(_audioConverter,
+                                                              kAudioConverterCurrentInputStreamDescription,
+                                                              &size,
+                                                              &actualSourceStreamDescription), @"Cannot get actual source description");
+                    _actualSourceStreamDescription = actualSourceStreamDescription;
+                }
+                
+                {
+                    AudioStreamBasicDescription actualDestinationStreamDescription;
+                    UInt32 size = sizeof(actualDestinationStreamDescription);
+                    AIXThrowIfError(AudioConverterGetProperty(_audioConverter,
+                                                              kAudioConverterCurrentOutputStreamDescription,
+                                                              &size,
+                                                              &actualDestinationStreamDescription), @"Cannot get actual destination description")
+                    _actualDestinationStreamDescription = actualDestinationStreamDescription;
+                }
+                
+                if (!AIPCMFormatFromStreamDescription(_actualDestinationStreamDescription, &sourceFormat)) {
+                    AIXThrowIfError(kAudioConverterErr_FormatNotSupported, @"Cannot decode source file");
+                }
+            } else {
+                _actualSourceStreamDescription = _sourceStreamDescription;
+                _actualDestinationStreamDescription = _sourceStreamDescription;
+            }
+        }
+        
+        BOOL convertedInParallel = NO;
+        
+        // Files get their sizes patched when the writer is closed; streams keep the unknown ones.
+        if (_outputHandler) {
+            _destination.reset(new AIOutputHandlerWAVOutput(_outputHandler));
+        } else {
+            AIWAVFileOutput *file = new AIWAVFileOutput(_destinationFileURL.fileSystemRepresentation);
+            _destination.reset(file);
+            AIXThrowIfError(file->getError(), @"Cannot Open Destination File");
+        }
+        
+        _writer.reset(new AIWAVWriter(*_destination,
+                                      AIWAVFormatFromStreamDescription(_destinationStreamDescription),
+                                      !_outputHandler || _outputIncludesWAVHeader));
+        
+        if (!_outputHandler && _allowsParallelConversion && mappedSource.isOpen() && AIWorkPool::sharedPool().getWorkerCount() > 0) {
+            AIParallelConverter converter(sourceFormat, _destinationStreamDescription.mSampleRate);
             
-            if (ioOutputDataPackets == 0 || [self isCancelled]) break;
+            if (converter.getSegmentCount(mappedSource.getPacketCount()) > 1) {
+                [self convertMappedSource:mappedSource withConverter:converter];
+                convertedInParallel = YES;
+            }
+        }
+        
+        if (!convertedInParallel) {
+            AIDataProcessInfo dataProcessInfo(sizePerPacket, *packetSource);
+            [self convertSequentiallyWithDataProcessInfo:dataProcessInfo sourceFormat:sourceFormat];
+        }
+        
+        if (!_writer->close()) {
+            AIXThrowIfError(_destination->getError(), @"Cannot Write Data To Destination File");
         }
     }
     @catch (NSException *exception) {
@@ -181,7 +443,10 @@
     @finally {
         if (_audioConverter) AudioConverterDispose(_audioConverter);
         if (_sourceFileID) AudioFileClose(_sourceFileID);
-        if (_destinationFileID) AudioFileClose(_destinationFileID);
+        _writer.reset();
+        _destination.reset();
+        
+        [AIAudioFileConvertOperation conversionDidEnd];
         
         [super main];
     }
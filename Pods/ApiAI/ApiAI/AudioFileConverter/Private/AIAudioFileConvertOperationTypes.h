@@ -23,9 +23,20 @@
 #import <AudioToolbox/AudioToolbox.h>
 
 #include "AIDataProcessInfo.hpp"
+#include "AIConversionEngine.hpp"
+#include "AIWAVHeader.hpp"
 
 OSStatus AIEncoderDataProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberDataPackets, AudioBufferList *ioData, AudioStreamPacketDescription **outDataPacketDescription, void *inUserData);
 
+// Returns false when the source is not interleaved linear PCM and has to be decoded by AudioConverter first.
+bool AIPCMFormatFromStreamDescription(const AudioStreamBasicDescription &description, AIPCMFormat *format);
+
+// Float interleaved PCM at the source rate and channel count; the only format AudioConverter is asked to produce.
+AudioStreamBasicDescription AIDecodedStreamDescription(const AudioStreamBasicDescription &source);
+
+// WAV fmt chunk for the integer PCM described by format.
+AIWAVFormat AIWAVFormatFromStreamDescription(const AudioStreamBasicDescription &format);
+
 void AIThrowIfError(OSStatus status, NSString *message);
 
 #define AIXThrowIfError(status, message)    \
@@ -25,34 +25,92 @@ OSStatus AIEncoderDataProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberD
 {
     AIDataProcessInfo *dataProcessInfo = (AIDataProcessInfo *)inUserData;
     
-    UInt32 maxPackets = dataProcessInfo->getBufferSize() / dataProcessInfo->getSizePerPacket();
-    if (*ioNumberDataPackets > maxPackets) *ioNumberDataPackets = maxPackets;
-    
-    UInt32 ioNumBytes = dataProcessInfo->getBufferSize();
-    OSStatus status =
-    AudioFileReadPacketData(
-                            dataProcessInfo->getSourceFileID(),
-                            false,
-                            &ioNumBytes,
-                            dataProcessInfo->getPacketDescriptions(),
-                            dataProcessInfo->getOffset(),
-                            ioNumberDataPackets,
-                            dataProcessInfo->getBuffer()
-                            );
+    UInt32 ioNumBytes = 0;
+    OSStatus status = dataProcessInfo->readPackets(ioNumberDataPackets, &ioNumBytes);
     
     ioData->mBuffers[0].mData = dataProcessInfo->getBuffer();
     ioData->mBuffers[0].mDataByteSize = ioNumBytes;
     ioData->mBuffers[0].mNumberChannels = 1;
     
-    dataProcessInfo->increaseOffset(*ioNumberDataPackets);
+    if (outDataPacketDescription) {
+        *outDataPacketDescription = dataProcessInfo->getPacketDescriptions();
+    }
     
-    *outDataPacketDescription = dataProcessInfo->getPacketDescriptions();
+    return status;
+}
+
+bool AIPCMFormatFromStreamDescription(const AudioStreamBasicDescription &description, AIPCMFormat *format)
+{
+    if (description.mFormatID != kAudioFormatLinearPCM) return false;
+    if (description.mFormatFlags & kAudioFormatFlagIsNonInterleaved) return false;
+    if (description.mChannelsPerFrame == 0 || description.mFramesPerPacket != 1) return false;
     
-    if (status == kAudioFileEndOfFileError) {
-        status = noErr;
+    UInt32 bits = description.mBitsPerChannel;
+    UInt32 bytesPerSample = description.mBytesPerFrame / description.mChannelsPerFrame;
+    
+    if (bytesPerSample * 8 != bits) return false;
+    
+    AIPCMFormat result;
+    result.sampleRate = description.mSampleRate;
+    result.channels = description.mChannelsPerFrame;
+    result.bigEndian = (description.mFormatFlags & kAudioFormatFlagIsBigEndian) != 0;
+    
+    if (description.mFormatFlags & kAudioFormatFlagIsFloat) {
+        if (bits == 32) {
+            result.sampleType = AISampleTypeFloat32;
+        } else if (bits == 64) {
+            result.sampleType = AISampleTypeFloat64;
+        } else {
+            return false;
+        }
+    } else if (description.mFormatFlags & kAudioFormatFlagIsSignedInteger) {
+        if (bits == 16) {
+            result.sampleType = AISampleTypeInt16;
+        } else if (bits == 24) {
+            result.sampleType = AISampleTypeInt24;
+        } else if (bits == 32) {
+            result.sampleType = AISampleTypeInt32;
+        } else {
+            return false;
+        }
+    } else if (bits == 8) {
+        result.sampleType = AISampleTypeUInt8;
+    } else {
+        return false;
     }
     
-    return status;
+    *format = result;
+    
+    return true;
+}
+
+AudioStreamBasicDescription AIDecodedStreamDescription(const AudioStreamBasicDescription &source)
+{
+    AudioStreamBasicDescription decoded = {0};
+    
+    decoded.mFormatID = kAudioFormatLinearPCM;
+    decoded.mSampleRate = source.mSampleRate;
+    decoded.mChannelsPerFrame = source.mChannelsPerFrame;
+    decoded.mBitsPerChannel = 32;
+    decoded.mBytesPerPacket = decoded.mBytesPerFrame = 4 * decoded.mChannelsPerFrame;
+    decoded.mFramesPerPacket = 1;
+    decoded.mFormatFlags = kLinearPCMFormatFlagIsPacked | kLinearPCMFormatFlagIsFloat;
+    
+    return decoded;
+}
+
+AIWAVFormat AIWAVFormatFromStreamDescription(const AudioStreamBasicDescription &format)
+{
+    AIWAVFormat wavFormat = {0};
+    
+    wavFormat.formatTag = AI_WAV_FORMAT_PCM;
+    wavFormat.channels = format.mChannelsPerFrame;
+    wavFormat.sampleRate = (uint32_t)format.mSampleRate;
+    wavFormat.bytesPerSecond = wavFormat.sampleRate * format.mBytesPerFrame;
+    wavFormat.blockAlign = format.mBytesPerFrame;
+    wavFormat.bitsPerSample = format.mBitsPerChannel;
+    
+    return wavFormat;
 }
 
 void AIThrowIfError(OSStatus status, NSString *message) {
@@ -0,0 +1,72 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIAudioFilePacketSource.hpp"
+
+AIAudioFilePacketSource::AIAudioFilePacketSource(AudioFileID sourceFileID, UInt32 sizePerPacket, UInt32 bufferSize) :
+    sourceFileID(sourceFileID),
+    bufferPool(AIBufferPool::sharedPool(bufferSize)),
+    packetDescriptionPool(AIBufferPool::sharedPool(sizeof(AudioStreamPacketDescription) * bufferSize / sizePerPacket)),
+    bufferSize(bufferSize)
+{
+    buffer = (char *)bufferPool.checkOut();
+    packetDescriptions = (AudioStreamPacketDescription *)packetDescriptionPool.checkOut();
+}
+
+AIAudioFilePacketSource::~AIAudioFilePacketSource()
+{
+    bufferPool.checkIn(buffer);
+    packetDescriptionPool.checkIn(packetDescriptions);
+}
+
+int32_t AIAudioFilePacketSource::readPackets(int64_t packetOffset, uint32_t *ioNumberPackets, const void **outData, uint32_t *outNumberBytes)
+{
+    if (!buffer || !packetDescriptions) {
+        return kAudio_MemFullError;
+    }
+    
+    UInt32 ioNumBytes = bufferSize;
+    OSStatus status =
+    AudioFileReadPacketData(
+                            sourceFileID,
+                            false,
+                            &ioNumBytes,
+                            packetDescriptions,
+                            packetOffset,
+                            ioNumberPackets,
+                            buffer
+                            );
+    
+    *outData = buffer;
+    *outNumberBytes = ioNumBytes;
+    
+    if (status == kAudioFileEndOfFileError) {
+        status = noErr;
+    }
+    
+    return status;
+}
+
+void *AIAudioFilePacketSource::getPacketDescriptions()
+{
+    return packetDescriptions;
+}
@@ -0,0 +1,61 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef AudioFilePacketSource_hpp
+#define AudioFilePacketSource_hpp
+
+#import <AudioToolbox/AudioToolbox.h>
+
+#include "AIPacketSource.hpp"
+#include "AIBufferPool.hpp"
+
+/*
+ * Packet source reading through AudioFileReadPacketData into a pooled bounce buffer. Handles every format
+ * AudioFile can open, including compressed ones that need packet descriptions.
+ */
+class AIAudioFilePacketSource : public AIPacketSource {
+public:
+    
+    AIAudioFilePacketSource(AudioFileID sourceFileID, UInt32 sizePerPacket, UInt32 bufferSize);
+    virtual ~AIAudioFilePacketSource();
+    
+    virtual int32_t readPackets(int64_t packetOffset, uint32_t *ioNumberPackets, const void **outData, uint32_t *outNumberBytes);
+    virtual void *getPacketDescriptions();
+    
+private:
+    
+    AudioFileID sourceFileID;
+    
+    AIBufferPool &bufferPool;
+    AIBufferPool &packetDescriptionPool;
+    
+    char *buffer;
+    UInt32 bufferSize;
+    
+    AudioStreamPacketDescription *packetDescriptions;
+    
+private:
+    AIAudioFilePacketSource( const AIAudioFilePacketSource& );
+    void operator=( const AIAudioFilePacketSource& );
+};
+
+#endif /* AudioFilePacketSource_hpp */
@@ -0,0 +1,204 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIBufferPool.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+
+AIBufferPool::AIBufferPool(size_t blockSize, size_t maxRetainedBlocks) : blockSize(blockSize), maxRetainedBlocks(maxRetainedBlocks)
+{
+    freeBlocks.reserve(maxRetainedBlocks);
+    
+    statistics.hits = 0;
+    statistics.misses = 0;
+    statistics.failures = 0;
+    statistics.outstandingBytes = 0;
+    statistics.highWaterBytes = 0;
+    statistics.retainedBytes = 0;
+}
+
+AIBufferPool::~AIBufferPool()
+{
+    trim();
+}
+
+void *AIBufferPool::checkOut()
+{
+    void *block = NULL;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        if (!freeBlocks.empty()) {
+            block = freeBlocks.back();
+            freeBlocks.pop_back();
+            
+            statistics.hits++;
+            statistics.retainedBytes -= blockSize;
+        } else {
+            statistics.misses++;
+        }
+        
+        statistics.outstandingBytes += blockSize;
+        if (statistics.outstandingBytes > statistics.highWaterBytes) {
+            statistics.highWaterBytes = statistics.outstandingBytes;
+        }
+    }
+    
+    if (!block) {
+        block = malloc(blockSize);
+        
+        if (!block) {
+            std::lock_guard<std::mutex> lock(mutex);
+            
+            statistics.failures++;
+            statistics.outstandingBytes -= blockSize;
+        }
+    }
+    
+    return block;
+}
+
+void AIBufferPool::checkIn(void *block)
+{
+    if (!block) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        statistics.outstandingBytes -= blockSize;
+        
+        if (freeBlocks.size() < maxRetainedBlocks) {
+            freeBlocks.push_back(block);
+            statistics.retainedBytes += blockSize;
+            return;
+        }
+    }
+    
+    free(block);
+}
+
+void AIBufferPool::trim()
+{
+    std::vector<void *> blocks;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        blocks.swap(freeBlocks);
+        freeBlocks.reserve(maxRetainedBlocks);
+        statistics.retainedBytes = 0;
+    }
+    
+    for (size_t i = 0; i < blocks.size(); i++) {
+        free(blocks[i]);
+    }
+}
+
+size_t AIBufferPool::getBlockSize() const
+{
+    return blockSize;
+}
+
+AIBufferPoolStatistics AIBufferPool::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+// Shared pools by block size. They are never destroyed, so references handed out stay valid until exit.
+static std::mutex AISharedPoolsMutex;
+
+static std::map<size_t, AIBufferPool *> &AISharedPools()
+{
+    static std::map<size_t, AIBufferPool *> *pools = new std::map<size_t, AIBufferPool *>();
+    return *pools;
+}
+
+AIBufferPool &AIBufferPool::sharedPool(size_t size)
+{
+    size_t blockSize = AI_BUFFER_POOL_MIN_BLOCK_SIZE;
+    while (blockSize < size) blockSize <<= 1;
+    
+    std::lock_guard<std::mutex> lock(AISharedPoolsMutex);
+    
+    AIBufferPool *&pool = AISharedPools()[blockSize];
+    if (!pool) {
+        pool = new AIBufferPool(blockSize);
+    }
+    
+    return *pool;
+}
+
+void AIBufferPool::trimSharedPools()
+{
+    std::lock_guard<std::mutex> lock(AISharedPoolsMutex);
+    
+    std::map<size_t, AIBufferPool *> &pools = AISharedPools();
+    for (std::map<size_t, AIBufferPool *>::iterator it = pools.begin(); it != pools.end(); ++it) {
+        it->second->trim();
+    }
+}
+
+AIBufferPoolStatistics AIBufferPool::getSharedStatistics()
+{
+    AIBufferPoolStatistics total;
+    memset(&total, 0, sizeof(total));
+    
+    std::lock_guard<std::mutex> lock(AISharedPoolsMutex);
+    
+    std::map<size_t, AIBufferPool *> &pools = AISharedPools();
+    for (std::map<size_t, AIBufferPool *>::iterator it = pools.begin(); it != pools.end(); ++it) {
+        AIBufferPoolStatistics statistics = it->second->getStatistics();
+        
+        total.hits += statistics.hits;
+        total.misses += statistics.misses;
+        total.failures += statistics.failures;
+        total.outstandingBytes += statistics.outstandingBytes;
+        total.highWaterBytes += statistics.highWaterBytes;
+        total.retainedBytes += statistics.retainedBytes;
+    }
+    
+    return total;
+}
+
+AIPooledBuffer::AIPooledBuffer(AIBufferPool &pool) : pool(pool)
+{
+    block = pool.checkOut();
+}
+
+AIPooledBuffer::~AIPooledBuffer()
+{
+    pool.checkIn(block);
+}
+
+char *AIPooledBuffer::get() const
+{
+    return (char *)block;
+}
+
+size_t AIPooledBuffer::size() const
+{
+    return pool.getBlockSize();
+}
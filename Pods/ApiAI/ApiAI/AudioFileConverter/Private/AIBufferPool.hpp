@@ -0,0 +1,109 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef BufferPool_hpp
+#define BufferPool_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+#define AI_BUFFER_POOL_MIN_BLOCK_SIZE 4096
+#define AI_BUFFER_POOL_MAX_RETAINED_BLOCKS 16
+
+struct AIBufferPoolStatistics {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t failures;
+    size_t outstandingBytes;
+    size_t highWaterBytes;
+    size_t retainedBytes;
+};
+
+/*
+ * Thread-safe free list of equally sized blocks shared by conversion operations.
+ *
+ * A check-out served from the free list is a hit, one that has to malloc is a miss, and one whose malloc fails is a
+ * failure. Up to maxRetainedBlocks returned blocks are kept for reuse; anything beyond that is freed immediately.
+ */
+class AIBufferPool {
+public:
+    
+    AIBufferPool(size_t blockSize, size_t maxRetainedBlocks = AI_BUFFER_POOL_MAX_RETAINED_BLOCKS);
+    virtual ~AIBufferPool();
+    
+    // Returns NULL when no block is free and malloc fails.
+    void *checkOut();
+    void checkIn(void *block);
+    
+    // Frees every retained block; outstanding blocks are unaffected.
+    void trim();
+    
+    size_t getBlockSize() const;
+    AIBufferPoolStatistics getStatistics() const;
+    
+    // Process-wide pool for the smallest power of two >= max(size, AI_BUFFER_POOL_MIN_BLOCK_SIZE).
+    static AIBufferPool &sharedPool(size_t size);
+    
+    // trim() and getStatistics() over every shared pool; the high-water marks are summed.
+    static void trimSharedPools();
+    static AIBufferPoolStatistics getSharedStatistics();
+    
+private:
+    
+    size_t blockSize;
+    size_t maxRetainedBlocks;
+    
+    std::vector<void *> freeBlocks;
+    AIBufferPoolStatistics statistics;
+    
+    mutable std::mutex mutex;
+    
+private:
+    AIBufferPool( const AIBufferPool& );
+    void operator=( const AIBufferPool& );
+};
+
+/*
+ * Scoped check-out from an AIBufferPool. get() is NULL when the pool could not allocate.
+ */
+class AIPooledBuffer {
+public:
+    
+    explicit AIPooledBuffer(AIBufferPool &pool);
+    ~AIPooledBuffer();
+    
+    char *get() const;
+    size_t size() const;
+    
+private:
+    
+    AIBufferPool &pool;
+    void *block;
+    
+private:
+    AIPooledBuffer( const AIPooledBuffer& );
+    void operator=( const AIPooledBuffer& );
+};
+
+#endif /* BufferPool_hpp */
@@ -0,0 +1,203 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIConversionEngine.hpp"
+
+#include <string.h>
+
+#if defined(__LITTLE_ENDIAN__) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define AI_HOST_BIG_ENDIAN 0
+#else
+#define AI_HOST_BIG_ENDIAN 1
+#endif
+
+static inline uint32_t AIReadWord(const uint8_t *bytes, unsigned size, bool bigEndian)
+{
+    uint32_t value = 0;
+    if (bigEndian) {
+        for (unsigned i = 0; i < size; i++) value = (value << 8) | bytes[i];
+    } else {
+        for (unsigned i = size; i > 0; i--) value = (value << 8) | bytes[i - 1];
+    }
+    return value;
+}
+
+static inline float AIReadSample(const uint8_t *bytes, AISampleType type, bool bigEndian)
+{
+    switch (type) {
+        case AISampleTypeUInt8:
+            return ((int)bytes[0] - 128) / 128.f;
+        case AISampleTypeInt16:
+            return (int16_t)AIReadWord(bytes, 2, bigEndian) / 32768.f;
+        case AISampleTypeInt24:
+            return (int32_t)(AIReadWord(bytes, 3, bigEndian) << 8) / 2147483648.f;
+        case AISampleTypeInt32:
+            return (int32_t)AIReadWord(bytes, 4, bigEndian) / 2147483648.f;
+        case AISampleTypeFloat32: {
+            uint32_t word = AIReadWord(bytes, 4, bigEndian);
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            return value;
+        }
+        case AISampleTypeFloat64: {
+            uint64_t word = bigEndian
+                ? ((uint64_t)AIReadWord(bytes, 4, true) << 32) | AIReadWord(bytes + 4, 4, true)
+                : ((uint64_t)AIReadWord(bytes + 4, 4, false) << 32) | AIReadWord(bytes, 4, false);
+            double value;
+            memcpy(&value, &word, sizeof(value));
+            return (float)value;
+        }
+    }
+    return 0.f;
+}
+
+unsigned AIPCMFormat::getBytesPerSample() const
+{
+    switch (sampleType) {
+        case AISampleTypeUInt8: return 1;
+        case AISampleTypeInt16: return 2;
+        case AISampleTypeInt24: return 3;
+        case AISampleTypeInt32: return 4;
+        case AISampleTypeFloat32: return 4;
+        case AISampleTypeFloat64: return 8;
+    }
+    return 0;
+}
+
+unsigned AIPCMFormat::getBytesPerFrame() const
+{
+    return getBytesPerSample() * channels;
+}
+
+AIConversionEngine::AIConversionEngine(const AIPCMFormat &sourceFormat, double destinationRate) :
+    sourceFormat(sourceFormat),
+    destinationRate(destinationRate),
+    resampler(sourceFormat.sampleRate, destinationRate, AI_CONVERSION_BLOCK_FRAMES),
+    kernels(AISampleKernelsGetDefault())
+{
+    if (sourceFormat.sampleType == AISampleTypeInt16 && sourceFormat.channels > 1) {
+        interleaved.resize(AI_CONVERSION_BLOCK_FRAMES * sourceFormat.channels);
+    }
+    mono.resize(AI_CONVERSION_BLOCK_FRAMES);
+    resampled.resize(resampler.getMaxOutputFrames(AI_CONVERSION_BLOCK_FRAMES));
+}
+
+AIConversionEngine::~AIConversionEngine()
+{
+}
+
+void AIConversionEngine::decode(const uint8_t *frames, size_t frameCount, float *mono)
+{
+    unsigned channels = sourceFormat.channels;
+    unsigned bytesPerSample = sourceFormat.getBytesPerSample();
+    AISampleType type = sourceFormat.sampleType;
+    bool bigEndian = sourceFormat.bigEndian;
+    
+    // The common native-endian layouts go through the shared kernels; the same arithmetic, so the same samples.
+    if (bigEndian == AI_HOST_BIG_ENDIAN) {
+        if (type == AISampleTypeInt16) {
+            if (channels == 1) {
+                kernels->int16ToFloat((const int16_t *)frames, frameCount, 1.f / 32768.f, mono);
+            } else {
+                kernels->int16ToFloat((const int16_t *)frames, frameCount * channels, 1.f / 32768.f, &interleaved[0]);
+                kernels->downmixToMono(&interleaved[0], channels, frameCount, mono);
+            }
+            return;
+        }
+        if (type == AISampleTypeFloat32) {
+            kernels->downmixToMono((const float *)frames, channels, frameCount, mono);
+            return;
+        }
+    }
+    
+    float scale = 1.f / channels;
+    
+    for (size_t i = 0; i < frameCount; i++) {
+        float sum = 0.f;
+        for (unsigned c = 0; c < channels; c++) {
+            sum += AIReadSample(frames, type, bigEndian);
+            frames += bytesPerSample;
+        }
+        mono[i] = sum * scale;
+    }
+}
+
+size_t AIConversionEngine::quantize(const float *samples, size_t count, int16_t *output)
+{
+    // Undithered, so segments converted in parallel join without seams.
+    kernels->floatToInt16(samples, count, output);
+    return count;
+}
+
+size_t AIConversionEngine::process(const void *frames, size_t frameCount, int16_t *output)
+{
+    const uint8_t *bytes = (const uint8_t *)frames;
+    unsigned bytesPerFrame = sourceFormat.getBytesPerFrame();
+    
+    size_t produced = 0;
+    
+    while (frameCount > 0) {
+        size_t block = frameCount < AI_CONVERSION_BLOCK_FRAMES ? frameCount : AI_CONVERSION_BLOCK_FRAMES;
+        
+        decode(bytes, block, &mono[0]);
+        size_t count = resampler.process(&mono[0], block, &resampled[0]);
+        produced += quantize(&resampled[0], count, output + produced);
+        
+        bytes += block * bytesPerFrame;
+        frameCount -= block;
+    }
+    
+    return produced;
+}
+
+size_t AIConversionEngine::flush(int16_t *output)
+{
+    size_t count = resampler.flush(&resampled[0]);
+    return quantize(&resampled[0], count, output);
+}
+
+uint64_t AIConversionEngine::seek(uint64_t outputFrame)
+{
+    return resampler.seek(outputFrame);
+}
+
+uint64_t AIConversionEngine::getOutputFrameCount(uint64_t frameCount) const
+{
+    return resampler.getOutputFrameCount(frameCount);
+}
+
+size_t AIConversionEngine::getMaxOutputFrames(size_t frameCount) const
+{
+    size_t blocks = (frameCount + AI_CONVERSION_BLOCK_FRAMES - 1) / AI_CONVERSION_BLOCK_FRAMES;
+    if (blocks == 0) blocks = 1;
+    return resampler.getMaxOutputFrames(frameCount + (blocks - 1) * resampler.getTaps()) + blocks;
+}
+
+const AIPCMFormat &AIConversionEngine::getSourceFormat() const
+{
+    return sourceFormat;
+}
+
+double AIConversionEngine::getDestinationRate() const
+{
+    return destinationRate;
+}
@@ -0,0 +1,99 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef ConversionEngine_hpp
+#define ConversionEngine_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "AIResampler.hpp"
+#include "AISampleKernels.h"
+
+#define AI_CONVERSION_BLOCK_FRAMES 4096
+
+typedef enum _AISampleType {
+    AISampleTypeUInt8 = 0,
+    AISampleTypeInt16,
+    AISampleTypeInt24,
+    AISampleTypeInt32,
+    AISampleTypeFloat32,
+    AISampleTypeFloat64,
+} AISampleType;
+
+/*
+ * Interleaved linear PCM layout of a conversion source.
+ */
+struct AIPCMFormat {
+    double sampleRate;
+    unsigned channels;
+    AISampleType sampleType;
+    bool bigEndian;
+    
+    unsigned getBytesPerSample() const;
+    unsigned getBytesPerFrame() const;
+};
+
+/*
+ * Platform-neutral part of AIAudioFileConvertOperation: decodes interleaved PCM frames of any supported layout,
+ * downmixes them to mono, resamples and emits signed 16-bit samples at the destination rate.
+ */
+class AIConversionEngine {
+public:
+    
+    AIConversionEngine(const AIPCMFormat &sourceFormat, double destinationRate);
+    virtual ~AIConversionEngine();
+    
+    // The output buffer must hold at least getMaxOutputFrames(frameCount) samples.
+    size_t process(const void *frames, size_t frameCount, int16_t *output);
+    size_t flush(int16_t *output);
+    
+    // See AIResampler::seek(); the returned value is a source frame index.
+    uint64_t seek(uint64_t outputFrame);
+    uint64_t getOutputFrameCount(uint64_t frameCount) const;
+    
+    size_t getMaxOutputFrames(size_t frameCount) const;
+    const AIPCMFormat &getSourceFormat() const;
+    double getDestinationRate() const;
+    
+private:
+    
+    void decode(const uint8_t *frames, size_t frameCount, float *mono);
+    size_t quantize(const float *samples, size_t count, int16_t *output);
+    
+    AIPCMFormat sourceFormat;
+    double destinationRate;
+    
+    AIResampler resampler;
+    const AISampleKernels *kernels;
+    
+    std::vector<float> interleaved;
+    std::vector<float> mono;
+    std::vector<float> resampled;
+    
+private:
+    AIConversionEngine( const AIConversionEngine& );
+    void operator=( const AIConversionEngine& );
+};
+
+#endif /* ConversionEngine_hpp */
@@ -21,23 +21,34 @@
 
 #include "AIDataProcessInfo.hpp"
 
-AIDataProcessInfo::AIDataProcessInfo(UInt32 sizePerPacket, AudioFileID sourceFileID) : sizePerPacket(sizePerPacket), sourceFileID(sourceFileID)
+AIDataProcessInfo::AIDataProcessInfo(UInt32 sizePerPacket, AIPacketSource &source) : sizePerPacket(sizePerPacket), source(source)
 {
-    buffer = (char *)malloc(sizeof(char) * AI_BUFFER_SIZE);
+    buffer = NULL;
     buffer_size = AI_BUFFER_SIZE;
-    outputPacketDescriptions = (AudioStreamPacketDescription *)malloc(sizeof(AudioStreamPacketDescription) * AI_BUFFER_SIZE / sizePerPacket);
     
     offset = 0;
 }
 
+OSStatus AIDataProcessInfo::readPackets(UInt32 *ioNumberPackets, UInt32 *outNumberBytes)
+{
+    UInt32 maxPackets = buffer_size / sizePerPacket;
+    if (*ioNumberPackets > maxPackets) *ioNumberPackets = maxPackets;
+    
+    OSStatus status = source.readPackets(offset, ioNumberPackets, &buffer, outNumberBytes);
+    
+    increaseOffset(*ioNumberPackets);
+    
+    return status;
+}
+
 UInt32 AIDataProcessInfo::getSizePerPacket()
 {
     return sizePerPacket;
 }
 
-AudioFileID AIDataProcessInfo::getSourceFileID()
+AIPacketSource &AIDataProcessInfo::getSource()
 {
-    return sourceFileID;
+    return source;
 }
 
 void AIDataProcessInfo::increaseOffset(SInt64 shift)
@@ -52,7 +63,7 @@ SInt64 AIDataProcessInfo::getOffset()
 
 char *AIDataProcessInfo::getBuffer()
 {
-    return buffer;
+    return (char *)buffer;
 }
 
 int AIDataProcessInfo::getBufferSize()
@@ -62,11 +73,9 @@ int AIDataProcessInfo::getBufferSize()
 
 AudioStreamPacketDescription *AIDataProcessInfo::getPacketDescriptions()
 {
-    return outputPacketDescriptions;
+    return (AudioStreamPacketDescription *)source.getPacketDescriptions();
 }
 
 AIDataProcessInfo::~AIDataProcessInfo()
 {
-    free(buffer);
-    free(outputPacketDescriptions);
 }
\ No newline at end of file
@@ -24,20 +24,26 @@
 
 #import <AudioToolbox/AudioToolbox.h>
 
+#include "AIPacketSource.hpp"
+
 #define AI_BUFFER_SIZE 32768
 
 class AIDataProcessInfo {
 public:
     
-    AIDataProcessInfo(UInt32 sizePerPacket, AudioFileID sourceFileID);
+    AIDataProcessInfo(UInt32 sizePerPacket, AIPacketSource &source);
     virtual ~AIDataProcessInfo();
     
+    // Makes the next packets available through getBuffer() and advances the offset; end of file is reported as
+    // noErr with zero packets.
+    OSStatus readPackets(UInt32 *ioNumberPackets, UInt32 *outNumberBytes);
+    
     void increaseOffset(SInt64 shift);
     SInt64 getOffset();
     char *getBuffer();
     int getBufferSize();
     AudioStreamPacketDescription *getPacketDescriptions();
-    AudioFileID getSourceFileID();
+    AIPacketSource &getSource();
     
     UInt32 getSizePerPacket();
     
@@ -45,17 +51,15 @@ private:
     
     SInt64 offset;
     
-    char *buffer;
+    const void *buffer;
     int buffer_size;
     
-    AudioStreamPacketDescription *outputPacketDescriptions;
-    
     UInt32 sizePerPacket;
-    AudioFileID sourceFileID;
+    AIPacketSource &source;
     
 private:
-    AIDataProcessInfo( const AIDataProcessInfo& ) {}
-    void operator=( const AIDataProcessInfo& ) {}
+    AIDataProcessInfo( const AIDataProcessInfo& );
+    void operator=( const AIDataProcessInfo& );
 };
 
 #endif /* DataProcessInfo_hpp */
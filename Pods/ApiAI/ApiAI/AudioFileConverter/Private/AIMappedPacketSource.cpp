@@ -0,0 +1,318 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIMappedPacketSource.hpp"
+
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static inline uint16_t AIReadLE16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t AIReadLE32(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static inline uint16_t AIReadBE16(const uint8_t *p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static inline uint32_t AIReadBE32(const uint8_t *p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3]; }
+static inline uint64_t AIReadBE64(const uint8_t *p) { return ((uint64_t)AIReadBE32(p) << 32) | AIReadBE32(p + 4); }
+
+static inline bool AIChunkIs(const uint8_t *p, const char *fourCC) { return memcmp(p, fourCC, 4) == 0; }
+
+// 80-bit IEEE 754 extended precision, as used by the AIFF COMM chunk.
+static double AIReadExtended(const uint8_t *p)
+{
+    int exponent = ((p[0] & 0x7F) << 8) | p[1];
+    uint64_t mantissa = ((uint64_t)AIReadBE32(p + 2) << 32) | AIReadBE32(p + 6);
+    
+    if (exponent == 0 && mantissa == 0) return 0.0;
+    
+    double value = ldexp((double)mantissa, exponent - 16383 - 63);
+    return (p[0] & 0x80) ? -value : value;
+}
+
+static bool AISampleTypeForBits(unsigned bits, bool isFloat, AISampleType *type)
+{
+    if (isFloat) {
+        if (bits == 32) { *type = AISampleTypeFloat32; return true; }
+        if (bits == 64) { *type = AISampleTypeFloat64; return true; }
+        return false;
+    }
+    
+    switch (bits) {
+        case 8: *type = AISampleTypeUInt8; return true;
+        case 16: *type = AISampleTypeInt16; return true;
+        case 24: *type = AISampleTypeInt24; return true;
+        case 32: *type = AISampleTypeInt32; return true;
+    }
+    
+    return false;
+}
+
+AIMappedPacketSource::AIMappedPacketSource(const char *path) : mapping(NULL), mappingSize(0), data(NULL), dataSize(0), bytesPerFrame(0)
+{
+    memset(&format, 0, sizeof(format));
+    
+    if (!path) return;
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= 12) {
+        void *address = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            mapping = (uint8_t *)address;
+            mappingSize = (size_t)info.st_size;
+        }
+    }
+    
+    close(fd);
+    
+    if (!mapping) return;
+    
+    bool parsed = false;
+    if (AIChunkIs(mapping, "RIFF") && AIChunkIs(mapping + 8, "WAVE")) {
+        parsed = parseWAVE();
+    } else if (AIChunkIs(mapping, "FORM") && (AIChunkIs(mapping + 8, "AIFF") || AIChunkIs(mapping + 8, "AIFC"))) {
+        parsed = parseAIFF();
+    } else if (AIChunkIs(mapping, "caff")) {
+        parsed = parseCAF();
+    }
+    
+    if (!parsed) {
+        munmap(mapping, mappingSize);
+        mapping = NULL;
+        mappingSize = 0;
+        data = NULL;
+        return;
+    }
+    
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+}
+
+AIMappedPacketSource::~AIMappedPacketSource()
+{
+    if (mapping) munmap(mapping, mappingSize);
+}
+
+bool AIMappedPacketSource::setData(uint64_t dataOffset, uint64_t size)
+{
+    if (dataOffset > mappingSize) return false;
+    
+    // Streamed files may carry a placeholder size; trust the file length instead.
+    if (size > mappingSize - dataOffset) size = mappingSize - dataOffset;
+    
+    bytesPerFrame = format.getBytesPerFrame();
+    if (bytesPerFrame == 0 || format.sampleRate <= 0.0) return false;
+    
+    data = mapping + dataOffset;
+    dataSize = size - size % bytesPerFrame;
+    
+    return true;
+}
+
+bool AIMappedPacketSource::parseWAVE()
+{
+    const uint8_t *end = mapping + mappingSize;
+    const uint8_t *chunk = mapping + 12;
+    
+    bool hasFormat = false;
+    
+    while (end - chunk >= 8) {
+        uint32_t size = AIReadLE32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        
+        if (AIChunkIs(chunk, "fmt ")) {
+            if (size < 16 || (size_t)(end - body) < 16) return false;
+            
+            uint16_t tag = AIReadLE16(body);
+            unsigned channels = AIReadLE16(body + 2);
+            uint32_t rate = AIReadLE32(body + 4);
+            unsigned blockAlign = AIReadLE16(body + 12);
+            unsigned bits = AIReadLE16(body + 14);
+            
+            if (tag == 0xFFFE) {
+                if (size < 40 || (size_t)(end - body) < 40) return false;
+                tag = AIReadLE16(body + 24);
+            }
+            
+            if (tag != 1 && tag != 3) return false;
+            if (channels == 0 || blockAlign != channels * (bits / 8) || bits % 8) return false;
+            if (!AISampleTypeForBits(bits, tag == 3, &format.sampleType)) return false;
+            
+            format.sampleRate = rate;
+            format.channels = channels;
+            format.bigEndian = false;
+            hasFormat = true;
+        } else if (AIChunkIs(chunk, "data")) {
+            return hasFormat && setData((uint64_t)(body - mapping), size);
+        }
+        
+        // The size comes from the file: check it against what is left before stepping over the chunk and its pad byte.
+        if ((uint64_t)size + (size & 1) > (uint64_t)(end - body)) return false;
+        chunk = body + size + (size & 1);
+    }
+    
+    return false;
+}
+
+bool AIMappedPacketSource::parseAIFF()
+{
+    const uint8_t *end = mapping + mappingSize;
+    const uint8_t *chunk = mapping + 12;
+    
+    bool compressed = AIChunkIs(mapping + 8, "AIFC");
+    bool hasFormat = false;
+    
+    while (end - chunk >= 8) {
+        uint32_t size = AIReadBE32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        
+        if (AIChunkIs(chunk, "COMM")) {
+            if (size < 18 || (size_t)(end - body) < 18) return false;
+            
+            unsigned channels = AIReadBE16(body);
+            unsigned bits = AIReadBE16(body + 6);
+            bool isFloat = false;
+            
+            format.bigEndian = true;
+            
+            if (compressed) {
+                if (size < 22 || (size_t)(end - body) < 22) return false;
+                const uint8_t *type = body + 18;
+                
+                if (AIChunkIs(type, "sowt")) {
+                    format.bigEndian = false;
+                } else if (AIChunkIs(type, "fl32") || AIChunkIs(type, "FL32")) {
+                    isFloat = true;
+                    bits = 32;
+                } else if (AIChunkIs(type, "fl64") || AIChunkIs(type, "FL64")) {
+                    isFloat = true;
+                    bits = 64;
+                } else if (!AIChunkIs(type, "NONE") && !AIChunkIs(type, "twos")) {
+                    return false;
+                }
+            }
+            
+            if (channels == 0 || bits % 8) return false;
+            if (!AISampleTypeForBits(bits, isFloat, &format.sampleType)) return false;
+            
+            // AIFF stores 8-bit samples signed; AIPCMFormat's 8-bit type is the unsigned WAV flavour.
+            if (format.sampleType == AISampleTypeUInt8) return false;
+            
+            format.sampleRate = AIReadExtended(body + 8);
+            format.channels = channels;
+            hasFormat = true;
+        } else if (AIChunkIs(chunk, "SSND")) {
+            if (!hasFormat || size < 8 || (size_t)(end - body) < 8) return false;
+            
+            uint32_t offset = AIReadBE32(body);
+            return setData((uint64_t)(body - mapping) + 8 + offset, size - 8 > offset ? size - 8 - offset : 0);
+        }
+        
+        // The size comes from the file: check it against what is left before stepping over the chunk and its pad byte.
+        if ((uint64_t)size + (size & 1) > (uint64_t)(end - body)) return false;
+        chunk = body + size + (size & 1);
+    }
+    
+    return false;
+}
+
+bool AIMappedPacketSource::parseCAF()
+{
+    const uint8_t *end = mapping + mappingSize;
+    const uint8_t *chunk = mapping + 8;
+    
+    bool hasFormat = false;
+    
+    while (end - chunk >= 12) {
+        int64_t size = (int64_t)AIReadBE64(chunk + 4);
+        const uint8_t *body = chunk + 12;
+        
+        if (AIChunkIs(chunk, "desc")) {
+            if (size < 32 || (size_t)(end - body) < 32) return false;
+            
+            uint64_t rateBits = AIReadBE64(body);
+            double rate;
+            memcpy(&rate, &rateBits, sizeof(rate));
+            
+            uint32_t flags = AIReadBE32(body + 12);
+            uint32_t bytesPerPacket = AIReadBE32(body + 16);
+            uint32_t framesPerPacket = AIReadBE32(body + 20);
+            uint32_t channels = AIReadBE32(body + 24);
+            uint32_t bits = AIReadBE32(body + 28);
+            
+            if (!AIChunkIs(body + 8, "lpcm") || framesPerPacket != 1 || channels == 0) return false;
+            if (bits % 8 || bytesPerPacket != channels * (bits / 8)) return false;
+            if (!AISampleTypeForBits(bits, (flags & 1) != 0, &format.sampleType)) return false;
+            if (format.sampleType == AISampleTypeUInt8) return false;
+            
+            format.sampleRate = rate;
+            format.channels = channels;
+            format.bigEndian = (flags & 2) == 0;
+            hasFormat = true;
+        } else if (AIChunkIs(chunk, "data")) {
+            if (!hasFormat || (size_t)(end - body) < 4) return false;
+            
+            uint64_t payload = size < 0 ? (uint64_t)(end - body - 4) : (uint64_t)size - 4;
+            return setData((uint64_t)(body - mapping) + 4, payload);
+        }
+        
+        if (size < 0 || (uint64_t)size > (uint64_t)(end - body)) return false;
+        chunk = body + size;
+    }
+    
+    return false;
+}
+
+int32_t AIMappedPacketSource::readPackets(int64_t packetOffset, uint32_t *ioNumberPackets, const void **outData, uint32_t *outNumberBytes)
+{
+    int64_t packetCount = getPacketCount();
+    int64_t available = (packetOffset >= 0 && packetOffset < packetCount) ? packetCount - packetOffset : 0;
+    
+    if ((int64_t)*ioNumberPackets > available) *ioNumberPackets = (uint32_t)available;
+    
+    *outData = available > 0 ? data + (uint64_t)packetOffset * bytesPerFrame : data;
+    *outNumberBytes = *ioNumberPackets * bytesPerFrame;
+    
+    return 0;
+}
+
+bool AIMappedPacketSource::isOpen() const
+{
+    return data != NULL;
+}
+
+const AIPCMFormat &AIMappedPacketSource::getFormat() const
+{
+    return format;
+}
+
+int64_t AIMappedPacketSource::getPacketCount() const
+{
+    return bytesPerFrame ? (int64_t)(dataSize / bytesPerFrame) : 0;
+}
+
+const uint8_t *AIMappedPacketSource::getData() const
+{
+    return data;
+}
@@ -0,0 +1,76 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef MappedPacketSource_hpp
+#define MappedPacketSource_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AIPacketSource.hpp"
+#include "AIConversionEngine.hpp"
+
+/*
+ * Packet source over a memory-mapped uncompressed WAV, AIFF/AIFC or CAF file.
+ *
+ * readPackets() returns pointers into the mapping, so PCM input reaches the conversion engine without a copy or a
+ * read() per callback. Files that are compressed or use a sample layout AIPCMFormat cannot describe are rejected;
+ * isOpen() is false for them and the caller falls back to AudioFile.
+ */
+class AIMappedPacketSource : public AIPacketSource {
+public:
+    
+    explicit AIMappedPacketSource(const char *path);
+    virtual ~AIMappedPacketSource();
+    
+    virtual int32_t readPackets(int64_t packetOffset, uint32_t *ioNumberPackets, const void **outData, uint32_t *outNumberBytes);
+    
+    bool isOpen() const;
+    const AIPCMFormat &getFormat() const;
+    int64_t getPacketCount() const;
+    
+    // The audio payload; valid while the source is alive.
+    const uint8_t *getData() const;
+    
+private:
+    
+    bool parseWAVE();
+    bool parseAIFF();
+    bool parseCAF();
+    
+    bool setData(uint64_t dataOffset, uint64_t dataSize);
+    
+    uint8_t *mapping;
+    size_t mappingSize;
+    
+    const uint8_t *data;
+    uint64_t dataSize;
+    
+    AIPCMFormat format;
+    uint32_t bytesPerFrame;
+    
+private:
+    AIMappedPacketSource( const AIMappedPacketSource& );
+    void operator=( const AIMappedPacketSource& );
+};
+
+#endif /* MappedPacketSource_hpp */
@@ -0,0 +1,46 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef PacketSource_hpp
+#define PacketSource_hpp
+
+#include <stdint.h>
+
+/*
+ * Where AIDataProcessInfo gets its packets from.
+ *
+ * A source either copies packets into a buffer it owns or points straight into storage that is already in memory;
+ * in both cases *outData stays valid until the next readPackets() call. Status codes are OSStatus-compatible,
+ * end of data is reported as 0 with zero packets.
+ */
+class AIPacketSource {
+public:
+    
+    virtual ~AIPacketSource() {}
+    
+    virtual int32_t readPackets(int64_t packetOffset, uint32_t *ioNumberPackets, const void **outData, uint32_t *outNumberBytes) = 0;
+    
+    // AudioStreamPacketDescription array for the last read, or NULL for constant bit rate sources.
+    virtual void *getPacketDescriptions() { return 0; }
+};
+
+#endif /* PacketSource_hpp */
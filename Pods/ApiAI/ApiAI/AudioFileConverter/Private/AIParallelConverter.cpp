@@ -0,0 +1,118 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIParallelConverter.hpp"
+#include "AIBufferPool.hpp"
+
+#include <mutex>
+
+AIParallelConverter::AIParallelConverter(const AIPCMFormat &sourceFormat, double destinationRate, uint64_t segmentFrames) :
+    sourceFormat(sourceFormat),
+    destinationRate(destinationRate),
+    segmentFrames(segmentFrames),
+    prototype(sourceFormat, destinationRate)
+{
+}
+
+AIParallelConverter::~AIParallelConverter()
+{
+}
+
+uint64_t AIParallelConverter::getOutputFrameCount(uint64_t frameCount) const
+{
+    return prototype.getOutputFrameCount(frameCount);
+}
+
+uint64_t AIParallelConverter::getSegmentCount(uint64_t frameCount) const
+{
+    return (getOutputFrameCount(frameCount) + segmentFrames - 1) / segmentFrames;
+}
+
+size_t AIParallelConverter::getSegmentBufferBytes() const
+{
+    // Room for a whole segment plus the overshoot of the block that completes it.
+    return sizeof(int16_t) * ((size_t)segmentFrames + prototype.getMaxOutputFrames(AI_CONVERSION_BLOCK_FRAMES));
+}
+
+bool AIParallelConverter::convertSegment(const uint8_t *frames, uint64_t frameCount, uint64_t segment, int16_t *output, size_t *outputCount, const CancellationCheck &isCancelled)
+{
+    uint64_t total = getOutputFrameCount(frameCount);
+    uint64_t first = segment * segmentFrames;
+    size_t needed = (size_t)((total - first) < segmentFrames ? (total - first) : segmentFrames);
+    
+    AIConversionEngine engine(sourceFormat, destinationRate);
+    
+    uint64_t position = engine.seek(first);
+    unsigned bytesPerFrame = sourceFormat.getBytesPerFrame();
+    
+    size_t produced = 0;
+    
+    while (produced < needed) {
+        if (isCancelled && isCancelled()) return false;
+        
+        if (position < frameCount) {
+            uint64_t block = frameCount - position;
+            if (block > AI_CONVERSION_BLOCK_FRAMES) block = AI_CONVERSION_BLOCK_FRAMES;
+            
+            produced += engine.process(frames + position * bytesPerFrame, (size_t)block, output + produced);
+            position += block;
+        } else {
+            produced += engine.flush(output + produced);
+            break;
+        }
+    }
+    
+    *outputCount = produced < needed ? produced : needed;
+    
+    return true;
+}
+
+bool AIParallelConverter::convert(const void *frames, uint64_t frameCount, AIWorkPool &pool, const SegmentWriter &writer, const CancellationCheck &isCancelled)
+{
+    uint64_t segments = getSegmentCount(frameCount);
+    
+    AIBufferPool &bufferPool = AIBufferPool::sharedPool(getSegmentBufferBytes());
+    
+    std::mutex writerMutex;
+    bool succeeded = true;
+    
+    pool.apply((size_t)segments, [&](size_t segment) {
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            if (!succeeded) return;
+        }
+        
+        AIPooledBuffer buffer(bufferPool);
+        int16_t *output = (int16_t *)buffer.get();
+        size_t count = 0;
+        
+        bool converted = output && convertSegment((const uint8_t *)frames, frameCount, segment, output, &count, isCancelled);
+        
+        std::lock_guard<std::mutex> lock(writerMutex);
+        
+        if (!converted || !succeeded || !writer(segment * segmentFrames, output, count)) {
+            succeeded = false;
+        }
+    });
+    
+    return succeeded;
+}
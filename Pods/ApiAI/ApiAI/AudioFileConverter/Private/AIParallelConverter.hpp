@@ -0,0 +1,77 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef ParallelConverter_hpp
+#define ParallelConverter_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+#include "AIConversionEngine.hpp"
+#include "AIWorkPool.hpp"
+
+// Ten seconds of 16 kHz output per segment.
+#define AI_PARALLEL_SEGMENT_FRAMES 160000
+
+/*
+ * Converts a random-access PCM buffer in independent output segments on an AIWorkPool.
+ *
+ * Every segment runs its own AIConversionEngine that is seeked to the segment's first output frame, so it starts
+ * reading getTaps() / 2 source frames early and rebuilds exactly the filter history the sequential pass would have
+ * had at that point. The concatenated segments are therefore bit-identical to a single AIConversionEngine run.
+ */
+class AIParallelConverter {
+public:
+    
+    // Called once per finished segment, never concurrently. Returning false aborts the conversion.
+    typedef std::function<bool(uint64_t outputFrame, const int16_t *samples, size_t count)> SegmentWriter;
+    typedef std::function<bool()> CancellationCheck;
+    
+    AIParallelConverter(const AIPCMFormat &sourceFormat, double destinationRate, uint64_t segmentFrames = AI_PARALLEL_SEGMENT_FRAMES);
+    virtual ~AIParallelConverter();
+    
+    // Returns false if the writer failed, a segment buffer could not be allocated or the conversion was cancelled.
+    bool convert(const void *frames, uint64_t frameCount, AIWorkPool &pool, const SegmentWriter &writer, const CancellationCheck &isCancelled);
+    
+    uint64_t getOutputFrameCount(uint64_t frameCount) const;
+    uint64_t getSegmentCount(uint64_t frameCount) const;
+    
+    // Size of the buffer each thread taking part in convert() checks out of the shared pools.
+    size_t getSegmentBufferBytes() const;
+    
+private:
+    
+    bool convertSegment(const uint8_t *frames, uint64_t frameCount, uint64_t segment, int16_t *output, size_t *outputCount, const CancellationCheck &isCancelled);
+    
+    AIPCMFormat sourceFormat;
+    double destinationRate;
+    uint64_t segmentFrames;
+    
+    AIConversionEngine prototype;
+    
+private:
+    AIParallelConverter( const AIParallelConverter& );
+    void operator=( const AIParallelConverter& );
+};
+
+#endif /* ParallelConverter_hpp */
@@ -0,0 +1,265 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIResampler.hpp"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <map>
+#include <mutex>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#define AI_RESAMPLER_ROLLOFF 0.92
+#define AI_RESAMPLER_KAISER_BETA 8.0
+
+static unsigned AIGreatestCommonDivisor(unsigned a, unsigned b)
+{
+    while (b) {
+        unsigned t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static double AIBesselI0(double x)
+{
+    double sum = 1.0, term = 1.0, halfX = x / 2.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// taps is always a multiple of 8, so the vector paths need no remainder loop.
+static inline float AIDotProduct(const float *a, const float *b, unsigned taps)
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    for (unsigned i = 0; i < taps; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#elif defined(__SSE__) || defined(_M_X64)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (unsigned i = 0; i < taps; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+#else
+    float acc = 0.f;
+    for (unsigned i = 0; i < taps; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+#endif
+}
+
+static void AIDesignFilterBank(std::vector<float> &coefficients, unsigned phases, unsigned taps, double cutoff)
+{
+    double halfSpan = taps / 2.0;
+    double windowNorm = 1.0 / AIBesselI0(AI_RESAMPLER_KAISER_BETA);
+    
+    coefficients.resize((size_t)phases * taps);
+    
+    for (unsigned p = 0; p < phases; p++) {
+        float *filter = &coefficients[(size_t)p * taps];
+        double sum = 0.0;
+        
+        for (unsigned j = 0; j < taps; j++) {
+            double t = (double)p / phases + (taps / 2 - 1) - j;
+            double x = t / halfSpan;
+            double value = 0.0;
+            
+            if (fabs(x) < 1.0) {
+                double arg = M_PI * cutoff * t;
+                double sinc = (arg == 0.0) ? 1.0 : (cutoff == 1.0 && t == floor(t)) ? 0.0 : sin(arg) / arg;
+                value = cutoff * sinc * AIBesselI0(AI_RESAMPLER_KAISER_BETA * sqrt(1.0 - x * x)) * windowNorm;
+            }
+            
+            filter[j] = (float)value;
+            sum += value;
+        }
+        
+        for (unsigned j = 0; j < taps; j++) {
+            filter[j] = (float)(filter[j] / sum);
+        }
+    }
+}
+
+// Filter banks only depend on the reduced ratio, so resamplers for the same ratio share one table.
+static std::shared_ptr<const std::vector<float> > AISharedFilterBank(unsigned interpolation, unsigned step, unsigned phases, unsigned taps, double cutoff)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<unsigned, unsigned>, std::weak_ptr<const std::vector<float> > > banks;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    std::weak_ptr<const std::vector<float> > &cached = banks[std::make_pair(interpolation, step)];
+    std::shared_ptr<const std::vector<float> > bank = cached.lock();
+    
+    if (!bank) {
+        std::shared_ptr<std::vector<float> > coefficients = std::make_shared<std::vector<float> >();
+        AIDesignFilterBank(*coefficients, phases, taps, cutoff);
+        bank = coefficients;
+        cached = bank;
+    }
+    
+    return bank;
+}
+
+AIResampler::AIResampler(double inputRate, double outputRate, size_t maxInputFrames) : maxInputFrames(maxInputFrames)
+{
+    unsigned input = (unsigned)lround(inputRate);
+    unsigned output = (unsigned)lround(outputRate);
+    unsigned divisor = AIGreatestCommonDivisor(input, output);
+    
+    interpolation = output / divisor;
+    step = input / divisor;
+    phases = interpolation < AI_RESAMPLER_MAX_PHASES ? interpolation : AI_RESAMPLER_MAX_PHASES;
+    
+    // At 1:1 the sinc at full bandwidth samples to a unit impulse, so the samples come out unchanged.
+    double cutoff = AI_RESAMPLER_ROLLOFF * (interpolation < step ? (double)interpolation / step : 1.0);
+    if (interpolation == step) {
+        cutoff = 1.0;
+    }
+    double halfWidth = AI_RESAMPLER_ZERO_CROSSINGS / cutoff;
+    
+    taps = 2 * (unsigned)ceil(halfWidth);
+    taps = (taps + 7) & ~7u;
+    
+    coefficients = AISharedFilterBank(interpolation, step, phases, taps, cutoff);
+    
+    history.resize(maxInputFrames + 2 * taps);
+    
+    reset();
+}
+
+AIResampler::~AIResampler()
+{
+}
+
+void AIResampler::reset()
+{
+    seek(0);
+}
+
+uint64_t AIResampler::seek(uint64_t outputFrame)
+{
+    uint64_t time = outputFrame * step;
+    int64_t start = (int64_t)(time / interpolation) - (taps / 2 - 1);
+    
+    phase = (unsigned)(time % interpolation);
+    position = 0;
+    historyLength = 0;
+    
+    if (start < 0) {
+        historyLength = (size_t)-start;
+        memset(&history[0], 0, sizeof(float) * historyLength);
+        start = 0;
+    }
+    
+    return (uint64_t)start;
+}
+
+size_t AIResampler::run(float *output)
+{
+    const float *samples = &history[0];
+    const float *filters = &(*coefficients)[0];
+    
+    size_t produced = 0;
+    
+    while (position + taps <= historyLength) {
+        size_t filter = (phases == interpolation) ? phase : (size_t)((uint64_t)phase * phases / interpolation);
+        output[produced++] = AIDotProduct(samples + position, filters + filter * taps, taps);
+        
+        phase += step;
+        position += phase / interpolation;
+        phase %= interpolation;
+    }
+    
+    size_t remaining = historyLength - position;
+    memmove(&history[0], samples + position, sizeof(float) * remaining);
+    historyLength = remaining;
+    position = 0;
+    
+    return produced;
+}
+
+size_t AIResampler::process(const float *input, size_t inputFrames, float *output)
+{
+    assert(inputFrames <= maxInputFrames);
+    
+    memcpy(&history[historyLength], input, sizeof(float) * inputFrames);
+    historyLength += inputFrames;
+    
+    return run(output);
+}
+
+size_t AIResampler::flush(float *output)
+{
+    memset(&history[historyLength], 0, sizeof(float) * (taps / 2));
+    historyLength += taps / 2;
+    
+    size_t produced = run(output);
+    
+    reset();
+    
+    return produced;
+}
+
+size_t AIResampler::getMaxOutputFrames(size_t inputFrames) const
+{
+    return (size_t)((uint64_t)(inputFrames + taps) * interpolation / step + 1);
+}
+
+uint64_t AIResampler::getOutputFrameCount(uint64_t inputFrames) const
+{
+    return (inputFrames * interpolation + step - 1) / step;
+}
+
+size_t AIResampler::getMaxInputFrames() const
+{
+    return maxInputFrames;
+}
+
+unsigned AIResampler::getTaps() const
+{
+    return taps;
+}
@@ -0,0 +1,91 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef Resampler_hpp
+#define Resampler_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#define AI_RESAMPLER_MAX_PHASES 1024
+#define AI_RESAMPLER_ZERO_CROSSINGS 16
+
+/*
+ * Streaming polyphase windowed-sinc resampler for mono float samples.
+ *
+ * The rate ratio is reduced to outputRate/inputRate = L/M and one Kaiser-windowed sinc filter is precomputed per
+ * output phase, so every output sample costs a single dot product of getTaps() input samples. When the reduced L
+ * exceeds AI_RESAMPLER_MAX_PHASES the rate stays exact and each output uses the nearest of AI_RESAMPLER_MAX_PHASES
+ * filters instead.
+ */
+class AIResampler {
+public:
+    
+    AIResampler(double inputRate, double outputRate, size_t maxInputFrames);
+    virtual ~AIResampler();
+    
+    // Consumes up to maxInputFrames samples and returns the number of samples written to output.
+    // The output buffer must hold at least getMaxOutputFrames(inputFrames) samples.
+    size_t process(const float *input, size_t inputFrames, float *output);
+    
+    // Pushes the tail of the filter through with silence; call once at end of stream.
+    size_t flush(float *output);
+    
+    void reset();
+    
+    // Restarts the stream so that the next output sample is outputFrame. Returns the index of the first input
+    // sample the resampler expects next; input before that point only influences outputs before outputFrame.
+    uint64_t seek(uint64_t outputFrame);
+    
+    // Number of samples a full pass over inputFrames samples produces, including the flush.
+    uint64_t getOutputFrameCount(uint64_t inputFrames) const;
+    
+    size_t getMaxOutputFrames(size_t inputFrames) const;
+    size_t getMaxInputFrames() const;
+    unsigned getTaps() const;
+    
+private:
+    
+    size_t run(float *output);
+    
+    unsigned interpolation;
+    unsigned step;
+    unsigned phases;
+    unsigned taps;
+    
+    std::shared_ptr<const std::vector<float> > coefficients;
+    
+    std::vector<float> history;
+    size_t historyLength;
+    size_t maxInputFrames;
+    
+    size_t position;
+    unsigned phase;
+    
+private:
+    AIResampler( const AIResampler& );
+    void operator=( const AIResampler& );
+};
+
+#endif /* Resampler_hpp */
@@ -0,0 +1,120 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIWorkPool.hpp"
+
+#include <algorithm>
+
+AIWorkPool::AIWorkPool(unsigned workerCount) : stopping(false)
+{
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers.push_back(std::thread(&AIWorkPool::workerLoop, this));
+    }
+}
+
+AIWorkPool::~AIWorkPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    
+    wake.notify_all();
+    
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+// Claims and runs one iteration of job with the lock released around the body. Returns false once the job has
+// no unclaimed iterations left.
+bool AIWorkPool::runNextIteration(std::unique_lock<std::mutex> &lock, Job *job)
+{
+    if (job->next >= job->count) {
+        std::deque<Job *>::iterator it = std::find(jobs.begin(), jobs.end(), job);
+        if (it != jobs.end()) jobs.erase(it);
+        return false;
+    }
+    
+    size_t index = job->next++;
+    
+    lock.unlock();
+    (*job->body)(index);
+    lock.lock();
+    
+    if (++job->finished == job->count) {
+        done.notify_all();
+    }
+    
+    return true;
+}
+
+void AIWorkPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true) {
+        while (!stopping && jobs.empty()) {
+            wake.wait(lock);
+        }
+        
+        if (stopping) return;
+        
+        runNextIteration(lock, jobs.front());
+    }
+}
+
+void AIWorkPool::apply(size_t count, const std::function<void(size_t)> &body)
+{
+    if (count == 0) return;
+    
+    Job job;
+    job.body = &body;
+    job.count = count;
+    job.next = 0;
+    job.finished = 0;
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    if (count > 1) {
+        jobs.push_back(&job);
+        wake.notify_all();
+    }
+    
+    while (runNextIteration(lock, &job)) {
+    }
+    
+    while (job.finished < job.count) {
+        done.wait(lock);
+    }
+}
+
+unsigned AIWorkPool::getWorkerCount() const
+{
+    return (unsigned)workers.size();
+}
+
+AIWorkPool &AIWorkPool::sharedPool()
+{
+    static AIWorkPool *pool = new AIWorkPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return *pool;
+}
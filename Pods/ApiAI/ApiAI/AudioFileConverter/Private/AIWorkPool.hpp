@@ -0,0 +1,78 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef WorkPool_hpp
+#define WorkPool_hpp
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads running parallel loops, in the spirit of dispatch_apply.
+ *
+ * apply() hands out iterations one at a time to the workers and to the calling thread and returns once every
+ * iteration has finished. Loops from different callers share the workers; bodies must not throw.
+ */
+class AIWorkPool {
+public:
+    
+    explicit AIWorkPool(unsigned workerCount);
+    virtual ~AIWorkPool();
+    
+    void apply(size_t count, const std::function<void(size_t)> &body);
+    
+    unsigned getWorkerCount() const;
+    
+    // One worker per core besides the caller's own thread.
+    static AIWorkPool &sharedPool();
+    
+private:
+    
+    struct Job {
+        const std::function<void(size_t)> *body;
+        size_t count;
+        size_t next;
+        size_t finished;
+    };
+    
+    bool runNextIteration(std::unique_lock<std::mutex> &lock, Job *job);
+    void workerLoop();
+    
+    std::vector<std::thread> workers;
+    std::deque<Job *> jobs;
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping;
+    
+private:
+    AIWorkPool( const AIWorkPool& );
+    void operator=( const AIWorkPool& );
+};
+
+#endif /* WorkPool_hpp */
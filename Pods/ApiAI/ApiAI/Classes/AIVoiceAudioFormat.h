@@ -0,0 +1,41 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ 
+ @enum AIVoiceAudioFormat enum
+ 
+ @discussion Encoding of the audio uploaded by voice requests.
+ 
+ */
+typedef NS_ENUM(NSUInteger, AIVoiceAudioFormat) {
+    /*! Uncompressed 16-bit PCM, sent as audio/wav. */
+    AIVoiceAudioFormatPCM,
+    /*! Lossless FLAC, about half the size of PCM for speech. Sent as audio/x-flac. */
+    AIVoiceAudioFormatFLAC,
+    /*! Lossy G.711 mu-law, 8 bits per sample. Sent as audio/wav. */
+    AIVoiceAudioFormatMuLaw,
+    /*! Lossy IMA ADPCM, 4 bits per sample; a quarter of PCM for constrained networks. Sent as audio/wav. */
+    AIVoiceAudioFormatIMAADPCM
+};
@@ -0,0 +1,43 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+
+ @enum AIVoiceCaptureConversion enum
+
+ @discussion How voice requests bring the microphone's audio to the 16 kHz they analyse and upload. The SDK's own
+ decimation needs a hardware rate that is a whole multiple of 16 kHz, such as 48 kHz; at other rates the system
+ converts whatever is chosen.
+
+ */
+typedef NS_ENUM(NSUInteger, AIVoiceCaptureConversion) {
+    /*! The system's audio unit converts from the hardware rate before the SDK sees the audio. */
+    AIVoiceCaptureConversionSystem,
+    /*! Decimated by the SDK with aliases 60 dB down and flat to 6.4 kHz; adds 0.6 ms at 48 kHz. */
+    AIVoiceCaptureConversionLowLatency,
+    /*! Decimated by the SDK with aliases 80 dB down and flat to 7 kHz; adds 1.3 ms at 48 kHz. */
+    AIVoiceCaptureConversionBalanced,
+    /*! Decimated by the SDK with aliases 100 dB down and flat to 7.2 kHz; adds 2.1 ms at 48 kHz. */
+    AIVoiceCaptureConversionHigh
+};
@@ -33,6 +33,10 @@
     #import "AIVoiceFileRequest_Private.h"
 #endif
 
+#if __has_include("AIAudioFileConvertOperation.h")
+    #import "AIAudioFileConvertOperation.h"
+#endif
+
 NSString *const kDefaultVersion = @"20150910";
 
 @interface ApiAI ()
@@ -119,6 +123,20 @@ NSString *const kDefaultVersion = @"20150910";
         }
     }
     
+#if __has_include("AIAudioFileConvertOperation.h")
+    // MP4 files, 16 kHz mono PCM WAV files and whatever AudioToolbox cannot read are uploaded byte for byte, as
+    // always; any other audio file is converted to 16 kHz while it is uploaded.
+    if (![contentType isEqualToString:@"audio/mp4"] && [AIAudioFileConvertOperation needsConversionOfFileURL:fileURL]) {
+        AIVoiceFileRequest *request = [[AIVoiceFileRequest alloc] initWithDataService:_dataService];
+        
+        request.sourceFileURL = fileURL;
+        [request setVersion:self.version];
+        [request setLang:self.lang];
+        
+        return request;
+    }
+#endif
+    
     NSInputStream *stream = [[NSInputStream alloc] initWithURL:fileURL];
     AIVoiceFileRequest *request = [self voiceFileRequestWithStream:stream];
     
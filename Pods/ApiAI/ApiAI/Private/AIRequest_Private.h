@@ -13,6 +13,7 @@
 - (instancetype)initWithDataService:(AIDataService *)dataService;
 
 - (void)configureHTTPRequest;
+- (void)cancelHTTPRequest;
 
 - (void)handleResponse:(id)response;
 - (void)handleError:(NSError *)error;
@@ -0,0 +1,695 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIFLACEncoder.hpp"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#define AI_FLAC_SAMPLE_BITS 16
+#define AI_FLAC_MAX_BLOCK_SIZE 65535
+#define AI_FLAC_TUKEY_PARAMETER 0.5
+
+struct AIFLACCRCTables {
+    uint8_t crc8[256];
+    uint16_t crc16[256];
+    
+    AIFLACCRCTables()
+    {
+        for (unsigned i = 0; i < 256; i++) {
+            unsigned crc = i;
+            for (unsigned bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+            }
+            crc8[i] = (uint8_t)crc;
+            
+            crc = i << 8;
+            for (unsigned bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x8005) : (crc << 1);
+            }
+            crc16[i] = (uint16_t)crc;
+        }
+    }
+};
+
+static const AIFLACCRCTables &AICRCTables()
+{
+    static const AIFLACCRCTables tables;
+    return tables;
+}
+
+static uint8_t AICRC8(const uint8_t *data, size_t length)
+{
+    const AIFLACCRCTables &tables = AICRCTables();
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = tables.crc8[crc ^ data[i]];
+    }
+    return crc;
+}
+
+static uint16_t AICRC16(const uint8_t *data, size_t length)
+{
+    const AIFLACCRCTables &tables = AICRCTables();
+    uint16_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 8) ^ tables.crc16[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+// MSB-first bit packer appending whole bytes to an output vector.
+class AIFLACBitWriter {
+public:
+    
+    explicit AIFLACBitWriter(std::vector<uint8_t> &output) : output(output), accumulator(0), bitCount(0) {}
+    
+    void write(uint32_t value, unsigned bits)
+    {
+        if (bits == 0) {
+            return;
+        }
+        
+        uint64_t mask = (bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+        accumulator = (accumulator << bits) | (value & mask);
+        bitCount += bits;
+        
+        while (bitCount >= 8) {
+            bitCount -= 8;
+            output.push_back((uint8_t)(accumulator >> bitCount));
+        }
+        
+        accumulator &= (1ull << bitCount) - 1;
+    }
+    
+    void writeSigned(int32_t value, unsigned bits)
+    {
+        write((uint32_t)value, bits);
+    }
+    
+    void writeUnary(uint32_t zeros)
+    {
+        while (zeros >= 32) {
+            write(0, 32);
+            zeros -= 32;
+        }
+        write(1, zeros + 1);
+    }
+    
+    void writeRice(uint32_t value, unsigned parameter)
+    {
+        writeUnary(value >> parameter);
+        write(value, parameter);
+    }
+    
+    void alignToByte()
+    {
+        if (bitCount) {
+            write(0, 8 - bitCount);
+        }
+    }
+    
+private:
+    std::vector<uint8_t> &output;
+    uint64_t accumulator;
+    unsigned bitCount;
+};
+
+struct AIRiceChoice {
+    unsigned partitionOrder;
+    unsigned parameters[1 << AI_FLAC_MAX_PARTITION_ORDER];
+    uint64_t bits;
+};
+
+static inline uint32_t AIFoldResidual(int32_t residual)
+{
+    return ((uint32_t)residual << 1) ^ (uint32_t)(residual >> 31);
+}
+
+static inline float AIDotProduct(const float *a, const float *b, unsigned count)
+{
+    unsigned i = 0;
+    float acc = 0.f;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float32x4_t sum4 = vaddq_f32(acc0, acc1);
+    float32x2_t sum2 = vadd_f32(vget_low_f32(sum4), vget_high_f32(sum4));
+    acc = vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+#elif defined(__SSE__) || defined(_M_X64)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    acc = _mm_cvtss_f32(sum);
+#endif
+    for (; i < count; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+static void AITukeyWindow(std::vector<float> &window, unsigned length)
+{
+    window.assign(length, 1.f);
+    
+    int taper = (int)(AI_FLAC_TUKEY_PARAMETER / 2. * length) - 1;
+    
+    if (taper > 0) {
+        for (int i = 0; i <= taper; i++) {
+            window[i] = (float)(0.5 - 0.5 * cos(M_PI * i / taper));
+            window[length - taper - 1 + i] = (float)(0.5 - 0.5 * cos(M_PI * (i + taper) / taper));
+        }
+    }
+}
+
+// Fills coefficients[order - 1][0..order) for every order up to maxOrder; returns the highest usable order.
+static unsigned AILevinsonDurbin(const double *autocorrelation, unsigned maxOrder, double coefficients[AI_FLAC_MAX_LPC_ORDER][AI_FLAC_MAX_LPC_ORDER])
+{
+    double lpc[AI_FLAC_MAX_LPC_ORDER];
+    double error = autocorrelation[0];
+    
+    for (unsigned i = 0; i < maxOrder; i++) {
+        double reflection = -autocorrelation[i + 1];
+        for (unsigned j = 0; j < i; j++) {
+            reflection -= lpc[j] * autocorrelation[i - j];
+        }
+        reflection /= error;
+        
+        lpc[i] = reflection;
+        
+        unsigned j = 0;
+        for (; j < (i >> 1); j++) {
+            double tmp = lpc[j];
+            lpc[j] += reflection * lpc[i - 1 - j];
+            lpc[i - 1 - j] += reflection * tmp;
+        }
+        if (i & 1) {
+            lpc[j] += lpc[j] * reflection;
+        }
+        
+        error *= 1. - reflection * reflection;
+        
+        for (j = 0; j <= i; j++) {
+            coefficients[i][j] = -lpc[j];
+        }
+        
+        if (error <= 0.) {
+            return i + 1;
+        }
+    }
+    
+    return maxOrder;
+}
+
+// Quantizes with error feedback so that rounding errors do not accumulate along the predictor.
+static bool AIQuantizeCoefficients(const double *coefficients, unsigned order, unsigned precision, int32_t *quantized, int *shift)
+{
+    double maxCoefficient = 0.;
+    for (unsigned i = 0; i < order; i++) {
+        maxCoefficient = std::max(maxCoefficient, fabs(coefficients[i]));
+    }
+    
+    if (maxCoefficient <= 0.) {
+        return false;
+    }
+    
+    int log2MaxCoefficient;
+    frexp(maxCoefficient, &log2MaxCoefficient);
+    log2MaxCoefficient--;
+    
+    // One bit of the precision is the sign.
+    int quantizationShift = (int)precision - 1 - log2MaxCoefficient - 1;
+    
+    if (quantizationShift < 0) {
+        return false;
+    }
+    
+    quantizationShift = std::min(quantizationShift, 15);
+    
+    const int32_t maxValue = (1 << (precision - 1)) - 1;
+    const int32_t minValue = -maxValue - 1;
+    
+    double error = 0.;
+    for (unsigned i = 0; i < order; i++) {
+        error += coefficients[i] * (1 << quantizationShift);
+        long value = lround(error);
+        value = std::max<long>(minValue, std::min<long>(maxValue, value));
+        error -= value;
+        quantized[i] = (int32_t)value;
+    }
+    
+    *shift = quantizationShift;
+    return true;
+}
+
+static void AIFixedResidual(const int32_t *x, unsigned count, unsigned order, int32_t *residual)
+{
+    switch (order) {
+        case 0:
+            for (unsigned i = 0; i < count; i++) residual[i] = x[i];
+            break;
+        case 1:
+            for (unsigned i = 1; i < count; i++) residual[i - 1] = x[i] - x[i - 1];
+            break;
+        case 2:
+            for (unsigned i = 2; i < count; i++) residual[i - 2] = x[i] - 2 * x[i - 1] + x[i - 2];
+            break;
+        case 3:
+            for (unsigned i = 3; i < count; i++) residual[i - 3] = x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+            break;
+        case 4:
+            for (unsigned i = 4; i < count; i++) residual[i - 4] = x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4];
+            break;
+    }
+}
+
+static void AILPCResidual(const int32_t *x, unsigned count, const int32_t *coefficients, unsigned order, int shift, int32_t *residual)
+{
+    for (unsigned i = order; i < count; i++) {
+        int64_t prediction = 0;
+        for (unsigned j = 0; j < order; j++) {
+            prediction += (int64_t)coefficients[j] * x[i - j - 1];
+        }
+        residual[i - order] = x[i] - (int32_t)(prediction >> shift);
+    }
+}
+
+static unsigned AIRiceParameter(uint64_t sum, unsigned count)
+{
+    unsigned parameter = 0;
+    while (parameter < AI_FLAC_MAX_RICE_PARAMETER && ((uint64_t)count << (parameter + 1)) < sum) {
+        parameter++;
+    }
+    return parameter;
+}
+
+// Picks the partition order and per-partition Rice parameters from per-partition sums of folded residuals.
+static void AIChooseRicePartitions(const int32_t *residual, unsigned blockSize, unsigned order, AIRiceChoice &choice)
+{
+    unsigned maxPartitionOrder = 0;
+    while (maxPartitionOrder < AI_FLAC_MAX_PARTITION_ORDER &&
+           (blockSize % (2u << maxPartitionOrder)) == 0 &&
+           (blockSize >> (maxPartitionOrder + 1)) > order) {
+        maxPartitionOrder++;
+    }
+    
+    uint64_t sums[1 << AI_FLAC_MAX_PARTITION_ORDER];
+    unsigned partitionSize = blockSize >> maxPartitionOrder;
+    
+    const int32_t *r = residual;
+    for (unsigned p = 0; p < (1u << maxPartitionOrder); p++) {
+        unsigned count = partitionSize - (p == 0 ? order : 0);
+        uint64_t sum = 0;
+        for (unsigned i = 0; i < count; i++) {
+            sum += AIFoldResidual(r[i]);
+        }
+        sums[p] = sum;
+        r += count;
+    }
+    
+    choice.bits = UINT64_MAX;
+    
+    for (int partitionOrder = (int)maxPartitionOrder; partitionOrder >= 0; partitionOrder--) {
+        unsigned partitions = 1u << partitionOrder;
+        unsigned size = blockSize >> partitionOrder;
+        
+        uint64_t bits = 0;
+        unsigned parameters[1 << AI_FLAC_MAX_PARTITION_ORDER];
+        
+        for (unsigned p = 0; p < partitions; p++) {
+            unsigned count = size - (p == 0 ? order : 0);
+            unsigned parameter = AIRiceParameter(sums[p], count);
+            parameters[p] = parameter;
+            bits += 4 + (uint64_t)count * (parameter + 1) + (sums[p] >> parameter);
+        }
+        
+        if (bits < choice.bits) {
+            choice.bits = bits;
+            choice.partitionOrder = (unsigned)partitionOrder;
+            memcpy(choice.parameters, parameters, partitions * sizeof(unsigned));
+        }
+        
+        for (unsigned p = 0; p < partitions / 2; p++) {
+            sums[p] = sums[2 * p] + sums[2 * p + 1];
+        }
+    }
+    
+    // Coding method and partition order fields.
+    choice.bits += 6;
+}
+
+static void AIWriteResidual(AIFLACBitWriter &writer, const int32_t *residual, unsigned blockSize, unsigned order, const AIRiceChoice &choice)
+{
+    writer.write(0, 2);
+    writer.write(choice.partitionOrder, 4);
+    
+    unsigned size = blockSize >> choice.partitionOrder;
+    
+    for (unsigned p = 0; p < (1u << choice.partitionOrder); p++) {
+        unsigned count = size - (p == 0 ? order : 0);
+        unsigned parameter = choice.parameters[p];
+        
+        writer.write(parameter, 4);
+        for (unsigned i = 0; i < count; i++) {
+            writer.writeRice(AIFoldResidual(residual[i]), parameter);
+        }
+        residual += count;
+    }
+}
+
+static unsigned AIBlockSizeCode(unsigned blockSize)
+{
+    switch (blockSize) {
+        case 192: return 1;
+        case 576: return 2;
+        case 1152: return 3;
+        case 2304: return 4;
+        case 4608: return 5;
+        case 256: return 8;
+        case 512: return 9;
+        case 1024: return 10;
+        case 2048: return 11;
+        case 4096: return 12;
+        case 8192: return 13;
+        case 16384: return 14;
+        case 32768: return 15;
+        default: return blockSize <= 256 ? 6 : 7;
+    }
+}
+
+static unsigned AISampleRateCode(unsigned sampleRate)
+{
+    switch (sampleRate) {
+        case 88200: return 1;
+        case 176400: return 2;
+        case 192000: return 3;
+        case 8000: return 4;
+        case 16000: return 5;
+        case 22050: return 6;
+        case 24000: return 7;
+        case 32000: return 8;
+        case 44100: return 9;
+        case 48000: return 10;
+        case 96000: return 11;
+    }
+    
+    if (sampleRate % 1000 == 0 && sampleRate <= 255000) return 12;
+    if (sampleRate <= 65535) return 13;
+    if (sampleRate % 10 == 0 && sampleRate <= 655350) return 14;
+    
+    return 0;
+}
+
+static void AIWriteUTF8(AIFLACBitWriter &writer, uint32_t value)
+{
+    if (value < 0x80) {
+        writer.write(value, 8);
+        return;
+    }
+    
+    unsigned bytes = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : 6;
+    
+    writer.write(((0xFF00u >> bytes) & 0xFF) | (value >> (6 * (bytes - 1))), 8);
+    for (int i = (int)bytes - 2; i >= 0; i--) {
+        writer.write(0x80 | ((value >> (6 * i)) & 0x3F), 8);
+    }
+}
+
+AIFLACEncoder::AIFLACEncoder(unsigned sampleRate, unsigned blockSize, unsigned maxLPCOrder) :
+    sampleRate(sampleRate),
+    blockSize(blockSize),
+    maxLPCOrder(maxLPCOrder),
+    frameCount(0)
+{
+    assert(blockSize >= 16 && blockSize <= AI_FLAC_MAX_BLOCK_SIZE);
+    assert(maxLPCOrder <= AI_FLAC_MAX_LPC_ORDER);
+    
+    pending.reserve(blockSize);
+    windowed.resize(blockSize);
+    residual.resize(blockSize);
+    bestResidual.resize(blockSize);
+    
+    AITukeyWindow(window, blockSize);
+}
+
+AIFLACEncoder::~AIFLACEncoder()
+{
+    
+}
+
+void AIFLACEncoder::writeStreamHeader(std::vector<uint8_t> &output) const
+{
+    AIFLACBitWriter writer(output);
+    
+    writer.write('f', 8);
+    writer.write('L', 8);
+    writer.write('a', 8);
+    writer.write('C', 8);
+    
+    // Last metadata block, type STREAMINFO, 34 bytes.
+    writer.write(1, 1);
+    writer.write(0, 7);
+    writer.write(34, 24);
+    
+    writer.write(blockSize, 16);
+    writer.write(blockSize, 16);
+    writer.write(0, 24);
+    writer.write(0, 24);
+    writer.write(sampleRate, 20);
+    writer.write(0, 3);
+    writer.write(AI_FLAC_SAMPLE_BITS - 1, 5);
+    writer.write(0, 4);
+    writer.write(0, 32);
+    
+    for (unsigned i = 0; i < 4; i++) {
+        writer.write(0, 32);
+    }
+}
+
+void AIFLACEncoder::encode(const int16_t *samples, size_t count, std::vector<uint8_t> &output)
+{
+    while (count > 0) {
+        size_t take = std::min(count, (size_t)blockSize - pending.size());
+        
+        pending.insert(pending.end(), samples, samples + take);
+        samples += take;
+        count -= take;
+        
+        if (pending.size() == blockSize) {
+            encodeFrame(pending.data(), blockSize, output);
+            pending.clear();
+        }
+    }
+}
+
+void AIFLACEncoder::finish(std::vector<uint8_t> &output)
+{
+    if (!pending.empty()) {
+        encodeFrame(pending.data(), (unsigned)pending.size(), output);
+        pending.clear();
+    }
+}
+
+void AIFLACEncoder::reset()
+{
+    pending.clear();
+    frameCount = 0;
+}
+
+void AIFLACEncoder::encodeFrame(const int32_t *samples, unsigned count, std::vector<uint8_t> &output)
+{
+    size_t frameStart = output.size();
+    AIFLACBitWriter writer(output);
+    
+    unsigned blockSizeCode = AIBlockSizeCode(count);
+    unsigned sampleRateCode = AISampleRateCode(sampleRate);
+    
+    // Sync code with fixed-blocksize strategy, mono, 16 bits per sample.
+    writer.write(0xFFF8, 16);
+    writer.write(blockSizeCode, 4);
+    writer.write(sampleRateCode, 4);
+    writer.write(0, 4);
+    writer.write(4, 3);
+    writer.write(0, 1);
+    AIWriteUTF8(writer, frameCount);
+    
+    if (blockSizeCode == 6) writer.write(count - 1, 8);
+    if (blockSizeCode == 7) writer.write(count - 1, 16);
+    
+    if (sampleRateCode == 12) writer.write(sampleRate / 1000, 8);
+    if (sampleRateCode == 13) writer.write(sampleRate, 16);
+    if (sampleRateCode == 14) writer.write(sampleRate / 10, 16);
+    
+    writer.write(AICRC8(&output[frameStart], output.size() - frameStart), 8);
+    
+    bool constant = true;
+    for (unsigned i = 1; i < count && constant; i++) {
+        constant = samples[i] == samples[0];
+    }
+    
+    if (constant) {
+        writer.write(0, 8);
+        writer.writeSigned(samples[0], AI_FLAC_SAMPLE_BITS);
+    } else {
+        enum { AIVerbatim, AIFixed, AILPC } bestType = AIVerbatim;
+        uint64_t bestBits = (uint64_t)count * AI_FLAC_SAMPLE_BITS;
+        unsigned bestOrder = 0;
+        int32_t bestCoefficients[AI_FLAC_MAX_LPC_ORDER];
+        int bestShift = 0;
+        AIRiceChoice bestChoice;
+        AIRiceChoice choice;
+        
+        for (unsigned order = 0; order <= AI_FLAC_MAX_FIXED_ORDER && order < count; order++) {
+            AIFixedResidual(samples, count, order, residual.data());
+            AIChooseRicePartitions(residual.data(), count, order, choice);
+            
+            uint64_t bits = order * AI_FLAC_SAMPLE_BITS + choice.bits;
+            if (bits < bestBits) {
+                bestType = AIFixed;
+                bestBits = bits;
+                bestOrder = order;
+                bestChoice = choice;
+                residual.swap(bestResidual);
+            }
+        }
+        
+        unsigned lpcOrder = std::min(maxLPCOrder, count - 1);
+        
+        if (lpcOrder > 0) {
+            if (window.size() != count) {
+                AITukeyWindow(window, count);
+            }
+            
+            for (unsigned i = 0; i < count; i++) {
+                windowed[i] = window[i] * (samples[i] * (1.f / 32768.f));
+            }
+            
+            double autocorrelation[AI_FLAC_MAX_LPC_ORDER + 1];
+            for (unsigned lag = 0; lag <= lpcOrder; lag++) {
+                autocorrelation[lag] = AIDotProduct(windowed.data() + lag, windowed.data(), count - lag);
+            }
+            
+            if (autocorrelation[0] > 0.) {
+                double coefficients[AI_FLAC_MAX_LPC_ORDER][AI_FLAC_MAX_LPC_ORDER];
+                lpcOrder = AILevinsonDurbin(autocorrelation, lpcOrder, coefficients);
+                
+                for (unsigned order = 1; order <= lpcOrder; order++) {
+                    int32_t quantized[AI_FLAC_MAX_LPC_ORDER];
+                    int shift;
+                    
+                    if (!AIQuantizeCoefficients(coefficients[order - 1], order, AI_FLAC_QLP_PRECISION, quantized, &shift)) {
+                        continue;
+                    }
+                    
+                    AILPCResidual(samples, count, quantized, order, shift, residual.data());
+                    AIChooseRicePartitions(residual.data(), count, order, choice);
+                    
+                    uint64_t bits = order * (AI_FLAC_SAMPLE_BITS + AI_FLAC_QLP_PRECISION) + 4 + 5 + choice.bits;
+                    if (bits < bestBits) {
+                        bestType = AILPC;
+                        bestBits = bits;
+                        bestOrder = order;
+                        memcpy(bestCoefficients, quantized, sizeof(quantized));
+                        bestShift = shift;
+                        bestChoice = choice;
+                        residual.swap(bestResidual);
+                    }
+                }
+            }
+            
+            if (window.size() != blockSize) {
+                AITukeyWindow(window, blockSize);
+            }
+        }
+        
+        switch (bestType) {
+            case AIVerbatim:
+                writer.write(0x02, 8);
+                for (unsigned i = 0; i < count; i++) {
+                    writer.writeSigned(samples[i], AI_FLAC_SAMPLE_BITS);
+                }
+                break;
+            case AIFixed:
+                writer.write((0x08 | bestOrder) << 1, 8);
+                for (unsigned i = 0; i < bestOrder; i++) {
+                    writer.writeSigned(samples[i], AI_FLAC_SAMPLE_BITS);
+                }
+                AIWriteResidual(writer, bestResidual.data(), count, bestOrder, bestChoice);
+                break;
+            case AILPC:
+                writer.write((0x20 | (bestOrder - 1)) << 1, 8);
+                for (unsigned i = 0; i < bestOrder; i++) {
+                    writer.writeSigned(samples[i], AI_FLAC_SAMPLE_BITS);
+                }
+                writer.write(AI_FLAC_QLP_PRECISION - 1, 4);
+                writer.writeSigned(bestShift, 5);
+                for (unsigned i = 0; i < bestOrder; i++) {
+                    writer.writeSigned(bestCoefficients[i], AI_FLAC_QLP_PRECISION);
+                }
+                AIWriteResidual(writer, bestResidual.data(), count, bestOrder, bestChoice);
+                break;
+        }
+    }
+    
+    writer.alignToByte();
+    writer.write(AICRC16(&output[frameStart], output.size() - frameStart), 16);
+    
+    frameCount++;
+}
+
+unsigned AIFLACEncoder::getSampleRate() const
+{
+    return sampleRate;
+}
+
+unsigned AIFLACEncoder::getBlockSize() const
+{
+    return blockSize;
+}
+
+unsigned AIFLACEncoder::getMaxLPCOrder() const
+{
+    return maxLPCOrder;
+}
+
+uint32_t AIFLACEncoder::getFrameCount() const
+{
+    return frameCount;
+}
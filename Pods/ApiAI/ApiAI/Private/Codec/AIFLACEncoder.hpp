@@ -0,0 +1,92 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+
+#ifndef FLACEncoder_hpp
+#define FLACEncoder_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// 256 ms at 16 kHz; one frame is sent per block.
+#define AI_FLAC_DEFAULT_BLOCK_SIZE 4096
+#define AI_FLAC_MAX_FIXED_ORDER 4
+#define AI_FLAC_MAX_LPC_ORDER 8
+#define AI_FLAC_QLP_PRECISION 12
+#define AI_FLAC_MAX_PARTITION_ORDER 6
+#define AI_FLAC_MAX_RICE_PARAMETER 14
+
+/*
+ * Streaming lossless encoder for mono 16-bit PCM producing a standard FLAC stream.
+ *
+ * Samples are cut into fixed-size blocks and every block becomes one frame with a single subframe. The encoder
+ * tries the constant, fixed (orders 0-4) and LPC (orders 1-getMaxLPCOrder()) predictors, Rice-codes the residual
+ * with the best partition order, and keeps whichever is smallest, falling back to verbatim samples. LPC
+ * coefficients come from a Tukey-windowed autocorrelation solved with Levinson-Durbin.
+ *
+ * Total sample count and MD5 in STREAMINFO are left zero ("unknown"), as FLAC allows for streams.
+ */
+class AIFLACEncoder {
+public:
+    
+    AIFLACEncoder(unsigned sampleRate, unsigned blockSize = AI_FLAC_DEFAULT_BLOCK_SIZE, unsigned maxLPCOrder = AI_FLAC_MAX_LPC_ORDER);
+    virtual ~AIFLACEncoder();
+    
+    // Appends the "fLaC" marker and the STREAMINFO block; call once before the first frame.
+    void writeStreamHeader(std::vector<uint8_t> &output) const;
+    
+    // Buffers samples and appends one frame for every block that becomes complete.
+    void encode(const int16_t *samples, size_t count, std::vector<uint8_t> &output);
+    
+    // Appends the remaining partial block, if any, as a shorter last frame.
+    void finish(std::vector<uint8_t> &output);
+    
+    void reset();
+    
+    unsigned getSampleRate() const;
+    unsigned getBlockSize() const;
+    unsigned getMaxLPCOrder() const;
+    uint32_t getFrameCount() const;
+    
+private:
+    
+    void encodeFrame(const int32_t *samples, unsigned count, std::vector<uint8_t> &output);
+    
+    unsigned sampleRate;
+    unsigned blockSize;
+    unsigned maxLPCOrder;
+    
+    std::vector<int32_t> pending;
+    uint32_t frameCount;
+    
+    std::vector<float> window;
+    std::vector<float> windowed;
+    std::vector<int32_t> residual;
+    std::vector<int32_t> bestResidual;
+    
+private:
+    AIFLACEncoder( const AIFLACEncoder& );
+    void operator=( const AIFLACEncoder& );
+};
+
+#endif /* FLACEncoder_hpp */
@@ -0,0 +1,151 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIG711.hpp"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Magnitudes are taken at 14 bits and biased as in the ITU reference. The reference clips at 8159 and then maps the
+// one value that overflows segment 7 to the top code; clipping one lower gives the same code without the special case.
+#define AI_MULAW_CLIP 8158
+#define AI_MULAW_BIAS 33
+
+// (float exponent bias + 5) << 4: the biased magnitude is at least 2^5, which is segment 0.
+#define AI_MULAW_EXPONENT_OFFSET ((127 + 5) << 4)
+
+struct AIMuLawDecodeTable {
+    int16_t values[256];
+    
+    AIMuLawDecodeTable()
+    {
+        for (unsigned code = 0; code < 256; code++) {
+            unsigned u = ~code & 0xFF;
+            int t = (((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4);
+            values[code] = (int16_t)((u & 0x80) ? (0x84 - t) : (t - 0x84));
+        }
+    }
+};
+
+static inline uint8_t AIMuLawEncodeSample(int16_t sample)
+{
+    int32_t value = sample >> 2;
+    uint32_t mask = 0xFF;
+    
+    if (value < 0) {
+        value = -value;
+        mask = 0x7F;
+    }
+    
+    if (value > AI_MULAW_CLIP) {
+        value = AI_MULAW_CLIP;
+    }
+    
+    float magnitude = (float)(value + AI_MULAW_BIAS);
+    uint32_t bits;
+    memcpy(&bits, &magnitude, sizeof(bits));
+    
+    return (uint8_t)(((bits >> 19) - AI_MULAW_EXPONENT_OFFSET) ^ mask);
+}
+
+void AIMuLawEncode(const int16_t *samples, size_t count, uint8_t *output)
+{
+    size_t i = 0;
+    
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const int32x4_t clip = vdupq_n_s32(AI_MULAW_CLIP);
+    const int32x4_t bias = vdupq_n_s32(AI_MULAW_BIAS);
+    const uint32x4_t offset = vdupq_n_u32(AI_MULAW_EXPONENT_OFFSET);
+    const uint32x4_t positiveMask = vdupq_n_u32(0xFF);
+    const uint32x4_t signBit = vdupq_n_u32(0x80);
+    
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t x = vld1q_s16(samples + i);
+        uint16x4_t codes[2];
+        
+        for (unsigned half = 0; half < 2; half++) {
+            int32x4_t value = vshrq_n_s32(vmovl_s16(half ? vget_high_s16(x) : vget_low_s16(x)), 2);
+            uint32x4_t negative = vcltq_s32(value, vdupq_n_s32(0));
+            
+            value = vaddq_s32(vminq_s32(vabsq_s32(value), clip), bias);
+            
+            uint32x4_t bits = vreinterpretq_u32_f32(vcvtq_f32_s32(value));
+            uint32x4_t code = vsubq_u32(vshrq_n_u32(bits, 19), offset);
+            uint32x4_t mask = veorq_u32(positiveMask, vandq_u32(negative, signBit));
+            
+            codes[half] = vmovn_u32(veorq_u32(code, mask));
+        }
+        
+        vst1_u8(output + i, vmovn_u16(vcombine_u16(codes[0], codes[1])));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i clip = _mm_set1_epi32(AI_MULAW_CLIP);
+    const __m128i bias = _mm_set1_epi32(AI_MULAW_BIAS);
+    const __m128i offset = _mm_set1_epi32(AI_MULAW_EXPONENT_OFFSET);
+    const __m128i positiveMask = _mm_set1_epi32(0xFF);
+    const __m128i signBit = _mm_set1_epi32(0x80);
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(samples + i));
+        __m128i codes[2];
+        
+        for (unsigned half = 0; half < 2; half++) {
+            __m128i widened = half ? _mm_unpackhi_epi16(x, x) : _mm_unpacklo_epi16(x, x);
+            __m128i value = _mm_srai_epi32(widened, 16 + 2);
+            __m128i negative = _mm_srai_epi32(value, 31);
+            
+            value = _mm_sub_epi32(_mm_xor_si128(value, negative), negative);
+            
+            __m128i overflow = _mm_cmpgt_epi32(value, clip);
+            value = _mm_or_si128(_mm_andnot_si128(overflow, value), _mm_and_si128(overflow, clip));
+            value = _mm_add_epi32(value, bias);
+            
+            __m128i bits = _mm_castps_si128(_mm_cvtepi32_ps(value));
+            __m128i code = _mm_sub_epi32(_mm_srli_epi32(bits, 19), offset);
+            __m128i mask = _mm_xor_si128(positiveMask, _mm_and_si128(negative, signBit));
+            
+            codes[half] = _mm_xor_si128(code, mask);
+        }
+        
+        __m128i packed = _mm_packs_epi32(codes[0], codes[1]);
+        _mm_storel_epi64((__m128i *)(output + i), _mm_packus_epi16(packed, packed));
+    }
+#endif
+    
+    for (; i < count; i++) {
+        output[i] = AIMuLawEncodeSample(samples[i]);
+    }
+}
+
+void AIMuLawDecode(const uint8_t *codes, size_t count, int16_t *output)
+{
+    static const AIMuLawDecodeTable table;
+    
+    for (size_t i = 0; i < count; i++) {
+        output[i] = table.values[codes[i]];
+    }
+}
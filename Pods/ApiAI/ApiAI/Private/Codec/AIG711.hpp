@@ -0,0 +1,42 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+
+#ifndef G711_hpp
+#define G711_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * G.711 µ-law companding of 16-bit PCM, 8 bits per sample.
+ *
+ * The segment and mantissa of the biased 14-bit magnitude are read straight from the exponent and top mantissa
+ * bits of its float representation, so the encoder has no branches or segment search and runs 8 samples per
+ * NEON/SSE2 iteration. Output matches the ITU reference encoder bit for bit.
+ */
+void AIMuLawEncode(const int16_t *samples, size_t count, uint8_t *output);
+
+// 256-entry table lookup; used to measure round-trip quality.
+void AIMuLawDecode(const uint8_t *codes, size_t count, int16_t *output);
+
+#endif /* G711_hpp */
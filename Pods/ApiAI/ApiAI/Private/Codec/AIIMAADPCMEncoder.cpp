@@ -0,0 +1,154 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIIMAADPCMEncoder.hpp"
+
+#include <assert.h>
+#include <algorithm>
+
+static const int16_t AIIMAStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107,
+    118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086,
+    29794, 32767
+};
+
+static const int8_t AIIMAIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+AIIMAADPCMEncoder::AIIMAADPCMEncoder(unsigned blockAlign) :
+    blockAlign(blockAlign),
+    samplesPerBlock((blockAlign - 4) * 2 + 1),
+    predictor(0),
+    stepIndex(0)
+{
+    assert(blockAlign > 4);
+    
+    pending.reserve(samplesPerBlock);
+}
+
+AIIMAADPCMEncoder::~AIIMAADPCMEncoder()
+{
+    
+}
+
+void AIIMAADPCMEncoder::encode(const int16_t *samples, size_t count, std::vector<uint8_t> &output)
+{
+    while (count > 0) {
+        size_t take = std::min(count, (size_t)samplesPerBlock - pending.size());
+        
+        pending.insert(pending.end(), samples, samples + take);
+        samples += take;
+        count -= take;
+        
+        if (pending.size() == samplesPerBlock) {
+            encodeBlock(pending.data(), output);
+            pending.clear();
+        }
+    }
+}
+
+void AIIMAADPCMEncoder::finish(std::vector<uint8_t> &output)
+{
+    if (!pending.empty()) {
+        pending.resize(samplesPerBlock, 0);
+        encodeBlock(pending.data(), output);
+        pending.clear();
+    }
+}
+
+void AIIMAADPCMEncoder::reset()
+{
+    pending.clear();
+    predictor = 0;
+    stepIndex = 0;
+}
+
+void AIIMAADPCMEncoder::encodeBlock(const int16_t *samples, std::vector<uint8_t> &output)
+{
+    predictor = samples[0];
+    
+    output.push_back((uint8_t)(predictor & 0xFF));
+    output.push_back((uint8_t)((predictor >> 8) & 0xFF));
+    output.push_back((uint8_t)stepIndex);
+    output.push_back(0);
+    
+    for (unsigned i = 1; i < samplesPerBlock; i += 2) {
+        uint8_t low = encodeSample(samples[i]);
+        uint8_t high = encodeSample(samples[i + 1]);
+        output.push_back((uint8_t)(low | (high << 4)));
+    }
+}
+
+uint8_t AIIMAADPCMEncoder::encodeSample(int32_t sample)
+{
+    int32_t step = AIIMAStepTable[stepIndex];
+    int32_t difference = sample - predictor;
+    uint8_t code = 0;
+    
+    if (difference < 0) {
+        code = 8;
+        difference = -difference;
+    }
+    
+    // Successive approximation of difference / step in three bits; delta is what the decoder will reconstruct.
+    int32_t delta = step >> 3;
+    
+    if (difference >= step) {
+        code |= 4;
+        difference -= step;
+        delta += step;
+    }
+    
+    step >>= 1;
+    if (difference >= step) {
+        code |= 2;
+        difference -= step;
+        delta += step;
+    }
+    
+    step >>= 1;
+    if (difference >= step) {
+        code |= 1;
+        delta += step;
+    }
+    
+    predictor += (code & 8) ? -delta : delta;
+    predictor = std::max(-32768, std::min(32767, predictor));
+    
+    stepIndex = std::max(0, std::min(88, stepIndex + AIIMAIndexTable[code]));
+    
+    return code;
+}
+
+unsigned AIIMAADPCMEncoder::getBlockAlign() const
+{
+    return blockAlign;
+}
+
+unsigned AIIMAADPCMEncoder::getSamplesPerBlock() const
+{
+    return samplesPerBlock;
+}
@@ -0,0 +1,76 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+
+#ifndef IMAADPCMEncoder_hpp
+#define IMAADPCMEncoder_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// 505 samples (31.6 ms at 16 kHz) per block.
+#define AI_IMA_ADPCM_BLOCK_ALIGN 256
+
+/*
+ * Streaming IMA ADPCM encoder for mono 16-bit PCM in the WAV (format 0x0011) block layout.
+ *
+ * Every block starts with the first sample and the current step index, followed by 4-bit codes for the remaining
+ * samples, low nibble first. Quantization uses the standard step and index tables, and the predictor is updated
+ * exactly as a decoder would, so errors do not accumulate.
+ */
+class AIIMAADPCMEncoder {
+public:
+    
+    AIIMAADPCMEncoder(unsigned blockAlign = AI_IMA_ADPCM_BLOCK_ALIGN);
+    virtual ~AIIMAADPCMEncoder();
+    
+    // Buffers samples and appends one block for every block that becomes complete.
+    void encode(const int16_t *samples, size_t count, std::vector<uint8_t> &output);
+    
+    // Appends the remaining samples as a last block padded with silence.
+    void finish(std::vector<uint8_t> &output);
+    
+    void reset();
+    
+    unsigned getBlockAlign() const;
+    unsigned getSamplesPerBlock() const;
+    
+private:
+    
+    void encodeBlock(const int16_t *samples, std::vector<uint8_t> &output);
+    uint8_t encodeSample(int32_t sample);
+    
+    unsigned blockAlign;
+    unsigned samplesPerBlock;
+    
+    std::vector<int16_t> pending;
+    
+    int32_t predictor;
+    int stepIndex;
+    
+private:
+    AIIMAADPCMEncoder( const AIIMAADPCMEncoder& );
+    void operator=( const AIIMAADPCMEncoder& );
+};
+
+#endif /* IMAADPCMEncoder_hpp */
@@ -0,0 +1,48 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import <Foundation/Foundation.h>
+
+#import "AIVoiceAudioFormat.h"
+
+/*
+ Encodes mono 16-bit PCM for voice uploads block by block. PCM passes through unchanged.
+ Not thread safe; feed it from one queue.
+ */
+@interface AIVoiceEncoder : NSObject
+
+- (instancetype)init __unavailable;
+- (instancetype)initWithFormat:(AIVoiceAudioFormat)format sampleRate:(double)sampleRate;
+
+@property(nonatomic, assign, readonly) AIVoiceAudioFormat format;
+@property(nonatomic, assign, readonly) double sampleRate;
+
+// MIME type of the encoded stream.
+@property(nonatomic, copy, readonly) NSString *contentType;
+
+// Returns whatever encoded bytes became available, possibly none. The first call includes the stream header.
+- (NSData *)encodeSamples:(NSData *)samples;
+
+// Returns the tail of the stream; the encoder starts a new stream afterwards.
+- (NSData *)finish;
+
+@end
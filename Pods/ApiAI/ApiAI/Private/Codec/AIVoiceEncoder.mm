@@ -0,0 +1,210 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#import "AIVoiceEncoder.h"
+
+#include "AIFLACEncoder.hpp"
+#include "AIG711.hpp"
+#include "AIIMAADPCMEncoder.hpp"
+#include "AIWAVWriter.hpp"
+
+#include <memory>
+#include <vector>
+
+// Collects what the WAV writer emits until the encoder hands it out. Uploads are streamed, so the sizes stay unknown.
+class AIVoiceEncoderWAVOutput : public AIWAVOutput {
+public:
+    
+    AIVoiceEncoderWAVOutput(std::vector<uint8_t> &output) : output(output) {}
+    
+    virtual bool write(const void *bytes, size_t length)
+    {
+        const uint8_t *data = (const uint8_t *)bytes;
+        output.insert(output.end(), data, data + length);
+        return true;
+    }
+    
+private:
+    
+    std::vector<uint8_t> &output;
+};
+
+@implementation AIVoiceEncoder
+{
+    std::unique_ptr<AIFLACEncoder> _flacEncoder;
+    std::unique_ptr<AIIMAADPCMEncoder> _adpcmEncoder;
+    std::unique_ptr<AIVoiceEncoderWAVOutput> _wavOutput;
+    std::unique_ptr<AIWAVWriter> _wavWriter;
+    std::vector<uint8_t> _encoded;
+    std::vector<uint8_t> _output;
+    BOOL _headerWritten;
+}
+
+- (instancetype)initWithFormat:(AIVoiceAudioFormat)format sampleRate:(double)sampleRate
+{
+    self = [super init];
+    if (self) {
+        _format = format;
+        _sampleRate = sampleRate;
+        
+        if (format == AIVoiceAudioFormatFLAC) {
+            _flacEncoder.reset(new AIFLACEncoder((unsigned)sampleRate));
+        } else if (format == AIVoiceAudioFormatIMAADPCM) {
+            _adpcmEncoder.reset(new AIIMAADPCMEncoder());
+        }
+        
+        _wavOutput.reset(new AIVoiceEncoderWAVOutput(_output));
+    }
+    
+    return self;
+}
+
+- (NSString *)contentType
+{
+    switch (_format) {
+        case AIVoiceAudioFormatFLAC:
+            return @"audio/x-flac";
+        default:
+            return @"audio/wav";
+    }
+}
+
+- (NSData *)takeOutput
+{
+    if (_wavWriter) {
+        _wavWriter->flush();
+    }
+    
+    NSData *data = [NSData dataWithBytes:_output.data() length:_output.size()];
+    _output.clear();
+    
+    return data;
+}
+
+- (void)appendEncoded
+{
+    if (_wavWriter && !_encoded.empty()) {
+        _wavWriter->append(_encoded.data(), _encoded.size());
+    }
+    _encoded.clear();
+}
+
+- (void)writeHeaderIfNeeded
+{
+    if (_headerWritten) {
+        return;
+    }
+    
+    AIWAVFormat format = {0};
+    format.channels = 1;
+    format.sampleRate = (uint32_t)_sampleRate;
+    
+    switch (_format) {
+        case AIVoiceAudioFormatFLAC:
+            _flacEncoder->writeStreamHeader(_output);
+            break;
+        case AIVoiceAudioFormatMuLaw:
+            format.formatTag = AI_WAV_FORMAT_MULAW;
+            format.bitsPerSample = 8;
+            format.blockAlign = 1;
+            format.bytesPerSecond = format.sampleRate;
+            _wavWriter.reset(new AIWAVWriter(*_wavOutput, format));
+            break;
+        case AIVoiceAudioFormatIMAADPCM:
+            format.formatTag = AI_WAV_FORMAT_IMA_ADPCM;
+            format.bitsPerSample = 4;
+            format.blockAlign = _adpcmEncoder->getBlockAlign();
+            format.samplesPerBlock = _adpcmEncoder->getSamplesPerBlock();
+            format.bytesPerSecond = format.sampleRate * format.blockAlign / format.samplesPerBlock;
+            _wavWriter.reset(new AIWAVWriter(*_wavOutput, format));
+            break;
+        default:
+            break;
+    }
+    
+    _headerWritten = YES;
+}
+
+- (NSData *)encodeSamples:(NSData *)samples
+{
+    if (_format == AIVoiceAudioFormatPCM) {
+        return samples;
+    }
+    
+    [self writeHeaderIfNeeded];
+    
+    const int16_t *frames = (const int16_t *)samples.bytes;
+    size_t count = samples.length / sizeof(int16_t);
+    
+    switch (_format) {
+        case AIVoiceAudioFormatFLAC:
+            _flacEncoder->encode(frames, count, _output);
+            break;
+        case AIVoiceAudioFormatMuLaw:
+            _encoded.resize(count);
+            AIMuLawEncode(frames, count, _encoded.data());
+            break;
+        case AIVoiceAudioFormatIMAADPCM:
+            _adpcmEncoder->encode(frames, count, _encoded);
+            break;
+        default:
+            break;
+    }
+    
+    [self appendEncoded];
+    
+    return [self takeOutput];
+}
+
+- (NSData *)finish
+{
+    if (_format == AIVoiceAudioFormatPCM) {
+        return [NSData data];
+    }
+    
+    [self writeHeaderIfNeeded];
+    
+    if (_flacEncoder) {
+        _flacEncoder->finish(_output);
+        _flacEncoder->reset();
+    }
+    
+    if (_adpcmEncoder) {
+        _adpcmEncoder->finish(_encoded);
+        _adpcmEncoder->reset();
+    }
+    
+    [self appendEncoded];
+    
+    // Closing pads an odd-sized data chunk to the word boundary RIFF requires.
+    if (_wavWriter) {
+        _wavWriter->close();
+    }
+    
+    NSData *data = [self takeOutput];
+    _wavWriter.reset();
+    _headerWritten = NO;
+    
+    return data;
+}
+
+@end
@@ -0,0 +1,73 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIWAVHeader.hpp"
+
+static void AIAppendTag(std::vector<uint8_t> &output, const char *tag)
+{
+    output.insert(output.end(), tag, tag + 4);
+}
+
+static void AIAppendLittleEndian(std::vector<uint8_t> &output, uint32_t value, unsigned size)
+{
+    for (unsigned i = 0; i < size; i++) {
+        output.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+void AIAppendWAVHeader(std::vector<uint8_t> &output, const AIWAVFormat &format, uint32_t dataSize, uint32_t frameCount)
+{
+    bool extended = format.formatTag != AI_WAV_FORMAT_PCM;
+    uint32_t extensionSize = format.formatTag == AI_WAV_FORMAT_IMA_ADPCM ? 2 : 0;
+    uint32_t fmtSize = extended ? 18 + extensionSize : 16;
+    uint32_t headerSize = 12 + 8 + fmtSize + (extended ? 12 : 0) + 8;
+    
+    uint32_t riffSize = dataSize == AI_WAV_UNKNOWN_SIZE ? AI_WAV_UNKNOWN_SIZE : dataSize + headerSize - 8;
+    
+    AIAppendTag(output, "RIFF");
+    AIAppendLittleEndian(output, riffSize, 4);
+    AIAppendTag(output, "WAVE");
+    
+    AIAppendTag(output, "fmt ");
+    AIAppendLittleEndian(output, fmtSize, 4);
+    AIAppendLittleEndian(output, format.formatTag, 2);
+    AIAppendLittleEndian(output, format.channels, 2);
+    AIAppendLittleEndian(output, format.sampleRate, 4);
+    AIAppendLittleEndian(output, format.bytesPerSecond, 4);
+    AIAppendLittleEndian(output, format.blockAlign, 2);
+    AIAppendLittleEndian(output, format.bitsPerSample, 2);
+    
+    if (extended) {
+        AIAppendLittleEndian(output, extensionSize, 2);
+        
+        if (format.formatTag == AI_WAV_FORMAT_IMA_ADPCM) {
+            AIAppendLittleEndian(output, format.samplesPerBlock, 2);
+        }
+        
+        AIAppendTag(output, "fact");
+        AIAppendLittleEndian(output, 4, 4);
+        AIAppendLittleEndian(output, frameCount, 4);
+    }
+    
+    AIAppendTag(output, "data");
+    AIAppendLittleEndian(output, dataSize, 4);
+}
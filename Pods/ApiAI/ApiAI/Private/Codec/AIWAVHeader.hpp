@@ -0,0 +1,55 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+
+#ifndef WAVHeader_hpp
+#define WAVHeader_hpp
+
+#include <stdint.h>
+#include <vector>
+
+#define AI_WAV_FORMAT_PCM 0x0001
+#define AI_WAV_FORMAT_IEEE_FLOAT 0x0003
+#define AI_WAV_FORMAT_MULAW 0x0007
+#define AI_WAV_FORMAT_IMA_ADPCM 0x0011
+#define AI_WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// Size written to RIFF, data and fact fields whose value is not known while streaming.
+#define AI_WAV_UNKNOWN_SIZE 0xFFFFFFFF
+
+struct AIWAVFormat {
+    uint16_t formatTag;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t bytesPerSecond;
+    uint16_t blockAlign;
+    uint16_t bitsPerSample;
+    
+    // IMA ADPCM only: frames per block, stored as the fmt extension.
+    uint16_t samplesPerBlock;
+};
+
+// Appends a RIFF/WAVE header describing dataSize bytes of audio. Non-PCM formats get the extended fmt chunk and a
+// fact chunk holding frameCount. Pass AI_WAV_UNKNOWN_SIZE for both when the length is not known up front.
+void AIAppendWAVHeader(std::vector<uint8_t> &output, const AIWAVFormat &format, uint32_t dataSize, uint32_t frameCount);
+
+#endif /* WAVHeader_hpp */
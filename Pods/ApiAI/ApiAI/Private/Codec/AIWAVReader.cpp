@@ -0,0 +1,200 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIWAVReader.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Extensible fmt chunks carry the subformat GUID, whose first two bytes are the plain format tag, at this offset.
+#define AI_WAV_EXTENSIBLE_FORMAT_SIZE 40
+#define AI_WAV_EXTENSIBLE_SUBFORMAT_OFFSET 24
+
+static inline uint16_t AIReadLittle16(const uint8_t *bytes)
+{
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint32_t AIReadLittle32(const uint8_t *bytes)
+{
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+AIWAVReader::AIWAVReader(const char *path) :
+    fd(open(path, O_RDONLY)),
+    error(fd < 0 ? errno : 0),
+    dataOffset(0),
+    dataSize(0),
+    position(0)
+{
+    memset(&format, 0, sizeof(format));
+    
+    if (fd >= 0 && !parse()) {
+        if (error == 0) error = EINVAL;
+        
+        close(fd);
+        fd = -1;
+    }
+}
+
+AIWAVReader::~AIWAVReader()
+{
+    if (fd >= 0) close(fd);
+}
+
+bool AIWAVReader::readAt(uint64_t offset, void *bytes, size_t length)
+{
+    uint8_t *data = (uint8_t *)bytes;
+    
+    while (length > 0) {
+        ssize_t count = pread(fd, data, length, (off_t)offset);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            error = errno;
+            return false;
+        }
+        
+        if (count == 0) {
+            return false;
+        }
+        
+        data += count;
+        offset += count;
+        length -= count;
+    }
+    
+    return true;
+}
+
+bool AIWAVReader::parse()
+{
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        error = errno;
+        return false;
+    }
+    
+    uint64_t fileSize = (uint64_t)status.st_size;
+    
+    uint8_t header[12];
+    if (!readAt(0, header, sizeof(header)) || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    
+    bool hasFormat = false;
+    uint64_t offset = sizeof(header);
+    
+    while (offset + 8 <= fileSize) {
+        uint8_t chunk[8];
+        if (!readAt(offset, chunk, sizeof(chunk))) {
+            return false;
+        }
+        
+        uint32_t size = AIReadLittle32(chunk + 4);
+        offset += sizeof(chunk);
+        
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[AI_WAV_EXTENSIBLE_FORMAT_SIZE];
+            if (size < 16 || !readAt(offset, fmt, size < sizeof(fmt) ? size : sizeof(fmt))) {
+                return false;
+            }
+            
+            format.formatTag = AIReadLittle16(fmt);
+            format.channels = AIReadLittle16(fmt + 2);
+            format.sampleRate = AIReadLittle32(fmt + 4);
+            format.bytesPerSecond = AIReadLittle32(fmt + 8);
+            format.blockAlign = AIReadLittle16(fmt + 12);
+            format.bitsPerSample = AIReadLittle16(fmt + 14);
+            
+            if (format.formatTag == AI_WAV_FORMAT_IMA_ADPCM && size >= 20) {
+                format.samplesPerBlock = AIReadLittle16(fmt + 18);
+            }
+            
+            if (format.formatTag == AI_WAV_FORMAT_EXTENSIBLE && size >= AI_WAV_EXTENSIBLE_FORMAT_SIZE) {
+                format.formatTag = AIReadLittle16(fmt + AI_WAV_EXTENSIBLE_SUBFORMAT_OFFSET);
+            }
+            
+            hasFormat = format.channels > 0 && format.blockAlign > 0;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            dataOffset = offset;
+            dataSize = fileSize - offset;
+            if (size != AI_WAV_UNKNOWN_SIZE && size < dataSize) {
+                dataSize = size;
+            }
+            
+            dataSize -= dataSize % (hasFormat ? format.blockAlign : 1);
+            return hasFormat;
+        }
+        
+        offset += size + (size & 1);
+    }
+    
+    return false;
+}
+
+bool AIWAVReader::isOpen() const
+{
+    return fd >= 0;
+}
+
+int AIWAVReader::getError() const
+{
+    return error;
+}
+
+const AIWAVFormat &AIWAVReader::getFormat() const
+{
+    return format;
+}
+
+uint64_t AIWAVReader::getFrameCount() const
+{
+    return fd >= 0 ? dataSize / format.blockAlign : 0;
+}
+
+size_t AIWAVReader::read(void *frames, size_t frameCount)
+{
+    if (fd < 0 || position >= dataSize) {
+        return 0;
+    }
+    
+    uint64_t length = (uint64_t)frameCount * format.blockAlign;
+    if (length > dataSize - position) {
+        length = dataSize - position;
+    }
+    
+    if (!readAt(dataOffset + position, frames, (size_t)length)) {
+        return 0;
+    }
+    
+    position += length;
+    return (size_t)(length / format.blockAlign);
+}
+
+void AIWAVReader::seek(uint64_t frame)
+{
+    uint64_t offset = frame * format.blockAlign;
+    position = offset < dataSize ? offset : dataSize;
+}
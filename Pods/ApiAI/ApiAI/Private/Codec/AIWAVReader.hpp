@@ -0,0 +1,79 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef WAVReader_hpp
+#define WAVReader_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AIWAVHeader.hpp"
+
+/*
+ * Reader of the audio frames of a RIFF/WAVE file.
+ *
+ * The chunks are walked up to "data" when the object is constructed; unknown chunks are skipped and an extensible fmt
+ * chunk is reported with its subformat's tag. Frames are then read straight from the file in its own format. A data
+ * size of AI_WAV_UNKNOWN_SIZE, as streaming writers leave it, is taken to mean "until the end of the file".
+ */
+class AIWAVReader {
+public:
+    
+    AIWAVReader(const char *path);
+    virtual ~AIWAVReader();
+    
+    // True when the file was opened and has both a fmt and a data chunk.
+    bool isOpen() const;
+    
+    // errno-style code of the first failure, EINVAL for files that are not WAVE, or 0.
+    int getError() const;
+    
+    const AIWAVFormat &getFormat() const;
+    uint64_t getFrameCount() const;
+    
+    // Reads up to frameCount interleaved frames into frames, which must hold frameCount * blockAlign bytes. Returns
+    // the number of frames read, 0 at the end of the data or on error.
+    size_t read(void *frames, size_t frameCount);
+    
+    // Positions the next read at frame.
+    void seek(uint64_t frame);
+    
+private:
+    
+    bool parse();
+    bool readAt(uint64_t offset, void *bytes, size_t length);
+    
+    int fd;
+    int error;
+    
+    AIWAVFormat format;
+    
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t position;
+    
+private:
+    AIWAVReader( const AIWAVReader& );
+    void operator=( const AIWAVReader& );
+};
+
+#endif /* WAVReader_hpp */
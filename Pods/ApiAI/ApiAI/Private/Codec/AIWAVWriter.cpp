@@ -0,0 +1,270 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIWAVWriter.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Largest data chunk whose RIFF size still fits below AI_WAV_UNKNOWN_SIZE.
+#define AI_WAV_MAX_RIFF_SIZE 0xFFFFFFFEull
+
+static int AIWriteFully(int fd, const void *bytes, size_t length, uint64_t offset)
+{
+    const uint8_t *data = (const uint8_t *)bytes;
+    
+    while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        
+        data += written;
+        offset += written;
+        length -= written;
+    }
+    
+    return 0;
+}
+
+AIWAVOutput::~AIWAVOutput()
+{
+}
+
+bool AIWAVOutput::isSeekable() const
+{
+    return false;
+}
+
+bool AIWAVOutput::writeAt(uint64_t, const void *, size_t)
+{
+    return false;
+}
+
+int AIWAVOutput::getError() const
+{
+    return 0;
+}
+
+AIWAVFileOutput::AIWAVFileOutput(const char *path) :
+    fd(open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)),
+    position(0),
+    error(fd < 0 ? errno : 0)
+{
+}
+
+AIWAVFileOutput::~AIWAVFileOutput()
+{
+    if (fd >= 0) close(fd);
+}
+
+bool AIWAVFileOutput::isOpen() const
+{
+    return fd >= 0;
+}
+
+bool AIWAVFileOutput::write(const void *bytes, size_t length)
+{
+    if (!writeAt(position, bytes, length)) {
+        return false;
+    }
+    
+    position += length;
+    return true;
+}
+
+bool AIWAVFileOutput::isSeekable() const
+{
+    return true;
+}
+
+bool AIWAVFileOutput::writeAt(uint64_t offset, const void *bytes, size_t length)
+{
+    if (error) {
+        return false;
+    }
+    
+    error = AIWriteFully(fd, bytes, length, offset);
+    return error == 0;
+}
+
+int AIWAVFileOutput::getError() const
+{
+    return error;
+}
+
+AIWAVWriter::AIWAVWriter(AIWAVOutput &output, const AIWAVFormat &format, bool writesHeader, size_t bufferSize) :
+    output(output),
+    format(format),
+    writesHeader(writesHeader),
+    appendOffset(0),
+    dataSize(0),
+    failed(false),
+    closed(false)
+{
+    buffer.reserve(bufferSize);
+    
+    // The placeholder header leaves with the first flush, together with the first audio data.
+    if (writesHeader) {
+        AIAppendWAVHeader(buffer, format, AI_WAV_UNKNOWN_SIZE, AI_WAV_UNKNOWN_SIZE);
+    }
+    
+    headerSize = buffer.size();
+}
+
+AIWAVWriter::~AIWAVWriter()
+{
+}
+
+bool AIWAVWriter::append(const void *bytes, size_t length)
+{
+    if (failed || closed) {
+        return false;
+    }
+    
+    if (buffer.size() + length > buffer.capacity() && !flush()) {
+        return false;
+    }
+    
+    if (length >= buffer.capacity()) {
+        if (!output.write(bytes, length)) {
+            failed = true;
+            return false;
+        }
+    } else {
+        const uint8_t *data = (const uint8_t *)bytes;
+        buffer.insert(buffer.end(), data, data + length);
+    }
+    
+    appendOffset += length;
+    if (appendOffset > dataSize) dataSize = appendOffset;
+    
+    return true;
+}
+
+bool AIWAVWriter::writeAt(uint64_t offset, const void *bytes, size_t length)
+{
+    if (failed || closed || !output.isSeekable()) {
+        return false;
+    }
+    
+    // Buffered bytes may overlap the range, so they have to land first.
+    if (!flush()) {
+        return false;
+    }
+    
+    if (!output.writeAt(headerSize + offset, bytes, length)) {
+        failed = true;
+        return false;
+    }
+    
+    if (offset + length > dataSize) dataSize = offset + length;
+    
+    return true;
+}
+
+bool AIWAVWriter::flush()
+{
+    if (failed) {
+        return false;
+    }
+    
+    if (!buffer.empty()) {
+        if (!output.write(buffer.data(), buffer.size())) {
+            failed = true;
+            return false;
+        }
+        buffer.clear();
+    }
+    
+    return true;
+}
+
+bool AIWAVWriter::close()
+{
+    if (closed) {
+        return !failed;
+    }
+    
+    if (!flush()) {
+        closed = true;
+        return false;
+    }
+    
+    // RIFF chunks are word aligned; the pad byte is not part of the data size.
+    if (writesHeader && dataSize % 2) {
+        const uint8_t pad = 0;
+        bool padded = output.isSeekable() ? output.writeAt(headerSize + dataSize, &pad, 1) : output.write(&pad, 1);
+        if (!padded) failed = true;
+    }
+    
+    if (!failed && writesHeader && output.isSeekable()) {
+        failed = !patchHeader();
+    }
+    
+    closed = true;
+    return !failed;
+}
+
+bool AIWAVWriter::patchHeader()
+{
+    // Past 4 GB the sizes cannot be represented, and the unknown ones already in place are the best answer.
+    if (dataSize + 1 + headerSize - 8 > AI_WAV_MAX_RIFF_SIZE) {
+        return true;
+    }
+    
+    buffer.clear();
+    AIAppendWAVHeader(buffer, format, (uint32_t)dataSize, getFrameCount());
+    
+    // Unlike the data size, the RIFF size counts the pad byte.
+    if (dataSize % 2) {
+        uint32_t riffSize = (uint32_t)(dataSize + 1 + headerSize - 8);
+        for (unsigned i = 0; i < 4; i++) buffer[4 + i] = (uint8_t)(riffSize >> (8 * i));
+    }
+    
+    bool patched = output.writeAt(0, buffer.data(), buffer.size());
+    buffer.clear();
+    
+    return patched;
+}
+
+uint32_t AIWAVWriter::getFrameCount() const
+{
+    if (format.blockAlign == 0) {
+        return AI_WAV_UNKNOWN_SIZE;
+    }
+    
+    uint64_t blocks = dataSize / format.blockAlign;
+    return (uint32_t)(blocks * (format.samplesPerBlock ? format.samplesPerBlock : 1));
+}
+
+uint64_t AIWAVWriter::getDataSize() const
+{
+    return dataSize;
+}
+
+bool AIWAVWriter::hasFailed() const
+{
+    return failed;
+}
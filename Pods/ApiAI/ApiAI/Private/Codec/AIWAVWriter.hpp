@@ -0,0 +1,133 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef WAVWriter_hpp
+#define WAVWriter_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "AIWAVHeader.hpp"
+
+#define AI_WAV_WRITER_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Byte sink of an AIWAVWriter. Outputs that can overwrite what they already wrote are seekable; the writer then
+ * accepts data out of order and patches the chunk sizes when it is closed.
+ */
+class AIWAVOutput {
+public:
+    
+    virtual ~AIWAVOutput();
+    
+    // Returns false if the bytes could not be written; the writer stops at the first failure.
+    virtual bool write(const void *bytes, size_t length) = 0;
+    
+    virtual bool isSeekable() const;
+    virtual bool writeAt(uint64_t offset, const void *bytes, size_t length);
+    
+    // errno-style code of the first failure, or 0.
+    virtual int getError() const;
+};
+
+/*
+ * Seekable output to a file that is created or truncated when the object is constructed.
+ */
+class AIWAVFileOutput : public AIWAVOutput {
+public:
+    
+    AIWAVFileOutput(const char *path);
+    virtual ~AIWAVFileOutput();
+    
+    bool isOpen() const;
+    
+    virtual bool write(const void *bytes, size_t length);
+    virtual bool isSeekable() const;
+    virtual bool writeAt(uint64_t offset, const void *bytes, size_t length);
+    virtual int getError() const;
+    
+private:
+    
+    int fd;
+    uint64_t position;
+    int error;
+    
+private:
+    AIWAVFileOutput( const AIWAVFileOutput& );
+    void operator=( const AIWAVFileOutput& );
+};
+
+/*
+ * Streaming RIFF/WAVE writer.
+ *
+ * The header goes out first with AI_WAV_UNKNOWN_SIZE in every size field, which streaming readers take as "until the
+ * end". Audio data is coalesced into one buffer of bufferSize bytes that is allocated up front, and appends at least
+ * that large bypass it, so the output sees few large writes and nothing is allocated while writing. On a seekable
+ * output close() rewrites the header with the final sizes.
+ */
+class AIWAVWriter {
+public:
+    
+    // Without writesHeader only the audio data is written, as is.
+    AIWAVWriter(AIWAVOutput &output, const AIWAVFormat &format, bool writesHeader = true, size_t bufferSize = AI_WAV_WRITER_BUFFER_SIZE);
+    virtual ~AIWAVWriter();
+    
+    // Appends audio data after the last appended byte.
+    bool append(const void *bytes, size_t length);
+    
+    // Writes audio data at offset bytes into the data chunk. Only seekable outputs support it.
+    bool writeAt(uint64_t offset, const void *bytes, size_t length);
+    
+    bool flush();
+    
+    // Flushes, pads the data chunk to an even size and, on a seekable output, patches the sizes. The fact chunk of
+    // non-PCM formats gets the frame count implied by the data size.
+    bool close();
+    
+    uint64_t getDataSize() const;
+    bool hasFailed() const;
+    
+private:
+    
+    bool patchHeader();
+    uint32_t getFrameCount() const;
+    
+    AIWAVOutput &output;
+    AIWAVFormat format;
+    bool writesHeader;
+    
+    std::vector<uint8_t> buffer;
+    
+    uint64_t headerSize;
+    uint64_t appendOffset;
+    uint64_t dataSize;
+    
+    bool failed;
+    bool closed;
+    
+private:
+    AIWAVWriter( const AIWAVWriter& );
+    void operator=( const AIWAVWriter& );
+};
+
+#endif /* WAVWriter_hpp */
@@ -0,0 +1,307 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIAudioFrontEnd.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define AI_AUDIO_FRONT_END_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_AUDIO_FRONT_END_SSE2 1
+#endif
+
+AIAudioFrontEnd::AIAudioFrontEnd(size_t frameSize, float scale, size_t queueFrames) :
+    frameSize(frameSize),
+    scale(scale),
+    frame(frameSize),
+    queuedSamples(queueFrames * frameSize)
+{
+    clear();
+}
+
+AIAudioFrontEnd::~AIAudioFrontEnd()
+{
+}
+
+AILevelMeasurement AIAudioFrontEnd::process(const int16_t *samples, size_t count, int16_t *upload, bool detect)
+{
+    AILevelMeasurement levels = {0.f, 0.f, 0.0};
+    
+    // The envelope restarts for every block, as AILevelMeter's does.
+    float envelope = 0.f;
+    
+    if (!detect) {
+        processSpan<false>(samples, count, upload, envelope, levels);
+        return levels;
+    }
+    
+    // Spans end where frames do, so that each frame can be queued in between.
+    size_t done = 0;
+    while (done < count) {
+        size_t span = count - done < frameSize - framePosition ? count - done : frameSize - framePosition;
+        processSpan<true>(samples + done, span, upload ? upload + done : NULL, envelope, levels);
+        
+        framePosition += span;
+        done += span;
+        
+        if (framePosition == frameSize) {
+            finishFrame();
+        }
+    }
+    
+    return levels;
+}
+
+// The meter levels of eight samples in int16 units. Each half is scanned on its own, as in AIMeasureEnvelopePeak, and
+// the envelope before the group reaches both halves through the powers of the feedback in carries, the first half's
+// last output the second half through the first four. Only one multiply-add per group then depends on the group
+// before, instead of one per half.
+#if AI_AUDIO_FRONT_END_NEON
+
+static inline float32x4_t AIScanEnvelope(float32x4_t magnitudes, float coefficient, float feedback)
+{
+    const float32x4_t zero = vdupq_n_f32(0);
+    
+    float32x4_t filtered = vmulq_n_f32(magnitudes, coefficient);
+    filtered = vmlaq_n_f32(filtered, vextq_f32(zero, filtered, 3), feedback);
+    return vmlaq_n_f32(filtered, vextq_f32(zero, filtered, 2), feedback * feedback);
+}
+
+static inline void AIMeterFrontEndSamples(float32x4_t low, float32x4_t high, float coefficient, float feedback,
+                                          const float32x4_t carries[2], float32x4_t &envelope,
+                                          float32x4_t &envelopePeaks, float32x4_t &peaks, float32x4_t &squares)
+{
+    float32x4_t lowMagnitudes = vabsq_f32(low);
+    float32x4_t highMagnitudes = vabsq_f32(high);
+    
+    peaks = vmaxq_f32(peaks, vmaxq_f32(lowMagnitudes, highMagnitudes));
+    squares = vaddq_f32(squares, vmulq_f32(lowMagnitudes, lowMagnitudes));
+    squares = vaddq_f32(squares, vmulq_f32(highMagnitudes, highMagnitudes));
+    
+    float32x4_t lowScan = AIScanEnvelope(lowMagnitudes, coefficient, feedback);
+    float32x4_t highScan = vmlaq_f32(AIScanEnvelope(highMagnitudes, coefficient, feedback),
+                                     vdupq_laneq_f32(lowScan, 3), carries[0]);
+    
+    lowScan = vmlaq_f32(lowScan, envelope, carries[0]);
+    highScan = vmlaq_f32(highScan, envelope, carries[1]);
+    
+    envelopePeaks = vmaxq_f32(envelopePeaks, vmaxq_f32(lowScan, highScan));
+    envelope = vdupq_laneq_f32(highScan, 3);
+}
+
+#elif AI_AUDIO_FRONT_END_SSE2
+
+static inline __m128 AIScanEnvelope(__m128 magnitudes, float coefficient, float feedback)
+{
+    __m128 filtered = _mm_mul_ps(magnitudes, _mm_set1_ps(coefficient));
+    filtered = _mm_add_ps(filtered, _mm_mul_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(filtered), 4)),
+                                               _mm_set1_ps(feedback)));
+    return _mm_add_ps(filtered, _mm_mul_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(filtered), 8)),
+                                           _mm_set1_ps(feedback * feedback)));
+}
+
+static inline void AIMeterFrontEndSamples(__m128 low, __m128 high, float coefficient, float feedback,
+                                          const __m128 carries[2], __m128 &envelope, __m128 &envelopePeaks,
+                                          __m128 &peaks, __m128 &squares)
+{
+    const __m128 absolute = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 lowMagnitudes = _mm_and_ps(low, absolute);
+    __m128 highMagnitudes = _mm_and_ps(high, absolute);
+    
+    peaks = _mm_max_ps(peaks, _mm_max_ps(lowMagnitudes, highMagnitudes));
+    squares = _mm_add_ps(squares, _mm_mul_ps(lowMagnitudes, lowMagnitudes));
+    squares = _mm_add_ps(squares, _mm_mul_ps(highMagnitudes, highMagnitudes));
+    
+    __m128 lowScan = AIScanEnvelope(lowMagnitudes, coefficient, feedback);
+    __m128 highScan = _mm_add_ps(AIScanEnvelope(highMagnitudes, coefficient, feedback),
+                                 _mm_mul_ps(_mm_shuffle_ps(lowScan, lowScan, _MM_SHUFFLE(3, 3, 3, 3)), carries[0]));
+    
+    lowScan = _mm_add_ps(lowScan, _mm_mul_ps(envelope, carries[0]));
+    highScan = _mm_add_ps(highScan, _mm_mul_ps(envelope, carries[1]));
+    
+    envelopePeaks = _mm_max_ps(envelopePeaks, _mm_max_ps(lowScan, highScan));
+    envelope = _mm_shuffle_ps(highScan, highScan, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+#endif
+
+// Everything one span accumulates, kept in locals while it runs so that the stores to the frame cannot force it
+// back to memory.
+struct AIFrontEndSpan {
+    float envelope;
+    float envelopePeak;
+    float blockPeak;
+    double blockSquares;
+};
+
+template <bool Detect>
+static inline void AIProcessFrontEndSample(AIFrontEndSpan &span, int16_t sample, float scale, float *output)
+{
+    const float coefficient = AI_LEVEL_METER_ENVELOPE_COEFFICIENT;
+    
+    float magnitude = (float)abs(sample);
+    span.envelope = coefficient * magnitude + (1.f - coefficient) * span.envelope;
+    if (span.envelope > span.envelopePeak) span.envelopePeak = span.envelope;
+    if (magnitude > span.blockPeak) span.blockPeak = magnitude;
+    span.blockSquares += (double)magnitude * (double)magnitude;
+    
+    if (Detect) {
+        *output = (float)sample * scale;
+    }
+}
+
+// One span within the frame being filled, or a whole block that is not detected on.
+template <bool Detect>
+void AIAudioFrontEnd::processSpan(const int16_t *samples, size_t count, int16_t *upload, float &envelope,
+                                  AILevelMeasurement &levels)
+{
+    AIFrontEndSpan span;
+    span.envelope = envelope;
+    span.envelopePeak = levels.envelopePeak;
+    span.blockPeak = levels.peak;
+    span.blockSquares = levels.sumOfSquares;
+    
+    float *output = &frame[framePosition];
+    size_t i = 0;
+    
+#if AI_AUDIO_FRONT_END_NEON
+    const float coefficient = AI_LEVEL_METER_ENVELOPE_COEFFICIENT;
+    const float feedback = 1.f - coefficient;
+    const float feedback2 = feedback * feedback;
+    const float feedback4 = feedback2 * feedback2;
+    const float powers[8] = {
+        feedback, feedback2, feedback2 * feedback, feedback4,
+        feedback4 * feedback, feedback4 * feedback2, feedback4 * feedback2 * feedback, feedback4 * feedback4,
+    };
+    const float32x4_t carries[2] = {vld1q_f32(powers), vld1q_f32(powers + 4)};
+    const float32x4_t zero = vdupq_n_f32(0);
+    
+    float32x4_t envelopes = vdupq_n_f32(span.envelope);
+    float32x4_t envelopePeaks = zero, peaks = zero, squares = zero;
+    
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t packed = vld1q_s16(samples + i);
+        if (upload) vst1q_s16(upload + i, packed);
+        
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(packed)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_high_s16(packed));
+        
+        AIMeterFrontEndSamples(low, high, coefficient, feedback, carries, envelopes, envelopePeaks, peaks, squares);
+        
+        if (Detect) {
+            vst1q_f32(output + i, vmulq_n_f32(low, scale));
+            vst1q_f32(output + i + 4, vmulq_n_f32(high, scale));
+        }
+    }
+    
+    span.envelope = vgetq_lane_f32(envelopes, 0);
+    span.envelopePeak = fmaxf(span.envelopePeak, vmaxvq_f32(envelopePeaks));
+    span.blockPeak = fmaxf(span.blockPeak, vmaxvq_f32(peaks));
+    span.blockSquares += (double)vaddvq_f32(squares);
+#elif AI_AUDIO_FRONT_END_SSE2
+    const float coefficient = AI_LEVEL_METER_ENVELOPE_COEFFICIENT;
+    const float feedback = 1.f - coefficient;
+    const float feedback2 = feedback * feedback;
+    const float feedback4 = feedback2 * feedback2;
+    const __m128 carries[2] = {
+        _mm_setr_ps(feedback, feedback2, feedback2 * feedback, feedback4),
+        _mm_setr_ps(feedback4 * feedback, feedback4 * feedback2, feedback4 * feedback2 * feedback,
+                    feedback4 * feedback4),
+    };
+    
+    __m128 envelopes = _mm_set1_ps(span.envelope);
+    __m128 envelopePeaks = _mm_setzero_ps(), peaks = _mm_setzero_ps(), squares = _mm_setzero_ps();
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm_loadu_si128((const __m128i *)(samples + i));
+        if (upload) _mm_storeu_si128((__m128i *)(upload + i), packed);
+        
+        __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+        __m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16));
+        
+        AIMeterFrontEndSamples(low, high, coefficient, feedback, carries, envelopes, envelopePeaks, peaks, squares);
+        
+        if (Detect) {
+            _mm_storeu_ps(output + i, _mm_mul_ps(low, _mm_set1_ps(scale)));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(high, _mm_set1_ps(scale)));
+        }
+    }
+    
+    span.envelope = _mm_cvtss_f32(envelopes);
+    
+    float lanes[12];
+    _mm_storeu_ps(lanes, envelopePeaks);
+    _mm_storeu_ps(lanes + 4, peaks);
+    _mm_storeu_ps(lanes + 8, squares);
+    for (unsigned lane = 0; lane < 4; lane++) {
+        if (lanes[lane] > span.envelopePeak) span.envelopePeak = lanes[lane];
+        if (lanes[lane + 4] > span.blockPeak) span.blockPeak = lanes[lane + 4];
+        span.blockSquares += (double)lanes[lane + 8];
+    }
+#endif
+    
+    for (; i < count; i++) {
+        if (upload) upload[i] = samples[i];
+        AIProcessFrontEndSample<Detect>(span, samples[i], scale, Detect ? output + i : NULL);
+    }
+    
+    envelope = span.envelope;
+    levels.envelopePeak = span.envelopePeak;
+    levels.peak = span.blockPeak;
+    levels.sumOfSquares = span.blockSquares;
+}
+
+void AIAudioFrontEnd::finishFrame()
+{
+    // A frame is queued whole or not at all, so that the detector never sees part of one.
+    if (queuedSamples.getWriteAvailable() >= frameSize) {
+        queuedSamples.write(frame.data(), frameSize);
+    }
+    
+    framePosition = 0;
+}
+
+const float *AIAudioFrontEnd::peekFrame(float *scratch) const
+{
+    return queuedSamples.peek(frameSize, scratch);
+}
+
+void AIAudioFrontEnd::skipFrame()
+{
+    queuedSamples.skip(frameSize);
+}
+
+void AIAudioFrontEnd::clear()
+{
+    queuedSamples.clear();
+    
+    framePosition = 0;
+}
+
+size_t AIAudioFrontEnd::getFrameSize() const
+{
+    return frameSize;
+}
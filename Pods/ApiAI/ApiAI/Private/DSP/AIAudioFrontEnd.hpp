@@ -0,0 +1,86 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef AudioFrontEnd_hpp
+#define AudioFrontEnd_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "AILevelMeter.hpp"
+#include "AIRingBuffer.hpp"
+
+/*
+ * Stage between capture and analysis that reads every captured sample once.
+ *
+ * One pass over an int16 block copies it for upload, measures its meter levels and converts it into float frames of
+ * frameSize samples. The frame being filled is the only buffer the pass writes besides the upload copy, so it stays in
+ * cache; completed frames wait in a bounded queue for the detector. Nothing is allocated after construction, and the
+ * work per block only depends on its length.
+ */
+class AIAudioFrontEnd {
+public:
+    
+    // Queues up to queueFrames frames; frames completed while the queue is full are dropped.
+    AIAudioFrontEnd(size_t frameSize, float scale, size_t queueFrames);
+    virtual ~AIAudioFrontEnd();
+    
+    // Takes one block and returns its meter levels. upload receives a copy of the block unless it is NULL. Unless
+    // detect is set, the block is only copied and metered, and the frame being filled waits for the next block.
+    AILevelMeasurement process(const int16_t *samples, size_t count, int16_t *upload, bool detect);
+    
+    // Returns the oldest queued frame of getFrameSize() samples, or NULL if there is none. The samples are read in
+    // place unless they wrap around the queue, in which case they are copied to scratch, which must hold
+    // getFrameSize() samples.
+    const float *peekFrame(float *scratch) const;
+    
+    // Consumes the frame peekFrame returned.
+    void skipFrame();
+    
+    // Drops the queued frames and the one being filled. Must not overlap process.
+    void clear();
+    
+    size_t getFrameSize() const;
+    
+private:
+    
+    template <bool Detect>
+    void processSpan(const int16_t *samples, size_t count, int16_t *upload, float &envelope,
+                     AILevelMeasurement &levels);
+    
+    void finishFrame();
+    
+    size_t frameSize;
+    float scale;
+    
+    std::vector<float> frame;
+    size_t framePosition;
+    
+    AIRingBuffer<float> queuedSamples;
+    
+private:
+    AIAudioFrontEnd( const AIAudioFrontEnd& );
+    void operator=( const AIAudioFrontEnd& );
+};
+
+#endif /* AudioFrontEnd_hpp */
@@ -0,0 +1,398 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIDecimator.hpp"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define AI_DECIMATOR_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_DECIMATOR_SSE2 1
+#endif
+
+#define AI_DECIMATOR_MAX_ODD_FACTOR 15
+
+// The aliases of consecutive stages add up, and Kaiser's length estimate is slightly optimistic.
+#define AI_DECIMATOR_MARGIN_DECIBELS 3.0
+
+AIDecimatorSettings AIDecimatorSettingsForQuality(AIDecimatorQuality quality)
+{
+    AIDecimatorSettings settings;
+    
+    switch (quality) {
+        case AIDecimatorQualityLowLatency:
+            settings.passband = 0.8;
+            settings.stopbandDecibels = 60.0;
+            break;
+        case AIDecimatorQualityHigh:
+            settings.passband = 0.9;
+            settings.stopbandDecibels = 100.0;
+            break;
+        case AIDecimatorQualityBalanced:
+        default:
+            settings.passband = 0.875;
+            settings.stopbandDecibels = 80.0;
+            break;
+    }
+    
+    return settings;
+}
+
+static double AIBesselI0(double x)
+{
+    double sum = 1.0, term = 1.0, halfX = x / 2.0;
+    for (int k = 1; k < 64; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// Kaiser's estimates of the window shape and the filter length for a given attenuation and transition width.
+static double AIKaiserBeta(double decibels)
+{
+    if (decibels > 50.0) {
+        return 0.1102 * (decibels - 8.7);
+    } else if (decibels > 21.0) {
+        return 0.5842 * pow(decibels - 21.0, 0.4) + 0.07886 * (decibels - 21.0);
+    }
+    return 0.0;
+}
+
+static unsigned AIKaiserLength(double decibels, double transition)
+{
+    unsigned length = (unsigned)ceil((decibels - 7.95) / (2.285 * 2.0 * M_PI * transition)) + 1;
+    
+    // Odd, so the delay is a whole number of samples.
+    return length | 1;
+}
+
+// Linear-phase lowpass with unity gain at DC; cutoff is relative to the sample rate.
+static void AIDesignLowpass(std::vector<double> &filter, unsigned length, double cutoff, double beta)
+{
+    double centre = (length - 1) / 2.0;
+    double windowNorm = 1.0 / AIBesselI0(beta);
+    double ratio = 2.0 * cutoff;
+    double sum = 0.0;
+    
+    filter.resize(length);
+    
+    for (unsigned j = 0; j < length; j++) {
+        double t = j - centre;
+        double x = t / centre;
+        double zeroCrossing = ratio * t;
+        double value = 0.0;
+        
+        // Taps on a zero crossing of the sinc are exactly zero, so that a half-band filter's can be skipped.
+        if (zeroCrossing == 0.0) {
+            value = ratio;
+        } else if (zeroCrossing != floor(zeroCrossing)) {
+            value = ratio * sin(M_PI * zeroCrossing) / (M_PI * zeroCrossing);
+        }
+        
+        value *= AIBesselI0(beta * sqrt(fmax(0.0, 1.0 - x * x))) * windowNorm;
+        
+        filter[j] = value;
+        sum += value;
+    }
+    
+    for (unsigned j = 0; j < length; j++) {
+        filter[j] /= sum;
+    }
+}
+
+static inline float AIDecimatorDot(const float *a, const float *b, size_t count)
+{
+    size_t i = 0;
+    float sum = 0.f;
+    
+#if AI_DECIMATOR_NEON
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    for (; i + 4 <= count; i += 4) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+#elif AI_DECIMATOR_SSE2
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+#endif
+    
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+AIPolyphaseDecimator::AIPolyphaseDecimator(unsigned factor, double inputRate, double passbandHz, double stopbandHz,
+                                           double stopbandDecibels, size_t maxInputFrames) :
+    factor(factor),
+    maxInputFrames(maxInputFrames)
+{
+    assert(factor > 0 && passbandHz < stopbandHz);
+    
+    length = AIKaiserLength(stopbandDecibels, (stopbandHz - passbandHz) / inputRate);
+    window = (length + factor - 1) / factor;
+    
+    std::vector<double> filter;
+    AIDesignLowpass(filter, length, (passbandHz + stopbandHz) / 2.0 / inputRate, AIKaiserBeta(stopbandDecibels));
+    
+    // Output n is the sum over j of filter[j] * x[n * factor + factor - 1 - j], so phase q, which holds
+    // x[m * factor + q], meets the taps j = k * factor + factor - 1 - q.
+    coefficients.assign((size_t)factor * window, 0.f);
+    firstTaps.resize(factor);
+    tapCounts.resize(factor);
+    
+    for (unsigned q = 0; q < factor; q++) {
+        float *subfilter = &coefficients[(size_t)q * window];
+        size_t first = window, last = 0;
+        
+        for (size_t k = 0; k < window; k++) {
+            size_t j = k * factor + factor - 1 - q;
+            if (j >= length || filter[j] == 0.0) continue;
+            
+            size_t t = window - 1 - k;
+            subfilter[t] = (float)filter[j];
+            
+            if (t < first) first = t;
+            if (t + 1 > last) last = t + 1;
+        }
+        
+        firstTaps[q] = first < last ? first : 0;
+        tapCounts[q] = first < last ? last - first : 0;
+    }
+    
+    capacity = window + (maxInputFrames + factor - 1) / factor + 1;
+    histories.resize((size_t)factor * capacity);
+    
+    reset();
+}
+
+AIPolyphaseDecimator::~AIPolyphaseDecimator()
+{
+}
+
+size_t AIPolyphaseDecimator::process(const float *input, size_t inputFrames, float *output)
+{
+    assert(inputFrames <= maxInputFrames);
+    
+    size_t first = historyLength;
+    
+    for (size_t i = 0; i < inputFrames; i++) {
+        histories[(size_t)phase * capacity + historyLength] = input[i];
+        
+        if (++phase == factor) {
+            phase = 0;
+            historyLength++;
+        }
+    }
+    
+    size_t produced = 0;
+    
+    for (size_t i = first; i < historyLength; i++) {
+        size_t start = i + 1 - window;
+        float sum = 0.f;
+        
+        for (unsigned q = 0; q < factor; q++) {
+            sum += AIDecimatorDot(&coefficients[(size_t)q * window + firstTaps[q]],
+                                  &histories[(size_t)q * capacity + start + firstTaps[q]], tapCounts[q]);
+        }
+        
+        output[produced++] = sum;
+    }
+    
+    // Keep the groups the next outputs still reach back to, and the incomplete one.
+    size_t start = historyLength + 1 - window;
+    for (unsigned q = 0; q < factor; q++) {
+        float *history = &histories[(size_t)q * capacity];
+        memmove(history, history + start, window * sizeof(float));
+    }
+    historyLength = window - 1;
+    
+    return produced;
+}
+
+void AIPolyphaseDecimator::reset()
+{
+    std::fill(histories.begin(), histories.end(), 0.f);
+    historyLength = window - 1;
+    phase = 0;
+}
+
+size_t AIPolyphaseDecimator::getMaxOutputFrames(size_t inputFrames) const
+{
+    return (inputFrames + factor - 1) / factor;
+}
+
+unsigned AIPolyphaseDecimator::getFactor() const
+{
+    return factor;
+}
+
+unsigned AIPolyphaseDecimator::getTaps() const
+{
+    size_t taps = 0;
+    for (unsigned q = 0; q < factor; q++) {
+        taps += tapCounts[q];
+    }
+    return (unsigned)taps;
+}
+
+double AIPolyphaseDecimator::getDelay() const
+{
+    return (length - 1) / 2.0;
+}
+
+bool AICanDecimate(double inputRate, double outputRate)
+{
+    if (outputRate <= 0.0 || inputRate < outputRate) {
+        return false;
+    }
+    
+    double ratio = inputRate / outputRate;
+    if (fabs(ratio - round(ratio)) > 1e-9) {
+        return false;
+    }
+    
+    unsigned odd = (unsigned)round(ratio);
+    while (odd % 2 == 0) {
+        odd /= 2;
+    }
+    return odd <= AI_DECIMATOR_MAX_ODD_FACTOR;
+}
+
+AIDecimator::AIDecimator(double inputRate, double outputRate, const AIDecimatorSettings &settings, size_t maxInputFrames) :
+    latency(0.0)
+{
+    assert(AICanDecimate(inputRate, outputRate));
+    
+    unsigned ratio = (unsigned)round(inputRate / outputRate);
+    unsigned odd = ratio;
+    while (odd % 2 == 0) {
+        odd /= 2;
+    }
+    
+    // Every stage keeps the final passband and rejects what its own output rate would fold onto it.
+    double passbandHz = settings.passband * outputRate / 2.0;
+    double decibels = settings.stopbandDecibels + AI_DECIMATOR_MARGIN_DECIBELS;
+    double rate = inputRate;
+    size_t frames = maxInputFrames;
+    
+    for (unsigned remaining = ratio; remaining > 1; ) {
+        unsigned factor = odd > 1 ? odd : 2;
+        
+        stages.push_back(std::unique_ptr<AIPolyphaseDecimator>(
+            new AIPolyphaseDecimator(factor, rate, passbandHz, rate / factor - passbandHz, decibels, frames)));
+        latency += stages.back()->getDelay() / rate;
+        
+        frames = stages.back()->getMaxOutputFrames(frames);
+        scratch.push_back(std::vector<float>(frames));
+        
+        rate /= factor;
+        remaining /= factor;
+        odd = 1;
+    }
+    
+    narrowband.reset(new AIPolyphaseDecimator(2, outputRate, passbandHz / 2.0, outputRate / 2.0 - passbandHz / 2.0,
+                                              decibels, frames));
+    narrowbandLatency = latency + narrowband->getDelay() / outputRate;
+}
+
+AIDecimator::~AIDecimator()
+{
+}
+
+AIDecimatorOutput AIDecimator::process(const float *input, size_t inputFrames, float *output, float *narrowbandOutput)
+{
+    AIDecimatorOutput result;
+    
+    const float *samples = input;
+    size_t count = inputFrames;
+    
+    if (stages.empty()) {
+        memcpy(output, input, inputFrames * sizeof(float));
+    }
+    
+    for (size_t i = 0; i < stages.size(); i++) {
+        float *target = i + 1 == stages.size() ? output : &scratch[i][0];
+        count = stages[i]->process(samples, count, target);
+        samples = target;
+    }
+    
+    result.frames = count;
+    result.narrowbandFrames = narrowbandOutput ? narrowband->process(output, count, narrowbandOutput) : 0;
+    
+    return result;
+}
+
+void AIDecimator::reset()
+{
+    for (size_t i = 0; i < stages.size(); i++) {
+        stages[i]->reset();
+    }
+    narrowband->reset();
+}
+
+size_t AIDecimator::getMaxOutputFrames(size_t inputFrames) const
+{
+    for (size_t i = 0; i < stages.size(); i++) {
+        inputFrames = stages[i]->getMaxOutputFrames(inputFrames);
+    }
+    return inputFrames;
+}
+
+size_t AIDecimator::getMaxNarrowbandFrames(size_t inputFrames) const
+{
+    return narrowband->getMaxOutputFrames(getMaxOutputFrames(inputFrames));
+}
+
+double AIDecimator::getLatency() const
+{
+    return latency;
+}
+
+double AIDecimator::getNarrowbandLatency() const
+{
+    return narrowbandLatency;
+}
@@ -0,0 +1,166 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef Decimator_hpp
+#define Decimator_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+typedef enum _AIDecimatorQuality {
+    // 60 dB against aliasing, flat to 80% of the output Nyquist frequency: the shortest filters and least delay.
+    AIDecimatorQualityLowLatency = 0,
+    // 80 dB, flat to 87.5%.
+    AIDecimatorQualityBalanced,
+    // 100 dB, flat to 90%.
+    AIDecimatorQualityHigh,
+} AIDecimatorQuality;
+
+/*
+ * Anti-aliasing requirements of a decimator. Every stage rejects whatever would alias into the passband by at least
+ * stopbandDecibels; aliases may only land between the passband and the output Nyquist frequency. A wider passband
+ * or a deeper stopband takes longer filters, which cost both work and delay: AIDecimator::getLatency tells how much.
+ */
+struct AIDecimatorSettings {
+    // Highest frequency kept flat, as a fraction of the output Nyquist frequency, below 1.
+    double passband;
+    
+    double stopbandDecibels;
+};
+
+AIDecimatorSettings AIDecimatorSettingsForQuality(AIDecimatorQuality quality);
+
+/*
+ * One FIR stage that keeps every factor-th sample, in polyphase form.
+ *
+ * A linear-phase Kaiser-windowed lowpass keeping passbandHz and rejecting from stopbandHz on is split into one
+ * subfilter per input phase. Input is dealt out to one history per phase, so every output costs one contiguous SIMD
+ * dot product per subfilter, all at the output rate. Zero coefficients at the ends of a subfilter are trimmed: in a
+ * half-band stage, a factor of 2 with band edges symmetric about a quarter of the input rate, every other
+ * coefficient is zero and one subfilter shrinks to the centre tap.
+ */
+class AIPolyphaseDecimator {
+public:
+    
+    AIPolyphaseDecimator(unsigned factor, double inputRate, double passbandHz, double stopbandHz,
+                         double stopbandDecibels, size_t maxInputFrames);
+    virtual ~AIPolyphaseDecimator();
+    
+    // Consumes up to maxInputFrames samples and returns the number of samples written to output, which must hold
+    // getMaxOutputFrames(inputFrames). Input that does not complete an output is kept for the next call.
+    size_t process(const float *input, size_t inputFrames, float *output);
+    
+    // Restarts from silence.
+    void reset();
+    
+    size_t getMaxOutputFrames(size_t inputFrames) const;
+    
+    unsigned getFactor() const;
+    
+    // Multiplications per output sample, after trimming.
+    unsigned getTaps() const;
+    
+    // Group delay in input samples.
+    double getDelay() const;
+    
+private:
+    
+    unsigned factor;
+    unsigned length;
+    
+    // Samples of each phase history an output reads.
+    size_t window;
+    
+    // The subfilter of phase q, reversed and window long, starts at q * window; only its firstTaps[q] to
+    // firstTaps[q] + tapCounts[q] coefficients are not zero.
+    std::vector<float> coefficients;
+    std::vector<size_t> firstTaps;
+    std::vector<size_t> tapCounts;
+    
+    // Phase q's history starts at q * capacity. Each holds the last window - 1 complete groups before the new ones,
+    // plus the phases already dealt of a group still incomplete.
+    std::vector<float> histories;
+    size_t capacity;
+    size_t historyLength;
+    unsigned phase;
+    
+    size_t maxInputFrames;
+    
+private:
+    AIPolyphaseDecimator( const AIPolyphaseDecimator& );
+    void operator=( const AIPolyphaseDecimator& );
+};
+
+// Whether AIDecimator can take inputRate down to outputRate: by an integer factor whose odd part is at most 15.
+bool AICanDecimate(double inputRate, double outputRate);
+
+struct AIDecimatorOutput {
+    size_t frames;
+    size_t narrowbandFrames;
+};
+
+/*
+ * Streaming decimator from a capture rate to outputRate, and on to outputRate / 2 for narrowband consumers.
+ *
+ * The factor's odd part, if any, is taken first by one polyphase stage, and every factor of 2 after it by a
+ * half-band stage, so the sharpest filter runs at the lowest rate. Each stage only has to reject what would alias
+ * into the final passband, so the earlier ones are short. The narrowband output is one more half-band stage on the
+ * output, designed to the same settings, so both streams come from the same filtered signal. Nothing is allocated
+ * after construction.
+ */
+class AIDecimator {
+public:
+    
+    AIDecimator(double inputRate, double outputRate, const AIDecimatorSettings &settings, size_t maxInputFrames);
+    virtual ~AIDecimator();
+    
+    // Consumes up to maxInputFrames samples. output must hold getMaxOutputFrames(inputFrames) samples. The
+    // narrowband stream is only produced when narrowbandOutput is not NULL, in which case it must hold
+    // getMaxNarrowbandFrames(inputFrames); skipping it for a while leaves a gap in it.
+    AIDecimatorOutput process(const float *input, size_t inputFrames, float *output, float *narrowbandOutput);
+    
+    void reset();
+    
+    size_t getMaxOutputFrames(size_t inputFrames) const;
+    size_t getMaxNarrowbandFrames(size_t inputFrames) const;
+    
+    // Delay of each output behind the input, in seconds.
+    double getLatency() const;
+    double getNarrowbandLatency() const;
+    
+private:
+    
+    std::vector<std::unique_ptr<AIPolyphaseDecimator> > stages;
+    std::vector<std::vector<float> > scratch;
+    std::unique_ptr<AIPolyphaseDecimator> narrowband;
+    
+    double latency;
+    double narrowbandLatency;
+    
+private:
+    AIDecimator( const AIDecimator& );
+    void operator=( const AIDecimator& );
+};
+
+#endif /* Decimator_hpp */
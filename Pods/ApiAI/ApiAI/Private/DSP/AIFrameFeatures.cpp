@@ -0,0 +1,305 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIFrameFeatures.hpp"
+
+#include <math.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define AI_FRAME_FEATURES_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_FRAME_FEATURES_SSE2 1
+#endif
+
+// Sign changes across five consecutive signs: bit 0 is whether the sample before was positive, bits 1 to 4 whether
+// each of the next four is.
+static const uint8_t AISignChangeCounts[32] = {
+    0, 1, 2, 1, 2, 3, 2, 1, 2, 3, 4, 3, 2, 3, 2, 1,
+    1, 2, 3, 2, 3, 4, 3, 2, 1, 2, 3, 2, 1, 2, 1, 0,
+};
+
+// Float frames are measured with a scale of 1, which leaves every sample exactly as it is.
+static inline float AIFrameSample(float sample, float scale)
+{
+    return sample * scale;
+}
+
+static inline float AIFrameSample(int16_t sample, float scale)
+{
+    return (float)sample * scale;
+}
+
+#if AI_FRAME_FEATURES_NEON
+
+static inline float32x4_t AILoadFrameSamples(const float *samples, float scale)
+{
+    return vmulq_n_f32(vld1q_f32(samples), scale);
+}
+
+static inline float32x4_t AILoadFrameSamples(const int16_t *samples, float scale)
+{
+    return vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(samples))), scale);
+}
+
+static inline void AIAccumulateFrameSamples(float32x4_t values, float64x2_t &sumsLow, float64x2_t &sumsHigh,
+                                            float32x4_t &peaks, unsigned &previous, unsigned &signChanges)
+{
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    
+    float64x2_t low = vcvt_f64_f32(vget_low_f32(values));
+    float64x2_t high = vcvt_high_f64_f32(values);
+    sumsLow = vaddq_f64(sumsLow, vmulq_f64(low, low));
+    sumsHigh = vaddq_f64(sumsHigh, vmulq_f64(high, high));
+    
+    peaks = vmaxq_f32(peaks, vabsq_f32(values));
+    
+    unsigned positive = vaddvq_u32(vandq_u32(vcgtq_f32(values, vdupq_n_f32(0)), vld1q_u32(laneBits)));
+    signChanges += AISignChangeCounts[(positive << 1) | previous];
+    previous = positive >> 3;
+}
+
+#elif AI_FRAME_FEATURES_SSE2
+
+static inline __m128 AILoadFrameSamples(const float *samples, float scale)
+{
+    return _mm_mul_ps(_mm_loadu_ps(samples), _mm_set1_ps(scale));
+}
+
+static inline __m128 AILoadFrameSamples(const int16_t *samples, float scale)
+{
+    __m128i packed = _mm_loadl_epi64((const __m128i *)samples);
+    __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(wide), _mm_set1_ps(scale));
+}
+
+static inline void AIAccumulateFrameSamples(__m128 values, __m128d &sumsLow, __m128d &sumsHigh,
+                                            __m128 &peaks, unsigned &previous, unsigned &signChanges)
+{
+    __m128d low = _mm_cvtps_pd(values);
+    __m128d high = _mm_cvtps_pd(_mm_movehl_ps(values, values));
+    sumsLow = _mm_add_pd(sumsLow, _mm_mul_pd(low, low));
+    sumsHigh = _mm_add_pd(sumsHigh, _mm_mul_pd(high, high));
+    
+    peaks = _mm_max_ps(peaks, _mm_and_ps(values, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))));
+    
+    unsigned positive = (unsigned)_mm_movemask_ps(_mm_cmpgt_ps(values, _mm_setzero_ps()));
+    signChanges += AISignChangeCounts[(positive << 1) | previous];
+    previous = positive >> 3;
+}
+
+#endif
+
+template <typename Sample>
+static AIFrameFeatures AIMeasureSamples(const Sample *samples, size_t count, float scale)
+{
+    AIFrameFeatures features = {0, 0, 0.f};
+    
+    if (count == 0) {
+        return features;
+    }
+    
+    double sums[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    float peak = 0.f;
+    unsigned signChanges = 0;
+    
+    // The first sample has nothing before it, so it counts as its own predecessor.
+    unsigned previous = AIFrameSample(samples[0], scale) > 0;
+    size_t i = 0;
+    
+    // Two groups of four lanes, so that eight independent additions are in flight.
+#if AI_FRAME_FEATURES_NEON
+    float64x2_t sums01 = vdupq_n_f64(0), sums23 = vdupq_n_f64(0), sums45 = vdupq_n_f64(0), sums67 = vdupq_n_f64(0);
+    float32x4_t peaks = vdupq_n_f32(0);
+    
+    for (; i + 8 <= count; i += 8) {
+        AIAccumulateFrameSamples(AILoadFrameSamples(samples + i, scale), sums01, sums23, peaks, previous, signChanges);
+        AIAccumulateFrameSamples(AILoadFrameSamples(samples + i + 4, scale), sums45, sums67, peaks, previous, signChanges);
+    }
+    
+    vst1q_f64(&sums[0], sums01);
+    vst1q_f64(&sums[2], sums23);
+    vst1q_f64(&sums[4], sums45);
+    vst1q_f64(&sums[6], sums67);
+    peak = vmaxvq_f32(peaks);
+#elif AI_FRAME_FEATURES_SSE2
+    __m128d sums01 = _mm_setzero_pd(), sums23 = _mm_setzero_pd(), sums45 = _mm_setzero_pd(), sums67 = _mm_setzero_pd();
+    __m128 peaks = _mm_setzero_ps();
+    
+    for (; i + 8 <= count; i += 8) {
+        AIAccumulateFrameSamples(AILoadFrameSamples(samples + i, scale), sums01, sums23, peaks, previous, signChanges);
+        AIAccumulateFrameSamples(AILoadFrameSamples(samples + i + 4, scale), sums45, sums67, peaks, previous, signChanges);
+    }
+    
+    _mm_storeu_pd(&sums[0], sums01);
+    _mm_storeu_pd(&sums[2], sums23);
+    _mm_storeu_pd(&sums[4], sums45);
+    _mm_storeu_pd(&sums[6], sums67);
+    
+    float lanes[4];
+    _mm_storeu_ps(lanes, peaks);
+    for (unsigned lane = 0; lane < 4; lane++) {
+        if (lanes[lane] > peak) peak = lanes[lane];
+    }
+#endif
+    
+    for (; i < count; i++) {
+        float value = AIFrameSample(samples[i], scale);
+        
+        sums[i % 8] += (double)value * (double)value;
+        
+        float absolute = fabsf(value);
+        if (absolute > peak) peak = absolute;
+        
+        unsigned positive = value > 0;
+        signChanges += positive != previous;
+        previous = positive;
+    }
+    
+    features.sumOfSquares = ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+    features.signChanges = signChanges;
+    features.peak = peak;
+    
+    return features;
+}
+
+AIFrameFeatures AIMeasureFrame(const float *samples, size_t count)
+{
+    return AIMeasureSamples(samples, count, 1.f);
+}
+
+AIFrameFeatures AIMeasureFrame(const int16_t *samples, size_t count, float scale)
+{
+    return AIMeasureSamples(samples, count, scale);
+}
+
+#if AI_FRAME_FEATURES_NEON
+
+static inline void AIAccumulateFixedFrameSamples(int16x8_t values, int64x2_t &sums, int16x8_t &maxima, int16x8_t &minima,
+                                                 unsigned &previous, unsigned &signChanges)
+{
+    static const uint16_t laneBits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    
+    // Each product fits in 31 bits, so the pairwise additions into 64 bits cannot overflow.
+    sums = vpadalq_s32(sums, vmull_s16(vget_low_s16(values), vget_low_s16(values)));
+    sums = vpadalq_s32(sums, vmull_high_s16(values, values));
+    
+    maxima = vmaxq_s16(maxima, values);
+    minima = vminq_s16(minima, values);
+    
+    unsigned positive = vaddvq_u16(vandq_u16(vcgtq_s16(values, vdupq_n_s16(0)), vld1q_u16(laneBits)));
+    signChanges += AISignChangeCounts[((positive & 15) << 1) | previous];
+    signChanges += AISignChangeCounts[((positive >> 4) << 1) | ((positive >> 3) & 1)];
+    previous = positive >> 7;
+}
+
+#elif AI_FRAME_FEATURES_SSE2
+
+static inline void AIAccumulateFixedFrameSamples(__m128i values, __m128i &sums, __m128i &maxima, __m128i &minima,
+                                                 unsigned &previous, unsigned &signChanges)
+{
+    // A pair of full-scale negative samples sums to 2^31, which only fits when read as unsigned.
+    __m128i pairs = _mm_madd_epi16(values, values);
+    sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(pairs, _mm_setzero_si128()));
+    sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(pairs, _mm_setzero_si128()));
+    
+    maxima = _mm_max_epi16(maxima, values);
+    minima = _mm_min_epi16(minima, values);
+    
+    __m128i mask = _mm_cmpgt_epi16(values, _mm_setzero_si128());
+    unsigned positive = (unsigned)_mm_movemask_epi8(_mm_packs_epi16(mask, mask)) & 0xFF;
+    signChanges += AISignChangeCounts[((positive & 15) << 1) | previous];
+    signChanges += AISignChangeCounts[((positive >> 4) << 1) | ((positive >> 3) & 1)];
+    previous = positive >> 7;
+}
+
+#endif
+
+AIFixedFrameFeatures AIMeasureFixedFrame(const int16_t *samples, size_t count)
+{
+    AIFixedFrameFeatures features = {0, 0, 0};
+    
+    if (count == 0) {
+        return features;
+    }
+    
+    uint64_t sumOfSquares = 0;
+    int32_t maximum = 0;
+    int32_t minimum = 0;
+    unsigned signChanges = 0;
+    
+    unsigned previous = samples[0] > 0;
+    size_t i = 0;
+    
+#if AI_FRAME_FEATURES_NEON
+    int64x2_t sums = vdupq_n_s64(0);
+    int16x8_t maxima = vdupq_n_s16(0), minima = vdupq_n_s16(0);
+    
+    for (; i + 8 <= count; i += 8) {
+        AIAccumulateFixedFrameSamples(vld1q_s16(samples + i), sums, maxima, minima, previous, signChanges);
+    }
+    
+    sumOfSquares = (uint64_t)vaddvq_s64(sums);
+    maximum = vmaxvq_s16(maxima);
+    minimum = vminvq_s16(minima);
+#elif AI_FRAME_FEATURES_SSE2
+    __m128i sums = _mm_setzero_si128();
+    __m128i maxima = _mm_setzero_si128(), minima = _mm_setzero_si128();
+    
+    for (; i + 8 <= count; i += 8) {
+        AIAccumulateFixedFrameSamples(_mm_loadu_si128((const __m128i *)(samples + i)), sums, maxima, minima,
+                                      previous, signChanges);
+    }
+    
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, sums);
+    sumOfSquares = lanes[0] + lanes[1];
+    
+    int16_t extremes[16];
+    _mm_storeu_si128((__m128i *)extremes, maxima);
+    _mm_storeu_si128((__m128i *)(extremes + 8), minima);
+    for (unsigned lane = 0; lane < 8; lane++) {
+        if (extremes[lane] > maximum) maximum = extremes[lane];
+        if (extremes[lane + 8] < minimum) minimum = extremes[lane + 8];
+    }
+#endif
+    
+    for (; i < count; i++) {
+        int32_t value = samples[i];
+        
+        sumOfSquares += (uint64_t)(value * value);
+        
+        if (value > maximum) maximum = value;
+        if (value < minimum) minimum = value;
+        
+        unsigned positive = value > 0;
+        signChanges += positive != previous;
+        previous = positive;
+    }
+    
+    features.sumOfSquares = sumOfSquares;
+    features.signChanges = signChanges;
+    features.peak = (uint32_t)(maximum > -minimum ? maximum : -minimum);
+    
+    return features;
+}
@@ -0,0 +1,62 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef FrameFeatures_hpp
+#define FrameFeatures_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct AIFrameFeatures {
+    // Sum of the squared samples. Every square is exact in double; they are added into eight partial sums by index
+    // modulo 8, which are then combined pairwise, so every implementation rounds the same way.
+    double sumOfSquares;
+    
+    // Number of neighbouring samples of which one is positive and the other is not.
+    unsigned signChanges;
+    
+    // Largest absolute sample.
+    float peak;
+};
+
+// Measures a frame in a single pass.
+AIFrameFeatures AIMeasureFrame(const float *samples, size_t count);
+
+// Same as measuring the frame converted with (float)samples[i] * scale; scale must be positive.
+AIFrameFeatures AIMeasureFrame(const int16_t *samples, size_t count, float scale);
+
+// Integer counterpart of AIFrameFeatures, in int16 units.
+struct AIFixedFrameFeatures {
+    // Exact sum of the squared samples; frames up to 2^33 samples cannot overflow it.
+    uint64_t sumOfSquares;
+    
+    // Same count as AIFrameFeatures::signChanges for the same samples.
+    unsigned signChanges;
+    
+    // Largest absolute sample, 32768 for a full-scale negative one.
+    uint32_t peak;
+};
+
+// Measures an int16 frame in a single pass without converting any sample.
+AIFixedFrameFeatures AIMeasureFixedFrame(const int16_t *samples, size_t count);
+
+#endif /* FrameFeatures_hpp */
@@ -0,0 +1,291 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AILevelMeter.hpp"
+#include "AIFrameFeatures.hpp"
+
+#include <math.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define AI_LEVEL_METER_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_LEVEL_METER_SSE2 1
+#endif
+
+AILevelMeter::AILevelMeter(double sampleRate, AILevelMeterMode mode) : sampleRate(sampleRate), mode(mode)
+{
+    setHoldDecay(AI_LEVEL_METER_HOLD_SECONDS, AI_LEVEL_METER_DECAY_DECIBELS_PER_SECOND);
+    reset();
+}
+
+AILevelMeter::~AILevelMeter()
+{
+}
+
+float AILevelMeter::process(const int16_t *samples, size_t count)
+{
+    // Only what the mode reads is measured.
+    AILevelMeasurement measurement = {0.f, 0.f, 0.0};
+    
+    if (mode == AILevelMeterModeEnvelope) {
+        measurement.envelopePeak = AIMeasureEnvelopePeak(samples, count, AI_LEVEL_METER_ENVELOPE_COEFFICIENT);
+    } else {
+        AIFixedFrameFeatures features = AIMeasureFixedFrame(samples, count);
+        measurement.peak = (float)features.peak;
+        measurement.sumOfSquares = (double)features.sumOfSquares;
+    }
+    
+    return process(measurement, count);
+}
+
+float AILevelMeter::process(const AILevelMeasurement &measurement, size_t count)
+{
+    float level;
+    
+    if (mode == AILevelMeterModeEnvelope) {
+        level = measurement.envelopePeak;
+    } else if (mode == AILevelMeterModeRMS) {
+        level = count ? (float)sqrt(measurement.sumOfSquares / (double)count) : 0.f;
+    } else {
+        level = measurement.peak;
+    }
+    
+    float decibels = level > 1.f ? 20.f * log10f(level) + AI_LEVEL_METER_DB_OFFSET : AI_LEVEL_METER_DB_OFFSET;
+    
+    if (mode == AILevelMeterModeHoldDecay) {
+        decibels = holdDecay(decibels, count);
+    }
+    
+    return decibels;
+}
+
+float AILevelMeter::holdDecay(float decibels, size_t count)
+{
+    if (decibels >= heldDecibels) {
+        heldDecibels = decibels;
+        holdRemaining = holdSamples;
+    } else if (holdRemaining >= count) {
+        holdRemaining -= count;
+    } else {
+        heldDecibels -= decayPerSample * (float)(count - holdRemaining);
+        holdRemaining = 0;
+        
+        if (heldDecibels < decibels) heldDecibels = decibels;
+    }
+    
+    return heldDecibels;
+}
+
+void AILevelMeter::reset()
+{
+    heldDecibels = AI_LEVEL_METER_DB_OFFSET;
+    holdRemaining = 0;
+}
+
+void AILevelMeter::setMode(AILevelMeterMode mode)
+{
+    this->mode = mode;
+    reset();
+}
+
+AILevelMeterMode AILevelMeter::getMode() const
+{
+    return mode;
+}
+
+void AILevelMeter::setHoldDecay(double holdSeconds, double decibelsPerSecond)
+{
+    holdSamples = (size_t)(holdSeconds * sampleRate);
+    decayPerSample = (float)(decibelsPerSecond / sampleRate);
+}
+
+// The envelope is a recurrence, so it is evaluated four samples at a time: a two-step scan gives each lane the
+// filtered sum of the magnitudes up to it within the block, and the last output of the previous block, scaled by the
+// powers of the feedback, is added on top.
+#if AI_LEVEL_METER_NEON
+
+static inline float32x4_t AILoadEnvelopeMagnitudes(const int16_t *samples, float coefficient)
+{
+    return vmulq_n_f32(vcvtq_f32_s32(vabsq_s32(vmovl_s16(vld1_s16(samples)))), coefficient);
+}
+
+#elif AI_LEVEL_METER_SSE2
+
+static inline __m128 AILoadEnvelopeMagnitudes(const int16_t *samples, float coefficient)
+{
+    __m128i packed = _mm_loadl_epi64((const __m128i *)samples);
+    __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+    __m128i sign = _mm_srai_epi32(wide, 31);
+    __m128i magnitudes = _mm_sub_epi32(_mm_xor_si128(wide, sign), sign);
+    
+    return _mm_mul_ps(_mm_cvtepi32_ps(magnitudes), _mm_set1_ps(coefficient));
+}
+
+#endif
+
+float AIMeasureEnvelopePeak(const int16_t *samples, size_t count, float coefficient)
+{
+    float feedback = 1.f - coefficient;
+    float envelope = 0.f;
+    float peak = 0.f;
+    size_t i = 0;
+    
+#if AI_LEVEL_METER_NEON
+    const float feedback2 = feedback * feedback;
+    const float carries[4] = {feedback, feedback2, feedback2 * feedback, feedback2 * feedback2};
+    const float32x4_t carry = vld1q_f32(carries);
+    const float32x4_t zero = vdupq_n_f32(0);
+    
+    float32x4_t previous = zero;
+    float32x4_t peaks = zero;
+    
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t values = AILoadEnvelopeMagnitudes(samples + i, coefficient);
+        values = vmlaq_n_f32(values, vextq_f32(zero, values, 3), feedback);
+        values = vmlaq_n_f32(values, vextq_f32(zero, values, 2), feedback2);
+        values = vmlaq_f32(values, previous, carry);
+        
+        peaks = vmaxq_f32(peaks, values);
+        previous = vdupq_laneq_f32(values, 3);
+    }
+    
+    envelope = vgetq_lane_f32(previous, 0);
+    peak = vmaxvq_f32(peaks);
+#elif AI_LEVEL_METER_SSE2
+    const float feedback2 = feedback * feedback;
+    const __m128 carry = _mm_setr_ps(feedback, feedback2, feedback2 * feedback, feedback2 * feedback2);
+    const __m128 shift1 = _mm_set1_ps(feedback);
+    const __m128 shift2 = _mm_set1_ps(feedback2);
+    
+    __m128 previous = _mm_setzero_ps();
+    __m128 peaks = _mm_setzero_ps();
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 values = AILoadEnvelopeMagnitudes(samples + i, coefficient);
+        values = _mm_add_ps(values, _mm_mul_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(values), 4)), shift1));
+        values = _mm_add_ps(values, _mm_mul_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(values), 8)), shift2));
+        values = _mm_add_ps(values, _mm_mul_ps(previous, carry));
+        
+        peaks = _mm_max_ps(peaks, values);
+        previous = _mm_shuffle_ps(values, values, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    
+    envelope = _mm_cvtss_f32(previous);
+    
+    float lanes[4];
+    _mm_storeu_ps(lanes, peaks);
+    for (unsigned lane = 0; lane < 4; lane++) {
+        if (lanes[lane] > peak) peak = lanes[lane];
+    }
+#endif
+    
+    for (; i < count; i++) {
+        envelope = coefficient * (float)abs(samples[i]) + feedback * envelope;
+        if (envelope > peak) peak = envelope;
+    }
+    
+    return peak;
+}
+
+// C++11 constexpr helpers for generating the meter scale table while compiling.
+template <size_t... Indices>
+struct AIIndexSequence {
+};
+
+template <size_t Count, size_t... Indices>
+struct AIMakeIndexSequence : AIMakeIndexSequence<Count - 1, Count - 1, Indices...> {
+};
+
+template <size_t... Indices>
+struct AIMakeIndexSequence<0, Indices...> : AIIndexSequence<Indices...> {
+};
+
+static constexpr double AIConstexprSquare(double x)
+{
+    return x * x;
+}
+
+static constexpr double AIConstexprExpSeries(double x, double term, unsigned n)
+{
+    return n == 16 ? term : term + AIConstexprExpSeries(x, term * x / (n + 1), n + 1);
+}
+
+// Halves arguments below -0.5 until the series converges quickly, then squares back.
+static constexpr double AIConstexprExp(double x)
+{
+    return x < -0.5 ? AIConstexprSquare(AIConstexprExp(x / 2)) : AIConstexprExpSeries(x, 1.0, 0);
+}
+
+static constexpr double AIConstexprSquareRoot(double x, double guess, unsigned iterations)
+{
+    return iterations == 0 ? guess : AIConstexprSquareRoot(x, 0.5 * (guess + x / guess), iterations - 1);
+}
+
+static constexpr double AIConstexprSquareRoot(double x)
+{
+    return x <= 0 ? 0 : AIConstexprSquareRoot(x, 1.0, 64);
+}
+
+static constexpr double AIConstexprDecibelsToAmplitude(double decibels)
+{
+    return AIConstexprExp(decibels * (2.302585092994046 / 20.0));
+}
+
+static constexpr double AIMeterScaleDecibelStep = AI_METER_SCALE_MIN_DECIBELS / (AI_METER_SCALE_TABLE_SIZE - 1);
+static constexpr double AIMeterScaleMinAmplitude = AIConstexprDecibelsToAmplitude(AI_METER_SCALE_MIN_DECIBELS);
+
+static constexpr float AIMeterScaleEntry(size_t index)
+{
+    return (float)AIConstexprSquareRoot((AIConstexprDecibelsToAmplitude(index * AIMeterScaleDecibelStep) - AIMeterScaleMinAmplitude) /
+                                        (1.0 - AIMeterScaleMinAmplitude));
+}
+
+struct AIMeterScaleTable {
+    float values[AI_METER_SCALE_TABLE_SIZE];
+};
+
+template <size_t... Indices>
+static constexpr AIMeterScaleTable AIMakeMeterScaleTable(AIIndexSequence<Indices...>)
+{
+    return AIMeterScaleTable{{AIMeterScaleEntry(Indices)...}};
+}
+
+// Entry i is for i * AIMeterScaleDecibelStep decibels, from 1 at 0 dB down to 0 at the minimum.
+static constexpr AIMeterScaleTable AIMeterScale = AIMakeMeterScaleTable(AIMakeIndexSequence<AI_METER_SCALE_TABLE_SIZE>());
+
+static_assert(AIMeterScale.values[0] == 1.f && AIMeterScale.values[AI_METER_SCALE_TABLE_SIZE - 1] == 0.f,
+              "the meter scale must run from 1 at 0 dB to 0 at the minimum");
+
+float AIMeterScaleValue(float decibels)
+{
+    if (!(decibels > (float)AI_METER_SCALE_MIN_DECIBELS)) return 0.f;
+    if (decibels >= 0.f) return 1.f;
+    
+    float position = decibels * (float)(1.0 / AIMeterScaleDecibelStep);
+    size_t index = (size_t)position;
+    if (index >= AI_METER_SCALE_TABLE_SIZE - 1) return 0.f;
+    
+    float fraction = position - (float)index;
+    return AIMeterScale.values[index] + (AIMeterScale.values[index + 1] - AIMeterScale.values[index]) * fraction;
+}
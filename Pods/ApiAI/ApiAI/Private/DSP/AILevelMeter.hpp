@@ -0,0 +1,115 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef LevelMeter_hpp
+#define LevelMeter_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Decibels added to 20 * log10 of a level in int16 units; levels below one unit read as this value.
+#define AI_LEVEL_METER_DB_OFFSET -74.f
+
+// Weight of each new magnitude in the envelope, which therefore has a time constant of about 1000 samples.
+#define AI_LEVEL_METER_ENVELOPE_COEFFICIENT 0.001f
+
+#define AI_LEVEL_METER_HOLD_SECONDS 0.5
+#define AI_LEVEL_METER_DECAY_DECIBELS_PER_SECOND 20.0
+
+// The meter scale maps AI_METER_SCALE_MIN_DECIBELS to 0 dB onto 0 to 1 through a table of this many points.
+#define AI_METER_SCALE_MIN_DECIBELS -80.0
+#define AI_METER_SCALE_TABLE_SIZE 400
+
+typedef enum _AILevelMeterMode {
+    // Peak of a one-pole envelope of the magnitudes, restarted for every buffer. This is the level the recorder has
+    // always reported.
+    AILevelMeterModeEnvelope = 0,
+    // Largest magnitude in the buffer.
+    AILevelMeterModePeak,
+    AILevelMeterModeRMS,
+    // Buffer peak, held for a while and then falling at a fixed rate until a higher peak arrives.
+    AILevelMeterModeHoldDecay,
+} AILevelMeterMode;
+
+// One buffer reduced to the levels the modes read, in int16 units.
+struct AILevelMeasurement {
+    // AIMeasureEnvelopePeak with AI_LEVEL_METER_ENVELOPE_COEFFICIENT.
+    float envelopePeak;
+    
+    // Largest magnitude.
+    float peak;
+    
+    double sumOfSquares;
+};
+
+/*
+ * Input level meter for int16 buffers.
+ *
+ * Each buffer is reduced to one linear level in a single SIMD pass, and only that level is converted to decibels.
+ */
+class AILevelMeter {
+public:
+    
+    AILevelMeter(double sampleRate, AILevelMeterMode mode = AILevelMeterModeEnvelope);
+    virtual ~AILevelMeter();
+    
+    // Measures one buffer and returns its level in decibels.
+    float process(const int16_t *samples, size_t count);
+    
+    // Same for a buffer of count samples measured elsewhere, such as by AIAudioFrontEnd.
+    float process(const AILevelMeasurement &measurement, size_t count);
+    
+    // Forgets any held peak.
+    void reset();
+    
+    void setMode(AILevelMeterMode mode);
+    AILevelMeterMode getMode() const;
+    
+    // How long AILevelMeterModeHoldDecay holds a peak, and how fast it falls afterwards.
+    void setHoldDecay(double holdSeconds, double decibelsPerSecond);
+    
+private:
+    
+    float holdDecay(float decibels, size_t count);
+    
+    double sampleRate;
+    AILevelMeterMode mode;
+    
+    size_t holdSamples;
+    float decayPerSample;
+    
+    float heldDecibels;
+    size_t holdRemaining;
+    
+private:
+    AILevelMeter( const AILevelMeter& );
+    void operator=( const AILevelMeter& );
+};
+
+// Largest value of the envelope y = coefficient * |x| + (1 - coefficient) * y over the samples, starting from 0.
+float AIMeasureEnvelopePeak(const int16_t *samples, size_t count, float coefficient);
+
+// Maps decibels onto the 0 to 1 meter scale: the square root of the amplitude above that of
+// AI_METER_SCALE_MIN_DECIBELS, interpolated from a table generated at compile time.
+float AIMeterScaleValue(float decibels);
+
+#endif /* LevelMeter_hpp */
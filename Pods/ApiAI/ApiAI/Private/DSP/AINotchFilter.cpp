@@ -0,0 +1,76 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AINotchFilter.hpp"
+
+#include <math.h>
+
+AINotchFilter::AINotchFilter(double sampleRate, const double *frequencies, size_t frequencyCount, double bandwidth)
+{
+    for (size_t i = 0; i < frequencyCount; i++) {
+        double w0 = 2.0 * M_PI * frequencies[i] / sampleRate;
+        double alpha = sin(w0) * bandwidth / (2.0 * frequencies[i]);
+        double a0 = 1.0 + alpha;
+        
+        Section section;
+        section.b0 = (float)(1.0 / a0);
+        section.b1 = (float)(-2.0 * cos(w0) / a0);
+        section.b2 = section.b0;
+        section.a1 = section.b1;
+        section.a2 = (float)((1.0 - alpha) / a0);
+        section.z1 = 0.f;
+        section.z2 = 0.f;
+        
+        sections.push_back(section);
+    }
+}
+
+AINotchFilter::~AINotchFilter()
+{
+}
+
+void AINotchFilter::process(int16_t *samples, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        float value = samples[i];
+        
+        // Transposed direct form II.
+        for (size_t j = 0; j < sections.size(); j++) {
+            Section &section = sections[j];
+            float output = section.b0 * value + section.z1;
+            section.z1 = section.b1 * value - section.a1 * output + section.z2;
+            section.z2 = section.b2 * value - section.a2 * output;
+            value = output;
+        }
+        
+        value = rintf(value);
+        samples[i] = value > 32767.f ? 32767 : value < -32768.f ? -32768 : (int16_t)value;
+    }
+}
+
+void AINotchFilter::reset()
+{
+    for (size_t j = 0; j < sections.size(); j++) {
+        sections[j].z1 = 0.f;
+        sections[j].z2 = 0.f;
+    }
+}
@@ -0,0 +1,62 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef NotchFilter_hpp
+#define NotchFilter_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Cascade of second-order notches that removes a few known tones, such as the echo of a prompt sound, while
+ * leaving the rest of the band as it was.
+ *
+ * Each section is the standard biquad notch with the given bandwidth at its frequency. The state is kept in
+ * floating point across calls; int16 samples are filtered in place, rounded and saturated.
+ */
+class AINotchFilter {
+public:
+    
+    AINotchFilter(double sampleRate, const double *frequencies, size_t frequencyCount, double bandwidth);
+    virtual ~AINotchFilter();
+    
+    void process(int16_t *samples, size_t count);
+    
+    // Clears the filter state, as if the preceding input had been silence.
+    void reset();
+    
+private:
+    
+    struct Section {
+        float b0, b1, b2, a1, a2;
+        float z1, z2;
+    };
+    
+    std::vector<Section> sections;
+    
+private:
+    AINotchFilter( const AINotchFilter& );
+    void operator=( const AINotchFilter& );
+};
+
+#endif /* NotchFilter_hpp */
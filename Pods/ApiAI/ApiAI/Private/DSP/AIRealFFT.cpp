@@ -0,0 +1,195 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIRealFFT.hpp"
+
+#include <math.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AI_REAL_FFT_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_REAL_FFT_SSE2 1
+#endif
+
+// One Stockham stage: m twiddles, each shared by a run of stride contiguous butterflies.
+static void AIRealFFTStage(const float *inReal, const float *inImaginary, float *outReal, float *outImaginary,
+                           size_t stride, size_t m, const float *cosines, const float *sines)
+{
+    for (size_t p = 0; p < m; p++) {
+        float wr = cosines[p * stride];
+        float wi = sines[p * stride];
+        
+        const float *ar = inReal + stride * p;
+        const float *ai = inImaginary + stride * p;
+        const float *br = inReal + stride * (p + m);
+        const float *bi = inImaginary + stride * (p + m);
+        
+        float *sumReal = outReal + stride * 2 * p;
+        float *sumImaginary = outImaginary + stride * 2 * p;
+        float *differenceReal = sumReal + stride;
+        float *differenceImaginary = sumImaginary + stride;
+        
+        size_t q = 0;
+        
+#if AI_REAL_FFT_NEON
+        float32x4_t vwr = vdupq_n_f32(wr);
+        float32x4_t vwi = vdupq_n_f32(wi);
+        
+        for (; q + 4 <= stride; q += 4) {
+            float32x4_t xr = vld1q_f32(ar + q), xi = vld1q_f32(ai + q);
+            float32x4_t yr = vld1q_f32(br + q), yi = vld1q_f32(bi + q);
+            float32x4_t dr = vsubq_f32(xr, yr), di = vsubq_f32(xi, yi);
+            
+            vst1q_f32(sumReal + q, vaddq_f32(xr, yr));
+            vst1q_f32(sumImaginary + q, vaddq_f32(xi, yi));
+            vst1q_f32(differenceReal + q, vsubq_f32(vmulq_f32(dr, vwr), vmulq_f32(di, vwi)));
+            vst1q_f32(differenceImaginary + q, vaddq_f32(vmulq_f32(dr, vwi), vmulq_f32(di, vwr)));
+        }
+#elif AI_REAL_FFT_SSE2
+        __m128 vwr = _mm_set1_ps(wr);
+        __m128 vwi = _mm_set1_ps(wi);
+        
+        for (; q + 4 <= stride; q += 4) {
+            __m128 xr = _mm_loadu_ps(ar + q), xi = _mm_loadu_ps(ai + q);
+            __m128 yr = _mm_loadu_ps(br + q), yi = _mm_loadu_ps(bi + q);
+            __m128 dr = _mm_sub_ps(xr, yr), di = _mm_sub_ps(xi, yi);
+            
+            _mm_storeu_ps(sumReal + q, _mm_add_ps(xr, yr));
+            _mm_storeu_ps(sumImaginary + q, _mm_add_ps(xi, yi));
+            _mm_storeu_ps(differenceReal + q, _mm_sub_ps(_mm_mul_ps(dr, vwr), _mm_mul_ps(di, vwi)));
+            _mm_storeu_ps(differenceImaginary + q, _mm_add_ps(_mm_mul_ps(dr, vwi), _mm_mul_ps(di, vwr)));
+        }
+#endif
+        
+        for (; q < stride; q++) {
+            float dr = ar[q] - br[q];
+            float di = ai[q] - bi[q];
+            
+            sumReal[q] = ar[q] + br[q];
+            sumImaginary[q] = ai[q] + bi[q];
+            differenceReal[q] = dr * wr - di * wi;
+            differenceImaginary[q] = dr * wi + di * wr;
+        }
+    }
+}
+
+AIRealFFT::AIRealFFT(size_t size) :
+    size(size),
+    half(size / 2)
+{
+    stageCosines.resize(half / 2);
+    stageSines.resize(half / 2);
+    for (size_t j = 0; j < half / 2; j++) {
+        double angle = 2.0 * M_PI * (double)j / (double)half;
+        stageCosines[j] = (float)cos(angle);
+        stageSines[j] = (float)-sin(angle);
+    }
+    
+    splitCosines.resize(half + 1);
+    splitSines.resize(half + 1);
+    for (size_t k = 0; k <= half; k++) {
+        double angle = 2.0 * M_PI * (double)k / (double)size;
+        splitCosines[k] = (float)cos(angle);
+        splitSines[k] = (float)-sin(angle);
+    }
+    
+    real0.resize(half);
+    imaginary0.resize(half);
+    real1.resize(half);
+    imaginary1.resize(half);
+    
+    spectrumReal.resize(half + 1);
+    spectrumImaginary.resize(half + 1);
+}
+
+AIRealFFT::~AIRealFFT()
+{
+}
+
+void AIRealFFT::transformPacked(const float *input, float *&real, float *&imaginary)
+{
+    float *inReal = &real0[0];
+    float *inImaginary = &imaginary0[0];
+    float *outReal = &real1[0];
+    float *outImaginary = &imaginary1[0];
+    
+    for (size_t j = 0; j < half; j++) {
+        inReal[j] = input[2 * j];
+        inImaginary[j] = input[2 * j + 1];
+    }
+    
+    for (size_t stride = 1, length = half; length > 1; stride *= 2, length /= 2) {
+        AIRealFFTStage(inReal, inImaginary, outReal, outImaginary, stride, length / 2, &stageCosines[0], &stageSines[0]);
+        
+        float *swap = inReal; inReal = outReal; outReal = swap;
+        swap = inImaginary; inImaginary = outImaginary; outImaginary = swap;
+    }
+    
+    real = inReal;
+    imaginary = inImaginary;
+}
+
+void AIRealFFT::forward(const float *input, float *real, float *imaginary)
+{
+    float *packedReal;
+    float *packedImaginary;
+    transformPacked(input, packedReal, packedImaginary);
+    
+    // Z[k] holds the even samples' spectrum plus i times the odd samples'; pairing it with conj(Z[half - k])
+    // separates the two, and the odd half is rotated by e^(-2 pi i k / size) onto the even one.
+    for (size_t k = 0; k <= half; k++) {
+        size_t index = k < half ? k : 0;
+        size_t mirror = k > 0 ? half - k : 0;
+        
+        float ar = packedReal[index];
+        float ai = packedImaginary[index];
+        float br = packedReal[mirror];
+        float bi = -packedImaginary[mirror];
+        
+        float evenReal = 0.5f * (ar + br);
+        float evenImaginary = 0.5f * (ai + bi);
+        float oddReal = 0.5f * (ai - bi);
+        float oddImaginary = -0.5f * (ar - br);
+        
+        float wr = splitCosines[k];
+        float wi = splitSines[k];
+        
+        real[k] = evenReal + wr * oddReal - wi * oddImaginary;
+        imaginary[k] = evenImaginary + wr * oddImaginary + wi * oddReal;
+    }
+}
+
+void AIRealFFT::powerSpectrum(const float *input, float *power)
+{
+    forward(input, &spectrumReal[0], &spectrumImaginary[0]);
+    
+    for (size_t k = 0; k <= half; k++) {
+        power[k] = spectrumReal[k] * spectrumReal[k] + spectrumImaginary[k] * spectrumImaginary[k];
+    }
+}
+
+size_t AIRealFFT::getSize() const
+{
+    return size;
+}
@@ -0,0 +1,78 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef RealFFT_hpp
+#define RealFFT_hpp
+
+#include <stddef.h>
+#include <vector>
+
+/*
+ * Forward FFT of real input of a fixed power-of-two size.
+ *
+ * The input is packed into a half-size complex sequence and run through a Stockham radix-2 FFT on split real and
+ * imaginary arrays. From the third stage on, every butterfly loop runs over contiguous samples with a shared twiddle,
+ * which the SIMD paths take four at a time. A final pass separates the real spectrum.
+ */
+class AIRealFFT {
+public:
+    
+    // size must be a power of two of at least 4.
+    AIRealFFT(size_t size);
+    virtual ~AIRealFFT();
+    
+    // Writes the size / 2 + 1 bins from DC to Nyquist. Neither output may alias the input.
+    void forward(const float *input, float *real, float *imaginary);
+    
+    // Writes the size / 2 + 1 bin powers re^2 + im^2.
+    void powerSpectrum(const float *input, float *power);
+    
+    size_t getSize() const;
+    
+private:
+    
+    // Leaves the half-size spectrum of the packed input in the returned arrays (one of the two buffer pairs).
+    void transformPacked(const float *input, float *&real, float *&imaginary);
+    
+    size_t size;
+    size_t half;
+    
+    // e^(-2 pi i j / half) for the complex stages and e^(-2 pi i k / size) for separating the real spectrum.
+    std::vector<float> stageCosines;
+    std::vector<float> stageSines;
+    std::vector<float> splitCosines;
+    std::vector<float> splitSines;
+    
+    std::vector<float> real0;
+    std::vector<float> imaginary0;
+    std::vector<float> real1;
+    std::vector<float> imaginary1;
+    
+    std::vector<float> spectrumReal;
+    std::vector<float> spectrumImaginary;
+    
+private:
+    AIRealFFT( const AIRealFFT& );
+    void operator=( const AIRealFFT& );
+};
+
+#endif /* RealFFT_hpp */
@@ -0,0 +1,153 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef RingBuffer_hpp
+#define RingBuffer_hpp
+
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+/*
+ * Fixed-capacity single-producer/single-consumer ring of trivially copyable items.
+ *
+ * One thread may write while another reads, without locks. The capacity is rounded up to a power of two and never
+ * grows: writes that do not fit are cut short, so memory stays bounded however far the consumer falls behind.
+ * Positions count every item ever written or read and wrap around through the mask.
+ */
+template <typename T>
+class AIRingBuffer {
+public:
+    
+    AIRingBuffer(size_t capacity) :
+        writePosition(0),
+        readPosition(0)
+    {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        
+        storage.resize(size);
+        mask = size - 1;
+    }
+    
+    virtual ~AIRingBuffer()
+    {
+    }
+    
+    // Producer side.
+    size_t getWriteAvailable() const
+    {
+        return storage.size() - (writePosition.load(std::memory_order_relaxed) - readPosition.load(std::memory_order_acquire));
+    }
+    
+    // Returns how many items fitted.
+    size_t write(const T *items, size_t count)
+    {
+        size_t available = getWriteAvailable();
+        if (count > available) count = available;
+        
+        size_t position = writePosition.load(std::memory_order_relaxed);
+        
+        size_t offset = position & mask;
+        size_t first = count < storage.size() - offset ? count : storage.size() - offset;
+        
+        memcpy(&storage[offset], items, first * sizeof(T));
+        memcpy(&storage[0], items + first, (count - first) * sizeof(T));
+        
+        writePosition.store(position + count, std::memory_order_release);
+        return count;
+    }
+    
+    // Consumer side.
+    size_t getReadAvailable() const
+    {
+        return writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed);
+    }
+    
+    // Returns the next count items without consuming them, or NULL if fewer are available. The items are read in
+    // place unless they wrap around the end of the storage, in which case they are copied to scratch, which must
+    // hold count items.
+    const T *peek(size_t count, T *scratch) const
+    {
+        if (getReadAvailable() < count) {
+            return NULL;
+        }
+        
+        size_t offset = readPosition.load(std::memory_order_relaxed) & mask;
+        if (offset + count <= storage.size()) {
+            return &storage[offset];
+        }
+        
+        size_t first = storage.size() - offset;
+        memcpy(scratch, &storage[offset], first * sizeof(T));
+        memcpy(scratch + first, &storage[0], (count - first) * sizeof(T));
+        
+        return scratch;
+    }
+    
+    // Consumes count items, which must be available.
+    void skip(size_t count)
+    {
+        readPosition.store(readPosition.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+    
+    // Copies out and consumes up to count items. Returns how many were read.
+    size_t read(T *items, size_t count)
+    {
+        size_t available = getReadAvailable();
+        if (count > available) count = available;
+        
+        const T *source = peek(count, items);
+        if (source != items) {
+            memcpy(items, source, count * sizeof(T));
+        }
+        
+        skip(count);
+        return count;
+    }
+    
+    // Consumes everything written so far.
+    void clear()
+    {
+        readPosition.store(writePosition.load(std::memory_order_acquire), std::memory_order_release);
+    }
+    
+    size_t getCapacity() const
+    {
+        return storage.size();
+    }
+    
+private:
+    
+    std::vector<T> storage;
+    size_t mask;
+    
+    std::atomic<size_t> writePosition;
+    std::atomic<size_t> readPosition;
+    
+private:
+    AIRingBuffer( const AIRingBuffer& );
+    void operator=( const AIRingBuffer& );
+};
+
+#endif /* RingBuffer_hpp */
@@ -0,0 +1,565 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AISampleKernels.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AI_SAMPLE_KERNELS_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AI_SAMPLE_KERNELS_SSE2 1
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define AI_SAMPLE_KERNELS_AVX2 1
+#define AI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#define AI_INT16_FLOAT_SCALE 32768.f
+#define AI_DITHER_SCALE (1.f / 65536.f)
+
+static inline uint32_t AIDitherNext(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// Difference of two uniform 16-bit draws: triangular over (-1, 1) LSB, exact in float.
+static inline float AIDitherSample(uint32_t *seed)
+{
+    int32_t a = (int32_t)(AIDitherNext(seed) >> 16);
+    int32_t b = (int32_t)(AIDitherNext(seed) >> 16);
+    return (float)(a - b) * AI_DITHER_SCALE;
+}
+
+static inline int16_t AIQuantizeSample(float value)
+{
+    if (value > 32767.f) {
+        value = 32767.f;
+    } else if (value < -32768.f) {
+        value = -32768.f;
+    }
+    return (int16_t)lrintf(value);
+}
+
+// MARK: - Scalar
+
+static void AIScalarInt16ToFloat(const int16_t *input, size_t count, float scale, float *output)
+{
+    for (size_t i = 0; i < count; i++) {
+        output[i] = (float)input[i] * scale;
+    }
+}
+
+static void AIScalarFloatToInt16(const float *input, size_t count, int16_t *output)
+{
+    for (size_t i = 0; i < count; i++) {
+        output[i] = AIQuantizeSample(input[i] * AI_INT16_FLOAT_SCALE);
+    }
+}
+
+static void AIScalarFloatToInt16DitheredFrom(const float *input, size_t start, size_t count, AIDitherState *state, int16_t *output)
+{
+    for (size_t i = start; i < count; i++) {
+        float scaled = input[i] * AI_INT16_FLOAT_SCALE;
+        output[i] = AIQuantizeSample(scaled + AIDitherSample(&state->seeds[i & 7]));
+    }
+}
+
+static void AIScalarFloatToInt16Dithered(const float *input, size_t count, AIDitherState *state, int16_t *output)
+{
+    AIScalarFloatToInt16DitheredFrom(input, 0, count, state, output);
+}
+
+static void AIScalarDownmixToMonoFrom(const float *input, unsigned channels, size_t start, size_t frames, float *output)
+{
+    if (channels == 1) {
+        memmove(output + start, input + start, (frames - start) * sizeof(float));
+        return;
+    }
+    
+    float scale = 1.f / channels;
+    
+    for (size_t i = start; i < frames; i++) {
+        const float *frame = input + i * channels;
+        float sum = 0;
+        for (unsigned c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        output[i] = sum * scale;
+    }
+}
+
+static void AIScalarDownmixToMono(const float *input, unsigned channels, size_t frames, float *output)
+{
+    AIScalarDownmixToMonoFrom(input, channels, 0, frames, output);
+}
+
+static void AIScalarApplyGain(float *samples, size_t count, float gain)
+{
+    for (size_t i = 0; i < count; i++) {
+        samples[i] *= gain;
+    }
+}
+
+static const AISampleKernels AIScalarKernels = {
+    "scalar",
+    AIScalarInt16ToFloat,
+    AIScalarFloatToInt16,
+    AIScalarFloatToInt16Dithered,
+    AIScalarDownmixToMono,
+    AIScalarApplyGain,
+};
+
+// MARK: - NEON
+
+#if AI_SAMPLE_KERNELS_NEON
+
+static void AINEONInt16ToFloat(const int16_t *input, size_t count, float scale, float *output)
+{
+    const float32x4_t factor = vdupq_n_f32(scale);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t samples = vld1q_s16(input + i);
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+        vst1q_f32(output + i, vmulq_f32(low, factor));
+        vst1q_f32(output + i + 4, vmulq_f32(high, factor));
+    }
+    
+    AIScalarInt16ToFloat(input + i, count - i, scale, output + i);
+}
+
+#if defined(__aarch64__)
+
+// vcvtnq rounds to nearest even like lrintf; 32-bit ARM only has the truncating conversion.
+static inline int16x4_t AINEONQuantize(float32x4_t values)
+{
+    values = vminq_f32(vmaxq_f32(values, vdupq_n_f32(-32768.f)), vdupq_n_f32(32767.f));
+    return vmovn_s32(vcvtnq_s32_f32(values));
+}
+
+static void AINEONFloatToInt16(const float *input, size_t count, int16_t *output)
+{
+    const float32x4_t factor = vdupq_n_f32(AI_INT16_FLOAT_SCALE);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        int16x4_t low = AINEONQuantize(vmulq_f32(vld1q_f32(input + i), factor));
+        int16x4_t high = AINEONQuantize(vmulq_f32(vld1q_f32(input + i + 4), factor));
+        vst1q_s16(output + i, vcombine_s16(low, high));
+    }
+    
+    AIScalarFloatToInt16(input + i, count - i, output + i);
+}
+
+static inline uint32x4_t AINEONDitherNext(uint32x4_t x)
+{
+    x = veorq_u32(x, vshlq_n_u32(x, 13));
+    x = veorq_u32(x, vshrq_n_u32(x, 17));
+    return veorq_u32(x, vshlq_n_u32(x, 5));
+}
+
+static inline float32x4_t AINEONDitherSample(uint32x4_t *seeds)
+{
+    uint32x4_t a = AINEONDitherNext(*seeds);
+    uint32x4_t b = AINEONDitherNext(a);
+    *seeds = b;
+    int32x4_t difference = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(a, 16)), vreinterpretq_s32_u32(vshrq_n_u32(b, 16)));
+    return vmulq_f32(vcvtq_f32_s32(difference), vdupq_n_f32(AI_DITHER_SCALE));
+}
+
+static void AINEONFloatToInt16Dithered(const float *input, size_t count, AIDitherState *state, int16_t *output)
+{
+    const float32x4_t factor = vdupq_n_f32(AI_INT16_FLOAT_SCALE);
+    uint32x4_t seedsLow = vld1q_u32(state->seeds);
+    uint32x4_t seedsHigh = vld1q_u32(state->seeds + 4);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t low = vaddq_f32(vmulq_f32(vld1q_f32(input + i), factor), AINEONDitherSample(&seedsLow));
+        float32x4_t high = vaddq_f32(vmulq_f32(vld1q_f32(input + i + 4), factor), AINEONDitherSample(&seedsHigh));
+        vst1q_s16(output + i, vcombine_s16(AINEONQuantize(low), AINEONQuantize(high)));
+    }
+    
+    vst1q_u32(state->seeds, seedsLow);
+    vst1q_u32(state->seeds + 4, seedsHigh);
+    
+    AIScalarFloatToInt16DitheredFrom(input, i, count, state, output);
+}
+
+#endif
+
+static void AINEONDownmixToMono(const float *input, unsigned channels, size_t frames, float *output)
+{
+    size_t i = 0;
+    
+    if (channels == 2) {
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x2_t frame = vld2q_f32(input + i * 2);
+            vst1q_f32(output + i, vmulq_f32(vaddq_f32(frame.val[0], frame.val[1]), half));
+        }
+    }
+    
+    AIScalarDownmixToMonoFrom(input, channels, i, frames, output);
+}
+
+static void AINEONApplyGain(float *samples, size_t count, float gain)
+{
+    const float32x4_t factor = vdupq_n_f32(gain);
+    size_t i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), factor));
+    }
+    
+    AIScalarApplyGain(samples + i, count - i, gain);
+}
+
+static const AISampleKernels AINEONKernels = {
+    "neon",
+    AINEONInt16ToFloat,
+#if defined(__aarch64__)
+    AINEONFloatToInt16,
+    AINEONFloatToInt16Dithered,
+#else
+    AIScalarFloatToInt16,
+    AIScalarFloatToInt16Dithered,
+#endif
+    AINEONDownmixToMono,
+    AINEONApplyGain,
+};
+
+#endif
+
+// MARK: - SSE2
+
+#if AI_SAMPLE_KERNELS_SSE2
+
+static inline __m128 AISSE2Clamp(__m128 values)
+{
+    return _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(-32768.f)), _mm_set1_ps(32767.f));
+}
+
+static void AISSE2Int16ToFloat(const int16_t *input, size_t count, float scale, float *output)
+{
+    const __m128 factor = _mm_set1_ps(scale);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i samples = _mm_loadu_si128((const __m128i *)(input + i));
+        // Interleave with themselves and shift back down to sign-extend.
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), factor));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factor));
+    }
+    
+    AIScalarInt16ToFloat(input + i, count - i, scale, output + i);
+}
+
+static void AISSE2FloatToInt16(const float *input, size_t count, int16_t *output)
+{
+    const __m128 factor = _mm_set1_ps(AI_INT16_FLOAT_SCALE);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i low = _mm_cvtps_epi32(AISSE2Clamp(_mm_mul_ps(_mm_loadu_ps(input + i), factor)));
+        __m128i high = _mm_cvtps_epi32(AISSE2Clamp(_mm_mul_ps(_mm_loadu_ps(input + i + 4), factor)));
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packs_epi32(low, high));
+    }
+    
+    AIScalarFloatToInt16(input + i, count - i, output + i);
+}
+
+static inline __m128i AISSE2DitherNext(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+static inline __m128 AISSE2DitherSample(__m128i *seeds)
+{
+    __m128i a = AISSE2DitherNext(*seeds);
+    __m128i b = AISSE2DitherNext(a);
+    *seeds = b;
+    __m128i difference = _mm_sub_epi32(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16));
+    return _mm_mul_ps(_mm_cvtepi32_ps(difference), _mm_set1_ps(AI_DITHER_SCALE));
+}
+
+static void AISSE2FloatToInt16Dithered(const float *input, size_t count, AIDitherState *state, int16_t *output)
+{
+    const __m128 factor = _mm_set1_ps(AI_INT16_FLOAT_SCALE);
+    __m128i seedsLow = _mm_loadu_si128((const __m128i *)state->seeds);
+    __m128i seedsHigh = _mm_loadu_si128((const __m128i *)(state->seeds + 4));
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128 low = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i), factor), AISSE2DitherSample(&seedsLow));
+        __m128 high = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), factor), AISSE2DitherSample(&seedsHigh));
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(AISSE2Clamp(low)), _mm_cvtps_epi32(AISSE2Clamp(high)));
+        _mm_storeu_si128((__m128i *)(output + i), packed);
+    }
+    
+    _mm_storeu_si128((__m128i *)state->seeds, seedsLow);
+    _mm_storeu_si128((__m128i *)(state->seeds + 4), seedsHigh);
+    
+    AIScalarFloatToInt16DitheredFrom(input, i, count, state, output);
+}
+
+static void AISSE2DownmixToMono(const float *input, unsigned channels, size_t frames, float *output)
+{
+    size_t i = 0;
+    
+    if (channels == 2) {
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(input + i * 2);
+            __m128 b = _mm_loadu_ps(input + i * 2 + 4);
+            __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+        }
+    }
+    
+    AIScalarDownmixToMonoFrom(input, channels, i, frames, output);
+}
+
+static void AISSE2ApplyGain(float *samples, size_t count, float gain)
+{
+    const __m128 factor = _mm_set1_ps(gain);
+    size_t i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), factor));
+    }
+    
+    AIScalarApplyGain(samples + i, count - i, gain);
+}
+
+static const AISampleKernels AISSE2Kernels = {
+    "sse2",
+    AISSE2Int16ToFloat,
+    AISSE2FloatToInt16,
+    AISSE2FloatToInt16Dithered,
+    AISSE2DownmixToMono,
+    AISSE2ApplyGain,
+};
+
+#endif
+
+// MARK: - AVX2
+
+#if AI_SAMPLE_KERNELS_AVX2
+
+AI_TARGET_AVX2 static inline __m256 AIAVX2Clamp(__m256 values)
+{
+    return _mm256_min_ps(_mm256_max_ps(values, _mm256_set1_ps(-32768.f)), _mm256_set1_ps(32767.f));
+}
+
+// packs works within 128-bit lanes, so the quadwords come out as 0, 2, 1, 3.
+AI_TARGET_AVX2 static inline __m256i AIAVX2Pack(__m256 low, __m256 high)
+{
+    __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(AIAVX2Clamp(low)), _mm256_cvtps_epi32(AIAVX2Clamp(high)));
+    return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+AI_TARGET_AVX2 static void AIAVX2Int16ToFloat(const int16_t *input, size_t count, float scale, float *output)
+{
+    const __m256 factor = _mm256_set1_ps(scale);
+    size_t i = 0;
+    
+    for (; i + 16 <= count; i += 16) {
+        __m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(input + i)));
+        __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(input + i + 8)));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), factor));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), factor));
+    }
+    
+    AIScalarInt16ToFloat(input + i, count - i, scale, output + i);
+}
+
+AI_TARGET_AVX2 static void AIAVX2FloatToInt16(const float *input, size_t count, int16_t *output)
+{
+    const __m256 factor = _mm256_set1_ps(AI_INT16_FLOAT_SCALE);
+    size_t i = 0;
+    
+    for (; i + 16 <= count; i += 16) {
+        __m256 low = _mm256_mul_ps(_mm256_loadu_ps(input + i), factor);
+        __m256 high = _mm256_mul_ps(_mm256_loadu_ps(input + i + 8), factor);
+        _mm256_storeu_si256((__m256i *)(output + i), AIAVX2Pack(low, high));
+    }
+    
+    AIScalarFloatToInt16(input + i, count - i, output + i);
+}
+
+AI_TARGET_AVX2 static inline __m256i AIAVX2DitherNext(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+    return _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+}
+
+AI_TARGET_AVX2 static inline __m256 AIAVX2DitherSample(__m256i *seeds)
+{
+    __m256i a = AIAVX2DitherNext(*seeds);
+    __m256i b = AIAVX2DitherNext(a);
+    *seeds = b;
+    __m256i difference = _mm256_sub_epi32(_mm256_srli_epi32(a, 16), _mm256_srli_epi32(b, 16));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(difference), _mm256_set1_ps(AI_DITHER_SCALE));
+}
+
+// One register holds all eight generators, so each needs two draws per 16 samples, in the scalar order.
+AI_TARGET_AVX2 static void AIAVX2FloatToInt16Dithered(const float *input, size_t count, AIDitherState *state, int16_t *output)
+{
+    const __m256 factor = _mm256_set1_ps(AI_INT16_FLOAT_SCALE);
+    __m256i seeds = _mm256_loadu_si256((const __m256i *)state->seeds);
+    size_t i = 0;
+    
+    for (; i + 16 <= count; i += 16) {
+        __m256 low = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), factor), AIAVX2DitherSample(&seeds));
+        __m256 high = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), factor), AIAVX2DitherSample(&seeds));
+        _mm256_storeu_si256((__m256i *)(output + i), AIAVX2Pack(low, high));
+    }
+    
+    _mm256_storeu_si256((__m256i *)state->seeds, seeds);
+    
+    AIScalarFloatToInt16DitheredFrom(input, i, count, state, output);
+}
+
+AI_TARGET_AVX2 static void AIAVX2DownmixToMono(const float *input, unsigned channels, size_t frames, float *output)
+{
+    size_t i = 0;
+    
+    if (channels == 2) {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        for (; i + 8 <= frames; i += 8) {
+            __m256 a = _mm256_loadu_ps(input + i * 2);
+            __m256 b = _mm256_loadu_ps(input + i * 2 + 8);
+            // shuffle works within 128-bit lanes, so frames come out as 0, 1, 4, 5, 2, 3, 6, 7.
+            __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256d mono = _mm256_castps_pd(_mm256_mul_ps(_mm256_add_ps(left, right), half));
+            _mm256_storeu_ps(output + i, _mm256_castpd_ps(_mm256_permute4x64_pd(mono, _MM_SHUFFLE(3, 1, 2, 0))));
+        }
+    }
+    
+    AIScalarDownmixToMonoFrom(input, channels, i, frames, output);
+}
+
+AI_TARGET_AVX2 static void AIAVX2ApplyGain(float *samples, size_t count, float gain)
+{
+    const __m256 factor = _mm256_set1_ps(gain);
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), factor));
+    }
+    
+    AIScalarApplyGain(samples + i, count - i, gain);
+}
+
+static const AISampleKernels AIAVX2Kernels = {
+    "avx2",
+    AIAVX2Int16ToFloat,
+    AIAVX2FloatToInt16,
+    AIAVX2FloatToInt16Dithered,
+    AIAVX2DownmixToMono,
+    AIAVX2ApplyGain,
+};
+
+static bool AISupportsAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+// MARK: - Dispatch
+
+size_t AISampleKernelsGetAvailable(const AISampleKernels **kernels, size_t capacity)
+{
+    const AISampleKernels *available[4];
+    size_t count = 0;
+    
+    available[count++] = &AIScalarKernels;
+#if AI_SAMPLE_KERNELS_NEON
+    available[count++] = &AINEONKernels;
+#endif
+#if AI_SAMPLE_KERNELS_SSE2
+    available[count++] = &AISSE2Kernels;
+#endif
+#if AI_SAMPLE_KERNELS_AVX2
+    if (AISupportsAVX2()) {
+        available[count++] = &AIAVX2Kernels;
+    }
+#endif
+    
+    for (size_t i = 0; i < count && i < capacity; i++) {
+        kernels[i] = available[i];
+    }
+    
+    return count;
+}
+
+const AISampleKernels *AISampleKernelsGetScalar(void)
+{
+    return &AIScalarKernels;
+}
+
+// Implementations are listed slowest first.
+static const AISampleKernels *AIFastestSampleKernels()
+{
+    const AISampleKernels *available[4];
+    size_t count = AISampleKernelsGetAvailable(available, 4);
+    return available[(count < 4 ? count : 4) - 1];
+}
+
+const AISampleKernels *AISampleKernelsGetDefault(void)
+{
+    static const AISampleKernels *fastest = AIFastestSampleKernels();
+    return fastest;
+}
+
+void AIDitherStateInit(AIDitherState *state, uint32_t seed)
+{
+    // Spread one seed over the lanes with splitmix32; xorshift must never start from zero.
+    for (unsigned i = 0; i < 8; i++) {
+        uint32_t z = (seed += 0x9E3779B9u);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        state->seeds[i] = z ? z : 0x6D2B79F5u;
+    }
+}
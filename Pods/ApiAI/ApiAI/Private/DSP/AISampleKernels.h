@@ -0,0 +1,80 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef SampleKernels_h
+#define SampleKernels_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Eight independent xorshift32 generators. Sample i of a call draws from seeds[i % 8], which is how the SIMD
+ * implementations lay out their lanes, so every implementation produces the same dithered output.
+ */
+typedef struct _AIDitherState {
+    uint32_t seeds[8];
+} AIDitherState;
+
+/*
+ * Sample-format and channel-layout kernels shared by the capture, analysis and conversion stages.
+ *
+ * Every implementation gives bit-identical results to the scalar one: float to int16 rounds to nearest with ties to
+ * even and saturates, and no step is fused. Buffers need no particular alignment.
+ */
+typedef struct _AISampleKernels {
+    const char *name;
+    
+    // output[i] = input[i] * scale
+    void (*int16ToFloat)(const int16_t *input, size_t count, float scale, float *output);
+    
+    // Rounds input[i] * 32768.
+    void (*floatToInt16)(const float *input, size_t count, int16_t *output);
+    
+    // Rounds input[i] * 32768 after adding triangular dither of +-1 LSB.
+    void (*floatToInt16Dithered)(const float *input, size_t count, AIDitherState *state, int16_t *output);
+    
+    // Averages every interleaved frame of channels samples into one sample.
+    void (*downmixToMono)(const float *input, unsigned channels, size_t frames, float *output);
+    
+    void (*applyGain)(float *samples, size_t count, float gain);
+} AISampleKernels;
+
+// Fastest implementation the running CPU supports, chosen on first use.
+const AISampleKernels *AISampleKernelsGetDefault(void);
+
+// Portable reference implementation.
+const AISampleKernels *AISampleKernelsGetScalar(void);
+
+// Fills kernels with every implementation usable on this CPU, scalar first, and returns how many there are.
+size_t AISampleKernelsGetAvailable(const AISampleKernels **kernels, size_t capacity);
+
+void AIDitherStateInit(AIDitherState *state, uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SampleKernels_h */
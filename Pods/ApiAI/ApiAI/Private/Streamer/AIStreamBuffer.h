@@ -23,6 +23,9 @@
 
 #import "AIStreamBufferDelegate.h"
 
+// written is NO when the buffer was closed before the data could be handed to the output stream.
+typedef void(^AIStreamBufferWriteCompletion)(BOOL written);
+
 @interface AIStreamBuffer : NSObject
 
 - (instancetype)init __unavailable;
@@ -32,6 +35,11 @@
 
 - (void)open;
 - (void)write:(NSData *)data;
+
+// The completion is called on the stream's run loop once every byte of data has been handed to the output stream.
+// Closing the buffer calls the completions still waiting, and a write after close calls its own at once, with NO.
+- (void)write:(NSData *)data completion:(AIStreamBufferWriteCompletion)completion;
+
 - (void)close;
 - (void)flushAndClose;
 
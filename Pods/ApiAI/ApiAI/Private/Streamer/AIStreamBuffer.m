@@ -21,19 +21,27 @@
 
 #import "AIStreamBuffer.h"
 
+// Already written bytes are dropped from the front of the buffer once this many have accumulated.
+#define AI_STREAM_BUFFER_COMPACTION_THRESHOLD 65536
+
 @interface AIStreamBuffer () <NSStreamDelegate>
 
 @property(nonatomic, strong) NSOutputStream *outputStream;
 @property(nonatomic, strong) NSMutableData *data;
+@property(nonatomic, strong) NSMutableArray *completions;
 
 @property(nonatomic, assign) BOOL waitForFlush;
 @property(nonatomic, assign) BOOL opened;
 
+// Set by close; later writes are dropped.
+@property(nonatomic, assign) BOOL closed;
+
 @end
 
 @implementation AIStreamBuffer
 {
     NSUInteger _offset;
+    NSUInteger _compactedLength;
     dispatch_queue_t mutex;
 }
 
@@ -59,8 +67,11 @@
     }
     
     self.data = [NSMutableData data];
+    self.completions = [NSMutableArray array];
     _offset = 0;
+    _compactedLength = 0;
     self.waitForFlush = NO;
+    self.closed = NO;
     
     [_outputStream scheduleInRunLoop:[NSRunLoop mainRunLoop] forMode:NSDefaultRunLoopMode];
     [_outputStream open];
@@ -68,10 +79,32 @@
 
 - (void)write:(NSData *)data
 {
+    [self write:data completion:nil];
+}
+
+- (void)write:(NSData *)data completion:(AIStreamBufferWriteCompletion)completion
+{
+    __block BOOL accepted = NO;
+    
     dispatch_sync(mutex, ^{
+        if (_closed) {
+            return;
+        }
+        
+        accepted = YES;
         [_data appendData:data];
+        
+        if (completion) {
+            // Completions are keyed by the absolute stream position of the last byte they wait for.
+            [_completions addObject:@[@(_compactedLength + _data.length), [completion copy]]];
+        }
     });
     
+    if (!accepted) {
+        if (completion) completion(NO);
+        return;
+    }
+    
     if ([_outputStream hasSpaceAvailable] && _opened) {
         [self flush];
     }
@@ -87,6 +120,9 @@
 
 - (void)flush
 {
+    __block NSArray *finishedCompletions = nil;
+    __block BOOL failed = NO;
+    
     dispatch_sync(mutex, ^{
     if ([self hasBytesForWriting]) {
         NSUInteger availableLen = _data.length - _offset;
@@ -95,19 +131,66 @@
         NSInteger writtenBytes = [_outputStream write:buffer maxLength:availableLen];
         
         if (writtenBytes < 0) {
-            NSError *error = _outputStream.streamError;
-            
-            if ([_delegate respondsToSelector:@selector(streamBuffer:error:)]) {
-                [_delegate streamBuffer:self error:error];
-            }
-            
-            [self close];
-            
+            failed = YES;
         } else {
             _offset += writtenBytes;
+            
+            finishedCompletions = [self takeCompletionsUpToPosition:_compactedLength + _offset];
+            
+            [self compact];
         }
     }
     });
+    
+    // Outside the mutex: close takes it to fail the completions still waiting.
+    if (failed) {
+        NSError *error = _outputStream.streamError;
+        
+        if ([_delegate respondsToSelector:@selector(streamBuffer:error:)]) {
+            [_delegate streamBuffer:self error:error];
+        }
+        
+        [self close];
+    }
+    
+    for (AIStreamBufferWriteCompletion completion in finishedCompletions) {
+        completion(YES);
+    }
+}
+
+- (NSArray *)takeCompletionsUpToPosition:(NSUInteger)position
+{
+    NSUInteger count = 0;
+    
+    while (count < _completions.count && [_completions[count][0] unsignedIntegerValue] <= position) {
+        count++;
+    }
+    
+    if (count == 0) {
+        return nil;
+    }
+    
+    NSMutableArray *completions = [NSMutableArray arrayWithCapacity:count];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        [completions addObject:_completions[i][1]];
+    }
+    
+    [_completions removeObjectsInRange:NSMakeRange(0, count)];
+    
+    return completions;
+}
+
+- (void)compact
+{
+    if (_offset < AI_STREAM_BUFFER_COMPACTION_THRESHOLD && _offset < _data.length) {
+        return;
+    }
+    
+    [_data replaceBytesInRange:NSMakeRange(0, _offset) withBytes:NULL length:0];
+    
+    _compactedLength += _offset;
+    _offset = 0;
 }
 
 - (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode
@@ -154,6 +237,19 @@
 
 - (void)close
 {
+    __block NSArray *abandonedCompletions = nil;
+    __block BOOL alreadyClosed = NO;
+    
+    dispatch_sync(mutex, ^{
+        alreadyClosed = _closed;
+        _closed = YES;
+        abandonedCompletions = [self takeCompletionsUpToPosition:NSUIntegerMax];
+    });
+    
+    if (alreadyClosed) {
+        return;
+    }
+    
     if ([_delegate respondsToSelector:@selector(willCloseStreamBuffer:)]) {
         [_delegate willCloseStreamBuffer:self];
     }
@@ -164,6 +260,11 @@
     if ([_delegate respondsToSelector:@selector(didCloseStreamBuffer:)]) {
         [_delegate didCloseStreamBuffer:self];
     }
+    
+    // Whoever waits for these, such as a converter paused for room in the buffer, must not wait forever.
+    for (AIStreamBufferWriteCompletion completion in abandonedCompletions) {
+        completion(NO);
+    }
 }
 
 - (void)flushAndClose
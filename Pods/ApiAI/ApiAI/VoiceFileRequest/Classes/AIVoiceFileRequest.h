@@ -7,6 +7,7 @@
 //
 
 #import "AIQueryRequest.h"
+#import "AIVoiceAudioFormat.h"
 
 /*!
  API.AI speech recognition is going to be deprecated soon.
@@ -22,4 +23,7 @@ AI_DEPRECATED_MSG_ATTRIBUTE("Will be removed on 1 Feb 2016.")
 
 @property(nonatomic, copy) NSString *contentType AI_DEPRECATED_ATTRIBUTE;
 
+// Encoding used when the request converts an audio file while uploading it. Default is AIVoiceAudioFormatPCM.
+@property(nonatomic, assign) AIVoiceAudioFormat audioFormat AI_DEPRECATED_ATTRIBUTE;
+
 @end
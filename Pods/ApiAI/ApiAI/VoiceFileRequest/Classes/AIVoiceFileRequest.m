@@ -13,6 +13,21 @@
 #import "AIDataService_Private.h"
 #import "AIResponseConstants.h"
 #import "AIRequest_Private.h"
+#import "AIVoiceEncoder.h"
+
+#if __has_include("AIAudioFileConvertOperation.h")
+    #import "AIAudioFileConvertOperation.h"
+    #define AI_SUPPORT_CONVERSION_PIPELINE 1
+#endif
+
+// AIAudioFileConvertOperation always produces 16 kHz mono.
+#define AI_CONVERSION_PIPELINE_SAMPLE_RATE 16000.
+
+// Number of converted blocks that may wait in the stream buffer before the converter is paused.
+#define AI_CONVERSION_PIPELINE_DEPTH 4
+
+// How often a paused converter checks whether the request went away.
+#define AI_CONVERSION_PIPELINE_POLL_INTERVAL (100 * NSEC_PER_MSEC)
 
 @interface AIVoiceFileRequest () <NSStreamDelegate>
 
@@ -21,6 +36,13 @@
 @property(nonatomic, strong) AIStreamBuffer *streamBuffer;
 @property(nonatomic, copy) NSString *boundary;
 
+#if AI_SUPPORT_CONVERSION_PIPELINE
+@property(nonatomic, strong) NSOperationQueue *conversionQueue;
+@property(nonatomic, strong) AIAudioFileConvertOperation *conversionOperation;
+@property(nonatomic, copy) NSError *conversionError;
+@property(nonatomic, strong) AIVoiceEncoder *encoder;
+#endif
+
 @end
 
 @implementation AIVoiceFileRequest
@@ -104,6 +126,13 @@
     [data appendData:[[NSString stringWithFormat:@"\r\n--%@\r\n", _boundary] dataUsingEncoding:NSUTF8StringEncoding]];
     [data appendData:[@"Content-Disposition: form-data; name=\"voiceData\"; filename=\"recording.mp4\"\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
     
+#if AI_SUPPORT_CONVERSION_PIPELINE
+    if (_sourceFileURL) {
+        self.encoder = [[AIVoiceEncoder alloc] initWithFormat:_audioFormat sampleRate:AI_CONVERSION_PIPELINE_SAMPLE_RATE];
+        self.contentType = _encoder.contentType;
+    }
+#endif
+    
     NSString *contentType = [NSString stringWithFormat:@"Content-Type: %@\r\n\r\n", self.contentType?:@"audio/wav"];
     
     [data appendData:[contentType dataUsingEncoding:NSUTF8StringEncoding]];
@@ -114,12 +143,120 @@
     [dataTask resume];
     
     [_streamBuffer write:data];
+    
+#if AI_SUPPORT_CONVERSION_PIPELINE
+    if (_sourceFileURL) {
+        [self startConversionPipeline];
+        return;
+    }
+#endif
 
     [_inputStream setDelegate:self];
     [_inputStream scheduleInRunLoop:[NSRunLoop mainRunLoop] forMode:NSDefaultRunLoopMode];
     [_inputStream open];
 }
 
+#if AI_SUPPORT_CONVERSION_PIPELINE
+- (void)startConversionPipeline
+{
+    // The converter blocks once AI_CONVERSION_PIPELINE_DEPTH blocks are queued and resumes as the stream buffer
+    // hands them to the connection, so memory stays bounded and the upload starts with the first converted block.
+    dispatch_semaphore_t slots = dispatch_semaphore_create(AI_CONVERSION_PIPELINE_DEPTH);
+    
+    // Only touched from the conversion thread: by the output handler and then by the completion block.
+    AIVoiceEncoder *encoder = _encoder;
+    
+    __weak typeof(self) selfWeak = self;
+    
+    // Lets the stream buffer stop the converter once it is closed and can take no more blocks.
+    __block __weak AIAudioFileConvertOperation *operationWeak = nil;
+    
+    AIAudioFileConvertOperation *operation =
+    [[AIAudioFileConvertOperation alloc] initWithSourceFileURL:_sourceFileURL
+                                                 outputHandler:^BOOL(NSData *data) {
+                                                     while (dispatch_semaphore_wait(slots, dispatch_time(DISPATCH_TIME_NOW, AI_CONVERSION_PIPELINE_POLL_INTERVAL))) {
+                                                         if (!selfWeak || selfWeak.conversionOperation.isCancelled) {
+                                                             return NO;
+                                                         }
+                                                     }
+                                                     
+                                                     if (operationWeak.isCancelled) {
+                                                         return NO;
+                                                     }
+                                                     
+                                                     NSData *encoded = [encoder encodeSamples:data];
+                                                     
+                                                     dispatch_async(dispatch_get_main_queue(), ^{
+                                                         [selfWeak.streamBuffer write:encoded completion:^(BOOL written) {
+                                                             if (!written) {
+                                                                 [operationWeak cancel];
+                                                             }
+                                                             
+                                                             dispatch_semaphore_signal(slots);
+                                                         }];
+                                                     });
+                                                     
+                                                     return YES;
+                                                 }];
+    
+    operation.outputIncludesWAVHeader = encoder.format == AIVoiceAudioFormatPCM;
+    
+    operationWeak = operation;
+    
+    operation.completionBlock = ^{
+        NSError *error = operationWeak.error;
+        BOOL cancelled = operationWeak.isCancelled;
+        NSData *tail = [encoder finish];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [selfWeak finishConversionPipelineWithTail:tail error:error cancelled:cancelled];
+        });
+    };
+    
+    self.conversionOperation = operation;
+    
+    self.conversionQueue = [[NSOperationQueue alloc] init];
+    [_conversionQueue addOperation:operation];
+}
+
+- (void)finishConversionPipelineWithTail:(NSData *)tail error:(NSError *)error cancelled:(BOOL)cancelled
+{
+    self.conversionOperation = nil;
+    self.conversionQueue = nil;
+    
+    if (cancelled) {
+        return;
+    }
+    
+    if (error) {
+        // The data task reports the cancellation, which is replaced by the conversion error in handleError:.
+        self.conversionError = error;
+        [self.dataTask cancel];
+        [_streamBuffer close];
+        return;
+    }
+    
+    [_streamBuffer write:tail];
+    [_streamBuffer write:[[NSString stringWithFormat:@"\r\n--%@--\r\n", _boundary] dataUsingEncoding:NSUTF8StringEncoding]];
+    [_streamBuffer flushAndClose];
+}
+
+- (void)handleError:(NSError *)error
+{
+    // A failed upload must not leave the converter waiting for room in a buffer nobody drains.
+    [_conversionOperation cancel];
+    [_streamBuffer close];
+    
+    [super handleError:_conversionError ?: error];
+}
+
+- (void)cancelHTTPRequest
+{
+    [_conversionOperation cancel];
+    [super cancelHTTPRequest];
+}
+#endif
+
 - (NSDictionary *)defaultHeaders
 {
     NSMutableDictionary *headers = [[super defaultHeaders] mutableCopy];
@@ -192,6 +329,9 @@
 
 - (void)dealloc
 {
+#if AI_SUPPORT_CONVERSION_PIPELINE
+    [_conversionOperation cancel];
+#endif
     [_inputStream close];
 }
 
@@ -12,4 +12,7 @@
 
 @property(nonatomic, strong) NSInputStream *inputStream;
 
+// When set, the file is converted to 16 kHz WAV while it is being uploaded instead of being read from inputStream.
+@property(nonatomic, copy) NSURL *sourceFileURL;
+
 @end
@@ -19,6 +19,8 @@
  *
  ***********************************************************************************************************************/
 #import "AIQueryRequest.h"
+#import "AIVoiceAudioFormat.h"
+#import "AIVoiceCaptureConversion.h"
 
 /*!
  * Sound level handler definition for AIVoiceRequest.
@@ -89,6 +91,26 @@ AI_DEPRECATED_MSG_ATTRIBUTE("Will be removed on 1 Feb 2016.")
  */
 @property(nonatomic, assign) BOOL useVADForAutoCommit AI_DEPRECATED_ATTRIBUTE;
 
+/*!
+ 
+ @property audioFormat
+ 
+ @discussion Encoding of the uploaded recording. Default is AIVoiceAudioFormatPCM.
+ 
+ */
+@property(nonatomic, assign) AIVoiceAudioFormat audioFormat AI_DEPRECATED_ATTRIBUTE;
+
+/*!
+ 
+ @property captureConversion
+ 
+ @discussion How the microphone's audio is brought to 16 kHz: by the system, or captured at the hardware rate and
+ decimated with the chosen alias rejection and delay. Applies from the next recording. Default is
+ AIVoiceCaptureConversionSystem.
+ 
+ */
+@property(nonatomic, assign) AIVoiceCaptureConversion captureConversion AI_DEPRECATED_ATTRIBUTE;
+
 /*!
  * Manually stop listening and send request to server.
  */
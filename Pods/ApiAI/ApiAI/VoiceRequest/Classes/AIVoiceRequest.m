@@ -29,6 +29,8 @@
 #import "AIQueryRequest+Private.h"
 #import "AIRequest_Private.h"
 #import "AiOriginalRequest_Private.h"
+#import "AIVoiceEncoder.h"
+#import "AISoundRecorderConstants.h"
 
 #import "AIResponseConstants.h"
 
@@ -47,18 +49,20 @@
 @property(nonatomic, strong) NSInputStream *input;
 @property(nonatomic, strong) AIRecordDetector *recordDetector;
 @property(nonatomic, strong) AIStreamBuffer *streamBuffer;
+@property(nonatomic, strong) AIVoiceEncoder *encoder;
 @property(nonatomic, copy) NSString *boundary;
 
 @property(nonnull, strong) NSURLSession *session;
 
 - (void)callSuperStart;
+- (void)beepDidFinish;
 
 @end
 
 static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void* __nullable clientData) {
     AIVoiceRequest *request = (__bridge AIVoiceRequest *)clientData;
     
-    [request callSuperStart];
+    [request beepDidFinish];
     
     AudioServicesRemoveSystemSoundCompletion(ssID);
     AudioServicesDisposeSystemSoundID(ssID);
@@ -164,6 +168,10 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
 
         OSStatus status = AudioServicesCreateSystemSoundID((__bridge CFURLRef _Nonnull)(audioFileURL), &soundID);
         if (status == noErr) {
+                // Capture runs while the beep plays, so speech over it is kept; it is uploaded once the request is set up.
+                [_recordDetector beginEchoSuppression];
+                [_recordDetector startPreRoll];
+                
                 AudioServicesAddSystemSoundCompletion(soundID,
                                                       CFRunLoopGetMain(),
                                                       kCFRunLoopDefaultMode,
@@ -182,6 +190,23 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
     [super start];
 }
 
+- (void)beepDidFinish {
+    [_recordDetector endEchoSuppression];
+    
+    if (self.isCancelled) {
+        return;
+    }
+    
+    [self callSuperStart];
+}
+
+- (void)cancel
+{
+    // The microphone may already be open for the pre-roll.
+    [_recordDetector cancel];
+    [super cancel];
+}
+
 - (NSDictionary *)defaultHeaders
 {
     NSMutableDictionary *headers = [[super defaultHeaders] mutableCopy];
@@ -243,7 +268,12 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
 
     [data appendData:[[NSString stringWithFormat:@"\r\n--%@\r\n", _boundary] dataUsingEncoding:NSUTF8StringEncoding]];
     [data appendData:[@"Content-Disposition: form-data; name=\"voiceData\"; filename=\"-\"\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
-    [data appendData:[@"Content-Type: audio/wav\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    
+    self.encoder = [[AIVoiceEncoder alloc] initWithFormat:_audioFormat sampleRate:kSampleRate];
+    
+    NSString *contentType = [NSString stringWithFormat:@"Content-Type: %@\r\n\r\n", _encoder.contentType];
+    
+    [data appendData:[contentType dataUsingEncoding:NSUTF8StringEncoding]];
 
     [self.dataTask resume];
     
@@ -258,6 +288,16 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
     self.recordDetector.VADListening = useVADForAutoCommit;
 }
 
+- (AIVoiceCaptureConversion)captureConversion
+{
+    return self.recordDetector.captureConversion;
+}
+
+- (void)setCaptureConversion:(AIVoiceCaptureConversion)captureConversion
+{
+    self.recordDetector.captureConversion = captureConversion;
+}
+
 - (NSString *)creteBoundary
 {
     return [NSString stringWithFormat:@"Boundary+%08X%08X", arc4random(), arc4random()];;
@@ -300,12 +340,17 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
 
 - (void)recordDetector:(AIRecordDetector *)helper didReceiveData:(NSData *)data power:(float)power
 {
-    if (self.soundLevelHandleBlock) {
-        _soundLevelHandleBlock(self, power);
-    }
+    // Encoding stays on the analysis thread; only the level and the encoded bytes go to the main thread.
+    NSData *encoded = [_encoder encodeSamples:data];
     
     dispatch_async(dispatch_get_main_queue(), ^{
-        [_streamBuffer write:data];
+        if (self.soundLevelHandleBlock) {
+            _soundLevelHandleBlock(self, power);
+        }
+        
+        if (encoded.length) {
+            [_streamBuffer write:encoded];
+        }
     });
 }
 
@@ -318,6 +363,14 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
 
 - (void)recordDetectorDidStopRecording:(AIRecordDetector *)helper cancelled:(BOOL)cancelled
 {
+    // A cancelled recording is not uploaded: the body is left unterminated and the request is not told it ended.
+    if (cancelled) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [_streamBuffer close];
+        });
+        return;
+    }
+    
     [self commitVoice];
     
     if (self.soundRecordEndBlock) {
@@ -329,8 +382,12 @@ static void MyAudioServicesSystemSoundCompletionProc( SystemSoundID ssID, void*
 {
     [_recordDetector stop];
     
-    [_streamBuffer write:[[NSString stringWithFormat:@"\r\n--%@--\r\n", _boundary] dataUsingEncoding:NSUTF8StringEncoding]];
-    [_streamBuffer flushAndClose];
+    // Stopping waits for the analysis thread, so every encoded write it queued is already ahead of this block.
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [_streamBuffer write:[_encoder finish]];
+        [_streamBuffer write:[[NSString stringWithFormat:@"\r\n--%@--\r\n", _boundary] dataUsingEncoding:NSUTF8StringEncoding]];
+        [_streamBuffer flushAndClose];
+    });
 }
 
 - (void)recordDetector:(AIRecordDetector *)helper didFailWithError:(NSError *)error
@@ -42,4 +42,8 @@
 
 + (instancetype)algorithmWithClassName:(NSString *)className;
 
+// Processes one frame of float samples without boxing them. The default implementation wraps them in NSNumbers and
+// calls processFrame:, so detectors only need to override it when they can do better.
+- (AIAlgorithmDetectorResult)processSamples:(const float *)samples count:(NSUInteger)count;
+
 @end
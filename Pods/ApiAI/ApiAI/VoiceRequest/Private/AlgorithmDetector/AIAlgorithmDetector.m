@@ -39,6 +39,16 @@
                                  userInfo:nil];
 }
 
+- (AIAlgorithmDetectorResult)processSamples:(const float *)samples count:(NSUInteger)count
+{
+    NSMutableArray *frame = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [frame addObject:@(samples[i])];
+    }
+    
+    return [self processFrame:frame];
+}
+
 + (instancetype)algorithmWithClassName:(NSString *)className
 {
     Class class = NSClassFromString(className);
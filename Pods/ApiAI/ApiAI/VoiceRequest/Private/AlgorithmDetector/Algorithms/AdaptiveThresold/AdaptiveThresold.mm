@@ -19,58 +19,54 @@
  *
  ***********************************************************************************************************************/
 
-#import "AIMeterTable.h"
-#import "AIAudioUtils.h"
+#import "AdaptiveThresold.h"
 
-#define kMinDBvalue -80.f
-#define kTableSize 400
-#define kRoot 2.f
+#include "AIAdaptiveThresholdDetector.hpp"
 
-@implementation AIMeterTable
+#include <vector>
+
+@implementation AdaptiveThresold
 {
-    float mMinDecibels;
-    float mDecibelResolution;
-    float mScaleFactor;
-    
-    float *mTable;
+    AIAdaptiveThresholdDetector _detector;
+    std::vector<float> _samples;
 }
 
 - (id)init
 {
     self = [super init];
     if (self) {
-        mMinDecibels = kMinDBvalue;
-        mDecibelResolution = mMinDecibels / (kTableSize - 1);
-        mScaleFactor = 1 / mDecibelResolution;
-        
-        mTable = (float *)malloc(kTableSize * sizeof(float));
-        
-        double minAmp = AIDbToAmpMy(mMinDecibels);
-        double ampRange = 1. - minAmp;
-        double invAmpRange = 1. / ampRange;
-        
-        double rroot = 1. / kRoot;
-        for (size_t i = 0; i < kTableSize; ++i) {
-            double decibels = i * mDecibelResolution;
-            double amp = AIDbToAmpMy(decibels);
-            double adjAmp = (amp - minAmp) * invAmpRange;
-            mTable[i] = pow(adjAmp, rroot);
-        }
+        [self reset];
+        _samples.reserve(_detector.getFrameSize());
     }
+    
     return self;
 }
 
-- (float)valueAt:(float)decibels
+- (AIAlgorithmDetectorResult)processFrame:(NSArray *)data
 {
-    if (decibels < mMinDecibels) return  0.;
-    if (decibels >= 0.) return 1.;
-    int index = (int)(decibels * mScaleFactor);
-    return mTable[index];
+    _samples.clear();
+    for (NSNumber *value in data) {
+        _samples.push_back([value floatValue]);
+    }
+    
+    return [self processSamples:_samples.data() count:_samples.size()];
+}
+
+- (AIAlgorithmDetectorResult)processSamples:(const float *)samples count:(NSUInteger)count
+{
+    AIAlgorithmDetectorResult result = (AIAlgorithmDetectorResult)_detector.process(samples, count);
+    
+    if (result != AIAlgorithmDetectorResultContinue) {
+        [_delegate endDetection:self withStatus:result];
+    }
+    
+    return result;
 }
 
-- (void)dealloc
+- (void)reset
 {
-    free(mTable);
+    _detector.reset();
+    self.frameSize = _detector.getFrameSize();
 }
 
 @end
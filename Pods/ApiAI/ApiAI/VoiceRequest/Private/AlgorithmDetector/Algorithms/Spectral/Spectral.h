@@ -19,11 +19,9 @@
  *
  ***********************************************************************************************************************/
 
-#import <Foundation/Foundation.h>
 
-@interface AIMeterTable : NSObject
+#import "AIAlgorithmDetector.h"
 
-- (float)valueAt:(float)decibels;
-- (id)init;
+@interface Spectral : AIAlgorithmDetector
 
 @end
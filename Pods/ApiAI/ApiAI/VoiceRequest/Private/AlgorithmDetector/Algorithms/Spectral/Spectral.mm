@@ -0,0 +1,72 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+#import "Spectral.h"
+
+#include "AISpectralDetector.hpp"
+
+#include <vector>
+
+@implementation Spectral
+{
+    AISpectralDetector _detector;
+    std::vector<float> _samples;
+}
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        [self reset];
+        _samples.reserve(_detector.getFrameSize());
+    }
+    
+    return self;
+}
+
+- (AIAlgorithmDetectorResult)processFrame:(NSArray *)data
+{
+    _samples.clear();
+    for (NSNumber *value in data) {
+        _samples.push_back([value floatValue]);
+    }
+    
+    return [self processSamples:_samples.data() count:_samples.size()];
+}
+
+- (AIAlgorithmDetectorResult)processSamples:(const float *)samples count:(NSUInteger)count
+{
+    AIAlgorithmDetectorResult result = (AIAlgorithmDetectorResult)_detector.process(samples, count);
+    
+    if (result != AIAlgorithmDetectorResultContinue) {
+        [_delegate endDetection:self withStatus:result];
+    }
+    
+    return result;
+}
+
+- (void)reset
+{
+    _detector.reset();
+    self.frameSize = _detector.getFrameSize();
+}
+
+@end
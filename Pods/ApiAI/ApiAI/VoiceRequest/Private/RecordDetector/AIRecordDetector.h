@@ -20,6 +20,17 @@
  ***********************************************************************************************************************/
 
 #import "AIRecordDetectorDelegate.h"
+#import "AIVoiceCaptureConversion.h"
+
+@class AISoundRecorder;
+
+// Time from the capture of an audio buffer to the VAD decision on it.
+typedef struct {
+    NSUInteger count;
+    double averageMilliseconds;
+    double maximumMilliseconds;
+    double lastMilliseconds;
+} AIRecordDetectorLatency;
 
 @interface AIRecordDetector : NSObject
 
@@ -27,6 +38,25 @@
 
 @property(nonatomic, assign) BOOL VADListening;
 
+// The sound recorder's captureConversion.
+@property(nonatomic, assign) AIVoiceCaptureConversion captureConversion;
+
+// Measured since the last start while VADListening is set. Safe to read from any thread.
+@property(nonatomic, readonly) AIRecordDetectorLatency decisionLatency;
+
+// Detects on what soundRecorder captures, such as a recorder with a file or synthetic capture source. init uses one
+// recording from the microphone.
+- (instancetype)initWithSoundRecorder:(AISoundRecorder *)soundRecorder;
+
+// Starts capturing into a bounded pre-roll without analysing or delivering anything. start then goes live without
+// restarting the audio unit, and the pre-roll is delivered ahead of the first live buffer.
+- (void)startPreRoll;
+
+// Filters the prompt sound out of what is captured from now until shortly after endEchoSuppression, and keeps that
+// audio away from the voice activity detector. Call beginEchoSuppression before startPreRoll or start.
+- (void)beginEchoSuppression;
+- (void)endEchoSuppression;
+
 - (void)start;
 - (void)stop;
 - (void)cancel;
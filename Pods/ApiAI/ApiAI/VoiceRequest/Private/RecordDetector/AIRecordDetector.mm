@@ -0,0 +1,427 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+#import "AIRecordDetector.h"
+#import "AIAlgorithmDetector.h"
+#import "AISoundRecorder.h"
+#import "AISoundRecorderConstants.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <mach/mach_time.h>
+
+#include "AIAudioFrontEnd.hpp"
+#include "AILevelMeter.hpp"
+#include "AINotchFilter.hpp"
+#include "AIRingBuffer.hpp"
+
+@import AVFoundation;
+
+// About four seconds of 16 kHz audio: a full pre-roll plus two seconds; frames completed while the analysis is
+// further behind are dropped.
+#define AI_RECORD_DETECTOR_RING_CAPACITY 65536
+
+// About two seconds of 16 kHz audio captured before start; anything beyond is dropped.
+#define AI_RECORD_DETECTOR_PRE_ROLL_CAPACITY 32768
+
+// The room keeps ringing for a while after the beep has finished playing; 100 ms at 16 kHz.
+#define AI_RECORD_DETECTOR_ECHO_TAIL 1600
+
+// beep.caf, the prompt AIVoiceRequest plays, is a chime of two partials. Notches this narrow leave speech intact.
+static const double AIBeepPartials[] = {653.0, 988.0};
+#define AI_RECORD_DETECTOR_BEEP_BANDWIDTH 60.0
+
+@interface AIRecordDetector() <AIAlgorithmDetectorDelegate, AISoundRecorderDelegate>
+
+@property(nonatomic, strong) AIAlgorithmDetector *algorithmDetector;
+@property(nonatomic, strong) AISoundRecorder *soundRecorder;
+
+@end
+
+@implementation AIRecordDetector {
+    // Copies, meters and frames every captured buffer in one pass.
+    std::unique_ptr<AIAudioFrontEnd> _frontEnd;
+    std::unique_ptr<AILevelMeter> _meter;
+    std::vector<float> _frame;
+    
+    // Written and read on the analysis thread only.
+    std::unique_ptr<AIRingBuffer<int16_t>> _preRoll;
+    size_t _preRollEchoSamples;
+    
+    std::unique_ptr<AINotchFilter> _echoFilter;
+    std::atomic<long> _echoSamplesLeft;
+    
+    std::atomic<bool> _preRolling;
+    std::atomic<bool> _detectionEnded;
+    
+    std::atomic<uint64_t> _latencyCount;
+    std::atomic<uint64_t> _latencyTotal;
+    std::atomic<uint64_t> _latencyMaximum;
+    std::atomic<uint64_t> _latencyLast;
+}
+
+- (id)init
+{
+    return [self initWithSoundRecorder:[[AISoundRecorder alloc] init]];
+}
+
+- (instancetype)initWithSoundRecorder:(AISoundRecorder *)soundRecorder
+{
+    self = [super init];
+    if (self) {
+//        self.algorithmDetector = [AIAlgorithmDetector algorithmWithClassName:@"EnergyAndZeroCross"];
+//        self.algorithmDetector = [AIAlgorithmDetector algorithmWithClassName:@"Spectral"];
+        self.algorithmDetector = [AIAlgorithmDetector algorithmWithClassName:@"AdaptiveThresold"];
+        _algorithmDetector.delegate = self;
+        [_algorithmDetector reset];
+        
+        self.soundRecorder = soundRecorder;
+        _soundRecorder.delegate = self;
+        _soundRecorder.metering = NO;
+        
+        [self resetFrontEnd];
+        _meter.reset(new AILevelMeter(kSampleRate));
+        _preRoll.reset(new AIRingBuffer<int16_t>(AI_RECORD_DETECTOR_PRE_ROLL_CAPACITY));
+        _preRollEchoSamples = 0;
+        
+        _echoFilter.reset(new AINotchFilter(kSampleRate, AIBeepPartials, sizeof(AIBeepPartials) / sizeof(AIBeepPartials[0]),
+                                            AI_RECORD_DETECTOR_BEEP_BANDWIDTH));
+        _echoSamplesLeft = 0;
+        _preRolling = false;
+    }
+    
+    return self;
+}
+
+- (void)startPreRoll
+{
+    _preRoll->clear();
+    _preRollEchoSamples = 0;
+    _preRolling = true;
+    
+    _soundRecorder.delegate = self;
+    [_soundRecorder start];
+}
+
+- (void)beginEchoSuppression
+{
+    _echoFilter->reset();
+    _echoSamplesLeft = LONG_MAX;
+}
+
+- (void)endEchoSuppression
+{
+    _echoSamplesLeft = AI_RECORD_DETECTOR_ECHO_TAIL;
+}
+
+- (void)start
+{
+    _detectionEnded = false;
+    [self resetDecisionLatency];
+    [_algorithmDetector reset];
+    [self resetFrontEnd];
+    _meter->reset();
+    _soundRecorder.delegate = self;
+    
+    // The analysis thread leaves the detector alone until the pre-roll ends, so everything above is safe to reset.
+    if (!_preRolling.exchange(false)) {
+        // Left over from a pre-roll that was stopped; the recorder is not running, so nothing else touches it.
+        _preRoll->clear();
+        _preRollEchoSamples = 0;
+        
+        [_soundRecorder start];
+    }
+    
+    __weak id selfWeak = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [_delegate recordDetectorDidStartRecording:selfWeak];
+    });
+}
+
+// Stopping delivers the buffers still queued, the tail of the speech, so the delegate is detached only after.
+- (void)stopRecorderAndDetach
+{
+    [_soundRecorder stop];
+    _soundRecorder.delegate = nil;
+    _frontEnd->clear();
+}
+
+- (void)cancel
+{
+    if (![_soundRecorder isRecording]) {
+        return;
+    }
+    
+    // Nothing was delivered yet, so there is nothing to report either.
+    if (_preRolling.exchange(false)) {
+        _soundRecorder.delegate = nil;
+        [_soundRecorder stop];
+        return;
+    }
+    
+    [self stopRecorderAndDetach];
+    
+    __weak id selfWeak = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [_delegate recordDetectorDidStopRecording:selfWeak cancelled:YES];
+    });
+}
+
+- (void)stop
+{
+    if (![_soundRecorder isRecording]) {
+        return;
+    }
+    
+    if (_preRolling.exchange(false)) {
+        _soundRecorder.delegate = nil;
+        [_soundRecorder stop];
+        return;
+    }
+    
+    [self stopRecorderAndDetach];
+    
+    __weak id selfWeak = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [_delegate recordDetectorDidStopRecording:selfWeak cancelled:NO];
+    });
+}
+
+- (AIVoiceCaptureConversion)captureConversion
+{
+    return _soundRecorder.captureConversion;
+}
+
+- (void)setCaptureConversion:(AIVoiceCaptureConversion)captureConversion
+{
+    _soundRecorder.captureConversion = captureConversion;
+}
+
+#pragma mark - 
+#pragma mark AlgorithmDetectorDelegate
+
+- (void)startDetection:(AIAlgorithmDetector *)algorithmDetector
+{
+    // TODO: remove this method (and from delegate too) or implement
+}
+
+- (void)endDetection:(AIAlgorithmDetector *)algorithmDetector
+          withStatus:(AIAlgorithmDetectorResult)algorithmDetectorResult;
+{
+    // Detectors may report from the analysis thread; the recorder is stopped and the delegate told on the main thread.
+    if (![NSThread isMainThread]) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self endDetection:algorithmDetector withStatus:algorithmDetectorResult];
+        });
+        return;
+    }
+    
+    // The recorder may already have been stopped, and the delegate told, while it delivered its last buffers.
+    if (![_soundRecorder isRecording]) {
+        return;
+    }
+    
+    [self stopRecorderAndDetach];
+    
+    if (algorithmDetectorResult != AIAlgorithmDetectorResultTerminate) {
+        NSError *error = [NSError errorWithDomain:@"voice.detection.error" code:algorithmDetectorResult userInfo:@{}];
+        [_delegate recordDetector:self didFailWithError:error];
+    } else {
+        [_delegate recordDetectorDidStopRecording:self cancelled:NO];
+    }
+}
+
+#pragma mark - 
+#pragma mark SoundRecorderDelegate
+
+- (void)willStartSoundRecorder:(AISoundRecorder *)soundRecorder
+{
+    
+}
+
+- (void)didStopSoundRecorder:(AISoundRecorder *)soundRecorder
+{
+    
+}
+
+- (void)soundRecorder:(AISoundRecorder *)soundRecorder
+         receivedData:(AudioBufferList *)ioData
+    andNumberOfFrames:(UInt32)numberofFrames
+             hostTime:(UInt64)hostTime
+{
+    // Echo is filtered in place; the captured buffers are the recorder's to reuse once this returns.
+    if (_preRolling) {
+        for (int i = 0; i < ioData->mNumberBuffers; i++) {
+            SInt16 *samples = (SInt16 *)ioData->mBuffers[i].mData;
+            BOOL echo = [self suppressEcho:samples count:numberofFrames];
+            
+            size_t written = _preRoll->write(samples, numberofFrames);
+            if (echo) {
+                _preRollEchoSamples += written;
+            }
+        }
+        
+        return;
+    }
+    
+    size_t preRolled = _preRoll->getReadAvailable();
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:(preRolled + ioData->mNumberBuffers * numberofFrames) * sizeof(SInt16)];
+    SInt16 *upload = (SInt16 *)data.mutableBytes;
+    
+    // Splice the pre-roll in front of the first live buffer. Its echo samples all come first. It is read straight
+    // into the upload data, so the front end has nothing left to copy.
+    if (preRolled) {
+        _preRoll->read(upload, preRolled);
+        
+        size_t echoSamples = _preRollEchoSamples < preRolled ? _preRollEchoSamples : preRolled;
+        _frontEnd->process(upload + echoSamples, preRolled - echoSamples, NULL, true);
+        _preRollEchoSamples = 0;
+        
+        upload += preRolled;
+    }
+    
+    AILevelMeasurement levels = {0.f, 0.f, 0.0};
+    for (int i = 0; i < ioData->mNumberBuffers; i++) {
+        SInt16 *samples = (SInt16 *)ioData->mBuffers[i].mData;
+        BOOL echo = [self suppressEcho:samples count:numberofFrames];
+        
+        levels = _frontEnd->process(samples, numberofFrames, upload, !echo);
+        upload += numberofFrames;
+    }
+    
+    double power = AIMeterScaleValue(_meter->process(levels, numberofFrames));
+    _soundRecorder.currentPower = power;
+    
+    // VAD runs here on the analysis thread, so main queue load no longer delays endpointing.
+    if (self.VADListening && !_detectionEnded) {
+        AIAlgorithmDetectorResult result = [self process];
+        if (result != AIAlgorithmDetectorResultContinue) {
+            _detectionEnded = true;
+        }
+        
+        [self recordDecisionLatencySince:hostTime];
+    }
+    
+    [_delegate recordDetector:self didReceiveData:data power:power];
+}
+
+// Frames for the detector's current frame size, with nothing queued. Only while the analysis thread leaves the front
+// end alone.
+- (void)resetFrontEnd
+{
+    size_t frameSize = (size_t)[_algorithmDetector frameSize];
+    
+    if (_frontEnd && _frontEnd->getFrameSize() == frameSize) {
+        _frontEnd->clear();
+        return;
+    }
+    
+    _frontEnd.reset(new AIAudioFrontEnd(frameSize, 1.f / SHRT_MAX, AI_RECORD_DETECTOR_RING_CAPACITY / frameSize));
+    _frame.resize(frameSize);
+}
+
+// Filters samples captured while the beep or its echo may be audible. Returns whether it did.
+- (BOOL)suppressEcho:(SInt16 *)samples count:(size_t)count
+{
+    long left = _echoSamplesLeft.load();
+    if (left <= 0) {
+        return NO;
+    }
+    
+    _echoFilter->process(samples, count);
+    
+    // If endEchoSuppression replaced the count meanwhile, its value stands.
+    _echoSamplesLeft.compare_exchange_strong(left, left - (long)count);
+    
+    return YES;
+}
+
+- (AIAlgorithmDetectorResult)process
+{
+    size_t frameSize = _frontEnd->getFrameSize();
+    const float *frame;
+    
+    while ((frame = _frontEnd->peekFrame(_frame.data()))) {
+        AIAlgorithmDetectorResult result = [_algorithmDetector processSamples:frame count:frameSize];
+        
+        if (result != AIAlgorithmDetectorResultContinue) {
+            // Detection is over, so nothing still queued is wanted.
+            _frontEnd->clear();
+            return result;
+        }
+        
+        _frontEnd->skipFrame();
+    }
+    
+    return AIAlgorithmDetectorResultContinue;
+}
+
+#pragma mark -
+#pragma mark Latency
+
+static uint64_t AIHostTimeToNanoseconds(uint64_t hostTime)
+{
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    
+    return hostTime * timebase.numer / timebase.denom;
+}
+
+- (void)recordDecisionLatencySince:(UInt64)hostTime
+{
+    UInt64 now = mach_absolute_time();
+    uint64_t latency = now > hostTime ? AIHostTimeToNanoseconds(now - hostTime) : 0;
+    
+    // Only the analysis thread writes these, so plain loads and stores are enough.
+    _latencyCount.store(_latencyCount.load() + 1);
+    _latencyTotal.store(_latencyTotal.load() + latency);
+    if (latency > _latencyMaximum.load()) {
+        _latencyMaximum.store(latency);
+    }
+    _latencyLast.store(latency);
+}
+
+- (void)resetDecisionLatency
+{
+    _latencyCount = 0;
+    _latencyTotal = 0;
+    _latencyMaximum = 0;
+    _latencyLast = 0;
+}
+
+- (AIRecordDetectorLatency)decisionLatency
+{
+    uint64_t count = _latencyCount.load();
+    
+    AIRecordDetectorLatency latency;
+    latency.count = (NSUInteger)count;
+    latency.averageMilliseconds = count ? _latencyTotal.load() / 1e6 / count : 0;
+    latency.maximumMilliseconds = _latencyMaximum.load() / 1e6;
+    latency.lastMilliseconds = _latencyLast.load() / 1e6;
+    
+    return latency;
+}
+
+@end
@@ -27,6 +27,7 @@
 
 @required
 
+// Called on the sound recorder's analysis thread; the other methods are called on the main thread.
 - (void)recordDetector:(AIRecordDetector *)helper didReceiveData:(NSData *)data power:(float)power;
 - (void)recordDetectorDidStartRecording:(AIRecordDetector *)helper;
 - (void)recordDetectorDidStopRecording:(AIRecordDetector *)helper cancelled:(BOOL)cancelled;
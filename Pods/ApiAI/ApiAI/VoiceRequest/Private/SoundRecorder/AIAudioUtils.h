@@ -29,8 +29,16 @@
 #include <AudioUnit/AudioUnit.h>
 #include <AudioToolbox/AudioToolbox.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 OSStatus AICAError(OSStatus result, const char *file, int line);
 double AIDbToAmpMy(double inDb);
 
+#ifdef __cplusplus
+}
+#endif
+
 
 #endif
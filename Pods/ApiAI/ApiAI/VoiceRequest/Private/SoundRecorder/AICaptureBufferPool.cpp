@@ -0,0 +1,124 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AICaptureBufferPool.hpp"
+
+AICaptureBufferPool::AICaptureBufferPool(size_t bufferCount, uint32_t frameCapacity) :
+    frameCapacity(frameCapacity),
+    storage(bufferCount * frameCapacity),
+    buffers(bufferCount),
+    freeBuffers(bufferCount),
+    submittedBuffers(bufferCount),
+    overrunning(false),
+    overruns(0),
+    droppedBuffers(0),
+    droppedFrames(0)
+{
+    for (size_t i = 0; i < bufferCount; i++) {
+        AICaptureBuffer *buffer = &buffers[i];
+        
+        buffer->samples = &storage[i * frameCapacity];
+        buffer->numberOfFrames = 0;
+        buffer->hostTime = 0;
+        
+        freeBuffers.write(&buffer, 1);
+    }
+}
+
+AICaptureBufferPool::~AICaptureBufferPool()
+{
+}
+
+AICaptureBuffer *AICaptureBufferPool::acquire(uint32_t numberOfFrames)
+{
+    AICaptureBuffer *buffer = NULL;
+    
+    if (numberOfFrames > frameCapacity || !freeBuffers.read(&buffer, 1)) {
+        recordDrop(numberOfFrames);
+        return NULL;
+    }
+    
+    overrunning = false;
+    
+    buffer->numberOfFrames = numberOfFrames;
+    
+    return buffer;
+}
+
+bool AICaptureBufferPool::canAcquire() const
+{
+    return freeBuffers.getReadAvailable() > 0;
+}
+
+void AICaptureBufferPool::submit(AICaptureBuffer *buffer)
+{
+    // Cannot fail: the ring holds as many pointers as there are buffers.
+    submittedBuffers.write(&buffer, 1);
+}
+
+AICaptureBuffer *AICaptureBufferPool::receive()
+{
+    AICaptureBuffer *buffer = NULL;
+    submittedBuffers.read(&buffer, 1);
+    
+    return buffer;
+}
+
+void AICaptureBufferPool::release(AICaptureBuffer *buffer)
+{
+    freeBuffers.write(&buffer, 1);
+}
+
+uint32_t AICaptureBufferPool::getFrameCapacity() const
+{
+    return frameCapacity;
+}
+
+AICaptureBufferPoolStatistics AICaptureBufferPool::getStatistics() const
+{
+    AICaptureBufferPoolStatistics statistics;
+    statistics.overruns = overruns.load(std::memory_order_relaxed);
+    statistics.droppedBuffers = droppedBuffers.load(std::memory_order_relaxed);
+    statistics.droppedFrames = droppedFrames.load(std::memory_order_relaxed);
+    
+    return statistics;
+}
+
+void AICaptureBufferPool::resetStatistics()
+{
+    overrunning = false;
+    
+    overruns.store(0, std::memory_order_relaxed);
+    droppedBuffers.store(0, std::memory_order_relaxed);
+    droppedFrames.store(0, std::memory_order_relaxed);
+}
+
+void AICaptureBufferPool::recordDrop(uint32_t numberOfFrames)
+{
+    if (!overrunning) {
+        overrunning = true;
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    droppedBuffers.fetch_add(1, std::memory_order_relaxed);
+    droppedFrames.fetch_add(numberOfFrames, std::memory_order_relaxed);
+}
@@ -0,0 +1,105 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef CaptureBufferPool_hpp
+#define CaptureBufferPool_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "AIRingBuffer.hpp"
+
+// A mono int16 buffer owned by an AICaptureBufferPool. samples points at the buffer's own storage.
+struct AICaptureBuffer {
+    int16_t *samples;
+    uint32_t numberOfFrames;
+    uint64_t hostTime;
+};
+
+struct AICaptureBufferPoolStatistics {
+    // Times the consumer fell behind far enough that no buffer was free. One episode may drop many buffers.
+    uint64_t overruns;
+    uint64_t droppedBuffers;
+    uint64_t droppedFrames;
+};
+
+/*
+ * Fixed set of capture buffers passed between a real-time producer and a single consumer without locks or
+ * allocation.
+ *
+ * Every buffer is allocated up front. The producer acquires a free buffer, fills it and submits it; the consumer
+ * receives it and releases it back once done. Both directions go through AIRingBuffers of buffer pointers, so
+ * neither side ever blocks or calls into the allocator. When the consumer lags and nothing is free, the producer
+ * records the loss and carries on.
+ */
+class AICaptureBufferPool {
+public:
+    
+    AICaptureBufferPool(size_t bufferCount, uint32_t frameCapacity);
+    virtual ~AICaptureBufferPool();
+    
+    // Producer side. Returns a free buffer able to hold numberOfFrames frames, with its frame count set, or NULL if
+    // none is free or the request exceeds the capacity. A NULL return is counted as dropped.
+    AICaptureBuffer *acquire(uint32_t numberOfFrames);
+    void submit(AICaptureBuffer *buffer);
+    
+    // Producer side. Whether acquire would find a free buffer; nothing is counted.
+    bool canAcquire() const;
+    
+    // Consumer side. Returns the oldest submitted buffer, or NULL if there is none.
+    AICaptureBuffer *receive();
+    void release(AICaptureBuffer *buffer);
+    
+    uint32_t getFrameCapacity() const;
+    
+    AICaptureBufferPoolStatistics getStatistics() const;
+    
+    // Zeroes the statistics. Only call while the producer is stopped.
+    void resetStatistics();
+    
+private:
+    
+    void recordDrop(uint32_t numberOfFrames);
+    
+    uint32_t frameCapacity;
+    
+    std::vector<int16_t> storage;
+    std::vector<AICaptureBuffer> buffers;
+    
+    AIRingBuffer<AICaptureBuffer *> freeBuffers;
+    AIRingBuffer<AICaptureBuffer *> submittedBuffers;
+    
+    // Producer-only: whether the last acquire failed, so that a run of drops counts as one overrun.
+    bool overrunning;
+    
+    std::atomic<uint64_t> overruns;
+    std::atomic<uint64_t> droppedBuffers;
+    std::atomic<uint64_t> droppedFrames;
+    
+private:
+    AICaptureBufferPool( const AICaptureBufferPool& );
+    void operator=( const AICaptureBufferPool& );
+};
+
+#endif /* CaptureBufferPool_hpp */
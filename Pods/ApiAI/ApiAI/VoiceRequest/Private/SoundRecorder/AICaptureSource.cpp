@@ -0,0 +1,146 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AICaptureSource.hpp"
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+// How long a source paced at maximum speed waits before asking a sink that was not ready again.
+#define AI_CAPTURE_SOURCE_RETRY_MICROSECONDS 500
+
+AICaptureSink::~AICaptureSink()
+{
+}
+
+bool AICaptureSink::isReady() const
+{
+    return true;
+}
+
+AICaptureSource::~AICaptureSource()
+{
+}
+
+uint64_t AICaptureHostTime()
+{
+#if defined(__APPLE__)
+    return mach_absolute_time();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#endif
+}
+
+AIThreadedCaptureSource::AIThreadedCaptureSource(AICapturePacing pacing) :
+    pacing(pacing),
+    sink(NULL),
+    running(false)
+{
+}
+
+AIThreadedCaptureSource::~AIThreadedCaptureSource()
+{
+    stop();
+}
+
+AICapturePacing AIThreadedCaptureSource::getPacing() const
+{
+    return pacing;
+}
+
+bool AIThreadedCaptureSource::start(AICaptureSink *sink)
+{
+    if (thread.joinable() || !rewind()) {
+        return false;
+    }
+    
+    buffer.resize((size_t)(getSampleRate() * AI_CAPTURE_SOURCE_BUFFER_MILLISECONDS / 1000));
+    
+    this->sink = sink;
+    running = true;
+    thread = std::thread(&AIThreadedCaptureSource::run, this);
+    
+    return true;
+}
+
+void AIThreadedCaptureSource::stop()
+{
+    if (!thread.joinable()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    
+    wake.notify_all();
+    thread.join();
+}
+
+bool AIThreadedCaptureSource::waitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running && std::chrono::steady_clock::now() < deadline) {
+        wake.wait_until(lock, deadline);
+    }
+    
+    return running;
+}
+
+void AIThreadedCaptureSource::run()
+{
+    double sampleRate = getSampleRate();
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    uint64_t delivered = 0;
+    
+    while (running) {
+        size_t count = render(&buffer[0], buffer.size());
+        if (count == 0) {
+            sink->captureDidEnd();
+            return;
+        }
+        
+        if (pacing == AICapturePacingRealTime) {
+            // Each buffer is due once it would have been fully captured, counted from the start, so no drift builds up.
+            std::chrono::duration<double> due((double)(delivered + count) / sampleRate);
+            if (!waitUntil(started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(due))) {
+                return;
+            }
+        } else {
+            while (!sink->isReady()) {
+                if (!waitUntil(std::chrono::steady_clock::now() + std::chrono::microseconds(AI_CAPTURE_SOURCE_RETRY_MICROSECONDS))) {
+                    return;
+                }
+            }
+        }
+        
+        sink->captureSamples(&buffer[0], count, AICaptureHostTime());
+        delivered += count;
+    }
+}
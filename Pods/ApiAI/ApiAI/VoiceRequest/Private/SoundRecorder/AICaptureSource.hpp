@@ -0,0 +1,139 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef CaptureSource_hpp
+#define CaptureSource_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Length of the buffers that sources producing their own audio deliver.
+#define AI_CAPTURE_SOURCE_BUFFER_MILLISECONDS 20
+
+/*
+ * Receiver of captured mono int16 audio.
+ *
+ * Called on the source's own thread, which for the microphone is the real-time audio thread, so implementations
+ * must neither block nor allocate.
+ */
+class AICaptureSink {
+public:
+    
+    virtual ~AICaptureSink();
+    
+    // hostTime is when the buffer was captured, in AICaptureHostTime() units.
+    virtual void captureSamples(const int16_t *samples, size_t count, uint64_t hostTime) = 0;
+    
+    // The source has run out of audio or failed; nothing follows. Must not stop the source.
+    virtual void captureDidEnd() = 0;
+    
+    // Whether captureSamples would take a buffer right now rather than drop it. Sources that are not bound to real
+    // time wait for this instead of outrunning the sink.
+    virtual bool isReady() const;
+};
+
+/*
+ * Where the recorder's audio comes from: the microphone, a file, or a generator.
+ *
+ * Only the microphone source needs Core Audio; the file and synthetic ones build anywhere, so the pipeline behind
+ * them can run headless.
+ */
+class AICaptureSource {
+public:
+    
+    virtual ~AICaptureSource();
+    
+    virtual double getSampleRate() const = 0;
+    
+    // Starts delivering to sink. Returns false when capture could not start.
+    virtual bool start(AICaptureSink *sink) = 0;
+    
+    // Stops delivering; sink is not called once this returns. Must not be called from the sink.
+    virtual void stop() = 0;
+};
+
+// mach_absolute_time() on Apple platforms, CLOCK_MONOTONIC nanoseconds elsewhere.
+uint64_t AICaptureHostTime();
+
+typedef enum _AICapturePacing {
+    // Buffers are delivered as fast as a microphone would deliver them.
+    AICapturePacingRealTime = 0,
+    // Buffers are delivered as fast as the sink is ready for them.
+    AICapturePacingMaximum,
+} AICapturePacing;
+
+/*
+ * Base of the sources that produce audio on a thread of their own.
+ *
+ * The thread renders AI_CAPTURE_SOURCE_BUFFER_MILLISECONDS at a time into a preallocated buffer and hands it to the
+ * sink, either on a real-time schedule or as soon as the sink is ready. Subclasses must call stop() from their
+ * destructors, before their state goes away.
+ */
+class AIThreadedCaptureSource : public AICaptureSource {
+public:
+    
+    explicit AIThreadedCaptureSource(AICapturePacing pacing);
+    virtual ~AIThreadedCaptureSource();
+    
+    virtual bool start(AICaptureSink *sink);
+    virtual void stop();
+    
+    AICapturePacing getPacing() const;
+    
+protected:
+    
+    // Called on the source thread. Fills up to count samples and returns how many, 0 at the end of the audio.
+    virtual size_t render(int16_t *samples, size_t count) = 0;
+    
+    // Called by start before the thread runs, to begin the audio again.
+    virtual bool rewind() = 0;
+    
+private:
+    
+    void run();
+    
+    // Sleeps until deadline or stop(). Returns false on stop().
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+    
+    AICapturePacing pacing;
+    
+    std::vector<int16_t> buffer;
+    AICaptureSink *sink;
+    
+    std::thread thread;
+    std::atomic<bool> running;
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    
+private:
+    AIThreadedCaptureSource( const AIThreadedCaptureSource& );
+    void operator=( const AIThreadedCaptureSource& );
+};
+
+#endif /* CaptureSource_hpp */
@@ -0,0 +1,126 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIFileCaptureSource.hpp"
+
+#include <errno.h>
+#include <string.h>
+
+AIFileCaptureSource::AIFileCaptureSource(const char *path, AICapturePacing pacing, bool looping) :
+    AIThreadedCaptureSource(pacing),
+    reader(path),
+    looping(looping),
+    isFloat(false),
+    error(0),
+    kernels(AISampleKernelsGetDefault())
+{
+    if (!reader.isOpen()) {
+        error = reader.getError();
+        return;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    bool isInt16 = format.formatTag == AI_WAV_FORMAT_PCM && format.bitsPerSample == 16;
+    isFloat = format.formatTag == AI_WAV_FORMAT_IEEE_FLOAT && format.bitsPerSample == 32;
+    
+    if ((!isInt16 && !isFloat) || format.channels == 0 || format.sampleRate == 0) {
+        error = EINVAL;
+    }
+}
+
+AIFileCaptureSource::~AIFileCaptureSource()
+{
+    stop();
+}
+
+bool AIFileCaptureSource::isValid() const
+{
+    return error == 0;
+}
+
+int AIFileCaptureSource::getError() const
+{
+    return error;
+}
+
+double AIFileCaptureSource::getSampleRate() const
+{
+    return reader.getFormat().sampleRate;
+}
+
+bool AIFileCaptureSource::rewind()
+{
+    if (!isValid()) {
+        return false;
+    }
+    
+    reader.seek(0);
+    return true;
+}
+
+size_t AIFileCaptureSource::readFrames(size_t count)
+{
+    size_t frames = reader.read(&frameBytes[0], count);
+    if (frames == 0 && looping) {
+        reader.seek(0);
+        frames = reader.read(&frameBytes[0], count);
+    }
+    
+    return frames;
+}
+
+size_t AIFileCaptureSource::render(int16_t *samples, size_t count)
+{
+    unsigned channels = reader.getFormat().channels;
+    
+    // Sized by the first call; every later one asks for the same count.
+    if (frameBytes.size() < count * reader.getFormat().blockAlign) {
+        frameBytes.resize(count * reader.getFormat().blockAlign);
+        interleaved.resize(count * channels);
+        mono.resize(count);
+    }
+    
+    size_t frames = readFrames(count);
+    if (frames == 0) {
+        return 0;
+    }
+    
+    if (!isFloat && channels == 1) {
+        memcpy(samples, &frameBytes[0], frames * sizeof(int16_t));
+        return frames;
+    }
+    
+    const float *floatSamples = (const float *)&frameBytes[0];
+    
+    if (!isFloat) {
+        kernels->int16ToFloat((const int16_t *)&frameBytes[0], frames * channels, 1.f / 32768.f, &interleaved[0]);
+        floatSamples = &interleaved[0];
+    }
+    
+    if (channels > 1) {
+        kernels->downmixToMono(floatSamples, channels, frames, &mono[0]);
+        floatSamples = &mono[0];
+    }
+    
+    kernels->floatToInt16(floatSamples, frames, samples);
+    return frames;
+}
@@ -0,0 +1,80 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef FileCaptureSource_hpp
+#define FileCaptureSource_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "AICaptureSource.hpp"
+#include "AISampleKernels.h"
+#include "AIWAVReader.hpp"
+
+/*
+ * Capture source that plays a WAV file in place of the microphone.
+ *
+ * 16-bit PCM and 32-bit float files with any number of channels are delivered as mono int16 at the file's own
+ * sample rate. A looping source starts over at the end of the file instead of ending.
+ */
+class AIFileCaptureSource : public AIThreadedCaptureSource {
+public:
+    
+    AIFileCaptureSource(const char *path, AICapturePacing pacing, bool looping = false);
+    virtual ~AIFileCaptureSource();
+    
+    // True when the file was opened and holds audio in a supported format.
+    bool isValid() const;
+    
+    // errno-style code of the failure, EINVAL for unsupported formats, or 0.
+    int getError() const;
+    
+    virtual double getSampleRate() const;
+    
+protected:
+    
+    virtual size_t render(int16_t *samples, size_t count);
+    virtual bool rewind();
+    
+private:
+    
+    size_t readFrames(size_t count);
+    
+    AIWAVReader reader;
+    bool looping;
+    
+    bool isFloat;
+    int error;
+    
+    const AISampleKernels *kernels;
+    
+    std::vector<uint8_t> frameBytes;
+    std::vector<float> interleaved;
+    std::vector<float> mono;
+    
+private:
+    AIFileCaptureSource( const AIFileCaptureSource& );
+    void operator=( const AIFileCaptureSource& );
+};
+
+#endif /* FileCaptureSource_hpp */
@@ -0,0 +1,266 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIRemoteIOCaptureSource.hpp"
+#include "AISoundRecorderConstants.h"
+#include "AIAudioUtils.h"
+
+#include <mach/mach_time.h>
+
+AIRemoteIOCaptureSource::AIRemoteIOCaptureSource(AIRemoteIOCaptureRate rate, const AIDecimatorSettings &settings) :
+    remoteIOUnit(NULL),
+    sink(NULL),
+    rate(rate),
+    settings(settings),
+    captureRate(kSampleRate),
+    samples(AI_CAPTURE_MAX_FRAMES_PER_SLICE),
+    kernels(AISampleKernelsGetDefault())
+{
+    bufferList.mNumberBuffers = 1;
+    bufferList.mBuffers[0].mNumberChannels = 1;
+    bufferList.mBuffers[0].mDataByteSize = 0;
+    bufferList.mBuffers[0].mData = &samples[0];
+}
+
+AIRemoteIOCaptureSource::~AIRemoteIOCaptureSource()
+{
+    stop();
+}
+
+void AIRemoteIOCaptureSource::setCaptureRate(AIRemoteIOCaptureRate rate, const AIDecimatorSettings &settings)
+{
+    this->rate = rate;
+    this->settings = settings;
+}
+
+double AIRemoteIOCaptureSource::getSampleRate() const
+{
+    return kSampleRate;
+}
+
+double AIRemoteIOCaptureSource::getCaptureRate() const
+{
+    return captureRate;
+}
+
+double AIRemoteIOCaptureSource::getConversionLatency() const
+{
+    return captureRate != kSampleRate ? decimator->getLatency() : 0.0;
+}
+
+OSStatus AIRemoteIOCaptureSource::performThru(void *refCon, AudioUnitRenderActionFlags *actionFlags,
+                                               const AudioTimeStamp *timeStamp, UInt32 busNumber, UInt32 numberOfFrames,
+                                               AudioBufferList *data)
+{
+    AIRemoteIOCaptureSource *source = (AIRemoteIOCaptureSource *)refCon;
+    
+    // The maximum frames per slice is set to the buffer's capacity, so this only guards against a unit ignoring it.
+    if (numberOfFrames > AI_CAPTURE_MAX_FRAMES_PER_SLICE) {
+        return noErr;
+    }
+    
+    source->bufferList.mBuffers[0].mDataByteSize = numberOfFrames * sizeof(SInt16);
+    
+    OSStatus status = AudioUnitRender(source->remoteIOUnit, actionFlags, timeStamp, busNumber, numberOfFrames,
+                                      &source->bufferList);
+    if (status != noErr) {
+        return status;
+    }
+    
+    uint64_t hostTime = (timeStamp->mFlags & kAudioTimeStampHostTimeValid) ? timeStamp->mHostTime : mach_absolute_time();
+    
+    if (!source->decimator) {
+        source->sink->captureSamples(&source->samples[0], numberOfFrames, hostTime);
+        return noErr;
+    }
+    
+    source->kernels->int16ToFloat(&source->nativeSamples[0], numberOfFrames, 1.f / 32768.f, &source->nativeFloats[0]);
+    
+    AIDecimatorOutput output = source->decimator->process(&source->nativeFloats[0], numberOfFrames,
+                                                          &source->decimatedFloats[0], NULL);
+    
+    if (output.frames > 0) {
+        source->kernels->floatToInt16(&source->decimatedFloats[0], output.frames, &source->samples[0]);
+        source->sink->captureSamples(&source->samples[0], output.frames, hostTime);
+    }
+    
+    return noErr;
+}
+
+bool AIRemoteIOCaptureSource::start(AICaptureSink *sink)
+{
+    if (remoteIOUnit) {
+        return false;
+    }
+    
+    this->sink = sink;
+    
+    if (!configure() || OPCA(AudioOutputUnitStart(remoteIOUnit)) != noErr) {
+        stop();
+        return false;
+    }
+    
+    return true;
+}
+
+void AIRemoteIOCaptureSource::stop()
+{
+    if (!remoteIOUnit) {
+        return;
+    }
+    
+    OPCA(AudioOutputUnitStop(remoteIOUnit));
+    OPCA(AudioUnitUninitialize(remoteIOUnit));
+    OPCA(AudioComponentInstanceDispose(remoteIOUnit));
+    
+    remoteIOUnit = NULL;
+}
+
+bool AIRemoteIOCaptureSource::configure()
+{
+    AudioComponentDescription desc;
+    desc.componentType = kComponentType;
+    desc.componentSubType = kComponentSubType;
+    desc.componentManufacturer = kComponentManufacturer;
+    desc.componentFlags = kComponentFlags;
+    desc.componentFlagsMask = kComponentFlagsMask;
+    
+    AudioComponent comp = AudioComponentFindNext(NULL, &desc);
+    
+    if (OPCA(AudioComponentInstanceNew(comp, &remoteIOUnit)) != noErr) {
+        remoteIOUnit = NULL;
+        return false;
+    }
+    
+#if TARGET_OS_IOS || TARGET_IPHONE_SIMULATOR
+    UInt32 one = 1;
+    
+    if (OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioOutputUnitProperty_EnableIO,
+                                  kAudioUnitScope_Input,
+                                  1,
+                                  &one,
+                                  sizeof(one))) != noErr) {
+        return false;
+    }
+#endif
+    
+    AURenderCallbackStruct inputProcess;
+    inputProcess.inputProc = performThru;
+    inputProcess.inputProcRefCon = this;
+    
+    if (OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioOutputUnitProperty_SetInputCallback,
+                                  kAudioUnitScope_Global,
+                                  1,
+                                  &inputProcess,
+                                  sizeof(inputProcess))) != noErr) {
+        return false;
+    }
+    
+    captureRate = chooseCaptureRate();
+    
+    // Without a decimator the unit renders straight into the buffer the sink reads.
+    if (captureRate != kSampleRate) {
+        decimator.reset(new AIDecimator(captureRate, kSampleRate, settings, AI_CAPTURE_MAX_FRAMES_PER_SLICE));
+        
+        nativeSamples.resize(AI_CAPTURE_MAX_FRAMES_PER_SLICE);
+        nativeFloats.resize(AI_CAPTURE_MAX_FRAMES_PER_SLICE);
+        decimatedFloats.resize(decimator->getMaxOutputFrames(AI_CAPTURE_MAX_FRAMES_PER_SLICE));
+        
+        bufferList.mBuffers[0].mData = &nativeSamples[0];
+    } else {
+        decimator.reset();
+        bufferList.mBuffers[0].mData = &samples[0];
+    }
+    
+    AudioStreamBasicDescription outputFormat;
+    outputFormat.mSampleRate = captureRate;
+    outputFormat.mFormatID = kFormatID;
+    outputFormat.mBytesPerPacket = kBytesPerPacket;
+    outputFormat.mFramesPerPacket = kFramesPerPacket;
+    outputFormat.mBytesPerFrame = kBytesPerFrame;
+    outputFormat.mChannelsPerFrame = kChannelsPerFrame;
+    outputFormat.mBitsPerChannel = kBitsPerChannel;
+    outputFormat.mFormatFlags = kFormatFlags;
+    outputFormat.mReserved = 0;
+    
+    if (OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioUnitProperty_StreamFormat,
+                                  kAudioUnitScope_Input,
+                                  0,
+                                  &outputFormat,
+                                  sizeof(outputFormat))) != noErr ||
+        OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioUnitProperty_StreamFormat,
+                                  kAudioUnitScope_Output,
+                                  1,
+                                  &outputFormat,
+                                  sizeof(outputFormat))) != noErr) {
+        return false;
+    }
+    
+    UInt32 maximumFramesPerSlice = AI_CAPTURE_MAX_FRAMES_PER_SLICE;
+    if (OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioUnitProperty_MaximumFramesPerSlice,
+                                  kAudioUnitScope_Global,
+                                  0,
+                                  &maximumFramesPerSlice,
+                                  sizeof(maximumFramesPerSlice))) != noErr) {
+        return false;
+    }
+    
+    UInt32 flag = 0;
+    if (OPCA(AudioUnitSetProperty(remoteIOUnit,
+                                  kAudioUnitProperty_ShouldAllocateBuffer,
+                                  kAudioUnitScope_Input,
+                                  1,
+                                  &flag,
+                                  sizeof(flag))) != noErr) {
+        return false;
+    }
+    
+    return OPCA(AudioUnitInitialize(remoteIOUnit)) == noErr;
+}
+
+double AIRemoteIOCaptureSource::chooseCaptureRate()
+{
+    if (rate != AIRemoteIOCaptureRateNative) {
+        return kSampleRate;
+    }
+    
+    // The input scope of the input bus carries the hardware's format.
+    AudioStreamBasicDescription hardwareFormat;
+    UInt32 size = sizeof(hardwareFormat);
+    
+    if (OPCA(AudioUnitGetProperty(remoteIOUnit,
+                                  kAudioUnitProperty_StreamFormat,
+                                  kAudioUnitScope_Input,
+                                  1,
+                                  &hardwareFormat,
+                                  &size)) != noErr ||
+        !AICanDecimate(hardwareFormat.mSampleRate, kSampleRate)) {
+        return kSampleRate;
+    }
+    
+    return hardwareFormat.mSampleRate;
+}
@@ -0,0 +1,111 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef RemoteIOCaptureSource_hpp
+#define RemoteIOCaptureSource_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include <AudioUnit/AudioUnit.h>
+
+#include "AICaptureSource.hpp"
+#include "AIDecimator.hpp"
+#include "AISampleKernels.h"
+
+// Largest render slice the unit is allowed to deliver.
+#define AI_CAPTURE_MAX_FRAMES_PER_SLICE 4096
+
+typedef enum _AIRemoteIOCaptureRate {
+    // The unit converts from the hardware's rate to the recorder's before the audio reaches us.
+    AIRemoteIOCaptureRateRecorder = 0,
+    // The unit delivers the hardware's own rate, which AIDecimator takes down to the recorder's. Falls back to the
+    // unit's conversion when the hardware's rate is not a multiple AIDecimator supports.
+    AIRemoteIOCaptureRateNative,
+} AIRemoteIOCaptureRate;
+
+/*
+ * Capture source for the microphone, through the RemoteIO unit on iOS and the voice processing unit on macOS, in the
+ * recorder's format.
+ *
+ * The sink is called on the real-time audio thread with samples rendered into buffers allocated up front. When
+ * capturing at the native rate, the decimator is built by start, never on that thread.
+ */
+class AIRemoteIOCaptureSource : public AICaptureSource {
+public:
+    
+    // settings shape the decimation at the native rate.
+    explicit AIRemoteIOCaptureSource(AIRemoteIOCaptureRate rate = AIRemoteIOCaptureRateRecorder,
+                                     const AIDecimatorSettings &settings =
+                                         AIDecimatorSettingsForQuality(AIDecimatorQualityBalanced));
+    virtual ~AIRemoteIOCaptureSource();
+    
+    // Takes effect at the next start. Must not overlap start.
+    void setCaptureRate(AIRemoteIOCaptureRate rate, const AIDecimatorSettings &settings);
+    
+    virtual double getSampleRate() const;
+    
+    virtual bool start(AICaptureSink *sink);
+    virtual void stop();
+    
+    // Rate the unit delivers at since the last start.
+    double getCaptureRate() const;
+    
+    // Delay the decimation adds to the recorder's stream since the last start, in seconds; 0 when the unit converts.
+    double getConversionLatency() const;
+    
+private:
+    
+    static OSStatus performThru(void *refCon, AudioUnitRenderActionFlags *actionFlags, const AudioTimeStamp *timeStamp,
+                                UInt32 busNumber, UInt32 numberOfFrames, AudioBufferList *data);
+    
+    bool configure();
+    
+    // Rate at which the unit should deliver: the hardware's if it may be and can be decimated, the recorder's
+    // otherwise.
+    double chooseCaptureRate();
+    
+    AudioUnit remoteIOUnit;
+    AICaptureSink *sink;
+    
+    AIRemoteIOCaptureRate rate;
+    AIDecimatorSettings settings;
+    double captureRate;
+    
+    std::vector<SInt16> samples;
+    AudioBufferList bufferList;
+    
+    // Only used when decimating: the unit renders into nativeSamples, and samples receives the decimated audio.
+    std::unique_ptr<AIDecimator> decimator;
+    const AISampleKernels *kernels;
+    std::vector<SInt16> nativeSamples;
+    std::vector<float> nativeFloats;
+    std::vector<float> decimatedFloats;
+    
+private:
+    AIRemoteIOCaptureSource( const AIRemoteIOCaptureSource& );
+    void operator=( const AIRemoteIOCaptureSource& );
+};
+
+#endif /* RemoteIOCaptureSource_hpp */
@@ -20,6 +20,11 @@
  ***********************************************************************************************************************/
 
 #import "AISoundRecorderDelegate.h"
+#import "AIVoiceCaptureConversion.h"
+
+#ifdef __cplusplus
+class AICaptureSource;
+#endif
 
 @interface AISoundRecorder : NSObject
 {
@@ -30,6 +35,25 @@
 @property(nonatomic, weak) id <AISoundRecorderDelegate> delegate;
 @property(atomic, assign) double currentPower;
 
+// Whether the recorder meters what it captures into currentPower, YES by default. A delegate that measures the buffers
+// anyway turns it off and sets currentPower itself.
+@property(atomic, assign) BOOL metering;
+
+// How the microphone's audio reaches the recorder's rate, AIVoiceCaptureConversionSystem by default. Set it on the main
+// thread; it takes effect at the next start. Recorders with another capture source ignore it.
+@property(nonatomic, assign) AIVoiceCaptureConversion captureConversion;
+
+// Since the last start: how many times the analysis thread fell behind until no capture buffer was free, and how
+// many captured buffers were lost as a result.
+@property(nonatomic, readonly) NSUInteger overrunCount;
+@property(nonatomic, readonly) NSUInteger droppedBufferCount;
+
+#ifdef __cplusplus
+// Records from source instead of the microphone, taking ownership of it. Returns nil unless the source delivers the
+// recorder's sample rate.
+- (instancetype)initWithCaptureSource:(AICaptureSource *)source;
+#endif
+
 - (BOOL)isRecording;
 - (void)start;
 - (void)stop;
@@ -0,0 +1,334 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+#import "AISoundRecorder.h"
+#import "AISoundRecorderConstants.h"
+#import "AIAudioUtils.h"
+
+#include <memory>
+
+#include "AICaptureBufferPool.hpp"
+#include "AILevelMeter.hpp"
+#include "AIRemoteIOCaptureSource.hpp"
+
+#define kBufferSize 32768
+
+// Captured buffers that can wait for the analysis thread. Buffers captured while all of them are in use are dropped.
+#define AI_CAPTURE_QUEUE_CAPACITY 64
+
+@import AudioUnit;
+@import AudioToolbox;
+@import AVFoundation;
+
+/*
+ * Copies what the capture source delivers into the recorder's pool and wakes the analysis thread.
+ *
+ * Runs on the source's thread, the real-time audio thread for the microphone: besides the copy it only touches the
+ * lock-free pool and signals a semaphore. When the analysis thread lags and every buffer is in use, the samples are
+ * lost and only counted.
+ */
+class AISoundRecorderSink : public AICaptureSink {
+public:
+    
+    AISoundRecorderSink(AISoundRecorder *recorder, AICaptureBufferPool *pool, dispatch_semaphore_t signal) :
+        recorder(recorder),
+        pool(pool),
+        signal(signal)
+    {
+    }
+    
+    virtual void captureSamples(const int16_t *samples, size_t count, uint64_t hostTime)
+    {
+        AICaptureBuffer *captured = pool->acquire((uint32_t)count);
+        if (!captured) {
+            return;
+        }
+        
+        memcpy(captured->samples, samples, count * sizeof(int16_t));
+        captured->hostTime = hostTime;
+        
+        pool->submit(captured);
+        dispatch_semaphore_signal(signal);
+    }
+    
+    // Only sources that are not the microphone end, so leaving the real-time thread alone does not matter here.
+    virtual void captureDidEnd()
+    {
+        __weak AISoundRecorder *weakRecorder = recorder;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakRecorder stop];
+        });
+    }
+    
+    virtual bool isReady() const
+    {
+        return pool->canAcquire();
+    }
+    
+private:
+    
+    __weak AISoundRecorder *recorder;
+    AICaptureBufferPool *pool;
+    dispatch_semaphore_t signal;
+};
+
+@interface AISoundRecorder() {
+    std::unique_ptr<AICaptureSource> _source;
+    // _source when recording from the microphone, NULL otherwise.
+    AIRemoteIOCaptureSource *_microphone;
+    std::unique_ptr<AISoundRecorderSink> _sink;
+    BOOL _recording;
+    
+    std::unique_ptr<AICaptureBufferPool> _captured;
+    std::unique_ptr<AILevelMeter> _meter;
+    dispatch_semaphore_t _capturedSignal;
+    
+    NSThread *_analysisThread;
+    dispatch_semaphore_t _analysisFinished;
+}
+
+@end
+
+@implementation AISoundRecorder
+{
+    
+}
+
+- (id)init
+{
+    AIRemoteIOCaptureSource *microphone = new AIRemoteIOCaptureSource();
+    
+    if (self = [self initWithCaptureSource:microphone]) {
+        _microphone = microphone;
+    }
+    return self;
+}
+
+- (instancetype)initWithCaptureSource:(AICaptureSource *)source
+{
+    std::unique_ptr<AICaptureSource> ownedSource(source);
+    
+    if (ownedSource->getSampleRate() != kSampleRate) {
+        return nil;
+    }
+    
+    if (self = [super init]) {
+        _source = std::move(ownedSource);
+        
+        _captured.reset(new AICaptureBufferPool(AI_CAPTURE_QUEUE_CAPACITY, AI_CAPTURE_MAX_FRAMES_PER_SLICE));
+        _meter.reset(new AILevelMeter(kSampleRate));
+        _metering = YES;
+        _capturedSignal = dispatch_semaphore_create(0);
+        
+        _sink.reset(new AISoundRecorderSink(self, _captured.get(), _capturedSignal));
+        
+#if TARGET_OS_IOS || TARGET_IPHONE_SIMULATOR
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(interruption:) name:AVAudioSessionInterruptionNotification object:nil];
+#endif
+    }
+    return self;
+}
+
+#if TARGET_OS_IOS || TARGET_IPHONE_SIMULATOR
+- (void)interruption:(NSNotification *)notification
+{
+    int interruptionType = [notification.userInfo[AVAudioSessionInterruptionTypeKey] intValue];
+    if (interruptionType == AVAudioSessionInterruptionTypeEnded) {
+        if ([self isRecording]) {
+            [self stop];
+            [self start];
+        }
+    }
+}
+#endif
+
+- (void)start
+{
+    if ([self isRecording]) {
+        return;
+    }
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if ([_delegate respondsToSelector:@selector(willStartSoundRecorder:)]) {
+                [_delegate willStartSoundRecorder:self];
+            }
+        });
+
+        _captured->resetStatistics();
+        _meter->reset();
+        
+        _recording = YES;
+        
+        [self startAnalysis];
+        
+        if (!_source->start(_sink.get())) {
+            [self stop];
+        }
+    });
+}
+
+- (BOOL)isRecording
+{
+    return _recording;
+}
+
+- (NSUInteger)overrunCount
+{
+    return (NSUInteger)_captured->getStatistics().overruns;
+}
+
+- (NSUInteger)droppedBufferCount
+{
+    return (NSUInteger)_captured->getStatistics().droppedBuffers;
+}
+
+// start configures the source on the main queue, so a setter on the main thread never overlaps it.
+- (void)setCaptureConversion:(AIVoiceCaptureConversion)captureConversion
+{
+    _captureConversion = captureConversion;
+    
+    if (!_microphone) {
+        return;
+    }
+    
+    switch (captureConversion) {
+        case AIVoiceCaptureConversionSystem:
+            _microphone->setCaptureRate(AIRemoteIOCaptureRateRecorder,
+                                        AIDecimatorSettingsForQuality(AIDecimatorQualityBalanced));
+            break;
+        case AIVoiceCaptureConversionLowLatency:
+            _microphone->setCaptureRate(AIRemoteIOCaptureRateNative,
+                                        AIDecimatorSettingsForQuality(AIDecimatorQualityLowLatency));
+            break;
+        case AIVoiceCaptureConversionBalanced:
+            _microphone->setCaptureRate(AIRemoteIOCaptureRateNative,
+                                        AIDecimatorSettingsForQuality(AIDecimatorQualityBalanced));
+            break;
+        case AIVoiceCaptureConversionHigh:
+            _microphone->setCaptureRate(AIRemoteIOCaptureRateNative,
+                                        AIDecimatorSettingsForQuality(AIDecimatorQualityHigh));
+            break;
+    }
+}
+
+- (void)stop
+{
+    if (!_recording) {
+        return;
+    }
+    
+    _source->stop();
+    _recording = NO;
+    
+    [self stopAnalysis];
+    
+    if ([_delegate respondsToSelector:@selector(didStopSoundRecorder:)]) {
+        [_delegate didStopSoundRecorder:self];
+    }
+}
+
+#pragma mark -
+#pragma mark Analysis thread
+
+- (void)startAnalysis
+{
+    // Each thread signals its own semaphore, so a thread that was stopped from itself and signals with nobody waiting
+    // cannot satisfy the wait for the next one.
+    _analysisFinished = dispatch_semaphore_create(0);
+    
+    _analysisThread = [[NSThread alloc] initWithTarget:self selector:@selector(runAnalysis:) object:_analysisFinished];
+    _analysisThread.name = @"ai.api.sound-recorder.analysis";
+    _analysisThread.qualityOfService = NSQualityOfServiceUserInteractive;
+    [_analysisThread start];
+}
+
+- (void)stopAnalysis
+{
+    if (!_analysisThread) {
+        return;
+    }
+    
+    [_analysisThread cancel];
+    dispatch_semaphore_signal(_capturedSignal);
+    
+    // Buffers already captured are still delivered before the thread exits. A delegate that stops the recorder from
+    // the analysis thread itself cannot wait for it.
+    if ([NSThread currentThread] != _analysisThread) {
+        dispatch_semaphore_wait(_analysisFinished, DISPATCH_TIME_FOREVER);
+    }
+    
+    _analysisThread = nil;
+    _analysisFinished = nil;
+}
+
+- (void)runAnalysis:(dispatch_semaphore_t)finished
+{
+    AICaptureBuffer *captured;
+    
+    for (;;) {
+        dispatch_semaphore_wait(_capturedSignal, DISPATCH_TIME_FOREVER);
+        
+        while ((captured = _captured->receive())) {
+            @autoreleasepool {
+                [self analyseBuffer:*captured];
+            }
+            
+            _captured->release(captured);
+        }
+        
+        if ([NSThread currentThread].isCancelled) {
+            break;
+        }
+    }
+    
+    dispatch_semaphore_signal(finished);
+}
+
+- (void)analyseBuffer:(AICaptureBuffer &)captured
+{
+    if (self.metering) {
+        float decibels = _meter->process(captured.samples, captured.numberOfFrames);
+        self.currentPower = AIMeterScaleValue(decibels);
+    }
+    
+    // The delegate takes Core Audio's buffer list; this one describes the pool buffer in place.
+    AudioBufferList captureData;
+    captureData.mNumberBuffers = 1;
+    captureData.mBuffers[0].mNumberChannels = 1;
+    captureData.mBuffers[0].mDataByteSize = captured.numberOfFrames * sizeof(int16_t);
+    captureData.mBuffers[0].mData = captured.samples;
+    
+    [_delegate soundRecorder:self
+                receivedData:&captureData
+           andNumberOfFrames:captured.numberOfFrames
+                    hostTime:captured.hostTime];
+}
+
+- (void)dealloc
+{
+    _delegate = nil;
+    [self stop];
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+@end
@@ -33,9 +33,11 @@
 
 @required
 
-//This method called async
+// Called on the recorder's analysis thread, never on the main thread. hostTime is the mach_absolute_time() at which
+// the buffer was captured. data belongs to the recorder and is reused once this returns.
 - (void)soundRecorder:(AISoundRecorder *)soundRecorder
          receivedData:(AudioBufferList *)data
-    andNumberOfFrames:(UInt32)numberofFrames;
+    andNumberOfFrames:(UInt32)numberofFrames
+             hostTime:(UInt64)hostTime;
 
 @end
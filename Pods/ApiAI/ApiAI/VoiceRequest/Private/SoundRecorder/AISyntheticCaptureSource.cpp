@@ -0,0 +1,155 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AISyntheticCaptureSource.hpp"
+
+#include <math.h>
+
+#define AI_SYNTHETIC_SAMPLE_RATE 16000.0
+
+#define AI_SYNTHETIC_FORMANT_FREQUENCY 500.0
+#define AI_SYNTHETIC_PITCH_DEPTH 0.5
+
+#define AI_SYNTHETIC_VIBRATO_FREQUENCY 5.0
+#define AI_SYNTHETIC_VIBRATO_DEPTH 0.08
+#define AI_SYNTHETIC_SYLLABLE_FREQUENCY 4.0
+
+AISyntheticCaptureSettings AIDefaultSyntheticCaptureSettings(AISyntheticSignal signal)
+{
+    AISyntheticCaptureSettings settings;
+    settings.signal = signal;
+    settings.sampleRate = AI_SYNTHETIC_SAMPLE_RATE;
+    settings.durationSeconds = 0;
+    settings.amplitude = signal == AISyntheticSignalNoise ? 0.05 : 0.3;
+    settings.frequency = signal == AISyntheticSignalTone ? 440.0 : 125.0;
+    settings.noiseAmplitude = signal == AISyntheticSignalSpeechBursts ? 0.0005 : 0;
+    settings.silenceSeconds = 2.0;
+    settings.burstSeconds = 1.5;
+    settings.seed = 1;
+    
+    return settings;
+}
+
+AISyntheticCaptureSource::AISyntheticCaptureSource(const AISyntheticCaptureSettings &settings, AICapturePacing pacing) :
+    AIThreadedCaptureSource(pacing),
+    settings(settings),
+    position(0),
+    length((uint64_t)(settings.durationSeconds * settings.sampleRate)),
+    phase(0),
+    pitchPhase(0),
+    noiseState(1)
+{
+}
+
+AISyntheticCaptureSource::~AISyntheticCaptureSource()
+{
+    stop();
+}
+
+double AISyntheticCaptureSource::getSampleRate() const
+{
+    return settings.sampleRate;
+}
+
+bool AISyntheticCaptureSource::rewind()
+{
+    position = 0;
+    phase = 0;
+    pitchPhase = 0;
+    
+    // xorshift must never start from zero.
+    noiseState = settings.seed ? settings.seed : 1;
+    
+    return true;
+}
+
+float AISyntheticCaptureSource::nextNoise()
+{
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    
+    return (float)((double)noiseState / 2147483648.0 - 1.0);
+}
+
+double AISyntheticCaptureSource::renderSignal(double time)
+{
+    switch (settings.signal) {
+        case AISyntheticSignalTone:
+            phase += settings.frequency / settings.sampleRate;
+            return sin(2 * M_PI * phase);
+            
+        case AISyntheticSignalNoise:
+            return nextNoise();
+            
+        case AISyntheticSignalSpeechBursts: {
+            double period = settings.silenceSeconds + settings.burstSeconds;
+            double offset = fmod(time, period) - settings.silenceSeconds;
+            if (offset < 0) {
+                phase = 0;
+                pitchPhase = 0;
+                return 0;
+            }
+            
+            double vibrato = 1 + AI_SYNTHETIC_VIBRATO_DEPTH * sin(2 * M_PI * AI_SYNTHETIC_VIBRATO_FREQUENCY * time);
+            phase += AI_SYNTHETIC_FORMANT_FREQUENCY * vibrato / settings.sampleRate;
+            pitchPhase += settings.frequency * vibrato / settings.sampleRate;
+            
+            double voiced = (1 + AI_SYNTHETIC_PITCH_DEPTH * cos(2 * M_PI * pitchPhase)) * sin(2 * M_PI * phase);
+            
+            // Syllables rise from and fall back to silence, and the burst starts and ends between two of them.
+            double envelope = 0.5 - 0.5 * cos(2 * M_PI * AI_SYNTHETIC_SYLLABLE_FREQUENCY * offset);
+            return envelope * voiced / (1 + AI_SYNTHETIC_PITCH_DEPTH);
+        }
+    }
+    
+    return 0;
+}
+
+size_t AISyntheticCaptureSource::render(int16_t *samples, size_t count)
+{
+    if (length) {
+        if (position >= length) {
+            return 0;
+        }
+        
+        if (count > length - position) count = (size_t)(length - position);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        double time = (double)(position + i) / settings.sampleRate;
+        
+        double value = settings.amplitude * renderSignal(time);
+        if (settings.noiseAmplitude > 0) {
+            value += settings.noiseAmplitude * nextNoise();
+        }
+        
+        double scaled = floor(value * 32768 + 0.5);
+        samples[i] = (int16_t)(scaled > 32767 ? 32767 : scaled < -32768 ? -32768 : scaled);
+    }
+    
+    position += count;
+    phase -= floor(phase);
+    pitchPhase -= floor(pitchPhase);
+    
+    return count;
+}
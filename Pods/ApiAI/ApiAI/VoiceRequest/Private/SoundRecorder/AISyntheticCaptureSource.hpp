@@ -0,0 +1,105 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef SyntheticCaptureSource_hpp
+#define SyntheticCaptureSource_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AICaptureSource.hpp"
+
+typedef enum _AISyntheticSignal {
+    // A sine at frequency.
+    AISyntheticSignalTone = 0,
+    // White noise.
+    AISyntheticSignalNoise,
+    // Alternating silence and bursts of a voiced, speech-like sound, starting with silence.
+    AISyntheticSignalSpeechBursts,
+} AISyntheticSignal;
+
+struct AISyntheticCaptureSettings {
+    AISyntheticSignal signal;
+    double sampleRate;
+    
+    // Total length of the audio; 0 for endless.
+    double durationSeconds;
+    
+    // Peak amplitude of the signal, as a fraction of full scale.
+    double amplitude;
+    
+    // Frequency of the tone, or pitch of the bursts.
+    double frequency;
+    
+    // Amplitude of white noise added under every signal.
+    double noiseAmplitude;
+    
+    // Speech bursts only.
+    double silenceSeconds;
+    double burstSeconds;
+    
+    uint32_t seed;
+};
+
+// Settings for a signal at the recorder's sample rate, with levels and timings a speech endpointer expects.
+AISyntheticCaptureSettings AIDefaultSyntheticCaptureSettings(AISyntheticSignal signal);
+
+/*
+ * Capture source that generates its audio, for exercising the voice pipeline without a microphone.
+ *
+ * The output only depends on the settings, seed included, so runs are repeatable. Speech bursts are a carrier at a
+ * formant frequency, amplitude-modulated at the pitch, with a slow vibrato and a syllable-rate envelope: their energy
+ * and zero-crossing rate are those of voiced speech.
+ */
+class AISyntheticCaptureSource : public AIThreadedCaptureSource {
+public:
+    
+    AISyntheticCaptureSource(const AISyntheticCaptureSettings &settings, AICapturePacing pacing);
+    virtual ~AISyntheticCaptureSource();
+    
+    virtual double getSampleRate() const;
+    
+protected:
+    
+    virtual size_t render(int16_t *samples, size_t count);
+    virtual bool rewind();
+    
+private:
+    
+    double renderSignal(double time);
+    float nextNoise();
+    
+    AISyntheticCaptureSettings settings;
+    
+    uint64_t position;
+    uint64_t length;
+    
+    double phase;
+    double pitchPhase;
+    uint32_t noiseState;
+    
+private:
+    AISyntheticCaptureSource( const AISyntheticCaptureSource& );
+    void operator=( const AISyntheticCaptureSource& );
+};
+
+#endif /* SyntheticCaptureSource_hpp */
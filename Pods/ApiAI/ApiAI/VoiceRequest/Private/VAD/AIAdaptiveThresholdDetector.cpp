@@ -0,0 +1,164 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIAdaptiveThresholdDetector.hpp"
+
+#include <math.h>
+#include <string.h>
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::AIBasicAdaptiveThresholdDetector() :
+    silenceFrames(AI_ADAPTIVE_THRESHOLD_SILENCE_FRAMES / referenceFrames),
+    noSpeechFrames(AI_ADAPTIVE_THRESHOLD_NO_SPEECH_FRAMES / referenceFrames)
+{
+    reset();
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::~AIBasicAdaptiveThresholdDetector()
+{
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIVoiceActivityResult AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::process(const float *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIVoiceActivityResult AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::process(const int16_t *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+template <typename Sample>
+AIVoiceActivityResult AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::processSamples(const Sample *samples, size_t count)
+{
+    AIVoiceActivityResult state = AIVoiceActivityResultContinue;
+    
+    if (count == 0) return state;
+    
+    AIFrameFeatures features = AIMeasureVoiceFrame(samples, count);
+    double energy = sqrt(features.sumOfSquares / (double)count);
+    
+    if (isFirst) {
+        isFirst = false;
+        
+        energyMax = energy;
+        energyMinInitial = energy;
+        energyMin = energyMinInitial;
+        
+        return state;
+    }
+    
+    if (energy > energyMax) {
+        energyMax = energy;
+    }
+    
+    if (energy < energyMin) {
+        if (energy < AI_ADAPTIVE_THRESHOLD_MIN_ENERGY) {
+            energyMin = energyMinInitial;
+        } else {
+            energyMin = energy;
+        }
+        
+        delta = initialDelta;
+    }
+    
+    double lam = fabs(energyMax - energyMin) / (energyMax + AI_ADAPTIVE_THRESHOLD_EPSILON);
+    double threshold = (1.0 - lam) * energyMax + lam * energyMin;
+    
+    bool voiced = features.signChanges >= minSignChanges && features.signChanges <= maxSignChanges;
+    
+    if ((energy > threshold * AI_ADAPTIVE_THRESHOLD_ACTIVE_RATIO) && (lam > AI_ADAPTIVE_THRESHOLD_MIN_LAMBDA) && voiced) {
+        if (activeFrameCount > minActiveFrames) {
+            inactiveFrameCount = 0;
+            wait = false;
+        }
+        
+        activeFrameCount += 1;
+    } else {
+        if (inactiveFrameCount > silenceFrames) {
+            state = AIVoiceActivityResultTerminate;
+            activeFrameCount = 0;
+        }
+        
+        inactiveFrameCount += 1;
+    }
+    
+    // Until speech was heard, silence only ends the detection as "no speech", and only after a longer wait.
+    if (state == AIVoiceActivityResultTerminate && wait) {
+        if (inactiveFrameCount < noSpeechFrames) {
+            state = AIVoiceActivityResultContinue;
+        } else {
+            state = AIVoiceActivityResultNoSpeech;
+            wait = false;
+        }
+    }
+    
+    delta *= deltaGrowth;
+    energyMin = energyMin * delta;
+    
+    return state;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+void AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::reset()
+{
+    isFirst = true;
+    
+    activeFrameCount = 0;
+    inactiveFrameCount = 0;
+    energyMax = 0.0;
+    energyMin = 0.0;
+    energyMinInitial = 0.0;
+    
+    wait = true;
+    
+    delta = initialDelta;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+size_t AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::getFrameSize() const
+{
+    return frameSize;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+bool AIBasicAdaptiveThresholdDetector<SampleRate, FrameMilliseconds>::setParameter(const char *name, double value)
+{
+    if (strcmp(name, "silenceFrames") == 0) {
+        silenceFrames = (long)value;
+    } else if (strcmp(name, "noSpeechFrames") == 0) {
+        noSpeechFrames = (long)value;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
+
+#define AI_ADAPTIVE_THRESHOLD_INSTANTIATE(sampleRate, frameMilliseconds) \
+    template class AIBasicAdaptiveThresholdDetector<sampleRate, frameMilliseconds>;
+
+AI_VOICE_ACTIVITY_FORMATS(AI_ADAPTIVE_THRESHOLD_INSTANTIATE)
@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef AdaptiveThresholdDetector_hpp
+#define AdaptiveThresholdDetector_hpp
+
+#include "AIVoiceActivityDetector.hpp"
+
+// Reference values for 10 ms frames at 16 kHz; the templates below derive their own from these.
+#define AI_ADAPTIVE_THRESHOLD_FRAME_SIZE 160
+#define AI_ADAPTIVE_THRESHOLD_FRAME_MILLISECONDS 10
+
+// The minimum energy is reset on a new low and then drifts up by a growing factor every frame.
+#define AI_ADAPTIVE_THRESHOLD_INITIAL_DELTA 1.01
+#define AI_ADAPTIVE_THRESHOLD_DELTA_GROWTH 1.001
+#define AI_ADAPTIVE_THRESHOLD_MIN_ENERGY 0.025
+#define AI_ADAPTIVE_THRESHOLD_EPSILON 0.001
+
+#define AI_ADAPTIVE_THRESHOLD_ACTIVE_RATIO 1.4
+#define AI_ADAPTIVE_THRESHOLD_MIN_LAMBDA 0.25
+#define AI_ADAPTIVE_THRESHOLD_MIN_ACTIVE_FRAMES 10
+
+// Voiced frames cross zero between 5 and 15 times per 10 ms.
+#define AI_ADAPTIVE_THRESHOLD_MIN_SIGN_CHANGES 5
+#define AI_ADAPTIVE_THRESHOLD_MAX_SIGN_CHANGES 15
+
+#define AI_ADAPTIVE_THRESHOLD_SILENCE_FRAMES 150
+#define AI_ADAPTIVE_THRESHOLD_NO_SPEECH_FRAMES 350
+
+// base^exponent in a constant expression.
+static constexpr double AIAdaptiveThresholdPower(double base, unsigned exponent)
+{
+    return exponent == 0 ? 1.0 : base * AIAdaptiveThresholdPower(base, exponent - 1);
+}
+
+/*
+ * Detector behind the AdaptiveThresold algorithm, for frames of FrameMilliseconds at SampleRate.
+ *
+ * Tracks the minimum and maximum frame RMS and counts a frame as speech when its RMS clears a threshold interpolated
+ * between them and its zero-crossing count looks voiced. Ends after 1.5 s of inactive frames once speech was heard,
+ * or reports no speech after 3.5 s without any.
+ *
+ * Every count is scaled from the 10 ms reference to the frame duration at compile time, and the per-frame growth of
+ * the minimum compounds accordingly, so all instantiations react on the same time scale. Only the formats in
+ * AI_VOICE_ACTIVITY_FORMATS are instantiated.
+ */
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+class AIBasicAdaptiveThresholdDetector : public AIVoiceActivityDetector {
+public:
+    
+    static_assert(SampleRate * FrameMilliseconds % 1000 == 0, "frames must hold a whole number of samples");
+    static_assert(FrameMilliseconds % AI_ADAPTIVE_THRESHOLD_FRAME_MILLISECONDS == 0, "frames must last a multiple of 10 ms");
+    
+    static const size_t frameSize = SampleRate * FrameMilliseconds / 1000;
+    
+    AIBasicAdaptiveThresholdDetector();
+    virtual ~AIBasicAdaptiveThresholdDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count);
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count);
+    
+    virtual void reset();
+    
+    virtual size_t getFrameSize() const;
+    
+    // "silenceFrames" and "noSpeechFrames", counted in frames of this detector (150 and 350 for 10 ms).
+    virtual bool setParameter(const char *name, double value);
+    
+private:
+    
+    static const unsigned referenceFrames = FrameMilliseconds / AI_ADAPTIVE_THRESHOLD_FRAME_MILLISECONDS;
+    
+    static const unsigned minSignChanges = AI_ADAPTIVE_THRESHOLD_MIN_SIGN_CHANGES * referenceFrames;
+    static const unsigned maxSignChanges = AI_ADAPTIVE_THRESHOLD_MAX_SIGN_CHANGES * referenceFrames;
+    static const long minActiveFrames = AI_ADAPTIVE_THRESHOLD_MIN_ACTIVE_FRAMES / referenceFrames;
+    
+    // One frame multiplies the minimum by what referenceFrames reference frames would: their deltas grow by
+    // growth each, so their product starts at initial^r / growth^(r(r-1)/2) and grows by growth^(r×r) per frame.
+    static constexpr double initialDelta =
+        AIAdaptiveThresholdPower(AI_ADAPTIVE_THRESHOLD_INITIAL_DELTA, referenceFrames) /
+        AIAdaptiveThresholdPower(AI_ADAPTIVE_THRESHOLD_DELTA_GROWTH, referenceFrames * (referenceFrames - 1) / 2);
+    static constexpr double deltaGrowth =
+        AIAdaptiveThresholdPower(AI_ADAPTIVE_THRESHOLD_DELTA_GROWTH, referenceFrames * referenceFrames);
+    
+    template <typename Sample>
+    AIVoiceActivityResult processSamples(const Sample *samples, size_t count);
+    
+    bool isFirst;
+    bool wait;
+    
+    double energyMax;
+    double energyMin;
+    double energyMinInitial;
+    double delta;
+    
+    long inactiveFrameCount;
+    long activeFrameCount;
+    
+    long silenceFrames;
+    long noSpeechFrames;
+    
+private:
+    AIBasicAdaptiveThresholdDetector( const AIBasicAdaptiveThresholdDetector& );
+    void operator=( const AIBasicAdaptiveThresholdDetector& );
+};
+
+// The detector AdaptiveThresold has always used.
+typedef AIBasicAdaptiveThresholdDetector<16000, AI_ADAPTIVE_THRESHOLD_FRAME_MILLISECONDS> AIAdaptiveThresholdDetector;
+
+#endif /* AdaptiveThresholdDetector_hpp */
@@ -0,0 +1,173 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIBatchAdaptiveThresholdDetector.hpp"
+
+#include <math.h>
+#include <string.h>
+
+AIBatchAdaptiveThresholdDetector::AIBatchAdaptiveThresholdDetector(size_t streamCount) :
+    streams(streamCount),
+    silenceFrames(AI_ADAPTIVE_THRESHOLD_SILENCE_FRAMES),
+    noSpeechFrames(AI_ADAPTIVE_THRESHOLD_NO_SPEECH_FRAMES)
+{
+    reset();
+}
+
+AIBatchAdaptiveThresholdDetector::~AIBatchAdaptiveThresholdDetector()
+{
+}
+
+void AIBatchAdaptiveThresholdDetector::process(const float *const *frames, AIVoiceActivityResult *results)
+{
+    processFrames(frames, results);
+}
+
+void AIBatchAdaptiveThresholdDetector::process(const int16_t *const *frames, AIVoiceActivityResult *results)
+{
+    processFrames(frames, results);
+}
+
+template <typename Sample>
+void AIBatchAdaptiveThresholdDetector::processFrames(const Sample *const *frames, AIVoiceActivityResult *results)
+{
+    for (size_t i = 0; i < streams.size(); i++) {
+        results[i] = update(streams[i], AIMeasureVoiceFrame(frames[i], AI_ADAPTIVE_THRESHOLD_FRAME_SIZE));
+    }
+}
+
+// AIAdaptiveThresholdDetector::processFeatures for one stream's state.
+AIVoiceActivityResult AIBatchAdaptiveThresholdDetector::update(Stream &stream, const AIFrameFeatures &features)
+{
+    AIVoiceActivityResult state = AIVoiceActivityResultContinue;
+    
+    double energy = sqrt(features.sumOfSquares / (double)AI_ADAPTIVE_THRESHOLD_FRAME_SIZE);
+    
+    if (stream.isFirst) {
+        stream.isFirst = false;
+        
+        stream.energyMax = energy;
+        stream.energyMinInitial = energy;
+        stream.energyMin = stream.energyMinInitial;
+        
+        return state;
+    }
+    
+    if (energy > stream.energyMax) {
+        stream.energyMax = energy;
+    }
+    
+    if (energy < stream.energyMin) {
+        if (energy < AI_ADAPTIVE_THRESHOLD_MIN_ENERGY) {
+            stream.energyMin = stream.energyMinInitial;
+        } else {
+            stream.energyMin = energy;
+        }
+        
+        stream.delta = AI_ADAPTIVE_THRESHOLD_INITIAL_DELTA;
+    }
+    
+    double lam = fabs(stream.energyMax - stream.energyMin) / (stream.energyMax + AI_ADAPTIVE_THRESHOLD_EPSILON);
+    double threshold = (1.0 - lam) * stream.energyMax + lam * stream.energyMin;
+    
+    bool voiced = features.signChanges >= AI_ADAPTIVE_THRESHOLD_MIN_SIGN_CHANGES &&
+                  features.signChanges <= AI_ADAPTIVE_THRESHOLD_MAX_SIGN_CHANGES;
+    bool loud = energy > threshold * AI_ADAPTIVE_THRESHOLD_ACTIVE_RATIO && lam > AI_ADAPTIVE_THRESHOLD_MIN_LAMBDA;
+    
+    if (loud && voiced) {
+        if (stream.activeFrameCount > AI_ADAPTIVE_THRESHOLD_MIN_ACTIVE_FRAMES) {
+            stream.inactiveFrameCount = 0;
+            stream.wait = false;
+        }
+        
+        stream.activeFrameCount += 1;
+    } else {
+        if (stream.inactiveFrameCount > silenceFrames) {
+            state = AIVoiceActivityResultTerminate;
+            stream.activeFrameCount = 0;
+        }
+        
+        stream.inactiveFrameCount += 1;
+    }
+    
+    // Until speech was heard, silence only ends the detection as "no speech", and only after a longer wait.
+    if (state == AIVoiceActivityResultTerminate && stream.wait) {
+        if (stream.inactiveFrameCount < noSpeechFrames) {
+            state = AIVoiceActivityResultContinue;
+        } else {
+            state = AIVoiceActivityResultNoSpeech;
+            stream.wait = false;
+        }
+    }
+    
+    stream.delta *= AI_ADAPTIVE_THRESHOLD_DELTA_GROWTH;
+    stream.energyMin = stream.energyMin * stream.delta;
+    
+    return state;
+}
+
+void AIBatchAdaptiveThresholdDetector::reset()
+{
+    for (size_t i = 0; i < streams.size(); i++) {
+        reset(i);
+    }
+}
+
+void AIBatchAdaptiveThresholdDetector::reset(size_t stream)
+{
+    Stream &state = streams[stream];
+    
+    state.isFirst = true;
+    
+    state.activeFrameCount = 0;
+    state.inactiveFrameCount = 0;
+    state.energyMax = 0.0;
+    state.energyMin = 0.0;
+    state.energyMinInitial = 0.0;
+    
+    state.wait = true;
+    
+    state.delta = AI_ADAPTIVE_THRESHOLD_INITIAL_DELTA;
+}
+
+size_t AIBatchAdaptiveThresholdDetector::getStreamCount() const
+{
+    return streams.size();
+}
+
+size_t AIBatchAdaptiveThresholdDetector::getFrameSize() const
+{
+    return AI_ADAPTIVE_THRESHOLD_FRAME_SIZE;
+}
+
+bool AIBatchAdaptiveThresholdDetector::setParameter(const char *name, double value)
+{
+    if (strcmp(name, "silenceFrames") == 0) {
+        silenceFrames = (long)value;
+    } else if (strcmp(name, "noSpeechFrames") == 0) {
+        noSpeechFrames = (long)value;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
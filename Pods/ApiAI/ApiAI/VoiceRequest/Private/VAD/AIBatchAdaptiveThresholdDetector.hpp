@@ -0,0 +1,87 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef BatchAdaptiveThresholdDetector_hpp
+#define BatchAdaptiveThresholdDetector_hpp
+
+#include <vector>
+
+#include "AIAdaptiveThresholdDetector.hpp"
+
+/*
+ * AdaptiveThresold endpointing for many independent streams at once, for example every microphone served by one
+ * process.
+ *
+ * Each call measures one frame per stream and updates that stream's state, which is kept contiguously with the
+ * others', without a virtual call or a detector object per stream. Each stream gives the same results as its own
+ * AIAdaptiveThresholdDetector.
+ */
+class AIBatchAdaptiveThresholdDetector {
+public:
+    
+    AIBatchAdaptiveThresholdDetector(size_t streamCount);
+    virtual ~AIBatchAdaptiveThresholdDetector();
+    
+    // frames holds one frame of getFrameSize() samples per stream; results receives one result per stream.
+    void process(const float *const *frames, AIVoiceActivityResult *results);
+    void process(const int16_t *const *frames, AIVoiceActivityResult *results);
+    
+    void reset();
+    void reset(size_t stream);
+    
+    size_t getStreamCount() const;
+    size_t getFrameSize() const;
+    
+    // Same parameters as AIAdaptiveThresholdDetector, applied to every stream.
+    bool setParameter(const char *name, double value);
+    
+private:
+    
+    struct Stream {
+        bool isFirst;
+        bool wait;
+        
+        double energyMax;
+        double energyMin;
+        double energyMinInitial;
+        double delta;
+        
+        long inactiveFrameCount;
+        long activeFrameCount;
+    };
+    
+    template <typename Sample>
+    void processFrames(const Sample *const *frames, AIVoiceActivityResult *results);
+    
+    AIVoiceActivityResult update(Stream &stream, const AIFrameFeatures &features);
+    
+    std::vector<Stream> streams;
+    
+    long silenceFrames;
+    long noSpeechFrames;
+    
+private:
+    AIBatchAdaptiveThresholdDetector( const AIBatchAdaptiveThresholdDetector& );
+    void operator=( const AIBatchAdaptiveThresholdDetector& );
+};
+
+#endif /* BatchAdaptiveThresholdDetector_hpp */
@@ -0,0 +1,151 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIEnergyAndZeroCrossDetector.hpp"
+
+#include <string.h>
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::AIBasicEnergyAndZeroCrossDetector()
+{
+    maxSilenceLengthMilis = 3.5;
+    minSilenceLengthMilis = 0.8;
+    sequenceLengthMilis = 0.03;
+    minSequenceCount = 3;
+    energyFactor = 3.1;
+    
+    reset();
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::~AIBasicEnergyAndZeroCrossDetector()
+{
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIVoiceActivityResult AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::process(const float *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIVoiceActivityResult AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::process(const int16_t *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+template <typename Sample>
+AIVoiceActivityResult AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::processSamples(const Sample *samples, size_t count)
+{
+    return advance(isFrameActive(samples, count));
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+AIVoiceActivityResult AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::advance(bool active)
+{
+    // The product is converted to float before the division, as it always was.
+    time = (float)(frameNumber * (long)frameSize) / (float)SampleRate;
+    
+    if (active) {
+        if (lastActiveTime >= 0 && (time - lastActiveTime) < sequenceLengthMilis) {
+            sequenceCounter += 1;
+            if (sequenceCounter >= minSequenceCount) {
+                lastSequenceTime = time;
+                double shortened = silenceLengthMilis - (maxSilenceLengthMilis - minSilenceLengthMilis) / 4;
+                silenceLengthMilis = minSilenceLengthMilis > shortened ? minSilenceLengthMilis : shortened;
+            }
+        } else {
+            sequenceCounter = 1;
+        }
+        lastActiveTime = time;
+    } else if (time - lastSequenceTime > silenceLengthMilis) {
+        return lastSequenceTime > 0 ? AIVoiceActivityResultTerminate : AIVoiceActivityResultNoSpeech;
+    }
+    
+    return AIVoiceActivityResultContinue;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+template <typename Sample>
+bool AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::isFrameActive(const Sample *samples, size_t count)
+{
+    AIFrameFeatures features = AIMeasureVoiceFrame(samples, count);
+    
+    double energy = features.sumOfSquares / (double)frameSize;
+    int signChanges = (int)features.signChanges;
+    
+    frameNumber += 1;
+    
+    if (frameNumber < noiseFrames) {
+        noiseEnergy = noiseEnergy + energy / (double)noiseFrames;
+        return false;
+    }
+    
+    if (signChanges >= minCZ && signChanges <= maxCZ) {
+        double noiseFloor = noiseEnergy > 0.001818 ? noiseEnergy : 0.001818;
+        return energy > noiseFloor * energyFactor;
+    }
+    
+    return false;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+void AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::reset()
+{
+    silenceLengthMilis = maxSilenceLengthMilis;
+    
+    noiseEnergy = 0.0;
+    frameNumber = 0;
+    lastActiveTime = -1.0;
+    lastSequenceTime = 0.0;
+    sequenceCounter = 0;
+    time = 0.f;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+size_t AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::getFrameSize() const
+{
+    return frameSize;
+}
+
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+bool AIBasicEnergyAndZeroCrossDetector<SampleRate, FrameMilliseconds>::setParameter(const char *name, double value)
+{
+    if (strcmp(name, "energyFactor") == 0) {
+        energyFactor = value;
+    } else if (strcmp(name, "maxSilenceLengthMilis") == 0) {
+        maxSilenceLengthMilis = value;
+        silenceLengthMilis = value;
+    } else if (strcmp(name, "minSilenceLengthMilis") == 0) {
+        minSilenceLengthMilis = value;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
+
+#define AI_ENERGY_AND_ZERO_CROSS_INSTANTIATE(sampleRate, frameMilliseconds) \
+    template class AIBasicEnergyAndZeroCrossDetector<sampleRate, frameMilliseconds>;
+
+AI_VOICE_ACTIVITY_FORMATS(AI_ENERGY_AND_ZERO_CROSS_INSTANTIATE)
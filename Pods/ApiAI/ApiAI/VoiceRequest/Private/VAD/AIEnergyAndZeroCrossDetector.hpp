@@ -0,0 +1,101 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef EnergyAndZeroCrossDetector_hpp
+#define EnergyAndZeroCrossDetector_hpp
+
+#include "AIVoiceActivityDetector.hpp"
+
+/*
+ * Detector behind the EnergyAndZeroCross algorithm, for frames of FrameMilliseconds at SampleRate.
+ *
+ * Learns the noise energy over the first 150 ms, then counts a frame as speech when it is three times louder and its
+ * zero-crossing count looks voiced. Runs of active frames shorten the silence that ends the phrase from 3.5 s down to
+ * 0.8 s. Times are in seconds despite the field names inherited from the original implementation.
+ *
+ * The frame size, the voiced zero-crossing range and the length of the noise estimate follow from the template
+ * arguments at compile time. Only the formats in AI_VOICE_ACTIVITY_FORMATS are instantiated.
+ */
+template <unsigned SampleRate, unsigned FrameMilliseconds>
+class AIBasicEnergyAndZeroCrossDetector : public AIVoiceActivityDetector {
+public:
+    
+    static_assert(SampleRate * FrameMilliseconds % 1000 == 0, "frames must hold a whole number of samples");
+    
+    static const size_t frameSize = SampleRate * FrameMilliseconds / 1000;
+    
+    AIBasicEnergyAndZeroCrossDetector();
+    virtual ~AIBasicEnergyAndZeroCrossDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count);
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count);
+    
+    virtual void reset();
+    
+    virtual size_t getFrameSize() const;
+    
+    // "energyFactor" (3.1), "maxSilenceLengthMilis" (3.5) and "minSilenceLengthMilis" (0.8), the latter two in seconds.
+    virtual bool setParameter(const char *name, double value);
+    
+protected:
+    
+    // Voiced frames cross zero between 5 and 15 times per 10 ms.
+    static const int minCZ = 5 * FrameMilliseconds / 10;
+    static const int maxCZ = minCZ * 3;
+    
+    // Frames of the noise estimate, 150 ms rounded down to whole frames.
+    static const int noiseFrames = 150 / FrameMilliseconds;
+    
+    // Moves on by one frame that was or was not active.
+    AIVoiceActivityResult advance(bool active);
+    
+    double maxSilenceLengthMilis;
+    double minSilenceLengthMilis;
+    double silenceLengthMilis;
+    double sequenceLengthMilis;
+    int minSequenceCount;
+    double energyFactor;
+    
+    double noiseEnergy;
+    int frameNumber;
+    double lastActiveTime;
+    double lastSequenceTime;
+    int sequenceCounter;
+    double time;
+    
+private:
+    
+    template <typename Sample>
+    AIVoiceActivityResult processSamples(const Sample *samples, size_t count);
+    
+    template <typename Sample>
+    bool isFrameActive(const Sample *samples, size_t count);
+    
+private:
+    AIBasicEnergyAndZeroCrossDetector( const AIBasicEnergyAndZeroCrossDetector& );
+    void operator=( const AIBasicEnergyAndZeroCrossDetector& );
+};
+
+// The detector EnergyAndZeroCross uses at its default sample rate.
+typedef AIBasicEnergyAndZeroCrossDetector<16000, 10> AIEnergyAndZeroCrossDetector;
+
+#endif /* EnergyAndZeroCrossDetector_hpp */
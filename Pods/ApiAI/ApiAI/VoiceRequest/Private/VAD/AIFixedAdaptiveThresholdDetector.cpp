@@ -0,0 +1,207 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIFixedAdaptiveThresholdDetector.hpp"
+
+#include <stdint.h>
+#include <string.h>
+
+// Levels are RMS values in int16 steps scaled by 2^8; full scale is 2^23.
+#define AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL_BITS 8
+#define AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL(energy) ((uint32_t)((energy) * 32767.0 * (1 << AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL_BITS) + 0.5))
+
+// The minimum grows every frame until a frame undercuts it; beyond twice full scale every frame does, so it is held there.
+#define AI_FIXED_ADAPTIVE_THRESHOLD_MAX_LEVEL (1u << 24)
+
+#define AI_FIXED_ADAPTIVE_THRESHOLD_DELTA_BITS 30
+#define AI_FIXED_ADAPTIVE_THRESHOLD_DELTA(value) ((uint32_t)((value) * (1 << AI_FIXED_ADAPTIVE_THRESHOLD_DELTA_BITS) + 0.5))
+
+#define AI_FIXED_ADAPTIVE_THRESHOLD_Q16(value) ((uint64_t)((value) * 65536.0 + 0.5))
+
+static const uint32_t AIFixedMinEnergy = AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL(AI_ADAPTIVE_THRESHOLD_MIN_ENERGY);
+static const uint32_t AIFixedEpsilon = AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL(AI_ADAPTIVE_THRESHOLD_EPSILON);
+static const uint32_t AIFixedInitialDelta = AI_FIXED_ADAPTIVE_THRESHOLD_DELTA(AI_ADAPTIVE_THRESHOLD_INITIAL_DELTA);
+static const uint64_t AIFixedDeltaGrowth = AI_FIXED_ADAPTIVE_THRESHOLD_DELTA(AI_ADAPTIVE_THRESHOLD_DELTA_GROWTH);
+static const uint64_t AIFixedActiveRatio = AI_FIXED_ADAPTIVE_THRESHOLD_Q16(AI_ADAPTIVE_THRESHOLD_ACTIVE_RATIO);
+static const uint64_t AIFixedMinLambda = AI_FIXED_ADAPTIVE_THRESHOLD_Q16(AI_ADAPTIVE_THRESHOLD_MIN_LAMBDA);
+
+// Largest root that does not exceed value.
+static uint32_t AIFixedSquareRoot(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    
+    while (bit > value) bit >>= 2;
+    
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    
+    return (uint32_t)root;
+}
+
+// Squared level, scaled like a frame's sum of squares shifted left by 16: level^2 * count.
+static inline uint64_t AIFixedSquaredLevel(uint64_t level, size_t count)
+{
+    return level * level * count;
+}
+
+AIFixedAdaptiveThresholdDetector::AIFixedAdaptiveThresholdDetector() :
+    silenceFrames(AI_ADAPTIVE_THRESHOLD_SILENCE_FRAMES),
+    noSpeechFrames(AI_ADAPTIVE_THRESHOLD_NO_SPEECH_FRAMES)
+{
+    reset();
+}
+
+AIFixedAdaptiveThresholdDetector::~AIFixedAdaptiveThresholdDetector()
+{
+}
+
+AIVoiceActivityResult AIFixedAdaptiveThresholdDetector::process(const float *samples, size_t count)
+{
+    if (count == 0) return AIVoiceActivityResultContinue;
+    
+    AIFrameFeatures features = AIMeasureVoiceFrame(samples, count);
+    return processFrame((uint64_t)(features.sumOfSquares * 32767.0 * 32767.0 + 0.5), features.signChanges, count);
+}
+
+AIVoiceActivityResult AIFixedAdaptiveThresholdDetector::process(const int16_t *samples, size_t count)
+{
+    if (count == 0) return AIVoiceActivityResultContinue;
+    
+    AIFixedFrameFeatures features = AIMeasureFixedFrame(samples, count);
+    return processFrame(features.sumOfSquares, features.signChanges, count);
+}
+
+AIVoiceActivityResult AIFixedAdaptiveThresholdDetector::processFrame(uint64_t sumOfSquares, unsigned signChanges, size_t count)
+{
+    AIVoiceActivityResult state = AIVoiceActivityResultContinue;
+    
+    // The frame's squared level times count; at most 2^54 for a full-scale 160-sample frame.
+    uint64_t power = sumOfSquares << (2 * AI_FIXED_ADAPTIVE_THRESHOLD_LEVEL_BITS);
+    
+    if (isFirst) {
+        isFirst = false;
+        
+        energyMax = AIFixedSquareRoot(power / count);
+        energyMinInitial = energyMax;
+        energyMin = energyMinInitial;
+        
+        return state;
+    }
+    
+    if (power > AIFixedSquaredLevel(energyMax, count)) {
+        energyMax = AIFixedSquareRoot(power / count);
+    }
+    
+    if (power < AIFixedSquaredLevel(energyMin, count)) {
+        if (power < AIFixedSquaredLevel(AIFixedMinEnergy, count)) {
+            energyMin = energyMinInitial;
+        } else {
+            energyMin = AIFixedSquareRoot(power / count);
+        }
+        
+        delta = AIFixedInitialDelta;
+    }
+    
+    // lam = (max - min) / (max + epsilon), and the threshold (1 - lam) * max + lam * min = max - lam * (max - min).
+    // The minimum never exceeds the maximum here.
+    uint64_t spread = energyMax - energyMin;
+    uint64_t scale = (uint64_t)energyMax + AIFixedEpsilon;
+    uint64_t threshold = energyMax - spread * spread / scale;
+    uint64_t activeLevel = (threshold * AIFixedActiveRatio) >> 16;
+    
+    bool voiced = signChanges >= AI_ADAPTIVE_THRESHOLD_MIN_SIGN_CHANGES && signChanges <= AI_ADAPTIVE_THRESHOLD_MAX_SIGN_CHANGES;
+    
+    if ((power > AIFixedSquaredLevel(activeLevel, count)) && ((spread << 16) > AIFixedMinLambda * scale) && voiced) {
+        if (activeFrameCount > AI_ADAPTIVE_THRESHOLD_MIN_ACTIVE_FRAMES) {
+            inactiveFrameCount = 0;
+            wait = false;
+        }
+        
+        activeFrameCount += 1;
+    } else {
+        if (inactiveFrameCount > silenceFrames) {
+            state = AIVoiceActivityResultTerminate;
+            activeFrameCount = 0;
+        }
+        
+        inactiveFrameCount += 1;
+    }
+    
+    // Until speech was heard, silence only ends the detection as "no speech", and only after a longer wait.
+    if (state == AIVoiceActivityResultTerminate && wait) {
+        if (inactiveFrameCount < noSpeechFrames) {
+            state = AIVoiceActivityResultContinue;
+        } else {
+            state = AIVoiceActivityResultNoSpeech;
+            wait = false;
+        }
+    }
+    
+    uint64_t grown = ((uint64_t)delta * AIFixedDeltaGrowth) >> AI_FIXED_ADAPTIVE_THRESHOLD_DELTA_BITS;
+    delta = grown > UINT32_MAX ? UINT32_MAX : (uint32_t)grown;
+    
+    uint64_t raised = ((uint64_t)energyMin * delta) >> AI_FIXED_ADAPTIVE_THRESHOLD_DELTA_BITS;
+    energyMin = raised > AI_FIXED_ADAPTIVE_THRESHOLD_MAX_LEVEL ? AI_FIXED_ADAPTIVE_THRESHOLD_MAX_LEVEL : (uint32_t)raised;
+    
+    return state;
+}
+
+void AIFixedAdaptiveThresholdDetector::reset()
+{
+    isFirst = true;
+    
+    activeFrameCount = 0;
+    inactiveFrameCount = 0;
+    energyMax = 0;
+    energyMin = 0;
+    energyMinInitial = 0;
+    
+    wait = true;
+    
+    delta = AIFixedInitialDelta;
+}
+
+size_t AIFixedAdaptiveThresholdDetector::getFrameSize() const
+{
+    return AI_ADAPTIVE_THRESHOLD_FRAME_SIZE;
+}
+
+bool AIFixedAdaptiveThresholdDetector::setParameter(const char *name, double value)
+{
+    if (strcmp(name, "silenceFrames") == 0) {
+        silenceFrames = (long)value;
+    } else if (strcmp(name, "noSpeechFrames") == 0) {
+        noSpeechFrames = (long)value;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
@@ -0,0 +1,81 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef FixedAdaptiveThresholdDetector_hpp
+#define FixedAdaptiveThresholdDetector_hpp
+
+#include "AIAdaptiveThresholdDetector.hpp"
+
+/*
+ * AdaptiveThresold in integer arithmetic, for CPUs where the floating-point path is too expensive.
+ *
+ * int16 frames are measured without converting a single sample. Energies are kept as RMS in 1/256 int16 steps and
+ * the frame is compared in the squared domain, so the only square root is an integer one taken when a frame sets a
+ * new minimum or maximum.
+ *
+ * Decisions follow AIAdaptiveThresholdDetector except for frames whose energy lies within about 1e-4 of a threshold,
+ * relative: the threshold is rounded to the energy step and the growth factor to 30 fractional bits. Such a frame
+ * can move an endpoint by one frame. Float frames are measured in floating point and then rescaled to int16 units.
+ */
+class AIFixedAdaptiveThresholdDetector : public AIVoiceActivityDetector {
+public:
+    
+    AIFixedAdaptiveThresholdDetector();
+    virtual ~AIFixedAdaptiveThresholdDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count);
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count);
+    
+    virtual void reset();
+    
+    virtual size_t getFrameSize() const;
+    
+    // "silenceFrames" (150) and "noSpeechFrames" (350).
+    virtual bool setParameter(const char *name, double value);
+    
+private:
+    
+    AIVoiceActivityResult processFrame(uint64_t sumOfSquares, unsigned signChanges, size_t count);
+    
+    bool isFirst;
+    bool wait;
+    
+    // RMS levels in 1/256 int16 steps.
+    uint32_t energyMax;
+    uint32_t energyMin;
+    uint32_t energyMinInitial;
+    
+    // Growth factor with 30 fractional bits.
+    uint32_t delta;
+    
+    long inactiveFrameCount;
+    long activeFrameCount;
+    
+    long silenceFrames;
+    long noSpeechFrames;
+    
+private:
+    AIFixedAdaptiveThresholdDetector( const AIFixedAdaptiveThresholdDetector& );
+    void operator=( const AIFixedAdaptiveThresholdDetector& );
+};
+
+#endif /* FixedAdaptiveThresholdDetector_hpp */
@@ -0,0 +1,83 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIFixedEnergyAndZeroCrossDetector.hpp"
+
+// Noise floor of the float detector, a mean square in [-1, 1] units.
+#define AI_FIXED_ENERGY_AND_ZERO_CROSS_NOISE_FLOOR 0.001818
+
+// value * factor / 2^16 without overflowing for any value below 2^48.
+static inline uint64_t AIFixedMultiplyQ16(uint64_t value, uint64_t factor)
+{
+    return (value >> 16) * factor + (((value & 0xFFFF) * factor) >> 16);
+}
+
+AIFixedEnergyAndZeroCrossDetector::AIFixedEnergyAndZeroCrossDetector() :
+    noiseSumOfSquares(0)
+{
+}
+
+AIFixedEnergyAndZeroCrossDetector::~AIFixedEnergyAndZeroCrossDetector()
+{
+}
+
+AIVoiceActivityResult AIFixedEnergyAndZeroCrossDetector::process(const float *samples, size_t count)
+{
+    AIFrameFeatures features = AIMeasureVoiceFrame(samples, count);
+    return advance(isFrameActive((uint64_t)(features.sumOfSquares * 32767.0 * 32767.0 + 0.5), features.signChanges));
+}
+
+AIVoiceActivityResult AIFixedEnergyAndZeroCrossDetector::process(const int16_t *samples, size_t count)
+{
+    AIFixedFrameFeatures features = AIMeasureFixedFrame(samples, count);
+    return advance(isFrameActive(features.sumOfSquares, features.signChanges));
+}
+
+// The float detector compares sumOfSquares / frameSize against max(noiseEnergy, floor) * energyFactor, where
+// noiseEnergy is the sum of the noise frames' energies over noiseFrames. Both sides are multiplied by
+// frameSize * noiseFrames here, which leaves only integers.
+bool AIFixedEnergyAndZeroCrossDetector::isFrameActive(uint64_t sumOfSquares, unsigned signChanges)
+{
+    frameNumber += 1;
+    
+    if (frameNumber < noiseFrames) {
+        noiseSumOfSquares += sumOfSquares;
+        return false;
+    }
+    
+    if ((int)signChanges >= minCZ && (int)signChanges <= maxCZ) {
+        uint64_t noiseFloor = (uint64_t)(AI_FIXED_ENERGY_AND_ZERO_CROSS_NOISE_FLOOR * 32767.0 * 32767.0 * frameSize * noiseFrames);
+        uint64_t noise = noiseSumOfSquares > noiseFloor ? noiseSumOfSquares : noiseFloor;
+        uint64_t factor = (uint64_t)(energyFactor * 65536.0 + 0.5);
+        
+        return sumOfSquares * (uint64_t)noiseFrames > AIFixedMultiplyQ16(noise, factor);
+    }
+    
+    return false;
+}
+
+void AIFixedEnergyAndZeroCrossDetector::reset()
+{
+    AIEnergyAndZeroCrossDetector::reset();
+    
+    noiseSumOfSquares = 0;
+}
@@ -0,0 +1,59 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef FixedEnergyAndZeroCrossDetector_hpp
+#define FixedEnergyAndZeroCrossDetector_hpp
+
+#include "AIEnergyAndZeroCrossDetector.hpp"
+
+/*
+ * EnergyAndZeroCross with integer frame energies.
+ *
+ * int16 frames are measured without converting a single sample, and the noise energy is learned as an exact sum of
+ * squares. The energy factor is rounded to 16 fractional bits, so decisions only differ from
+ * AIEnergyAndZeroCrossDetector for frames within about 1e-5 of the threshold, relative. Float frames are measured
+ * in floating point and then rescaled to int16 units. The phrase timing is shared with the float detector.
+ */
+class AIFixedEnergyAndZeroCrossDetector : public AIEnergyAndZeroCrossDetector {
+public:
+    
+    AIFixedEnergyAndZeroCrossDetector();
+    virtual ~AIFixedEnergyAndZeroCrossDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count);
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count);
+    
+    virtual void reset();
+    
+private:
+    
+    bool isFrameActive(uint64_t sumOfSquares, unsigned signChanges);
+    
+    // Sum of squares of the noise frames, in int16 units.
+    uint64_t noiseSumOfSquares;
+    
+private:
+    AIFixedEnergyAndZeroCrossDetector( const AIFixedEnergyAndZeroCrossDetector& );
+    void operator=( const AIFixedEnergyAndZeroCrossDetector& );
+};
+
+#endif /* FixedEnergyAndZeroCrossDetector_hpp */
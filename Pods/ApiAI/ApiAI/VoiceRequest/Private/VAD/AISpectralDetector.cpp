@@ -0,0 +1,256 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AISpectralDetector.hpp"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define AI_SPECTRAL_SAMPLE_RATE 16000
+#define AI_SPECTRAL_FRAME_SIZE 160
+#define AI_SPECTRAL_FFT_SIZE 256
+#define AI_SPECTRAL_BIN_COUNT (AI_SPECTRAL_FFT_SIZE / 2 + 1)
+#define AI_SPECTRAL_BIN(hz) ((size_t)((hz) * AI_SPECTRAL_FFT_SIZE / AI_SPECTRAL_SAMPLE_RATE))
+
+// Bins below 300 Hz carry wind and handling noise; 300-3400 Hz is the telephone speech band.
+#define AI_SPECTRAL_LOW_BAND_BEGIN 1
+#define AI_SPECTRAL_SPEECH_BAND_BEGIN AI_SPECTRAL_BIN(300)
+#define AI_SPECTRAL_SPEECH_BAND_END (AI_SPECTRAL_BIN(3400) + 1)
+
+// Noise tracking over 8 subwindows of 16 frames, about 1.3 s. The minimum of smoothed periodograms sits below the
+// mean noise power, which the bias factor makes up for.
+#define AI_SPECTRAL_SMOOTHING 0.7f
+#define AI_SPECTRAL_SUBWINDOW_FRAMES 16
+#define AI_SPECTRAL_SUBWINDOW_COUNT 8
+#define AI_SPECTRAL_NOISE_BIAS 1.5f
+#define AI_SPECTRAL_POWER_FLOOR 1e-10f
+
+// A frame is speech at 6 dB over the noise floor with a flatness well below the 0.56 of white noise, unless more
+// than four fifths of its power is below 300 Hz.
+#define AI_SPECTRAL_MIN_SNR 4.f
+#define AI_SPECTRAL_MAX_FLATNESS 0.45f
+#define AI_SPECTRAL_MAX_LOW_BAND_SHARE 0.8f
+
+#define AI_SPECTRAL_MIN_SPEECH_FRAMES 5
+#define AI_SPECTRAL_SILENCE_FRAMES 150
+#define AI_SPECTRAL_NO_SPEECH_FRAMES 350
+
+static inline float AISpectralSample(float sample)
+{
+    return sample;
+}
+
+static inline float AISpectralSample(int16_t sample)
+{
+    return (float)sample * AI_VOICE_ACTIVITY_INT16_SCALE;
+}
+
+AISpectralDetector::AISpectralDetector() :
+    fft(AI_SPECTRAL_FFT_SIZE),
+    window(AI_SPECTRAL_FFT_SIZE),
+    history(AI_SPECTRAL_FFT_SIZE),
+    windowed(AI_SPECTRAL_FFT_SIZE),
+    power(AI_SPECTRAL_BIN_COUNT),
+    smoothedPower(AI_SPECTRAL_BIN_COUNT),
+    noise(AI_SPECTRAL_BIN_COUNT),
+    subwindowMinimum(AI_SPECTRAL_BIN_COUNT),
+    previousMinima(AI_SPECTRAL_BIN_COUNT * AI_SPECTRAL_SUBWINDOW_COUNT),
+    previousMinimum(AI_SPECTRAL_BIN_COUNT),
+    silenceFrames(AI_SPECTRAL_SILENCE_FRAMES),
+    noSpeechFrames(AI_SPECTRAL_NO_SPEECH_FRAMES),
+    minSNR(AI_SPECTRAL_MIN_SNR)
+{
+    for (size_t i = 0; i < AI_SPECTRAL_FFT_SIZE; i++) {
+        window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * (double)i / AI_SPECTRAL_FFT_SIZE));
+    }
+    
+    reset();
+}
+
+AISpectralDetector::~AISpectralDetector()
+{
+}
+
+AIVoiceActivityResult AISpectralDetector::process(const float *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+AIVoiceActivityResult AISpectralDetector::process(const int16_t *samples, size_t count)
+{
+    return processSamples(samples, count);
+}
+
+template <typename Sample>
+AIVoiceActivityResult AISpectralDetector::processSamples(const Sample *samples, size_t count)
+{
+    AIVoiceActivityResult state = AIVoiceActivityResultContinue;
+    
+    if (count == 0) return state;
+    
+    if (count >= AI_SPECTRAL_FFT_SIZE) {
+        samples += count - AI_SPECTRAL_FFT_SIZE;
+        count = AI_SPECTRAL_FFT_SIZE;
+    }
+    
+    size_t kept = AI_SPECTRAL_FFT_SIZE - count;
+    memmove(&history[0], &history[count], kept * sizeof(float));
+    for (size_t i = 0; i < count; i++) {
+        history[kept + i] = AISpectralSample(samples[i]);
+    }
+    
+    for (size_t i = 0; i < AI_SPECTRAL_FFT_SIZE; i++) {
+        windowed[i] = history[i] * window[i];
+    }
+    
+    fft.powerSpectrum(&windowed[0], &power[0]);
+    trackNoise();
+    
+    if (isFrameActive()) {
+        activeFrameCount += 1;
+        
+        if (activeFrameCount >= AI_SPECTRAL_MIN_SPEECH_FRAMES) {
+            speechHeard = true;
+            inactiveFrameCount = 0;
+        }
+    } else {
+        activeFrameCount = 0;
+        inactiveFrameCount += 1;
+    }
+    
+    if (speechHeard) {
+        if (inactiveFrameCount > silenceFrames) {
+            state = AIVoiceActivityResultTerminate;
+        }
+    } else if (inactiveFrameCount >= noSpeechFrames) {
+        state = AIVoiceActivityResultNoSpeech;
+    }
+    
+    return state;
+}
+
+void AISpectralDetector::trackNoise()
+{
+    for (size_t k = 0; k < AI_SPECTRAL_BIN_COUNT; k++) {
+        float smoothed = isFirst ? power[k] : AI_SPECTRAL_SMOOTHING * smoothedPower[k] + (1.f - AI_SPECTRAL_SMOOTHING) * power[k];
+        float minimum = smoothed < subwindowMinimum[k] ? smoothed : subwindowMinimum[k];
+        
+        smoothedPower[k] = smoothed;
+        subwindowMinimum[k] = minimum;
+        noise[k] = AI_SPECTRAL_NOISE_BIAS * (minimum < previousMinimum[k] ? minimum : previousMinimum[k]);
+    }
+    
+    isFirst = false;
+    
+    if (++subwindowFrame < AI_SPECTRAL_SUBWINDOW_FRAMES) {
+        return;
+    }
+    
+    memcpy(&previousMinima[subwindowIndex * AI_SPECTRAL_BIN_COUNT], &subwindowMinimum[0], AI_SPECTRAL_BIN_COUNT * sizeof(float));
+    subwindowIndex = (subwindowIndex + 1) % AI_SPECTRAL_SUBWINDOW_COUNT;
+    subwindowFrame = 0;
+    
+    for (size_t k = 0; k < AI_SPECTRAL_BIN_COUNT; k++) {
+        float minimum = FLT_MAX;
+        for (size_t u = 0; u < AI_SPECTRAL_SUBWINDOW_COUNT; u++) {
+            float value = previousMinima[u * AI_SPECTRAL_BIN_COUNT + k];
+            minimum = value < minimum ? value : minimum;
+        }
+        
+        previousMinimum[k] = minimum;
+        subwindowMinimum[k] = FLT_MAX;
+    }
+}
+
+bool AISpectralDetector::isFrameActive()
+{
+    float lowPower = 0.f;
+    for (size_t k = AI_SPECTRAL_LOW_BAND_BEGIN; k < AI_SPECTRAL_SPEECH_BAND_BEGIN; k++) {
+        lowPower += power[k];
+    }
+    
+    float speechPower = 0.f;
+    float noisePower = 0.f;
+    float logPower = 0.f;
+    for (size_t k = AI_SPECTRAL_SPEECH_BAND_BEGIN; k < AI_SPECTRAL_SPEECH_BAND_END; k++) {
+        float value = power[k] + AI_SPECTRAL_POWER_FLOOR;
+        
+        speechPower += value;
+        noisePower += noise[k] + AI_SPECTRAL_POWER_FLOOR;
+        logPower += logf(value);
+    }
+    
+    const float bins = (float)(AI_SPECTRAL_SPEECH_BAND_END - AI_SPECTRAL_SPEECH_BAND_BEGIN);
+    
+    // Geometric over arithmetic mean: near 1 for noise-like spectra, small for harmonic ones.
+    float flatness = expf(logPower / bins) / (speechPower / bins);
+    
+    if (speechPower < minSNR * noisePower) return false;
+    if (flatness > AI_SPECTRAL_MAX_FLATNESS) return false;
+    if (lowPower > AI_SPECTRAL_MAX_LOW_BAND_SHARE * (lowPower + speechPower)) return false;
+    
+    return true;
+}
+
+void AISpectralDetector::reset()
+{
+    memset(&history[0], 0, history.size() * sizeof(float));
+    
+    for (size_t k = 0; k < AI_SPECTRAL_BIN_COUNT; k++) {
+        subwindowMinimum[k] = FLT_MAX;
+        previousMinimum[k] = FLT_MAX;
+    }
+    
+    for (size_t i = 0; i < previousMinima.size(); i++) {
+        previousMinima[i] = FLT_MAX;
+    }
+    
+    subwindowFrame = 0;
+    subwindowIndex = 0;
+    
+    isFirst = true;
+    speechHeard = false;
+    
+    activeFrameCount = 0;
+    inactiveFrameCount = 0;
+}
+
+size_t AISpectralDetector::getFrameSize() const
+{
+    return AI_SPECTRAL_FRAME_SIZE;
+}
+
+bool AISpectralDetector::setParameter(const char *name, double value)
+{
+    if (strcmp(name, "silenceFrames") == 0) {
+        silenceFrames = (long)value;
+    } else if (strcmp(name, "noSpeechFrames") == 0) {
+        noSpeechFrames = (long)value;
+    } else if (strcmp(name, "minSNR") == 0) {
+        minSNR = (float)value;
+    } else {
+        return false;
+    }
+    
+    return true;
+}
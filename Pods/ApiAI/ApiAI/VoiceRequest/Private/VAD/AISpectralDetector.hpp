@@ -0,0 +1,98 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef SpectralDetector_hpp
+#define SpectralDetector_hpp
+
+#include <vector>
+
+#include "AIVoiceActivityDetector.hpp"
+#include "AIRealFFT.hpp"
+
+/*
+ * Detector behind the Spectral algorithm.
+ *
+ * Windows the last 256 samples every 10 ms frame at 16 kHz and takes their power spectrum. A minimum-statistics
+ * tracker follows the noise floor of every bin over about 1.3 s. A frame counts as speech when the 300-3400 Hz band
+ * clears that floor by 6 dB, is not spectrally flat, and is not dominated by the band below 300 Hz. This rejects
+ * wind and steady crowd noise that the time-domain detectors take for speech. It ends like AdaptiveThresold: after
+ * 150 inactive frames once speech was heard, or with no speech after 350.
+ */
+class AISpectralDetector : public AIVoiceActivityDetector {
+public:
+    
+    AISpectralDetector();
+    virtual ~AISpectralDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count);
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count);
+    
+    virtual void reset();
+    
+    virtual size_t getFrameSize() const;
+    
+    // "silenceFrames" (150), "noSpeechFrames" (350) and "minSNR" (4, as a power ratio).
+    virtual bool setParameter(const char *name, double value);
+    
+private:
+    
+    template <typename Sample>
+    AIVoiceActivityResult processSamples(const Sample *samples, size_t count);
+    
+    bool isFrameActive();
+    void trackNoise();
+    
+    AIRealFFT fft;
+    std::vector<float> window;
+    
+    // The last FFT-size samples, oldest first, and the windowed copy handed to the FFT.
+    std::vector<float> history;
+    std::vector<float> windowed;
+    
+    std::vector<float> power;
+    std::vector<float> smoothedPower;
+    std::vector<float> noise;
+    
+    // Minimum statistics: the minimum of the current subwindow, the minima of the previous ones, and the least of
+    // those, refreshed whenever a subwindow completes.
+    std::vector<float> subwindowMinimum;
+    std::vector<float> previousMinima;
+    std::vector<float> previousMinimum;
+    size_t subwindowFrame;
+    size_t subwindowIndex;
+    
+    bool isFirst;
+    bool speechHeard;
+    
+    long activeFrameCount;
+    long inactiveFrameCount;
+    
+    long silenceFrames;
+    long noSpeechFrames;
+    float minSNR;
+    
+private:
+    AISpectralDetector( const AISpectralDetector& );
+    void operator=( const AISpectralDetector& );
+};
+
+#endif /* SpectralDetector_hpp */
@@ -0,0 +1,79 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef VoiceActivityDetector_hpp
+#define VoiceActivityDetector_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AIFrameFeatures.hpp"
+
+// Same values as AIAlgorithmDetectorResult.
+typedef enum _AIVoiceActivityResult {
+    AIVoiceActivityResultContinue = 0,
+    AIVoiceActivityResultNoSpeech = 1,
+    AIVoiceActivityResultTerminate = 3,
+} AIVoiceActivityResult;
+
+// Formats the sample-rate-generic detectors are instantiated for, as X(sampleRate, frameMilliseconds).
+// AICreateVoiceActivityDetector dispatches to exactly these.
+#define AI_VOICE_ACTIVITY_FORMATS(X) X(8000, 10) X(8000, 20) X(16000, 10) X(16000, 20) X(48000, 10) X(48000, 20)
+
+// Scale AIRecordDetector applies to captured samples; int16 frames are converted with it, so both entry points agree.
+#define AI_VOICE_ACTIVITY_INT16_SCALE (1.f / 32767.f)
+
+static inline AIFrameFeatures AIMeasureVoiceFrame(const float *samples, size_t count)
+{
+    return AIMeasureFrame(samples, count);
+}
+
+static inline AIFrameFeatures AIMeasureVoiceFrame(const int16_t *samples, size_t count)
+{
+    return AIMeasureFrame(samples, count, AI_VOICE_ACTIVITY_INT16_SCALE);
+}
+
+/*
+ * End-of-speech detector fed with consecutive frames of getFrameSize() mono samples.
+ *
+ * Detectors only read the spans they are given and set up any state they need when constructed, so they never
+ * allocate while processing. Samples are either floats in [-1, 1] or int16 values, which are scaled by
+ * AI_VOICE_ACTIVITY_INT16_SCALE.
+ */
+class AIVoiceActivityDetector {
+public:
+    
+    virtual ~AIVoiceActivityDetector();
+    
+    virtual AIVoiceActivityResult process(const float *samples, size_t count) = 0;
+    virtual AIVoiceActivityResult process(const int16_t *samples, size_t count) = 0;
+    
+    virtual void reset() = 0;
+    
+    virtual size_t getFrameSize() const = 0;
+    
+    // Sets a tuning parameter by name. Parameters survive reset() and should be set before the first frame. Returns
+    // false for names the detector does not have.
+    virtual bool setParameter(const char *name, double value);
+};
+
+#endif /* VoiceActivityDetector_hpp */
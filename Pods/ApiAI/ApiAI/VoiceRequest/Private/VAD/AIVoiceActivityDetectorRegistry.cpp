@@ -0,0 +1,94 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIVoiceActivityDetectorRegistry.hpp"
+
+#include <string.h>
+
+#include "AIAdaptiveThresholdDetector.hpp"
+#include "AIEnergyAndZeroCrossDetector.hpp"
+#include "AIFixedAdaptiveThresholdDetector.hpp"
+#include "AIFixedEnergyAndZeroCrossDetector.hpp"
+#include "AISpectralDetector.hpp"
+
+// Detectors that only work on 10 ms frames at 16 kHz.
+template <typename Detector>
+static AIVoiceActivityDetector *AICreateDetector(unsigned sampleRate, unsigned frameMilliseconds)
+{
+    return sampleRate == 16000 && frameMilliseconds == 10 ? new Detector() : NULL;
+}
+
+// Picks the instantiation of a sample-rate-generic detector for the format.
+template <template <unsigned, unsigned> class Detector>
+static AIVoiceActivityDetector *AICreateDetectorForFormat(unsigned sampleRate, unsigned frameMilliseconds)
+{
+#define AI_CREATE_DETECTOR_FOR_FORMAT(rate, milliseconds) \
+    if (sampleRate == rate && frameMilliseconds == milliseconds) return new Detector<rate, milliseconds>();
+    
+    AI_VOICE_ACTIVITY_FORMATS(AI_CREATE_DETECTOR_FOR_FORMAT)
+    
+#undef AI_CREATE_DETECTOR_FOR_FORMAT
+    
+    return NULL;
+}
+
+struct AIVoiceActivityDetectorEntry {
+    const char *name;
+    AIVoiceActivityDetector *(*create)(unsigned sampleRate, unsigned frameMilliseconds);
+};
+
+static const AIVoiceActivityDetectorEntry AIVoiceActivityDetectors[] = {
+    { "AdaptiveThresold", AICreateDetectorForFormat<AIBasicAdaptiveThresholdDetector> },
+    { "EnergyAndZeroCross", AICreateDetectorForFormat<AIBasicEnergyAndZeroCrossDetector> },
+    { "Spectral", AICreateDetector<AISpectralDetector> },
+    { "AdaptiveThresoldFixedPoint", AICreateDetector<AIFixedAdaptiveThresholdDetector> },
+    { "EnergyAndZeroCrossFixedPoint", AICreateDetector<AIFixedEnergyAndZeroCrossDetector> },
+};
+
+#define AI_VOICE_ACTIVITY_DETECTOR_COUNT (sizeof(AIVoiceActivityDetectors) / sizeof(AIVoiceActivityDetectors[0]))
+
+AIVoiceActivityDetector *AICreateVoiceActivityDetector(const char *algorithmName)
+{
+    return AICreateVoiceActivityDetector(algorithmName, 16000, 10);
+}
+
+AIVoiceActivityDetector *AICreateVoiceActivityDetector(const char *algorithmName, unsigned sampleRate,
+                                                       unsigned frameMilliseconds)
+{
+    for (size_t i = 0; i < AI_VOICE_ACTIVITY_DETECTOR_COUNT; i++) {
+        if (strcmp(AIVoiceActivityDetectors[i].name, algorithmName) == 0) {
+            return AIVoiceActivityDetectors[i].create(sampleRate, frameMilliseconds);
+        }
+    }
+    
+    return NULL;
+}
+
+size_t AIGetVoiceActivityDetectorCount()
+{
+    return AI_VOICE_ACTIVITY_DETECTOR_COUNT;
+}
+
+const char *AIGetVoiceActivityDetectorName(size_t index)
+{
+    return index < AI_VOICE_ACTIVITY_DETECTOR_COUNT ? AIVoiceActivityDetectors[index].name : NULL;
+}
@@ -0,0 +1,43 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef VoiceActivityDetectorRegistry_hpp
+#define VoiceActivityDetectorRegistry_hpp
+
+#include <stddef.h>
+
+#include "AIVoiceActivityDetector.hpp"
+
+// Creates the detector behind the AIAlgorithmDetector algorithm of that name, or returns NULL for unknown names.
+// The caller owns the detector.
+AIVoiceActivityDetector *AICreateVoiceActivityDetector(const char *algorithmName);
+
+// Same for frames of frameMilliseconds at sampleRate. Returns NULL when the algorithm has no instantiation for that
+// format; AdaptiveThresold and EnergyAndZeroCross cover AI_VOICE_ACTIVITY_FORMATS, the others 10 ms at 16 kHz.
+AIVoiceActivityDetector *AICreateVoiceActivityDetector(const char *algorithmName, unsigned sampleRate,
+                                                       unsigned frameMilliseconds);
+
+// Names of the registered algorithms.
+size_t AIGetVoiceActivityDetectorCount();
+const char *AIGetVoiceActivityDetectorName(size_t index);
+
+#endif /* VoiceActivityDetectorRegistry_hpp */
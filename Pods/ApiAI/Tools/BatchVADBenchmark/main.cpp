@@ -0,0 +1,254 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * batch-vad-benchmark: checks that AIBatchAdaptiveThresholdDetector decides every stream as its own
+ * AIAdaptiveThresholdDetector would, then times both over many streams.
+ *
+ *     batch-vad-benchmark [-n streams] [-f frames] [-r runs]
+ *
+ * The check feeds 37 streams with bursts of tone and noise at different levels and rhythms, through both entry points.
+ * Every stream is reset when it decides, in the batch and in its single detector, and every result must match. The
+ * benchmark then runs the batch and one detector per stream over the same frames and prints the time per stream-frame
+ * and how many 10 ms streams one core keeps up with. Exits with 1 on any difference. Builds on Linux and macOS from the
+ * SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/VoiceRequest/Private/VAD Tools/BatchVADBenchmark/main.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIBatchAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIVoiceActivityDetector.cpp ApiAI/Private/DSP/AIFrameFeatures.cpp \
+ *         -o batch-vad-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "AIBatchAdaptiveThresholdDetector.hpp"
+
+#define AI_BATCH_VAD_CHECKED_STREAMS 37
+#define AI_BATCH_VAD_CHECKED_FRAMES 3000
+#define AI_BATCH_VAD_FRAME_SECONDS 0.01
+
+// Distinct frames the benchmark cycles through, so that the streams do not all read the same memory.
+#define AI_BATCH_VAD_POOL_FRAMES 256
+
+struct AIBatchVADCheck {
+    unsigned long results;
+    unsigned long decisions;
+    unsigned long differences;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-n streams] [-f frames] [-r runs]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// Frame of stream: a tremolo tone while the stream's rhythm says speech, noise at a stream-specific level otherwise.
+static void AIMakeFrame(size_t stream, size_t frame, size_t frameSize, uint32_t &seed, int16_t *samples)
+{
+    bool speaking = ((frame + stream * 37) / (100 + stream * 13)) % 3 == 1;
+    double level = speaking ? 8000.0 : 50.0 + (double)stream * 10.0;
+    double frequency = 300.0 + (double)stream * 5.0;
+    
+    for (size_t i = 0; i < frameSize; i++) {
+        double time = (double)(frame * frameSize + i) / 16000.0;
+        double value;
+        
+        if (speaking) {
+            value = level * sin(2 * M_PI * frequency * time) * (0.6 + 0.4 * sin(2 * M_PI * 4.0 * time));
+        } else {
+            value = level * ((double)(AINextRandom(seed) % 2001) - 1000.0) / 1000.0;
+        }
+        
+        samples[i] = (int16_t)value;
+    }
+}
+
+static void AIConvertFrame(const int16_t *samples, size_t count, int16_t *output)
+{
+    memcpy(output, samples, count * sizeof(int16_t));
+}
+
+// Float streams get the scale the detectors apply to int16 ones.
+static void AIConvertFrame(const int16_t *samples, size_t count, float *output)
+{
+    for (size_t i = 0; i < count; i++) {
+        output[i] = (float)samples[i] * AI_VOICE_ACTIVITY_INT16_SCALE;
+    }
+}
+
+template <typename Sample>
+static void AICheckStreams(AIBatchVADCheck &check)
+{
+    size_t streamCount = AI_BATCH_VAD_CHECKED_STREAMS;
+    
+    AIBatchAdaptiveThresholdDetector batch(streamCount);
+    std::vector<std::unique_ptr<AIAdaptiveThresholdDetector> > singles;
+    for (size_t stream = 0; stream < streamCount; stream++) {
+        singles.push_back(std::unique_ptr<AIAdaptiveThresholdDetector>(new AIAdaptiveThresholdDetector()));
+    }
+    
+    size_t frameSize = batch.getFrameSize();
+    std::vector<int16_t> int16Frames(streamCount * frameSize);
+    std::vector<Sample> frames(streamCount * frameSize);
+    std::vector<const Sample *> pointers(streamCount);
+    std::vector<AIVoiceActivityResult> results(streamCount);
+    uint32_t seed = 3;
+    
+    for (size_t frame = 0; frame < AI_BATCH_VAD_CHECKED_FRAMES; frame++) {
+        for (size_t stream = 0; stream < streamCount; stream++) {
+            AIMakeFrame(stream, frame, frameSize, seed, &int16Frames[stream * frameSize]);
+            AIConvertFrame(&int16Frames[stream * frameSize], frameSize, &frames[stream * frameSize]);
+            pointers[stream] = &frames[stream * frameSize];
+        }
+        
+        batch.process(pointers.data(), results.data());
+        
+        for (size_t stream = 0; stream < streamCount; stream++) {
+            AIVoiceActivityResult single = singles[stream]->process(pointers[stream], frameSize);
+            
+            check.results++;
+            check.differences += single != results[stream];
+            
+            if (single != AIVoiceActivityResultContinue) {
+                check.decisions++;
+                singles[stream]->reset();
+                batch.reset(stream);
+            }
+        }
+    }
+}
+
+// Best of runs, in nanoseconds per stream-frame.
+template <typename Run>
+static double AITimeStreams(Run run, size_t streamCount, size_t frameCount, int runs)
+{
+    double best = 0;
+    
+    for (int i = 0; i < runs; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / ((double)streamCount * (double)frameCount);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t streamCount = 4096;
+    size_t frameCount = 200;
+    int runs = 5;
+    
+    int option;
+    while ((option = getopt(argc, argv, "n:f:r:")) != -1) {
+        switch (option) {
+            case 'n':
+                streamCount = (size_t)atol(optarg);
+                break;
+            case 'f':
+                frameCount = (size_t)atol(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || streamCount == 0 || frameCount == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    AIBatchVADCheck check = {0, 0, 0};
+    AICheckStreams<int16_t>(check);
+    AICheckStreams<float>(check);
+    
+    printf("%d streams, %d frames, int16 and float: %lu results, %lu decisions, %lu differ\n",
+           AI_BATCH_VAD_CHECKED_STREAMS, AI_BATCH_VAD_CHECKED_FRAMES, check.results, check.decisions,
+           check.differences);
+    
+    AIBatchAdaptiveThresholdDetector batch(streamCount);
+    std::vector<std::unique_ptr<AIAdaptiveThresholdDetector> > singles;
+    for (size_t stream = 0; stream < streamCount; stream++) {
+        singles.push_back(std::unique_ptr<AIAdaptiveThresholdDetector>(new AIAdaptiveThresholdDetector()));
+    }
+    
+    size_t frameSize = batch.getFrameSize();
+    std::vector<int16_t> pool(AI_BATCH_VAD_POOL_FRAMES * frameSize);
+    uint32_t seed = 5;
+    for (size_t frame = 0; frame < AI_BATCH_VAD_POOL_FRAMES; frame++) {
+        AIMakeFrame(frame, frame, frameSize, seed, &pool[frame * frameSize]);
+    }
+    
+    std::vector<const int16_t *> pointers(streamCount);
+    std::vector<AIVoiceActivityResult> results(streamCount);
+    
+    double batchTime = AITimeStreams([&] {
+        batch.reset();
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            for (size_t stream = 0; stream < streamCount; stream++) {
+                pointers[stream] = &pool[((stream + frame) % AI_BATCH_VAD_POOL_FRAMES) * frameSize];
+            }
+            batch.process(pointers.data(), results.data());
+        }
+    }, streamCount, frameCount, runs);
+    
+    double singleTime = AITimeStreams([&] {
+        for (size_t stream = 0; stream < streamCount; stream++) {
+            singles[stream]->reset();
+        }
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            for (size_t stream = 0; stream < streamCount; stream++) {
+                const int16_t *samples = &pool[((stream + frame) % AI_BATCH_VAD_POOL_FRAMES) * frameSize];
+                results[stream] = singles[stream]->process(samples, frameSize);
+            }
+        }
+    }, streamCount, frameCount, runs);
+    
+    printf("%zu streams, %zu frames, ns per stream-frame and 10 ms streams per core\n", streamCount, frameCount);
+    printf("single %8.1f ns %10.0f\n", singleTime, AI_BATCH_VAD_FRAME_SECONDS * 1e9 / singleTime);
+    printf("batch  %8.1f ns %10.0f, %.2fx\n", batchTime, AI_BATCH_VAD_FRAME_SECONDS * 1e9 / batchTime,
+           singleTime / batchTime);
+    
+    return check.differences ? 1 : 0;
+}
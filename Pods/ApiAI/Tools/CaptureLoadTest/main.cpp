@@ -0,0 +1,574 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * capture-load-test: runs the voice pipeline headless behind the file and synthetic capture sources, checks what they
+ * deliver, and load-tests many pipelines at once at maximum speed.
+ *
+ *     capture-load-test [-a algorithm] [-n pipelines] [-s seconds] [file.wav...]
+ *
+ * Each pipeline does what AIRecordDetector does with the recorder's audio: AIAudioFrontEnd copies every buffer for
+ * upload and frames it, AILevelMeter meters it and the detector takes the frames, starting over after each decision
+ * as a new request would. The checks, which must all pass or the tool exits with 1:
+ *
+ * - Speech bursts end with Terminate between the end of the first burst and the start of the second, and noise
+ *   alone never does.
+ * - The synthetic audio, written out as a 16-bit mono and as a 32-bit float stereo WAV file, plays back sample for
+ *   sample with the same decisions, and a looping file starts over seamlessly.
+ * - A source paced at real time takes as long as its audio.
+ * - Pipelines running concurrently get all of their audio and decide as one running alone does.
+ *
+ * The given 16-bit or float WAV files are then played through a pipeline each, at maximum speed. Builds on Linux and
+ * macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -pthread -IApiAI/Private/DSP -IApiAI/Private/Codec -IApiAI/VoiceRequest/Private/VAD \
+ *         -IApiAI/VoiceRequest/Private/SoundRecorder Tools/CaptureLoadTest/main.cpp \
+ *         ApiAI/VoiceRequest/Private/SoundRecorder/AICaptureSource.cpp \
+ *         ApiAI/VoiceRequest/Private/SoundRecorder/AIFileCaptureSource.cpp \
+ *         ApiAI/VoiceRequest/Private/SoundRecorder/AISyntheticCaptureSource.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AI*.cpp ApiAI/Private/DSP/AIAudioFrontEnd.cpp \
+ *         ApiAI/Private/DSP/AIFrameFeatures.cpp ApiAI/Private/DSP/AILevelMeter.cpp ApiAI/Private/DSP/AIRealFFT.cpp \
+ *         ApiAI/Private/DSP/AISampleKernels.cpp ApiAI/Private/Codec/AIWAVReader.cpp \
+ *         ApiAI/Private/Codec/AIWAVHeader.cpp -o capture-load-test
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AIAudioFrontEnd.hpp"
+#include "AIFileCaptureSource.hpp"
+#include "AILevelMeter.hpp"
+#include "AISyntheticCaptureSource.hpp"
+#include "AIVoiceActivityDetectorRegistry.hpp"
+#include "AIWAVHeader.hpp"
+
+// As AIRecordDetector: the samples its front end may queue for the detector.
+#define AI_CAPTURE_LOAD_RING_CAPACITY 65536
+
+// The detectors' frame duration, as AIRecordDetector's algorithms use.
+#define AI_CAPTURE_LOAD_FRAME_MILLISECONDS 10
+
+// Length of the synthetic recordings the checks use.
+#define AI_CAPTURE_LOAD_CHECK_SECONDS 8.0
+#define AI_CAPTURE_LOAD_LOOPS 3
+
+// A paced source may finish up to one buffer early, and late by scheduling delays up to this many seconds.
+#define AI_CAPTURE_LOAD_PACED_SECONDS 1.0
+#define AI_CAPTURE_LOAD_PACING_SLACK 0.2
+
+// Loaded pipelines cycle through this many noise seeds, each checked against a pipeline run alone.
+#define AI_CAPTURE_LOAD_SEEDS 4
+
+struct AICaptureDecision {
+    uint64_t sample;
+    AIVoiceActivityResult result;
+};
+
+static bool operator==(const AICaptureDecision &a, const AICaptureDecision &b)
+{
+    return a.sample == b.sample && a.result == b.result;
+}
+
+/*
+ * One voice pipeline behind a capture source.
+ *
+ * The upload copy of the first uploadCapacity samples is kept for checking; later samples are only counted. Runs on
+ * the source's thread, which for file and synthetic sources is not a real-time one, so recording decisions may
+ * allocate.
+ */
+class AIPipelineSink : public AICaptureSink {
+public:
+    
+    AIPipelineSink(AIVoiceActivityDetector *detector, double sampleRate, size_t uploadCapacity) :
+        detector(detector),
+        frontEnd(detector->getFrameSize(), 1.f / SHRT_MAX, AI_CAPTURE_LOAD_RING_CAPACITY / detector->getFrameSize()),
+        meter(sampleRate),
+        frame(detector->getFrameSize()),
+        upload(uploadCapacity),
+        peakPower(0),
+        frameStart(0),
+        received(0),
+        ended(false)
+    {
+    }
+    
+    virtual void captureSamples(const int16_t *samples, size_t count, uint64_t)
+    {
+        uint64_t start = received.load(std::memory_order_relaxed);
+        size_t room = start < upload.size() ? std::min(count, upload.size() - (size_t)start) : 0;
+        
+        int16_t *copy = room == count ? &upload[(size_t)start] : NULL;
+        AILevelMeasurement levels = frontEnd.process(samples, count, copy, true);
+        if (!copy && room) {
+            memcpy(&upload[(size_t)start], samples, room * sizeof(int16_t));
+        }
+        
+        peakPower = std::max(peakPower, (double)AIMeterScaleValue(meter.process(levels, count)));
+        
+        size_t frameSize = frontEnd.getFrameSize();
+        const float *samplesOfFrame;
+        
+        while ((samplesOfFrame = frontEnd.peekFrame(&frame[0]))) {
+            AIVoiceActivityResult result = detector->process(samplesOfFrame, frameSize);
+            frameStart += frameSize;
+            
+            if (result != AIVoiceActivityResultContinue) {
+                AICaptureDecision decision = {frameStart, result};
+                decisions.push_back(decision);
+                
+                // Start over as the next request would, with this buffer's remaining frames dropped.
+                detector->reset();
+                frontEnd.clear();
+                frameStart = start + count;
+                break;
+            }
+            
+            frontEnd.skipFrame();
+        }
+        
+        received.store(start + count, std::memory_order_release);
+    }
+    
+    virtual void captureDidEnd()
+    {
+        ended.store(true, std::memory_order_release);
+    }
+    
+    void waitUntilEnded() const
+    {
+        while (!ended.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    
+    void waitUntilReceived(uint64_t count) const
+    {
+        while (received.load(std::memory_order_acquire) < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    
+    uint64_t getReceived() const
+    {
+        return received.load(std::memory_order_acquire);
+    }
+    
+    const std::vector<int16_t> &getUpload() const
+    {
+        return upload;
+    }
+    
+    const std::vector<AICaptureDecision> &getDecisions() const
+    {
+        return decisions;
+    }
+    
+    // Highest meter reading, on the recorder's 0 to 1 scale.
+    double getPeakPower() const
+    {
+        return peakPower;
+    }
+    
+private:
+    
+    std::unique_ptr<AIVoiceActivityDetector> detector;
+    AIAudioFrontEnd frontEnd;
+    AILevelMeter meter;
+    
+    std::vector<float> frame;
+    std::vector<int16_t> upload;
+    std::vector<AICaptureDecision> decisions;
+    
+    double peakPower;
+    
+    // Sample at which the frame at the head of the front end's queue begins.
+    uint64_t frameStart;
+    
+    std::atomic<uint64_t> received;
+    std::atomic<bool> ended;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-a algorithm] [-n pipelines] [-s seconds] [file.wav...]\n", program);
+    return 2;
+}
+
+static AISyntheticCaptureSettings AIMakeSettings(AISyntheticSignal signal, double seconds, uint32_t seed)
+{
+    AISyntheticCaptureSettings settings = AIDefaultSyntheticCaptureSettings(signal);
+    settings.durationSeconds = seconds;
+    settings.seed = seed;
+    
+    return settings;
+}
+
+// A pipeline at the source's rate, or NULL when the algorithm has no detector for it.
+static AIPipelineSink *AICreateSink(const char *algorithm, const AICaptureSource &source, size_t uploadCapacity)
+{
+    double sampleRate = source.getSampleRate();
+    AIVoiceActivityDetector *detector = AICreateVoiceActivityDetector(algorithm, (unsigned)sampleRate,
+                                                                      AI_CAPTURE_LOAD_FRAME_MILLISECONDS);
+    
+    return detector ? new AIPipelineSink(detector, sampleRate, uploadCapacity) : NULL;
+}
+
+// Plays source to its end through a new pipeline. Returns the seconds it took, or a negative value if there is no
+// detector for the source or it did not start.
+static double AIRunToEnd(AICaptureSource &source, const char *algorithm, size_t uploadCapacity,
+                         std::unique_ptr<AIPipelineSink> &sink)
+{
+    sink.reset(AICreateSink(algorithm, source, uploadCapacity));
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!sink || !source.start(sink.get())) {
+        return -1;
+    }
+    
+    sink->waitUntilEnded();
+    source.stop();
+    
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string AIFormatDecisions(const std::vector<AICaptureDecision> &decisions, double sampleRate)
+{
+    std::string text;
+    
+    for (size_t i = 0; i < decisions.size(); i++) {
+        char decision[48];
+        snprintf(decision, sizeof(decision), "%s%s at %.2f s", i ? ", " : "",
+                 decisions[i].result == AIVoiceActivityResultTerminate ? "Terminate" : "NoSpeech",
+                 (double)decisions[i].sample / sampleRate);
+        text += decision;
+    }
+    
+    return decisions.empty() ? "no decision" : text;
+}
+
+// Speech bursts must end with Terminate in the silence after the first burst; noise alone must never be speech.
+static bool AICheckEndpoints(const char *algorithm, std::vector<int16_t> &speech)
+{
+    AISyntheticCaptureSettings settings = AIMakeSettings(AISyntheticSignalSpeechBursts,
+                                                         AI_CAPTURE_LOAD_CHECK_SECONDS, 1);
+    AISyntheticCaptureSource speechSource(settings, AICapturePacingMaximum);
+    size_t length = (size_t)(AI_CAPTURE_LOAD_CHECK_SECONDS * speechSource.getSampleRate());
+    
+    std::unique_ptr<AIPipelineSink> sink;
+    AIRunToEnd(speechSource, algorithm, length, sink);
+    speech = sink->getUpload();
+    
+    const std::vector<AICaptureDecision> &decisions = sink->getDecisions();
+    double first = decisions.empty() ? 0 : (double)decisions[0].sample / settings.sampleRate;
+    double burstEnd = settings.silenceSeconds + settings.burstSeconds;
+    bool speechPassed = sink->getReceived() == length && !decisions.empty() &&
+                        decisions[0].result == AIVoiceActivityResultTerminate && first > burstEnd &&
+                        first <= burstEnd + settings.silenceSeconds;
+    
+    printf("speech bursts: %s%s\n", AIFormatDecisions(decisions, settings.sampleRate).c_str(),
+           speechPassed ? "" : ", WRONG");
+    
+    AISyntheticCaptureSource noiseSource(AIMakeSettings(AISyntheticSignalNoise, AI_CAPTURE_LOAD_CHECK_SECONDS, 1),
+                                         AICapturePacingMaximum);
+    AIRunToEnd(noiseSource, algorithm, 0, sink);
+    
+    bool noisePassed = sink->getReceived() == length;
+    for (size_t i = 0; i < sink->getDecisions().size(); i++) {
+        noisePassed = noisePassed && sink->getDecisions()[i].result != AIVoiceActivityResultTerminate;
+    }
+    
+    printf("noise: %s%s\n", AIFormatDecisions(sink->getDecisions(), settings.sampleRate).c_str(),
+           noisePassed ? "" : ", WRONG");
+    
+    return speechPassed && noisePassed;
+}
+
+static bool AIWriteWAV(const char *path, const std::vector<int16_t> &samples, bool asFloatStereo)
+{
+    AIWAVFormat format;
+    format.formatTag = asFloatStereo ? AI_WAV_FORMAT_IEEE_FLOAT : AI_WAV_FORMAT_PCM;
+    format.channels = asFloatStereo ? 2 : 1;
+    format.sampleRate = 16000;
+    format.bitsPerSample = asFloatStereo ? 32 : 16;
+    format.blockAlign = format.channels * format.bitsPerSample / 8;
+    format.bytesPerSecond = format.blockAlign * format.sampleRate;
+    format.samplesPerBlock = 0;
+    
+    std::vector<uint8_t> output;
+    AIAppendWAVHeader(output, format, (uint32_t)(samples.size() * format.blockAlign), (uint32_t)samples.size());
+    
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (asFloatStereo) {
+            float value = samples[i] / 32768.f;
+            for (unsigned channel = 0; channel < 2; channel++) {
+                output.insert(output.end(), (const uint8_t *)&value, (const uint8_t *)&value + sizeof(value));
+            }
+        } else {
+            output.insert(output.end(), (const uint8_t *)&samples[i], (const uint8_t *)&samples[i] + sizeof(int16_t));
+        }
+    }
+    
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    
+    bool written = fwrite(&output[0], 1, output.size(), file) == output.size();
+    return fclose(file) == 0 && written;
+}
+
+static std::string AIMakeTemporaryPath()
+{
+    const char *directory = getenv("TMPDIR");
+    std::string path = std::string(directory && *directory ? directory : "/tmp") + "/capture-load-test-XXXXXX";
+    
+    int descriptor = mkstemp(&path[0]);
+    if (descriptor < 0) {
+        return std::string();
+    }
+    
+    close(descriptor);
+    return path;
+}
+
+static size_t AICountDifferences(const std::vector<int16_t> &samples, const std::vector<int16_t> &expected,
+                                 size_t count)
+{
+    size_t differences = 0;
+    for (size_t i = 0; i < count; i++) {
+        differences += samples[i] != expected[i % expected.size()];
+    }
+    
+    return differences;
+}
+
+// The speech recording played back from both kinds of file must match the source, and loop without a seam.
+static bool AICheckFilePlayback(const char *algorithm, const std::vector<int16_t> &speech)
+{
+    AISyntheticCaptureSettings settings = AIMakeSettings(AISyntheticSignalSpeechBursts,
+                                                         AI_CAPTURE_LOAD_CHECK_SECONDS, 1);
+    AISyntheticCaptureSource speechSource(settings, AICapturePacingMaximum);
+    std::unique_ptr<AIPipelineSink> reference;
+    AIRunToEnd(speechSource, algorithm, 0, reference);
+    
+    std::string path = AIMakeTemporaryPath();
+    if (path.empty()) {
+        printf("file playback: cannot create a temporary file, %s\n", strerror(errno));
+        return false;
+    }
+    
+    bool passed = true;
+    const char *kinds[] = {"16-bit mono", "float stereo"};
+    
+    for (unsigned kind = 0; kind < 2; kind++) {
+        if (!AIWriteWAV(path.c_str(), speech, kind == 1)) {
+            printf("%s file: cannot write %s\n", kinds[kind], path.c_str());
+            passed = false;
+            continue;
+        }
+        
+        AIFileCaptureSource source(path.c_str(), AICapturePacingMaximum);
+        std::unique_ptr<AIPipelineSink> sink;
+        
+        if (!source.isValid() || AIRunToEnd(source, algorithm, speech.size(), sink) < 0) {
+            printf("%s file: cannot play, %s\n", kinds[kind], strerror(source.getError()));
+            passed = false;
+            continue;
+        }
+        
+        size_t differences = AICountDifferences(sink->getUpload(), speech, speech.size());
+        bool decided = sink->getDecisions() == reference->getDecisions();
+        bool kindPassed = sink->getReceived() == speech.size() && differences == 0 && decided;
+        
+        printf("%s file: %llu samples, %zu differ, decisions %s\n", kinds[kind],
+               (unsigned long long)sink->getReceived(), differences, decided ? "match" : "DIFFER");
+        passed = passed && kindPassed;
+    }
+    
+    if (AIWriteWAV(path.c_str(), speech, false)) {
+        size_t length = speech.size() * AI_CAPTURE_LOAD_LOOPS;
+        AIFileCaptureSource source(path.c_str(), AICapturePacingMaximum, true);
+        std::unique_ptr<AIPipelineSink> sink(AICreateSink(algorithm, source, length));
+        
+        bool started = source.start(sink.get());
+        if (started) {
+            sink->waitUntilReceived(length);
+            source.stop();
+        }
+        
+        size_t differences = started ? AICountDifferences(sink->getUpload(), speech, length) : length;
+        printf("looping file: %d times through, %zu samples differ\n", AI_CAPTURE_LOAD_LOOPS, differences);
+        passed = passed && differences == 0;
+    }
+    
+    unlink(path.c_str());
+    return passed;
+}
+
+static bool AICheckPacing(const char *algorithm)
+{
+    AISyntheticCaptureSource source(AIMakeSettings(AISyntheticSignalSpeechBursts, AI_CAPTURE_LOAD_PACED_SECONDS, 1),
+                                    AICapturePacingRealTime);
+    std::unique_ptr<AIPipelineSink> sink;
+    double elapsed = AIRunToEnd(source, algorithm, 0, sink);
+    
+    double early = AI_CAPTURE_LOAD_PACED_SECONDS - AI_CAPTURE_SOURCE_BUFFER_MILLISECONDS / 1000.0;
+    bool passed = elapsed >= early && elapsed <= AI_CAPTURE_LOAD_PACED_SECONDS + AI_CAPTURE_LOAD_PACING_SLACK;
+    
+    printf("real-time pacing: %.1f s of audio in %.3f s%s\n", AI_CAPTURE_LOAD_PACED_SECONDS, elapsed,
+           passed ? "" : ", WRONG");
+    return passed;
+}
+
+// Runs pipelines concurrently, each on its own source thread, and compares each with one of the same seed run alone.
+static bool AIRunLoad(const char *algorithm, unsigned pipelines, double seconds)
+{
+    std::vector<std::unique_ptr<AIPipelineSink> > references(AI_CAPTURE_LOAD_SEEDS);
+    for (uint32_t seed = 0; seed < AI_CAPTURE_LOAD_SEEDS && seed < pipelines; seed++) {
+        AISyntheticCaptureSource source(AIMakeSettings(AISyntheticSignalSpeechBursts, seconds, seed + 1),
+                                        AICapturePacingMaximum);
+        AIRunToEnd(source, algorithm, 0, references[seed]);
+    }
+    
+    std::vector<std::unique_ptr<AISyntheticCaptureSource> > sources;
+    std::vector<std::unique_ptr<AIPipelineSink> > sinks;
+    
+    for (unsigned i = 0; i < pipelines; i++) {
+        AISyntheticCaptureSettings settings = AIMakeSettings(AISyntheticSignalSpeechBursts, seconds,
+                                                             i % AI_CAPTURE_LOAD_SEEDS + 1);
+        sources.push_back(std::unique_ptr<AISyntheticCaptureSource>(
+            new AISyntheticCaptureSource(settings, AICapturePacingMaximum)));
+        sinks.push_back(std::unique_ptr<AIPipelineSink>(AICreateSink(algorithm, *sources[i], 0)));
+    }
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    
+    for (unsigned i = 0; i < pipelines; i++) {
+        sources[i]->start(sinks[i].get());
+    }
+    for (unsigned i = 0; i < pipelines; i++) {
+        sinks[i]->waitUntilEnded();
+        sources[i]->stop();
+    }
+    
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    uint64_t length = (uint64_t)(seconds * sources[0]->getSampleRate());
+    unsigned failures = 0;
+    size_t decisions = 0;
+    
+    for (unsigned i = 0; i < pipelines; i++) {
+        const AIPipelineSink &reference = *references[i % AI_CAPTURE_LOAD_SEEDS];
+        bool passed = sinks[i]->getReceived() == length && sinks[i]->getDecisions() == reference.getDecisions();
+        
+        if (!passed) {
+            printf("pipeline %u: %llu of %llu samples, %zu decisions against %zu alone\n", i,
+                   (unsigned long long)sinks[i]->getReceived(), (unsigned long long)length,
+                   sinks[i]->getDecisions().size(), reference.getDecisions().size());
+        }
+        
+        failures += !passed;
+        decisions += sinks[i]->getDecisions().size();
+    }
+    
+    printf("%u pipelines of %.0f s: %zu decisions, %u differ from a pipeline alone, %.3f s, %.0fx real time "
+           "overall, %.0fx per pipeline\n", pipelines, seconds, decisions, failures, elapsed,
+           pipelines * seconds / elapsed, seconds / elapsed);
+    return failures == 0;
+}
+
+static void AIPlayFile(const char *path, const char *algorithm)
+{
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    
+    AIFileCaptureSource source(path, AICapturePacingMaximum);
+    if (!source.isValid()) {
+        printf("%s: skipped, %s\n", name, strerror(source.getError()));
+        return;
+    }
+    
+    std::unique_ptr<AIPipelineSink> sink;
+    double elapsed = AIRunToEnd(source, algorithm, 0, sink);
+    if (elapsed < 0) {
+        printf("%s: skipped, no %s detector at %.0f Hz\n", name, algorithm, source.getSampleRate());
+        return;
+    }
+    
+    double seconds = (double)sink->getReceived() / source.getSampleRate();
+    
+    printf("%s: %.1f s in %.3f s, %.0fx real time, peak meter %.2f, %s\n", name, seconds, elapsed, seconds / elapsed,
+           sink->getPeakPower(), AIFormatDecisions(sink->getDecisions(), source.getSampleRate()).c_str());
+}
+
+int main(int argc, char *argv[])
+{
+    const char *algorithm = "AdaptiveThresold";
+    unsigned pipelines = std::max(1u, std::thread::hardware_concurrency());
+    double seconds = 60;
+    
+    int option;
+    while ((option = getopt(argc, argv, "a:n:s:")) != -1) {
+        switch (option) {
+            case 'a':
+                algorithm = optarg;
+                break;
+            case 'n':
+                pipelines = (unsigned)atoi(optarg);
+                break;
+            case 's':
+                seconds = atof(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    std::unique_ptr<AIVoiceActivityDetector> probe(AICreateVoiceActivityDetector(algorithm));
+    if (!probe || pipelines == 0 || seconds <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<int16_t> speech;
+    bool endpointed = AICheckEndpoints(algorithm, speech);
+    bool played = AICheckFilePlayback(algorithm, speech);
+    bool paced = AICheckPacing(algorithm);
+    bool loaded = AIRunLoad(algorithm, pipelines, seconds);
+    
+    for (int i = optind; i < argc; i++) {
+        AIPlayFile(argv[i], algorithm);
+    }
+    
+    return endpointed && played && paced && loaded ? 0 : 1;
+}
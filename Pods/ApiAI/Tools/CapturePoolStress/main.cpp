@@ -0,0 +1,263 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * capture-pool-stress: drives an AICaptureBufferPool from a paced render thread and a lagging analysis thread, checks
+ * every buffer that comes through and the overrun statistics, and measures the time the render side spends per slice.
+ *
+ *     capture-pool-stress [-b buffers] [-f frames per slice] [-p microseconds per slice] [-s stall milliseconds] \
+ *         [-n slices]
+ *
+ * The render thread does what AISoundRecorder's sink does on the audio thread, faster than real time: every period it
+ * acquires a buffer for a slice of varying length, fills it with numbered samples and submits it, and once in a while
+ * asks for more than the capacity. The analysis thread receives, checks and releases buffers as the recorder's does,
+ * and every few hundred buffers stalls for longer than the pool lasts, as under UI load. Every delivered buffer must
+ * arrive in order with its payload intact, and the pool's overruns, dropped buffers and dropped frames must match
+ * what the render thread saw fail. Exits with 1 otherwise. Builds on Linux and macOS from the SDK sources, for
+ * example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -pthread -IApiAI/Private/DSP -IApiAI/VoiceRequest/Private/SoundRecorder \
+ *         Tools/CapturePoolStress/main.cpp ApiAI/VoiceRequest/Private/SoundRecorder/AICaptureBufferPool.cpp \
+ *         -o capture-pool-stress
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "AICaptureBufferPool.hpp"
+
+// As AISoundRecorder's pool: the largest slice the remote IO unit is allowed to render.
+#define AI_CAPTURE_STRESS_FRAME_CAPACITY 4096
+
+// One slice in this many asks for more than the capacity and must be dropped.
+#define AI_CAPTURE_STRESS_OVERSIZED_INTERVAL 4999
+
+// Buffers the analysis thread takes between two stalls.
+#define AI_CAPTURE_STRESS_STALL_INTERVAL 500
+
+struct AICaptureStressProducer {
+    uint64_t slices;
+    uint64_t droppedBuffers;
+    uint64_t droppedFrames;
+    uint64_t overruns;
+    std::vector<double> sliceMicroseconds;
+};
+
+struct AICaptureStressConsumer {
+    uint64_t delivered;
+    uint64_t stalls;
+    uint64_t errors;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-b buffers] [-f frames per slice] [-p microseconds per slice] [-s stall milliseconds] "
+            "[-n slices]\n", program);
+    return 2;
+}
+
+// The sample a slice holds at frame, different for neighbouring slices so that a buffer mixed up with another shows.
+static int16_t AIExpectedSample(uint64_t slice, uint32_t frame)
+{
+    return (int16_t)(slice * 7 + frame);
+}
+
+// The remote IO unit does not promise a fixed slice length.
+static uint32_t AISliceFrames(uint64_t slice, uint32_t frames)
+{
+    return frames - (uint32_t)(slice % 7) * (frames / 8);
+}
+
+static void AIRender(AICaptureBufferPool &pool, uint32_t frames, double period, uint64_t slices,
+                     std::atomic<bool> &finished, AICaptureStressProducer &producer)
+{
+    typedef std::chrono::steady_clock::duration AIStep;
+    AIStep step = std::chrono::duration_cast<AIStep>(std::chrono::duration<double, std::micro>(period));
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    bool dropping = false;
+    
+    for (uint64_t slice = 0; slice < slices; slice++) {
+        next += step;
+        while (std::chrono::steady_clock::now() < next) {
+        }
+        
+        uint32_t count = AISliceFrames(slice, frames);
+        if (slice % AI_CAPTURE_STRESS_OVERSIZED_INTERVAL == AI_CAPTURE_STRESS_OVERSIZED_INTERVAL - 1) {
+            count = AI_CAPTURE_STRESS_FRAME_CAPACITY + 1;
+        }
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        
+        AICaptureBuffer *buffer = pool.acquire(count);
+        if (buffer) {
+            for (uint32_t i = 0; i < count; i++) {
+                buffer->samples[i] = AIExpectedSample(slice, i);
+            }
+            
+            buffer->hostTime = slice;
+            pool.submit(buffer);
+        }
+        
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        producer.sliceMicroseconds.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        
+        if (!buffer) {
+            producer.overruns += !dropping;
+            producer.droppedBuffers++;
+            producer.droppedFrames += count;
+        }
+        
+        dropping = buffer == NULL;
+        producer.slices++;
+    }
+    
+    finished.store(true, std::memory_order_release);
+}
+
+static void AIAnalyse(AICaptureBufferPool &pool, uint32_t frames, int stallMilliseconds, std::atomic<bool> &finished,
+                      AICaptureStressConsumer &consumer)
+{
+    int64_t lastSlice = -1;
+    
+    for (;;) {
+        bool done = finished.load(std::memory_order_acquire);
+        
+        AICaptureBuffer *buffer = pool.receive();
+        if (!buffer) {
+            if (done) break;
+            std::this_thread::yield();
+            continue;
+        }
+        
+        uint64_t slice = buffer->hostTime;
+        
+        bool valid = (int64_t)slice > lastSlice && buffer->numberOfFrames == AISliceFrames(slice, frames);
+        for (uint32_t i = 0; i < buffer->numberOfFrames && valid; i++) {
+            valid = buffer->samples[i] == AIExpectedSample(slice, i);
+        }
+        
+        if (!valid) {
+            if (consumer.errors == 0) {
+                printf("buffer %llu from slice %llu, after slice %lld, is not intact\n",
+                       (unsigned long long)consumer.delivered, (unsigned long long)slice, (long long)lastSlice);
+            }
+            consumer.errors++;
+        }
+        
+        lastSlice = (int64_t)slice;
+        pool.release(buffer);
+        
+        if (++consumer.delivered % AI_CAPTURE_STRESS_STALL_INTERVAL == 0 && stallMilliseconds > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(stallMilliseconds));
+            consumer.stalls++;
+        }
+    }
+}
+
+static bool AICheckCount(const char *name, uint64_t pool, uint64_t expected)
+{
+    if (pool == expected) {
+        return true;
+    }
+    
+    printf("pool counted %llu %s, the render thread %llu\n", (unsigned long long)pool, name,
+           (unsigned long long)expected);
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t bufferCount = 64;
+    uint32_t frames = 1024;
+    double period = 100.0;
+    int stallMilliseconds = 20;
+    uint64_t slices = 50000;
+    
+    int option;
+    while ((option = getopt(argc, argv, "b:f:p:s:n:")) != -1) {
+        switch (option) {
+            case 'b':
+                bufferCount = (size_t)atol(optarg);
+                break;
+            case 'f':
+                frames = (uint32_t)atol(optarg);
+                break;
+            case 'p':
+                period = atof(optarg);
+                break;
+            case 's':
+                stallMilliseconds = atoi(optarg);
+                break;
+            case 'n':
+                slices = (uint64_t)atoll(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || bufferCount == 0 || frames < 8 || frames > AI_CAPTURE_STRESS_FRAME_CAPACITY ||
+        period < 0 || stallMilliseconds < 0 || slices == 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    AICaptureBufferPool pool(bufferCount, AI_CAPTURE_STRESS_FRAME_CAPACITY);
+    AICaptureStressProducer producer = {0, 0, 0, 0, std::vector<double>()};
+    AICaptureStressConsumer consumer = {0, 0, 0};
+    std::atomic<bool> finished(false);
+    
+    producer.sliceMicroseconds.reserve(slices);
+    
+    std::thread render(AIRender, std::ref(pool), frames, period, slices, std::ref(finished), std::ref(producer));
+    AIAnalyse(pool, frames, stallMilliseconds, finished, consumer);
+    render.join();
+    
+    AICaptureBufferPoolStatistics statistics = pool.getStatistics();
+    
+    bool counted = AICheckCount("slices", consumer.delivered + statistics.droppedBuffers, producer.slices);
+    counted = AICheckCount("overruns", statistics.overruns, producer.overruns) && counted;
+    counted = AICheckCount("dropped buffers", statistics.droppedBuffers, producer.droppedBuffers) && counted;
+    counted = AICheckCount("dropped frames", statistics.droppedFrames, producer.droppedFrames) && counted;
+    
+    std::vector<double> &times = producer.sliceMicroseconds;
+    std::sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+    double tail = times[std::min(times.size() - 1, times.size() * 999 / 1000)];
+    
+    printf("%zu buffers of %d frames, %u frames per slice every %.0f us, %d ms stalls every %d buffers\n", bufferCount,
+           AI_CAPTURE_STRESS_FRAME_CAPACITY, frames, period, stallMilliseconds, AI_CAPTURE_STRESS_STALL_INTERVAL);
+    printf("%llu slices, %llu delivered, %llu dropped in %llu overruns, %llu frames dropped, %llu stalls, "
+           "%llu errors\n", (unsigned long long)producer.slices, (unsigned long long)consumer.delivered,
+           (unsigned long long)statistics.droppedBuffers, (unsigned long long)statistics.overruns,
+           (unsigned long long)statistics.droppedFrames, (unsigned long long)consumer.stalls,
+           (unsigned long long)consumer.errors);
+    printf("render side per slice: median %.2f us, 99.9%% %.2f us, worst %.2f us\n", median, tail, times.back());
+    
+    return consumer.errors || !counted ? 1 : 0;
+}
@@ -0,0 +1,411 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * codec-round-trip: encodes recordings to µ-law and IMA ADPCM, decodes them again and prints the signal-to-noise
+ * ratio and the encode throughput of each format.
+ *
+ *     codec-round-trip [-b samples per call] [-r runs] [file.wav|directory...]
+ *
+ * Recordings must be mono 16-bit PCM; directories are searched for .wav files, and without arguments the tool uses a
+ * synthetic 16 kHz recording. ADPCM is encoded in capture-sized calls, as AIVoiceEncoder does, and decoded with the
+ * standard IMA decoder. Before the recordings, the µ-law encoder is checked against the ITU G.191 reference for every
+ * 16-bit input, in whole vectors and one sample at a time; the tool exits with 1 if any code differs or a stream
+ * decodes to the wrong length. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/Codec Tools/CodecRoundTrip/main.cpp ApiAI/Private/Codec/AIG711.cpp \
+ *         ApiAI/Private/Codec/AIIMAADPCMEncoder.cpp ApiAI/Private/Codec/AIWAVReader.cpp \
+ *         ApiAI/Private/Codec/AIWAVHeader.cpp -o codec-round-trip
+ */
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "AIG711.hpp"
+#include "AIIMAADPCMEncoder.hpp"
+#include "AIWAVReader.hpp"
+
+#define AI_ROUND_TRIP_SYNTHETIC_RATE 16000
+#define AI_ROUND_TRIP_SYNTHETIC_SECONDS 60
+
+static const int AIIMAStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107,
+    118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086,
+    29794, 32767
+};
+
+static const int AIIMAIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// Energies, encode time and size of one format, summed over every recording.
+struct AIRoundTripTally {
+    double signal;
+    double noise;
+    double encodeSeconds;
+    uint64_t bytes;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-b samples per call] [-r runs] [file.wav|directory...]\n", program);
+    return 2;
+}
+
+// linear2ulaw() of the ITU G.191 software tools, with its segment search.
+static uint8_t AIReferenceMuLaw(int16_t sample)
+{
+    static const int16_t segmentEnds[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+    
+    int value = sample >> 2;
+    int mask = 0xFF;
+    
+    if (value < 0) {
+        value = -value;
+        mask = 0x7F;
+    }
+    
+    if (value > 8159) value = 8159;
+    value += 0x84 >> 2;
+    
+    int segment = 0;
+    while (segment < 8 && value > segmentEnds[segment]) {
+        segment++;
+    }
+    
+    if (segment >= 8) return (uint8_t)(0x7F ^ mask);
+    
+    return (uint8_t)(((segment << 4) | ((value >> (segment + 1)) & 0xF)) ^ mask);
+}
+
+static unsigned AICheckMuLaw()
+{
+    std::vector<int16_t> samples(65536);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = (int16_t)(i - 32768);
+    }
+    
+    std::vector<uint8_t> codes(samples.size());
+    AIMuLawEncode(samples.data(), samples.size(), codes.data());
+    
+    unsigned differences = 0;
+    
+    for (size_t i = 0; i < samples.size(); i++) {
+        uint8_t single;
+        AIMuLawEncode(&samples[i], 1, &single);
+        
+        uint8_t reference = AIReferenceMuLaw(samples[i]);
+        differences += codes[i] != reference || single != reference;
+    }
+    
+    return differences;
+}
+
+// Standard IMA decoder for the WAV block layout that AIIMAADPCMEncoder writes.
+static void AIDecodeIMAADPCM(const std::vector<uint8_t> &blocks, unsigned blockAlign, std::vector<int16_t> &samples)
+{
+    for (size_t offset = 0; offset + blockAlign <= blocks.size(); offset += blockAlign) {
+        const uint8_t *block = &blocks[offset];
+        
+        int predictor = (int16_t)(block[0] | (block[1] << 8));
+        int stepIndex = std::min((int)block[2], 88);
+        samples.push_back((int16_t)predictor);
+        
+        for (unsigned i = 4; i < blockAlign; i++) {
+            for (unsigned nibble = 0; nibble < 2; nibble++) {
+                int code = (block[i] >> (4 * nibble)) & 0xF;
+                int step = AIIMAStepTable[stepIndex];
+                
+                int delta = step >> 3;
+                if (code & 4) delta += step;
+                if (code & 2) delta += step >> 1;
+                if (code & 1) delta += step >> 2;
+                
+                predictor += (code & 8) ? -delta : delta;
+                predictor = std::max(-32768, std::min(32767, predictor));
+                stepIndex = std::max(0, std::min(88, stepIndex + AIIMAIndexTable[code]));
+                
+                samples.push_back((int16_t)predictor);
+            }
+        }
+    }
+}
+
+static void AIAddError(const std::vector<int16_t> &samples, const std::vector<int16_t> &decoded, double &signal,
+                       double &noise)
+{
+    for (size_t i = 0; i < samples.size(); i++) {
+        double error = (double)samples[i] - (double)decoded[i];
+        signal += (double)samples[i] * (double)samples[i];
+        noise += error * error;
+    }
+}
+
+static double AISNR(double signal, double noise)
+{
+    if (noise <= 0) return INFINITY;
+    return 10.0 * log10(signal / noise);
+}
+
+// Best of runs, in seconds.
+template <typename Encode>
+static double AITimeEncode(Encode encode, int runs)
+{
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        encode();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best;
+}
+
+// Round-trips the recording through both formats; false when a decoded stream is shorter than the recording.
+static bool AIRoundTripRecording(const char *name, const std::vector<int16_t> &samples, unsigned sampleRate,
+                                 size_t callSize, int runs, AIRoundTripTally &muLaw, AIRoundTripTally &adpcm)
+{
+    std::vector<uint8_t> codes(samples.size());
+    double muLawTime = AITimeEncode([&] {
+        AIMuLawEncode(samples.data(), samples.size(), codes.data());
+    }, runs);
+    
+    std::vector<int16_t> muLawDecoded(samples.size());
+    AIMuLawDecode(codes.data(), codes.size(), muLawDecoded.data());
+    
+    AIIMAADPCMEncoder encoder;
+    std::vector<uint8_t> blocks;
+    blocks.reserve(samples.size() / 2 + AI_IMA_ADPCM_BLOCK_ALIGN);
+    
+    double adpcmTime = AITimeEncode([&] {
+        encoder.reset();
+        blocks.clear();
+        for (size_t done = 0; done < samples.size(); done += callSize) {
+            encoder.encode(&samples[done], std::min(callSize, samples.size() - done), blocks);
+        }
+        encoder.finish(blocks);
+    }, runs);
+    
+    std::vector<int16_t> adpcmDecoded;
+    AIDecodeIMAADPCM(blocks, encoder.getBlockAlign(), adpcmDecoded);
+    
+    if (adpcmDecoded.size() < samples.size()) {
+        printf("%s: ADPCM decodes to %zu samples of %zu\n", name, adpcmDecoded.size(), samples.size());
+        return false;
+    }
+    
+    double muLawSignal = 0, muLawNoise = 0, adpcmSignal = 0, adpcmNoise = 0;
+    AIAddError(samples, muLawDecoded, muLawSignal, muLawNoise);
+    AIAddError(samples, adpcmDecoded, adpcmSignal, adpcmNoise);
+    
+    double seconds = (double)samples.size() / sampleRate;
+    
+    printf("%-24s %7.1f s   %6.1f dB %9.0fx   %6.1f dB %9.0fx %6.3f\n", name, seconds,
+           AISNR(muLawSignal, muLawNoise), muLawTime > 0 ? seconds / muLawTime : 0.0,
+           AISNR(adpcmSignal, adpcmNoise), adpcmTime > 0 ? seconds / adpcmTime : 0.0,
+           samples.empty() ? 0.0 : (double)blocks.size() / (double)(samples.size() * sizeof(int16_t)));
+    
+    muLaw.signal += muLawSignal;
+    muLaw.noise += muLawNoise;
+    muLaw.encodeSeconds += muLawTime;
+    muLaw.bytes += codes.size();
+    
+    adpcm.signal += adpcmSignal;
+    adpcm.noise += adpcmNoise;
+    adpcm.encodeSeconds += adpcmTime;
+    adpcm.bytes += blocks.size();
+    
+    return true;
+}
+
+// Bursts of a pitched vowel-like tone in low noise, with the pauses between them that a voice request records.
+static std::vector<int16_t> AIMakeRecording(size_t count)
+{
+    std::vector<int16_t> samples(count);
+    uint32_t seed = 1;
+    
+    for (size_t i = 0; i < count; i++) {
+        double time = (double)i / AI_ROUND_TRIP_SYNTHETIC_RATE;
+        bool speaking = fmod(time, 3.0) > 1.5;
+        
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        double noise = ((double)(seed >> 8) / (double)(1 << 24) - 0.5) * 60.0;
+        
+        double voice = speaking ? 6000.0 * (1.0 + 0.5 * sin(2 * M_PI * 125.0 * time)) * sin(2 * M_PI * 500.0 * time) : 0.0;
+        samples[i] = (int16_t)lrint(voice + noise);
+    }
+    
+    return samples;
+}
+
+static bool AIReadRecording(const char *path, std::vector<int16_t> &samples, unsigned &sampleRate, std::string &error)
+{
+    AIWAVReader reader(path);
+    if (!reader.isOpen()) {
+        error = strerror(reader.getError());
+        return false;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    if (format.formatTag != AI_WAV_FORMAT_PCM || format.bitsPerSample != 16 || format.channels != 1) {
+        error = "not mono 16-bit PCM";
+        return false;
+    }
+    
+    sampleRate = format.sampleRate;
+    samples.resize((size_t)reader.getFrameCount());
+    samples.resize(samples.empty() ? 0 : reader.read(&samples[0], samples.size()));
+    
+    return true;
+}
+
+static void AIAddRecordings(const char *path, std::vector<std::string> &paths)
+{
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        paths.push_back(path);
+        return;
+    }
+    
+    DIR *dir = opendir(path);
+    if (!dir) {
+        paths.push_back(path);
+        return;
+    }
+    
+    std::vector<std::string> names;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 4 && strcasecmp(entry->d_name + length - 4, ".wav") == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        paths.push_back(std::string(path) + "/" + names[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t callSize = 512;
+    int runs = 10;
+    
+    int option;
+    while ((option = getopt(argc, argv, "b:r:")) != -1) {
+        switch (option) {
+            case 'b':
+                callSize = (size_t)atol(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (callSize == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<std::string> paths;
+    for (int i = optind; i < argc; i++) {
+        AIAddRecordings(argv[i], paths);
+    }
+    
+    unsigned muLawDifferences = AICheckMuLaw();
+    printf("mu-law %s the G.191 reference for all 16-bit inputs\n", muLawDifferences ? "DIFFERS FROM" : "matches");
+    
+    AIRoundTripTally muLaw = {0, 0, 0, 0};
+    AIRoundTripTally adpcm = {0, 0, 0, 0};
+    uint64_t pcmBytes = 0;
+    double seconds = 0;
+    unsigned failures = 0;
+    unsigned decoded = 0;
+    
+    printf("%-24s %9s   %9s %10s   %9s %10s %6s\n", "", "length", "mu-law", "realtime", "ADPCM", "realtime", "ratio");
+    
+    if (paths.empty()) {
+        std::vector<int16_t> samples = AIMakeRecording(AI_ROUND_TRIP_SYNTHETIC_SECONDS * AI_ROUND_TRIP_SYNTHETIC_RATE);
+        failures += !AIRoundTripRecording("synthetic", samples, AI_ROUND_TRIP_SYNTHETIC_RATE, callSize, runs, muLaw,
+                                          adpcm);
+        pcmBytes += samples.size() * sizeof(int16_t);
+        seconds += (double)samples.size() / AI_ROUND_TRIP_SYNTHETIC_RATE;
+        decoded++;
+    }
+    
+    for (size_t i = 0; i < paths.size(); i++) {
+        const char *name = strrchr(paths[i].c_str(), '/');
+        name = name ? name + 1 : paths[i].c_str();
+        
+        std::vector<int16_t> samples;
+        unsigned sampleRate = 0;
+        std::string error;
+        
+        if (!AIReadRecording(paths[i].c_str(), samples, sampleRate, error)) {
+            printf("%s: skipped, %s\n", name, error.c_str());
+            continue;
+        }
+        
+        failures += !AIRoundTripRecording(name, samples, sampleRate, callSize, runs, muLaw, adpcm);
+        pcmBytes += samples.size() * sizeof(int16_t);
+        seconds += (double)samples.size() / sampleRate;
+        decoded++;
+    }
+    
+    if (decoded == 0) {
+        return 1;
+    }
+    
+    printf("%-24s %7.1f s   %6.1f dB %9.0fx   %6.1f dB %9.0fx %6.3f\n", "total", seconds,
+           AISNR(muLaw.signal, muLaw.noise), muLaw.encodeSeconds > 0 ? seconds / muLaw.encodeSeconds : 0.0,
+           AISNR(adpcm.signal, adpcm.noise), adpcm.encodeSeconds > 0 ? seconds / adpcm.encodeSeconds : 0.0,
+           pcmBytes ? (double)adpcm.bytes / (double)pcmBytes : 0.0);
+    
+    return muLawDifferences || failures ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * conversion-benchmark: times AIConversionEngine converting a tone to 16 kHz mono int16 from common source formats
+ * and prints the throughput in multiples of real time.
+ *
+ *     conversion-benchmark [-c channels] [-b frames per block] [-s seconds] [-r runs]
+ *
+ * Every source rate is converted from int16 and from float32, block by block as AIAudioFileConvertOperation feeds the
+ * engine. The tool also prints the tone's signal-to-error ratio after conversion, as a check that speed did not cost
+ * accuracy. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/AudioFileConverter/Private Tools/ConversionBenchmark/main.cpp \
+ *         ApiAI/AudioFileConverter/Private/AIConversionEngine.cpp ApiAI/AudioFileConverter/Private/AIResampler.cpp \
+ *         ApiAI/Private/DSP/AISampleKernels.cpp -o conversion-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "AIConversionEngine.hpp"
+
+#define AI_CONVERSION_BENCHMARK_DESTINATION_RATE 16000.0
+#define AI_CONVERSION_BENCHMARK_TONE_HZ 1000.0
+#define AI_CONVERSION_BENCHMARK_AMPLITUDE 0.3
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-c channels] [-b frames per block] [-s seconds] [-r runs]\n", program);
+    return 2;
+}
+
+static double AITone(double rate, size_t frame)
+{
+    return AI_CONVERSION_BENCHMARK_AMPLITUDE * sin(2 * M_PI * AI_CONVERSION_BENCHMARK_TONE_HZ * frame / rate);
+}
+
+// Interleaved frames of the tone, the same on every channel.
+static std::vector<uint8_t> AIMakeSource(const AIPCMFormat &format, size_t frames)
+{
+    std::vector<uint8_t> bytes((size_t)format.getBytesPerFrame() * frames);
+    
+    for (size_t i = 0; i < frames; i++) {
+        double value = AITone(format.sampleRate, i);
+        
+        for (unsigned channel = 0; channel < format.channels; channel++) {
+            size_t sample = i * format.channels + channel;
+            
+            if (format.sampleType == AISampleTypeFloat32) {
+                ((float *)&bytes[0])[sample] = (float)value;
+            } else {
+                ((int16_t *)&bytes[0])[sample] = (int16_t)lrint(value * 32767.0);
+            }
+        }
+    }
+    
+    return bytes;
+}
+
+// Ratio of the ideal tone's power to the error's, in dB, away from the filter's start-up at either end.
+static double AISignalToError(const std::vector<int16_t> &output)
+{
+    double signal = 0, error = 0;
+    size_t margin = 256;
+    
+    for (size_t i = margin; i + margin < output.size(); i++) {
+        double ideal = AITone(AI_CONVERSION_BENCHMARK_DESTINATION_RATE, i) * 32767.0;
+        signal += ideal * ideal;
+        error += (output[i] - ideal) * (output[i] - ideal);
+    }
+    
+    return 10 * log10(signal / error);
+}
+
+// Best of runs, in seconds; output receives the last run's samples.
+static double AITimeConversion(const AIPCMFormat &format, const std::vector<uint8_t> &source, size_t frames,
+                               size_t blockSize, int runs, std::vector<int16_t> &output)
+{
+    double best = 0;
+    unsigned bytesPerFrame = format.getBytesPerFrame();
+    
+    for (int run = 0; run < runs; run++) {
+        AIConversionEngine engine(format, AI_CONVERSION_BENCHMARK_DESTINATION_RATE);
+        output.assign((size_t)engine.getOutputFrameCount(frames) + engine.getMaxOutputFrames(blockSize), 0);
+        size_t produced = 0;
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        
+        for (size_t done = 0; done < frames; done += blockSize) {
+            size_t count = frames - done < blockSize ? frames - done : blockSize;
+            produced += engine.process(&source[done * bytesPerFrame], count, &output[produced]);
+        }
+        produced += engine.flush(&output[produced]);
+        
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        output.resize(produced);
+        
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned channels = 2;
+    size_t blockSize = 4096;
+    double seconds = 30.0;
+    int runs = 5;
+    
+    int option;
+    while ((option = getopt(argc, argv, "c:b:s:r:")) != -1) {
+        switch (option) {
+            case 'c':
+                channels = (unsigned)atoi(optarg);
+                break;
+            case 'b':
+                blockSize = (size_t)atol(optarg);
+                break;
+            case 's':
+                seconds = atof(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || channels == 0 || blockSize == 0 || seconds <= 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    static const double rates[] = { 8000.0, 11025.0, 16000.0, 22050.0, 32000.0, 44100.0, 48000.0 };
+    static const AISampleType types[] = { AISampleTypeInt16, AISampleTypeFloat32 };
+    
+    printf("kernels %s, %u channels, %zu-frame blocks, %.0f s of audio\n", AISampleKernelsGetDefault()->name, channels,
+           blockSize, seconds);
+    
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+            AIPCMFormat format;
+            format.sampleRate = rates[r];
+            format.channels = channels;
+            format.sampleType = types[t];
+            format.bigEndian = false;
+            
+            size_t frames = (size_t)(seconds * rates[r]);
+            std::vector<uint8_t> source = AIMakeSource(format, frames);
+            std::vector<int16_t> output;
+            
+            double elapsed = AITimeConversion(format, source, frames, blockSize, runs, output);
+            
+            printf("%7.0f Hz %-7s %9.0fx real time, %6.1f dB signal to error\n", rates[r],
+                   types[t] == AISampleTypeFloat32 ? "float32" : "int16", seconds / elapsed, AISignalToError(output));
+        }
+    }
+    
+    return 0;
+}
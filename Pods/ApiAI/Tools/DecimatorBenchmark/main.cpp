@@ -0,0 +1,307 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * decimator-benchmark: measures AIDecimator from common hardware rates to 16 kHz, and on to 8 kHz, at every quality.
+ *
+ *     decimator-benchmark [-b frames per block] [-s seconds] [-r runs]
+ *
+ * Tones across the passband give the ripple, tones that fold onto the passband give the alias rejection, and the
+ * phase of a low tone gives the delay of each output behind the input sample that completed it, which should be
+ * getLatency(). The speed is timed on noise, in multiples of real time. Exits with 1 when the ripple exceeds
+ * 0.05 dB, an alias is less than the settings' stopband down, or the delay is off by more than a microsecond. Builds
+ * on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP Tools/DecimatorBenchmark/main.cpp ApiAI/Private/DSP/AIDecimator.cpp \
+ *         -o decimator-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <complex>
+#include <vector>
+
+#include "AIDecimator.hpp"
+
+#define AI_DECIMATOR_BENCHMARK_OUTPUT_RATE 16000.0
+#define AI_DECIMATOR_BENCHMARK_AMPLITUDE 0.5
+
+// Tones per band edge to edge, and output samples every tone is measured over once the filters have settled.
+#define AI_DECIMATOR_BENCHMARK_TONES 24
+#define AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES 4096
+
+// Low enough that a period is longer than any delay, so the phase is not ambiguous.
+#define AI_DECIMATOR_BENCHMARK_DELAY_TONE_HZ 50.0
+
+#define AI_DECIMATOR_BENCHMARK_MAX_RIPPLE_DECIBELS 0.05
+#define AI_DECIMATOR_BENCHMARK_MAX_DELAY_ERROR 1e-6
+
+// One of the two streams of a decimator: the output, or the narrowband one derived from it.
+struct AIDecimatorBenchmarkStream {
+    const char *name;
+    bool narrowband;
+    double rate;
+    double passbandHz;
+    double latency;
+};
+
+// What one stream measured.
+struct AIDecimatorBenchmarkResult {
+    double ripple;
+    double rejection;
+    double delay;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-b frames per block] [-s seconds] [-r runs]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Runs a tone of frequencyHz through a fresh decimator block by block, and returns the stream's samples.
+static std::vector<float> AIDecimateTone(double inputRate, const AIDecimatorSettings &settings, bool narrowband,
+                                         double frequencyHz, size_t inputFrames, size_t blockSize)
+{
+    AIDecimator decimator(inputRate, AI_DECIMATOR_BENCHMARK_OUTPUT_RATE, settings, blockSize);
+    
+    std::vector<float> input(blockSize);
+    std::vector<float> output(decimator.getMaxOutputFrames(blockSize));
+    std::vector<float> narrowbandOutput(decimator.getMaxNarrowbandFrames(blockSize));
+    std::vector<float> stream;
+    
+    for (size_t done = 0; done < inputFrames; done += blockSize) {
+        size_t count = inputFrames - done < blockSize ? inputFrames - done : blockSize;
+        for (size_t i = 0; i < count; i++) {
+            input[i] = (float)(AI_DECIMATOR_BENCHMARK_AMPLITUDE * sin(2 * M_PI * frequencyHz * (double)(done + i) /
+                                                                     inputRate));
+        }
+        
+        AIDecimatorOutput produced = decimator.process(&input[0], count, &output[0],
+                                                       narrowband ? &narrowbandOutput[0] : NULL);
+        
+        if (narrowband) {
+            stream.insert(stream.end(), narrowbandOutput.begin(), narrowbandOutput.begin() + produced.narrowbandFrames);
+        } else {
+            stream.insert(stream.end(), output.begin(), output.begin() + produced.frames);
+        }
+    }
+    
+    return stream;
+}
+
+// Amplitude and phase of the component at frequencyHz in the last AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES samples,
+// through a Hann window. Sample n is taken at (n * factor + factor - 1) / inputRate, when the input sample that
+// completes it arrives, so the phase tells its delay behind the input.
+static std::complex<double> AIMeasureTone(const std::vector<float> &stream, double frequencyHz, unsigned factor,
+                                          double inputRate)
+{
+    size_t start = stream.size() - AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES;
+    std::complex<double> sum = 0;
+    double weights = 0;
+    
+    for (size_t i = 0; i < AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES; i++) {
+        size_t n = start + i;
+        double weight = 0.5 - 0.5 * cos(2 * M_PI * (i + 0.5) / AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES);
+        double time = (double)(n * factor + factor - 1) / inputRate;
+        
+        sum += weight * (double)stream[n] * std::polar(1.0, -2 * M_PI * frequencyHz * time);
+        weights += weight;
+    }
+    
+    // A sine of amplitude a and phase p comes out as a / 2j * e^jp of the weights.
+    return sum * std::complex<double>(0.0, 2.0) / weights;
+}
+
+static AIDecimatorBenchmarkResult AIMeasureStream(double inputRate, const AIDecimatorSettings &settings,
+                                                  const AIDecimatorBenchmarkStream &stream, size_t blockSize)
+{
+    unsigned factor = (unsigned)lrint(inputRate / stream.rate);
+    
+    // Long enough for the filters to settle several times over before the measured samples.
+    size_t settleFrames = (size_t)ceil(stream.latency * stream.rate) * 4 + 64;
+    size_t inputFrames = (settleFrames + AI_DECIMATOR_BENCHMARK_MEASURED_FRAMES) * factor;
+    
+    AIDecimatorBenchmarkResult result;
+    double lowest = 0, highest = 0;
+    
+    for (unsigned tone = 1; tone <= AI_DECIMATOR_BENCHMARK_TONES; tone++) {
+        double frequencyHz = stream.passbandHz * tone / AI_DECIMATOR_BENCHMARK_TONES;
+        std::vector<float> output = AIDecimateTone(inputRate, settings, stream.narrowband, frequencyHz, inputFrames,
+                                                   blockSize);
+        
+        double gain = 20 * log10(std::abs(AIMeasureTone(output, frequencyHz, factor, inputRate)) /
+                                 AI_DECIMATOR_BENCHMARK_AMPLITUDE);
+        if (tone == 1 || gain < lowest) lowest = gain;
+        if (tone == 1 || gain > highest) highest = gain;
+    }
+    
+    result.ripple = highest - lowest;
+    
+    // Every tone k * rate +- f below the input's Nyquist frequency lands on f of the passband.
+    result.rejection = HUGE_VAL;
+    
+    for (unsigned tone = 1; tone <= AI_DECIMATOR_BENCHMARK_TONES; tone++) {
+        double frequencyHz = stream.passbandHz * tone / AI_DECIMATOR_BENCHMARK_TONES;
+        
+        for (unsigned k = 1; k * stream.rate - frequencyHz < inputRate / 2; k++) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                double aliasHz = k * stream.rate + sign * frequencyHz;
+                if (aliasHz >= inputRate / 2) continue;
+                
+                std::vector<float> output = AIDecimateTone(inputRate, settings, stream.narrowband, aliasHz,
+                                                           inputFrames, blockSize);
+                
+                double amplitude = std::abs(AIMeasureTone(output, frequencyHz, factor, inputRate));
+                double rejection = 20 * log10(AI_DECIMATOR_BENCHMARK_AMPLITUDE / amplitude);
+                if (rejection < result.rejection) result.rejection = rejection;
+            }
+        }
+    }
+    
+    // The tone is delayed by -phase / omega, less whole periods.
+    std::vector<float> output = AIDecimateTone(inputRate, settings, stream.narrowband,
+                                               AI_DECIMATOR_BENCHMARK_DELAY_TONE_HZ, inputFrames, blockSize);
+    double phase = std::arg(AIMeasureTone(output, AI_DECIMATOR_BENCHMARK_DELAY_TONE_HZ, factor, inputRate));
+    double period = 1.0 / AI_DECIMATOR_BENCHMARK_DELAY_TONE_HZ;
+    
+    result.delay = fmod(-phase / (2 * M_PI * AI_DECIMATOR_BENCHMARK_DELAY_TONE_HZ) + period, period);
+    
+    return result;
+}
+
+// Best of runs, in seconds, for seconds of noise through the output stream only, as the capture source runs it.
+static double AITimeDecimator(double inputRate, const AIDecimatorSettings &settings, double seconds,
+                              size_t blockSize, int runs)
+{
+    size_t frames = (size_t)(seconds * inputRate);
+    std::vector<float> input(frames);
+    uint32_t state = 1;
+    
+    for (size_t i = 0; i < frames; i++) {
+        input[i] = (float)((double)AINextRandom(state) / 4294967296.0 - 0.5);
+    }
+    
+    AIDecimator decimator(inputRate, AI_DECIMATOR_BENCHMARK_OUTPUT_RATE, settings, blockSize);
+    std::vector<float> output(decimator.getMaxOutputFrames(blockSize));
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        decimator.reset();
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        
+        for (size_t done = 0; done < frames; done += blockSize) {
+            size_t count = frames - done < blockSize ? frames - done : blockSize;
+            decimator.process(&input[done], count, &output[0], NULL);
+        }
+        
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t blockSize = 1024;
+    double seconds = 30.0;
+    int runs = 5;
+    
+    int option;
+    while ((option = getopt(argc, argv, "b:s:r:")) != -1) {
+        switch (option) {
+            case 'b':
+                blockSize = (size_t)atol(optarg);
+                break;
+            case 's':
+                seconds = atof(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || blockSize == 0 || seconds <= 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    static const double rates[] = { 32000.0, 48000.0, 96000.0 };
+    static const AIDecimatorQuality qualities[] = {
+        AIDecimatorQualityLowLatency, AIDecimatorQualityBalanced, AIDecimatorQualityHigh,
+    };
+    static const char *const qualityNames[] = { "low latency", "balanced", "high" };
+    
+    printf("%zu-frame blocks, %.0f s of noise timed\n", blockSize, seconds);
+    
+    unsigned failures = 0;
+    
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        for (size_t q = 0; q < sizeof(qualities) / sizeof(qualities[0]); q++) {
+            AIDecimatorSettings settings = AIDecimatorSettingsForQuality(qualities[q]);
+            AIDecimator decimator(rates[r], AI_DECIMATOR_BENCHMARK_OUTPUT_RATE, settings, blockSize);
+            
+            double elapsed = AITimeDecimator(rates[r], settings, seconds, blockSize, runs);
+            printf("%6.0f Hz %-11s %8.0fx real time\n", rates[r], qualityNames[q], seconds / elapsed);
+            
+            double passbandHz = settings.passband * AI_DECIMATOR_BENCHMARK_OUTPUT_RATE / 2;
+            AIDecimatorBenchmarkStream streams[] = {
+                { "output", false, AI_DECIMATOR_BENCHMARK_OUTPUT_RATE, passbandHz, decimator.getLatency() },
+                { "narrowband", true, AI_DECIMATOR_BENCHMARK_OUTPUT_RATE / 2, passbandHz / 2,
+                  decimator.getNarrowbandLatency() },
+            };
+            
+            for (size_t s = 0; s < sizeof(streams) / sizeof(streams[0]); s++) {
+                AIDecimatorBenchmarkResult result = AIMeasureStream(rates[r], settings, streams[s], blockSize);
+                
+                bool passes = result.ripple <= AI_DECIMATOR_BENCHMARK_MAX_RIPPLE_DECIBELS &&
+                              result.rejection >= settings.stopbandDecibels &&
+                              fabs(result.delay - streams[s].latency) <= AI_DECIMATOR_BENCHMARK_MAX_DELAY_ERROR;
+                failures += !passes;
+                
+                printf("    %-10s flat to %4.0f Hz within %.5f dB, aliases %5.1f dB down (%3.0f required), "
+                       "delay %.3f ms (getLatency %.3f)%s\n", streams[s].name, streams[s].passbandHz, result.ripple,
+                       result.rejection, settings.stopbandDecibels, result.delay * 1e3, streams[s].latency * 1e3,
+                       passes ? "" : " FAILED");
+            }
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
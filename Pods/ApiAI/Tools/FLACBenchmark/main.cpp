@@ -0,0 +1,517 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * flac-benchmark: encodes recordings with AIFLACEncoder and prints the compression ratio and the encode cost per
+ * second of audio.
+ *
+ *     flac-benchmark [-b samples per call] [-o max LPC order] [-r runs] [file.wav|directory...]
+ *
+ * Recordings must be mono 16-bit PCM; directories are searched for .wav files, and without arguments the tool
+ * encodes a synthetic 16 kHz recording. Samples are handed to the encoder in capture-sized calls, as AIVoiceEncoder
+ * does. Every stream is decoded again, with the CRCs checked, and must give back the recording sample for sample.
+ * Exits with 1 otherwise. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/Codec Tools/FLACBenchmark/main.cpp ApiAI/Private/Codec/AIFLACEncoder.cpp \
+ *         ApiAI/Private/Codec/AIWAVReader.cpp ApiAI/Private/Codec/AIWAVHeader.cpp -o flac-benchmark
+ */
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "AIFLACEncoder.hpp"
+#include "AIWAVReader.hpp"
+
+#define AI_FLAC_BENCHMARK_SYNTHETIC_RATE 16000
+#define AI_FLAC_BENCHMARK_SYNTHETIC_SECONDS 60
+
+struct AIFLACBenchmarkTally {
+    double seconds;
+    double encodeSeconds;
+    uint64_t pcmBytes;
+    uint64_t flacBytes;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-b samples per call] [-o max LPC order] [-r runs] [file.wav|directory...]\n", program);
+    return 2;
+}
+
+// MSB-first reader over a FLAC stream; reads past the end return zero bits and set overrun.
+class AIFLACBitReader {
+public:
+    
+    AIFLACBitReader(const std::vector<uint8_t> &stream) : stream(stream), position(0), overrun(false)
+    {
+        
+    }
+    
+    uint32_t read(unsigned bits)
+    {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < bits; i++, position++) {
+            size_t byte = position >> 3;
+            if (byte >= stream.size()) {
+                overrun = true;
+                value <<= 1;
+                continue;
+            }
+            value = (value << 1) | ((stream[byte] >> (7 - (position & 7))) & 1);
+        }
+        return value;
+    }
+    
+    int32_t readSigned(unsigned bits)
+    {
+        uint32_t value = read(bits);
+        if (bits < 32 && (value >> (bits - 1)) & 1) {
+            value |= ~0u << bits;
+        }
+        return (int32_t)value;
+    }
+    
+    uint32_t readUnary()
+    {
+        uint32_t zeros = 0;
+        while (!overrun && read(1) == 0) {
+            zeros++;
+        }
+        return zeros;
+    }
+    
+    void alignToByte()
+    {
+        position = (position + 7) & ~(uint64_t)7;
+    }
+    
+    void skipBytes(uint64_t count)
+    {
+        position += count * 8;
+    }
+    
+    size_t getBytePosition() const
+    {
+        return (size_t)(position >> 3);
+    }
+    
+    bool atEnd() const
+    {
+        return (position >> 3) >= stream.size();
+    }
+    
+    bool hasOverrun() const
+    {
+        return overrun;
+    }
+    
+private:
+    const std::vector<uint8_t> &stream;
+    uint64_t position;
+    bool overrun;
+    
+private:
+    AIFLACBitReader( const AIFLACBitReader& );
+    void operator=( const AIFLACBitReader& );
+};
+
+static uint8_t AICRC8(const uint8_t *data, size_t length)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (unsigned bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t AICRC16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (unsigned bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x8005) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static unsigned AIDecodeBlockSize(AIFLACBitReader &reader, unsigned code)
+{
+    if (code == 1) return 192;
+    if (code >= 2 && code <= 5) return 576u << (code - 2);
+    if (code == 6) return reader.read(8) + 1;
+    if (code == 7) return reader.read(16) + 1;
+    if (code >= 8) return 256u << (code - 8);
+    return 0;
+}
+
+static bool AIDecodeResidual(AIFLACBitReader &reader, unsigned order, std::vector<int32_t> &block)
+{
+    if (reader.read(2) != 0) return false;
+    
+    unsigned partitionOrder = reader.read(4);
+    unsigned size = (unsigned)block.size() >> partitionOrder;
+    if (size < order) return false;
+    
+    size_t i = order;
+    for (unsigned p = 0; p < (1u << partitionOrder); p++) {
+        unsigned parameter = reader.read(4);
+        if (parameter == 15) return false;
+        
+        unsigned count = size - (p == 0 ? order : 0);
+        for (unsigned j = 0; j < count && !reader.hasOverrun(); j++) {
+            uint32_t folded = (reader.readUnary() << parameter) | reader.read(parameter);
+            block[i++] = (int32_t)(folded >> 1) ^ -(int32_t)(folded & 1);
+        }
+    }
+    
+    return !reader.hasOverrun();
+}
+
+// Decodes the subset of FLAC that AIFLACEncoder writes: mono 16-bit frames with one subframe each.
+static bool AIDecodeFLAC(const std::vector<uint8_t> &stream, std::vector<int16_t> &samples)
+{
+    AIFLACBitReader reader(stream);
+    
+    if (reader.read(32) != 0x664C6143) return false;
+    
+    bool last = false;
+    while (!last && !reader.hasOverrun()) {
+        last = reader.read(1) != 0;
+        reader.read(7);
+        reader.skipBytes(reader.read(24));
+    }
+    
+    std::vector<int32_t> block;
+    
+    while (!reader.atEnd()) {
+        size_t frameStart = reader.getBytePosition();
+        
+        if (reader.read(16) != 0xFFF8) return false;
+        
+        unsigned blockSizeCode = reader.read(4);
+        unsigned sampleRateCode = reader.read(4);
+        if (reader.read(4) != 0 || reader.read(3) != 4 || reader.read(1) != 0) return false;
+        
+        uint32_t first = reader.read(8);
+        for (uint32_t mask = 0x40; (first & 0x80) && (first & mask); mask >>= 1) {
+            reader.read(8);
+        }
+        
+        block.resize(AIDecodeBlockSize(reader, blockSizeCode));
+        if (block.empty()) return false;
+        
+        if (sampleRateCode == 12) reader.read(8);
+        if (sampleRateCode == 13 || sampleRateCode == 14) reader.read(16);
+        
+        size_t headerEnd = reader.getBytePosition();
+        if (reader.read(8) != AICRC8(&stream[frameStart], headerEnd - frameStart)) return false;
+        
+        if (reader.read(1) != 0) return false;
+        unsigned type = reader.read(6);
+        if (reader.read(1) != 0) return false;
+        
+        unsigned count = (unsigned)block.size();
+        
+        if (type == 0) {
+            std::fill(block.begin(), block.end(), reader.readSigned(16));
+        } else if (type == 1) {
+            for (unsigned i = 0; i < count; i++) {
+                block[i] = reader.readSigned(16);
+            }
+        } else if ((type & 0x38) == 0x08 && (type & 7) <= 4) {
+            unsigned order = type & 7;
+            for (unsigned i = 0; i < order && i < count; i++) {
+                block[i] = reader.readSigned(16);
+            }
+            if (!AIDecodeResidual(reader, order, block)) return false;
+            
+            for (unsigned i = order; i < count; i++) {
+                int32_t *x = &block[i];
+                switch (order) {
+                    case 1: x[0] += x[-1]; break;
+                    case 2: x[0] += 2 * x[-1] - x[-2]; break;
+                    case 3: x[0] += 3 * x[-1] - 3 * x[-2] + x[-3]; break;
+                    case 4: x[0] += 4 * x[-1] - 6 * x[-2] + 4 * x[-3] - x[-4]; break;
+                }
+            }
+        } else if (type & 0x20) {
+            unsigned order = (type & 0x1F) + 1;
+            if (order > count) return false;
+            
+            for (unsigned i = 0; i < order; i++) {
+                block[i] = reader.readSigned(16);
+            }
+            
+            unsigned precision = reader.read(4) + 1;
+            int shift = reader.readSigned(5);
+            if (shift < 0) return false;
+            
+            int32_t coefficients[32];
+            for (unsigned i = 0; i < order; i++) {
+                coefficients[i] = reader.readSigned(precision);
+            }
+            if (!AIDecodeResidual(reader, order, block)) return false;
+            
+            for (unsigned i = order; i < count; i++) {
+                int64_t prediction = 0;
+                for (unsigned j = 0; j < order; j++) {
+                    prediction += (int64_t)coefficients[j] * block[i - j - 1];
+                }
+                block[i] += (int32_t)(prediction >> shift);
+            }
+        } else {
+            return false;
+        }
+        
+        reader.alignToByte();
+        size_t frameEnd = reader.getBytePosition();
+        if (reader.read(16) != AICRC16(&stream[frameStart], frameEnd - frameStart)) return false;
+        if (reader.hasOverrun()) return false;
+        
+        for (unsigned i = 0; i < count; i++) {
+            if (block[i] < INT16_MIN || block[i] > INT16_MAX) return false;
+            samples.push_back((int16_t)block[i]);
+        }
+    }
+    
+    return true;
+}
+
+// Bursts of a pitched vowel-like tone in low noise, with the pauses between them that a voice request records.
+static std::vector<int16_t> AIMakeRecording(size_t count)
+{
+    std::vector<int16_t> samples(count);
+    uint32_t seed = 1;
+    
+    for (size_t i = 0; i < count; i++) {
+        double time = (double)i / AI_FLAC_BENCHMARK_SYNTHETIC_RATE;
+        bool speaking = fmod(time, 3.0) > 1.5;
+        
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        double noise = ((double)(seed >> 8) / (double)(1 << 24) - 0.5) * 60.0;
+        
+        double voice = speaking ? 6000.0 * (1.0 + 0.5 * sin(2 * M_PI * 125.0 * time)) * sin(2 * M_PI * 500.0 * time) : 0.0;
+        samples[i] = (int16_t)lrint(voice + noise);
+    }
+    
+    return samples;
+}
+
+static bool AIReadRecording(const char *path, std::vector<int16_t> &samples, unsigned &sampleRate, std::string &error)
+{
+    AIWAVReader reader(path);
+    if (!reader.isOpen()) {
+        error = strerror(reader.getError());
+        return false;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    if (format.formatTag != AI_WAV_FORMAT_PCM || format.bitsPerSample != 16 || format.channels != 1) {
+        error = "not mono 16-bit PCM";
+        return false;
+    }
+    
+    sampleRate = format.sampleRate;
+    samples.resize((size_t)reader.getFrameCount());
+    samples.resize(samples.empty() ? 0 : reader.read(&samples[0], samples.size()));
+    
+    return true;
+}
+
+static void AIAddRecordings(const char *path, std::vector<std::string> &paths)
+{
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        paths.push_back(path);
+        return;
+    }
+    
+    DIR *dir = opendir(path);
+    if (!dir) {
+        paths.push_back(path);
+        return;
+    }
+    
+    std::vector<std::string> names;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 4 && strcasecmp(entry->d_name + length - 4, ".wav") == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        paths.push_back(std::string(path) + "/" + names[i]);
+    }
+}
+
+static void AIEncode(AIFLACEncoder &encoder, const std::vector<int16_t> &samples, size_t callSize,
+                     std::vector<uint8_t> &stream)
+{
+    encoder.reset();
+    stream.clear();
+    encoder.writeStreamHeader(stream);
+    
+    for (size_t done = 0; done < samples.size(); done += callSize) {
+        encoder.encode(&samples[done], std::min(callSize, samples.size() - done), stream);
+    }
+    
+    encoder.finish(stream);
+}
+
+// Encodes the recording runs times, keeping the best time, and checks that the stream decodes to it.
+static bool AIBenchmarkRecording(const char *name, const std::vector<int16_t> &samples, unsigned sampleRate,
+                                 size_t callSize, unsigned maxLPCOrder, int runs, AIFLACBenchmarkTally &tally)
+{
+    AIFLACEncoder encoder(sampleRate, AI_FLAC_DEFAULT_BLOCK_SIZE, maxLPCOrder);
+    std::vector<uint8_t> stream;
+    stream.reserve(samples.size() * sizeof(int16_t) + 1024);
+    
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        AIEncode(encoder, samples, callSize, stream);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    std::vector<int16_t> decoded;
+    decoded.reserve(samples.size());
+    bool lossless = AIDecodeFLAC(stream, decoded) && decoded == samples;
+    
+    double seconds = (double)samples.size() / sampleRate;
+    uint64_t pcmBytes = samples.size() * sizeof(int16_t);
+    
+    printf("%-24s %7.1f s %6.3f %8.3f ms/s %8.0fx  %s\n", name, seconds,
+           pcmBytes ? (double)stream.size() / (double)pcmBytes : 0.0, seconds > 0 ? best * 1e3 / seconds : 0.0,
+           best > 0 ? seconds / best : 0.0, lossless ? "lossless" : "DIFFERENT");
+    
+    tally.seconds += seconds;
+    tally.encodeSeconds += best;
+    tally.pcmBytes += pcmBytes;
+    tally.flacBytes += stream.size();
+    
+    return lossless;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t callSize = 512;
+    unsigned maxLPCOrder = AI_FLAC_MAX_LPC_ORDER;
+    int runs = 10;
+    
+    int option;
+    while ((option = getopt(argc, argv, "b:o:r:")) != -1) {
+        switch (option) {
+            case 'b':
+                callSize = (size_t)atol(optarg);
+                break;
+            case 'o':
+                maxLPCOrder = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (callSize == 0 || maxLPCOrder > AI_FLAC_MAX_LPC_ORDER || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<std::string> paths;
+    for (int i = optind; i < argc; i++) {
+        AIAddRecordings(argv[i], paths);
+    }
+    
+    AIFLACBenchmarkTally tally = {0, 0, 0, 0};
+    unsigned encoded = 0;
+    unsigned differences = 0;
+    
+    printf("%zu samples per call, LPC up to order %u, %u-sample blocks\n", callSize, maxLPCOrder,
+           AI_FLAC_DEFAULT_BLOCK_SIZE);
+    printf("%-24s %9s %6s %13s %9s\n", "", "length", "ratio", "encode", "realtime");
+    
+    if (paths.empty()) {
+        std::vector<int16_t> samples = AIMakeRecording(AI_FLAC_BENCHMARK_SYNTHETIC_SECONDS *
+                                                       AI_FLAC_BENCHMARK_SYNTHETIC_RATE);
+        differences += !AIBenchmarkRecording("synthetic", samples, AI_FLAC_BENCHMARK_SYNTHETIC_RATE, callSize,
+                                             maxLPCOrder, runs, tally);
+        encoded++;
+    }
+    
+    for (size_t i = 0; i < paths.size(); i++) {
+        const char *name = strrchr(paths[i].c_str(), '/');
+        name = name ? name + 1 : paths[i].c_str();
+        
+        std::vector<int16_t> samples;
+        unsigned sampleRate = 0;
+        std::string error;
+        
+        if (!AIReadRecording(paths[i].c_str(), samples, sampleRate, error)) {
+            printf("%s: skipped, %s\n", name, error.c_str());
+            continue;
+        }
+        
+        differences += !AIBenchmarkRecording(name, samples, sampleRate, callSize, maxLPCOrder, runs, tally);
+        encoded++;
+    }
+    
+    if (encoded == 0) {
+        return 1;
+    }
+    
+    printf("%-24s %7.1f s %6.3f %8.3f ms/s %8.0fx  %u of %u lossless\n", "total", tally.seconds,
+           tally.pcmBytes ? (double)tally.flacBytes / (double)tally.pcmBytes : 0.0,
+           tally.seconds > 0 ? tally.encodeSeconds * 1e3 / tally.seconds : 0.0,
+           tally.encodeSeconds > 0 ? tally.seconds / tally.encodeSeconds : 0.0, encoded - differences, encoded);
+    
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,355 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * fixed-point-vad: checks that the fixed-point detectors end recordings where the floating-point ones do, and times
+ * both on int16 frames.
+ *
+ *     fixed-point-vad [-t trials] [-r runs] [file.wav|directory...]
+ *
+ * AIMeasureFixedFrame is first compared with exact integer sums over random frames of every length up to 320,
+ * full-scale samples included. Then each pair of detectors runs over synthetic 16 kHz recordings, with speech of
+ * random level, pitch and timing over random noise, and over the given 16 kHz mono 16-bit recordings; directories are
+ * searched for .wav files. Both detectors of a pair must decide alike, and the fixed-point one may end at most one
+ * frame away from the floating-point one, the tolerance their rounding is documented to allow. Exits with 1
+ * otherwise. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/Private/Codec -IApiAI/VoiceRequest/Private/VAD \
+ *         Tools/FixedPointVAD/main.cpp ApiAI/VoiceRequest/Private/VAD/AIAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIFixedAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIEnergyAndZeroCrossDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIFixedEnergyAndZeroCrossDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIVoiceActivityDetector.cpp ApiAI/Private/DSP/AIFrameFeatures.cpp \
+ *         ApiAI/Private/Codec/AIWAVReader.cpp ApiAI/Private/Codec/AIWAVHeader.cpp -o fixed-point-vad
+ */
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "AIAdaptiveThresholdDetector.hpp"
+#include "AIEnergyAndZeroCrossDetector.hpp"
+#include "AIFixedAdaptiveThresholdDetector.hpp"
+#include "AIFixedEnergyAndZeroCrossDetector.hpp"
+#include "AIWAVReader.hpp"
+
+#define AI_FIXED_VAD_SAMPLE_RATE 16000
+#define AI_FIXED_VAD_FRAME_SIZE 160
+#define AI_FIXED_VAD_TRIAL_FRAMES 1200
+#define AI_FIXED_VAD_MAX_CHECKED_LENGTH 320
+#define AI_FIXED_VAD_MAX_ENDPOINT_SHIFT 1
+
+struct AIFixedVADTally {
+    const char *algorithm;
+    unsigned long recordings;
+    unsigned long decisions;
+    unsigned long moved;
+    unsigned long failures;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-t trials] [-r runs] [file.wav|directory...]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static unsigned AICheckFixedFrames()
+{
+    uint32_t seed = 1;
+    unsigned differences = 0;
+    std::vector<int16_t> samples(AI_FIXED_VAD_MAX_CHECKED_LENGTH);
+    
+    for (size_t count = 0; count <= AI_FIXED_VAD_MAX_CHECKED_LENGTH; count++) {
+        for (unsigned repeat = 0; repeat < 16; repeat++) {
+            for (size_t i = 0; i < count; i++) {
+                uint32_t random = AINextRandom(seed);
+                switch (random % 5) {
+                    case 0: samples[i] = INT16_MIN; break;
+                    case 1: samples[i] = INT16_MAX; break;
+                    case 2: samples[i] = 0; break;
+                    default: samples[i] = (int16_t)(random >> 16); break;
+                }
+            }
+            
+            uint64_t sumOfSquares = 0;
+            unsigned signChanges = 0;
+            uint32_t peak = 0;
+            
+            for (size_t i = 0; i < count; i++) {
+                int32_t sample = samples[i];
+                sumOfSquares += (uint64_t)(sample * sample);
+                peak = std::max(peak, (uint32_t)abs(sample));
+                if (i > 0) signChanges += (samples[i] > 0) != (samples[i - 1] > 0);
+            }
+            
+            AIFixedFrameFeatures features = AIMeasureFixedFrame(samples.data(), count);
+            differences += features.sumOfSquares != sumOfSquares || features.signChanges != signChanges ||
+                           features.peak != peak;
+        }
+    }
+    
+    return differences;
+}
+
+// Speech bursts of a random level and pitch, at random times, over noise of a random level.
+static std::vector<int16_t> AIMakeTrial(unsigned trial)
+{
+    uint32_t seed = trial * 2654435761u + 1;
+    double noise = 5.0 + AINextRandom(seed) % 400;
+    double level = 500.0 + AINextRandom(seed) % 20000;
+    double pitch = 100.0 + AINextRandom(seed) % 300;
+    
+    std::vector<int16_t> samples(AI_FIXED_VAD_TRIAL_FRAMES * AI_FIXED_VAD_FRAME_SIZE);
+    
+    for (size_t i = 0; i < samples.size(); i++) {
+        size_t frame = i / AI_FIXED_VAD_FRAME_SIZE;
+        double time = (double)i / AI_FIXED_VAD_SAMPLE_RATE;
+        bool speaking = (frame > 40 + trial % 50 && frame < 200 + trial % 300) || (frame > 400 && frame < 420 + trial);
+        
+        double value = noise * ((double)(AINextRandom(seed) % 2001) - 1000.0) / 1000.0;
+        if (speaking) {
+            value += level * sin(2 * M_PI * pitch * time) * (0.5 + 0.5 * sin(2 * M_PI * 3.0 * time));
+            value += 0.3 * level * sin(2 * M_PI * 2.3 * pitch * time);
+        }
+        
+        samples[i] = (int16_t)std::max(-32768.0, std::min(32767.0, value));
+    }
+    
+    return samples;
+}
+
+// Frame at which the detector decides, or -1 if it does not before the recording ends.
+template <typename Detector>
+static long AIFindEndpoint(const std::vector<int16_t> &samples, AIVoiceActivityResult &result)
+{
+    Detector detector;
+    result = AIVoiceActivityResultContinue;
+    
+    for (size_t offset = 0; offset + AI_FIXED_VAD_FRAME_SIZE <= samples.size(); offset += AI_FIXED_VAD_FRAME_SIZE) {
+        result = detector.process(&samples[offset], AI_FIXED_VAD_FRAME_SIZE);
+        if (result != AIVoiceActivityResultContinue) {
+            return (long)(offset / AI_FIXED_VAD_FRAME_SIZE);
+        }
+    }
+    
+    return -1;
+}
+
+template <typename FloatDetector, typename FixedDetector>
+static void AICompareRecording(const char *name, const std::vector<int16_t> &samples, AIFixedVADTally &tally)
+{
+    AIVoiceActivityResult floatResult, fixedResult;
+    long floatEnd = AIFindEndpoint<FloatDetector>(samples, floatResult);
+    long fixedEnd = AIFindEndpoint<FixedDetector>(samples, fixedResult);
+    
+    tally.recordings++;
+    tally.decisions += floatEnd >= 0;
+    
+    if (floatEnd == fixedEnd && floatResult == fixedResult) {
+        return;
+    }
+    
+    bool withinTolerance = floatResult == fixedResult && floatEnd >= 0 && fixedEnd >= 0 &&
+                           labs(floatEnd - fixedEnd) <= AI_FIXED_VAD_MAX_ENDPOINT_SHIFT;
+    
+    tally.moved++;
+    tally.failures += !withinTolerance;
+    
+    printf("%s %s: floating point ends with %d at frame %ld, fixed point with %d at frame %ld\n", tally.algorithm,
+           name, floatResult, floatEnd, fixedResult, fixedEnd);
+}
+
+// Best of runs, in nanoseconds per int16 frame.
+template <typename Detector>
+static double AITimeDetector(const std::vector<int16_t> &samples, int runs)
+{
+    Detector detector;
+    size_t frames = samples.size() / AI_FIXED_VAD_FRAME_SIZE;
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        detector.reset();
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++) {
+            if (detector.process(&samples[frame * AI_FIXED_VAD_FRAME_SIZE], AI_FIXED_VAD_FRAME_SIZE)) {
+                detector.reset();
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / (double)frames;
+}
+
+static bool AIReadRecording(const char *path, std::vector<int16_t> &samples, std::string &error)
+{
+    AIWAVReader reader(path);
+    if (!reader.isOpen()) {
+        error = strerror(reader.getError());
+        return false;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    if (format.formatTag != AI_WAV_FORMAT_PCM || format.bitsPerSample != 16 || format.channels != 1 ||
+        format.sampleRate != AI_FIXED_VAD_SAMPLE_RATE) {
+        error = "not 16 kHz mono 16-bit PCM";
+        return false;
+    }
+    
+    samples.resize((size_t)reader.getFrameCount());
+    samples.resize(samples.empty() ? 0 : reader.read(&samples[0], samples.size()));
+    
+    return true;
+}
+
+static void AIAddRecordings(const char *path, std::vector<std::string> &paths)
+{
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        paths.push_back(path);
+        return;
+    }
+    
+    DIR *dir = opendir(path);
+    if (!dir) {
+        paths.push_back(path);
+        return;
+    }
+    
+    std::vector<std::string> names;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 4 && strcasecmp(entry->d_name + length - 4, ".wav") == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        paths.push_back(std::string(path) + "/" + names[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned trials = 200;
+    int runs = 20;
+    
+    int option;
+    while ((option = getopt(argc, argv, "t:r:")) != -1) {
+        switch (option) {
+            case 't':
+                trials = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<std::string> paths;
+    for (int i = optind; i < argc; i++) {
+        AIAddRecordings(argv[i], paths);
+    }
+    
+    unsigned frameDifferences = AICheckFixedFrames();
+    printf("fixed frame features %s exact integer sums up to %d samples\n", frameDifferences ? "DIFFER FROM" : "match",
+           AI_FIXED_VAD_MAX_CHECKED_LENGTH);
+    
+    AIFixedVADTally adaptive = {"AdaptiveThresold", 0, 0, 0, 0};
+    AIFixedVADTally energy = {"EnergyAndZeroCross", 0, 0, 0, 0};
+    
+    for (unsigned trial = 0; trial < trials; trial++) {
+        char name[32];
+        snprintf(name, sizeof(name), "trial %u", trial);
+        
+        std::vector<int16_t> samples = AIMakeTrial(trial);
+        AICompareRecording<AIAdaptiveThresholdDetector, AIFixedAdaptiveThresholdDetector>(name, samples, adaptive);
+        AICompareRecording<AIEnergyAndZeroCrossDetector, AIFixedEnergyAndZeroCrossDetector>(name, samples, energy);
+    }
+    
+    for (size_t i = 0; i < paths.size(); i++) {
+        const char *name = strrchr(paths[i].c_str(), '/');
+        name = name ? name + 1 : paths[i].c_str();
+        
+        std::vector<int16_t> samples;
+        std::string error;
+        
+        if (!AIReadRecording(paths[i].c_str(), samples, error)) {
+            printf("%s: skipped, %s\n", name, error.c_str());
+            continue;
+        }
+        
+        AICompareRecording<AIAdaptiveThresholdDetector, AIFixedAdaptiveThresholdDetector>(name, samples, adaptive);
+        AICompareRecording<AIEnergyAndZeroCrossDetector, AIFixedEnergyAndZeroCrossDetector>(name, samples, energy);
+    }
+    
+    std::vector<int16_t> timed = AIMakeTrial(0);
+    
+    const AIFixedVADTally *tallies[] = {&adaptive, &energy};
+    double floatTimes[] = {AITimeDetector<AIAdaptiveThresholdDetector>(timed, runs),
+                           AITimeDetector<AIEnergyAndZeroCrossDetector>(timed, runs)};
+    double fixedTimes[] = {AITimeDetector<AIFixedAdaptiveThresholdDetector>(timed, runs),
+                           AITimeDetector<AIFixedEnergyAndZeroCrossDetector>(timed, runs)};
+    
+    for (size_t i = 0; i < 2; i++) {
+        printf("%-18s %lu recordings, %lu decisions, %lu endpoints moved, %lu beyond %d frame\n", tallies[i]->algorithm,
+               tallies[i]->recordings, tallies[i]->decisions, tallies[i]->moved, tallies[i]->failures,
+               AI_FIXED_VAD_MAX_ENDPOINT_SHIFT);
+        printf("%-18s int16 frames: floating point %.1f ns, fixed point %.1f ns, %.2fx\n", "", floatTimes[i],
+               fixedTimes[i], floatTimes[i] / fixedTimes[i]);
+    }
+    
+    return frameDifferences || adaptive.failures || energy.failures ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * frame-features-benchmark: times AIMeasureFrame against the scalar passes over a VAD frame that it replaced.
+ *
+ *     frame-features-benchmark [-n samples per frame] [-f frames] [-r runs]
+ *
+ * The scalar reference sums the squares in sample order, then walks the frame again for the sign changes and the
+ * peak, as the detectors did before the fused kernel. Both measure the same random frames, float and int16, and the
+ * tool checks that sign changes and peaks are identical and that the energies agree to within the reordering of the
+ * additions. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP Tools/FrameFeaturesBenchmark/main.cpp \
+ *         ApiAI/Private/DSP/AIFrameFeatures.cpp -o frame-features-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "AIFrameFeatures.hpp"
+
+#define AI_FRAME_FEATURES_BENCHMARK_SCALE (1.f / 32767.f)
+
+// Reordering the additions of n non-negative terms moves the sum by at most 2(n - 1) units in the last place.
+#define AI_FRAME_FEATURES_BENCHMARK_ENERGY_TOLERANCE(count) (2.0 * (double)(count) * 1.12e-16)
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-n samples per frame] [-f frames] [-r runs]\n", program);
+    return 2;
+}
+
+static inline float AIScaledSample(float sample)
+{
+    return sample;
+}
+
+static inline float AIScaledSample(int16_t sample)
+{
+    return (float)sample * AI_FRAME_FEATURES_BENCHMARK_SCALE;
+}
+
+// The separate passes the detectors made before AIMeasureFrame.
+template <typename Sample>
+static AIFrameFeatures AIMeasureFrameScalar(const Sample *samples, size_t count)
+{
+    AIFrameFeatures features = {0, 0, 0.f};
+    
+    for (size_t i = 0; i < count; i++) {
+        double value = AIScaledSample(samples[i]);
+        features.sumOfSquares += value * value;
+    }
+    
+    for (size_t i = 1; i < count; i++) {
+        bool positive = AIScaledSample(samples[i]) > 0;
+        bool wasPositive = AIScaledSample(samples[i - 1]) > 0;
+        features.signChanges += positive != wasPositive;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        float absolute = fabsf(AIScaledSample(samples[i]));
+        if (absolute > features.peak) features.peak = absolute;
+    }
+    
+    return features;
+}
+
+static inline AIFrameFeatures AIMeasureFrameFused(const float *samples, size_t count)
+{
+    return AIMeasureFrame(samples, count);
+}
+
+static inline AIFrameFeatures AIMeasureFrameFused(const int16_t *samples, size_t count)
+{
+    return AIMeasureFrame(samples, count, AI_FRAME_FEATURES_BENCHMARK_SCALE);
+}
+
+// Speech-like levels with a fifth of the samples at zero, so that the sign tests see every case.
+static void AIMakeFrames(size_t count, std::vector<int16_t> &int16Samples, std::vector<float> &floatSamples)
+{
+    uint32_t seed = 1;
+    
+    int16Samples.resize(count);
+    floatSamples.resize(count);
+    
+    for (size_t i = 0; i < count; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        
+        int16Samples[i] = seed % 5 == 0 ? 0 : (int16_t)(seed >> 16);
+        floatSamples[i] = AIScaledSample(int16Samples[i]);
+    }
+}
+
+template <typename Sample>
+static size_t AICountDifferences(const std::vector<Sample> &samples, size_t frameSize, double &largestEnergyDifference)
+{
+    size_t differences = 0;
+    
+    for (size_t offset = 0; offset + frameSize <= samples.size(); offset += frameSize) {
+        AIFrameFeatures scalar = AIMeasureFrameScalar(&samples[offset], frameSize);
+        AIFrameFeatures fused = AIMeasureFrameFused(&samples[offset], frameSize);
+        
+        double difference = fabs(fused.sumOfSquares - scalar.sumOfSquares);
+        double relative = scalar.sumOfSquares > 0 ? difference / scalar.sumOfSquares : difference;
+        if (relative > largestEnergyDifference) largestEnergyDifference = relative;
+        
+        bool energyAgrees = relative <= AI_FRAME_FEATURES_BENCHMARK_ENERGY_TOLERANCE(frameSize);
+        differences += !energyAgrees || fused.signChanges != scalar.signChanges || fused.peak != scalar.peak;
+    }
+    
+    return differences;
+}
+
+// Best of runs, in nanoseconds per frame.
+template <typename Sample>
+static double AITimeFrames(AIFrameFeatures (*measure)(const Sample *, size_t), const std::vector<Sample> &samples,
+                           size_t frameSize, int runs)
+{
+    double best = 0;
+    size_t frames = samples.size() / frameSize;
+    volatile double sink = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        double total = 0;
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++) {
+            AIFrameFeatures features = measure(&samples[frame * frameSize], frameSize);
+            total += features.sumOfSquares + features.signChanges + features.peak;
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        sink = sink + total;
+        
+        double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / (double)frames;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t frameSize = 160;
+    size_t frameCount = 1000;
+    int runs = 200;
+    
+    int option;
+    while ((option = getopt(argc, argv, "n:f:r:")) != -1) {
+        switch (option) {
+            case 'n':
+                frameSize = (size_t)atol(optarg);
+                break;
+            case 'f':
+                frameCount = (size_t)atol(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || frameSize == 0 || frameCount == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<int16_t> int16Samples;
+    std::vector<float> floatSamples;
+    AIMakeFrames(frameSize * frameCount, int16Samples, floatSamples);
+    
+    double largestEnergyDifference = 0;
+    size_t differences = AICountDifferences(floatSamples, frameSize, largestEnergyDifference);
+    differences += AICountDifferences(int16Samples, frameSize, largestEnergyDifference);
+    
+    double scalarFloat = AITimeFrames<float>(AIMeasureFrameScalar, floatSamples, frameSize, runs);
+    double fusedFloat = AITimeFrames<float>(AIMeasureFrameFused, floatSamples, frameSize, runs);
+    double scalarInt16 = AITimeFrames<int16_t>(AIMeasureFrameScalar, int16Samples, frameSize, runs);
+    double fusedInt16 = AITimeFrames<int16_t>(AIMeasureFrameFused, int16Samples, frameSize, runs);
+    
+    printf("%zu-sample frames, %zu frames\n", frameSize, frameCount);
+    printf("float  scalar %8.1f ns, fused %8.1f ns per frame, %.2fx, %.2f GB/s\n", scalarFloat, fusedFloat,
+           scalarFloat / fusedFloat, (double)(frameSize * sizeof(float)) / fusedFloat);
+    printf("int16  scalar %8.1f ns, fused %8.1f ns per frame, %.2fx, %.2f GB/s\n", scalarInt16, fusedInt16,
+           scalarInt16 / fusedInt16, (double)(frameSize * sizeof(int16_t)) / fusedInt16);
+    printf("features %s, largest relative energy difference %.2e\n", differences ? "DIFFERENT" : "agree",
+           largestEnergyDifference);
+    
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * front-end-benchmark: times AIAudioFrontEnd against the stages it replaced, on the same captured blocks.
+ *
+ *     front-end-benchmark [-b frames per block] [-s seconds] [-r runs]
+ *
+ * The staged path meters each block, copies it for upload, converts it to float into a scratch buffer, queues that
+ * in a ring, and the detector takes its frames from the ring. The fused path meters, copies and frames in one pass
+ * with AIAudioFrontEnd and the detector takes its frames from the front end's queue. Both run the adaptive threshold
+ * detector on a synthetic 16 kHz recording, and the tool checks that they upload and decide the same. Builds on Linux
+ * and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/VoiceRequest/Private/VAD Tools/FrontEndBenchmark/main.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIVoiceActivityDetector.cpp ApiAI/Private/DSP/AIAudioFrontEnd.cpp \
+ *         ApiAI/Private/DSP/AIFrameFeatures.cpp ApiAI/Private/DSP/AILevelMeter.cpp \
+ *         ApiAI/Private/DSP/AISampleKernels.cpp -o front-end-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "AIAdaptiveThresholdDetector.hpp"
+#include "AIAudioFrontEnd.hpp"
+#include "AILevelMeter.hpp"
+#include "AIRingBuffer.hpp"
+#include "AISampleKernels.h"
+
+#define AI_FRONT_END_BENCHMARK_SAMPLE_RATE 16000
+#define AI_FRONT_END_BENCHMARK_RING_CAPACITY 65536
+
+// What one path produced, for checking that both agree.
+struct AIFrontEndBenchmarkOutput {
+    std::vector<int16_t> upload;
+    std::vector<AIVoiceActivityResult> decisions;
+    double power;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-b frames per block] [-s seconds] [-r runs]\n", program);
+    return 2;
+}
+
+// Bursts of a pitched vowel-like tone in low noise, so that the detector goes through both of its states.
+static std::vector<int16_t> AIMakeRecording(size_t count)
+{
+    std::vector<int16_t> samples(count);
+    uint32_t seed = 1;
+    
+    for (size_t i = 0; i < count; i++) {
+        double time = (double)i / AI_FRONT_END_BENCHMARK_SAMPLE_RATE;
+        bool speaking = fmod(time, 3.0) > 1.5;
+        
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        double noise = ((double)(seed >> 8) / (double)(1 << 24) - 0.5) * 60.0;
+        
+        double voice = speaking ? 6000.0 * (1.0 + 0.5 * sin(2 * M_PI * 125.0 * time)) * sin(2 * M_PI * 500.0 * time) : 0.0;
+        samples[i] = (int16_t)lrint(voice + noise);
+    }
+    
+    return samples;
+}
+
+static void AIRunStaged(const std::vector<int16_t> &recording, size_t blockSize, AIFrontEndBenchmarkOutput &output)
+{
+    const AISampleKernels *kernels = AISampleKernelsGetDefault();
+    AILevelMeter meter(AI_FRONT_END_BENCHMARK_SAMPLE_RATE);
+    AIAdaptiveThresholdDetector detector;
+    size_t frameSize = detector.getFrameSize();
+    
+    AIRingBuffer<float> ring(AI_FRONT_END_BENCHMARK_RING_CAPACITY);
+    std::vector<float> converted(blockSize);
+    std::vector<float> frame(frameSize);
+    
+    for (size_t done = 0; done + blockSize <= recording.size(); done += blockSize) {
+        const int16_t *block = &recording[done];
+        
+        output.power = AIMeterScaleValue(meter.process(block, blockSize));
+        memcpy(&output.upload[done], block, blockSize * sizeof(int16_t));
+        
+        kernels->int16ToFloat(block, blockSize, AI_VOICE_ACTIVITY_INT16_SCALE, converted.data());
+        ring.write(converted.data(), blockSize);
+        
+        while (ring.getReadAvailable() >= frameSize) {
+            const float *samples = ring.peek(frameSize, frame.data());
+            output.decisions.push_back(detector.process(samples, frameSize));
+            ring.skip(frameSize);
+        }
+    }
+}
+
+static void AIRunFused(const std::vector<int16_t> &recording, size_t blockSize, AIFrontEndBenchmarkOutput &output)
+{
+    AILevelMeter meter(AI_FRONT_END_BENCHMARK_SAMPLE_RATE);
+    AIAdaptiveThresholdDetector detector;
+    size_t frameSize = detector.getFrameSize();
+    
+    AIAudioFrontEnd frontEnd(frameSize, AI_VOICE_ACTIVITY_INT16_SCALE, AI_FRONT_END_BENCHMARK_RING_CAPACITY / frameSize);
+    std::vector<float> frame(frameSize);
+    
+    for (size_t done = 0; done + blockSize <= recording.size(); done += blockSize) {
+        AILevelMeasurement levels = frontEnd.process(&recording[done], blockSize, &output.upload[done], true);
+        output.power = AIMeterScaleValue(meter.process(levels, blockSize));
+        
+        const float *samples;
+        while ((samples = frontEnd.peekFrame(frame.data()))) {
+            output.decisions.push_back(detector.process(samples, frameSize));
+            frontEnd.skipFrame();
+        }
+    }
+}
+
+// Best of runs, in nanoseconds per block.
+static double AITimePath(void (*path)(const std::vector<int16_t> &, size_t, AIFrontEndBenchmarkOutput &),
+                         const std::vector<int16_t> &recording, size_t blockSize, int runs,
+                         AIFrontEndBenchmarkOutput &output)
+{
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        output.upload.assign(recording.size(), 0);
+        output.decisions.clear();
+        output.decisions.reserve(recording.size());
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        path(recording, blockSize, output);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / (double)(recording.size() / blockSize);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t blockSize = 512;
+    double seconds = 60.0;
+    int runs = 20;
+    
+    int option;
+    while ((option = getopt(argc, argv, "b:s:r:")) != -1) {
+        switch (option) {
+            case 'b':
+                blockSize = (size_t)atol(optarg);
+                break;
+            case 's':
+                seconds = atof(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || blockSize == 0 || seconds <= 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<int16_t> recording = AIMakeRecording((size_t)(seconds * AI_FRONT_END_BENCHMARK_SAMPLE_RATE));
+    if (recording.size() < blockSize) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    AIFrontEndBenchmarkOutput staged, fused;
+    double stagedTime = AITimePath(AIRunStaged, recording, blockSize, runs, staged);
+    double fusedTime = AITimePath(AIRunFused, recording, blockSize, runs, fused);
+    
+    size_t differences = staged.decisions.size() == fused.decisions.size() ? 0 : 1;
+    for (size_t i = 0; !differences && i < staged.decisions.size(); i++) {
+        differences += staged.decisions[i] != fused.decisions[i];
+    }
+    
+    bool sameUpload = staged.upload == fused.upload;
+    
+    printf("kernels %s, %zu-sample blocks, %zu blocks\n", AISampleKernelsGetDefault()->name, blockSize,
+           recording.size() / blockSize);
+    printf("staged %9.1f ns per block\n", stagedTime);
+    printf("fused  %9.1f ns per block, %.2fx\n", fusedTime, stagedTime / fusedTime);
+    printf("upload %s, decisions %s, last power %.6f and %.6f\n", sameUpload ? "identical" : "DIFFERENT",
+           differences ? "DIFFERENT" : "identical", staged.power, fused.power);
+    
+    return sameUpload && !differences ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * kernel-benchmark: times every AISampleKernels implementation the CPU supports, kernel by kernel, and checks that
+ * each one gives the scalar implementation's output bit for bit.
+ *
+ *     kernel-benchmark [-n samples per call] [-c channels] [-r runs]
+ *
+ * The check also runs over short and odd lengths, so the SIMD remainder loops are covered, and splits the dithered
+ * conversion across calls to check that the dither state carries over. Builds on Linux and macOS from the SDK
+ * sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP Tools/KernelBenchmark/main.cpp ApiAI/Private/DSP/AISampleKernels.cpp \
+ *         -o kernel-benchmark
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "AISampleKernels.h"
+
+#define AI_KERNEL_BENCHMARK_MAX_IMPLEMENTATIONS 8
+#define AI_KERNEL_BENCHMARK_GAIN 0.7f
+
+// Lengths around every vector width, and one long enough to leave a remainder after the unrolled loops.
+static const size_t AICheckedLengths[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, 4099};
+
+// Inputs and outputs for one call of every kernel.
+struct AIKernelBuffers {
+    std::vector<int16_t> int16Input;
+    std::vector<float> floatInput;
+    std::vector<float> interleavedInput;
+    
+    std::vector<float> floatOutput;
+    std::vector<int16_t> int16Output;
+    std::vector<int16_t> ditheredOutput;
+    std::vector<float> monoOutput;
+    std::vector<float> gainOutput;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-n samples per call] [-c channels] [-r runs]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// Full-scale int16, and floats that reach past +-1 so that saturation is exercised.
+static void AIFillInputs(AIKernelBuffers &buffers, size_t count, unsigned channels)
+{
+    uint32_t seed = 1;
+    
+    buffers.int16Input.resize(count);
+    buffers.floatInput.resize(count);
+    buffers.interleavedInput.resize(count * channels);
+    
+    for (size_t i = 0; i < count; i++) {
+        buffers.int16Input[i] = (int16_t)(AINextRandom(seed) >> 16);
+        buffers.floatInput[i] = ((float)(AINextRandom(seed) >> 8) / (float)(1 << 24) - 0.5f) * 2.4f;
+    }
+    
+    for (size_t i = 0; i < count * channels; i++) {
+        buffers.interleavedInput[i] = (float)(AINextRandom(seed) >> 8) / (float)(1 << 24) * 2.0f - 1.0f;
+    }
+    
+    buffers.floatOutput.assign(count, 0);
+    buffers.int16Output.assign(count, 0);
+    buffers.ditheredOutput.assign(count, 0);
+    buffers.monoOutput.assign(count, 0);
+    buffers.gainOutput.assign(count, 0);
+}
+
+static void AIRunKernels(const AISampleKernels *kernels, AIKernelBuffers &buffers, size_t count, unsigned channels)
+{
+    AIDitherState dither;
+    AIDitherStateInit(&dither, 42);
+    
+    size_t split = count / 3;
+    
+    kernels->int16ToFloat(buffers.int16Input.data(), count, 1.0f / 32768.0f, buffers.floatOutput.data());
+    kernels->floatToInt16(buffers.floatInput.data(), count, buffers.int16Output.data());
+    kernels->floatToInt16Dithered(buffers.floatInput.data(), split, &dither, buffers.ditheredOutput.data());
+    kernels->floatToInt16Dithered(buffers.floatInput.data() + split, count - split, &dither,
+                                  buffers.ditheredOutput.data() + split);
+    kernels->downmixToMono(buffers.interleavedInput.data(), channels, count, buffers.monoOutput.data());
+    
+    memcpy(buffers.gainOutput.data(), buffers.floatInput.data(), count * sizeof(float));
+    kernels->applyGain(buffers.gainOutput.data(), count, AI_KERNEL_BENCHMARK_GAIN);
+}
+
+// Name of the first kernel whose output differs from the reference, or NULL.
+static const char *AIFirstDifference(const AIKernelBuffers &reference, const AIKernelBuffers &buffers, size_t count)
+{
+    if (memcmp(reference.floatOutput.data(), buffers.floatOutput.data(), count * sizeof(float))) return "int16ToFloat";
+    if (memcmp(reference.int16Output.data(), buffers.int16Output.data(), count * sizeof(int16_t))) return "floatToInt16";
+    if (memcmp(reference.ditheredOutput.data(), buffers.ditheredOutput.data(), count * sizeof(int16_t))) {
+        return "floatToInt16Dithered";
+    }
+    if (memcmp(reference.monoOutput.data(), buffers.monoOutput.data(), count * sizeof(float))) return "downmixToMono";
+    if (memcmp(reference.gainOutput.data(), buffers.gainOutput.data(), count * sizeof(float))) return "applyGain";
+    
+    return NULL;
+}
+
+static bool AICheckImplementations(const AISampleKernels **implementations, size_t implementationCount)
+{
+    bool identical = true;
+    
+    for (size_t i = 0; i < sizeof(AICheckedLengths) / sizeof(AICheckedLengths[0]); i++) {
+        size_t count = AICheckedLengths[i];
+        
+        for (unsigned channels = 1; channels <= 6; channels++) {
+            AIKernelBuffers reference;
+            AIFillInputs(reference, count, channels);
+            AIRunKernels(implementations[0], reference, count, channels);
+            
+            for (size_t j = 1; j < implementationCount; j++) {
+                AIKernelBuffers buffers;
+                AIFillInputs(buffers, count, channels);
+                AIRunKernels(implementations[j], buffers, count, channels);
+                
+                const char *difference = AIFirstDifference(reference, buffers, count);
+                if (difference) {
+                    printf("%s %s differs from %s for %zu samples of %u channels\n", implementations[j]->name,
+                           difference, implementations[0]->name, count, channels);
+                    identical = false;
+                }
+            }
+        }
+    }
+    
+    return identical;
+}
+
+// Best of runs, in millions of output samples per second.
+template <typename Call>
+static double AITimeKernel(Call call, size_t count, int runs)
+{
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        call();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best > 0 ? (double)count / best / 1e6 : 0;
+}
+
+static void AIBenchmarkImplementation(const AISampleKernels *kernels, size_t count, unsigned channels, int runs)
+{
+    AIKernelBuffers buffers;
+    AIFillInputs(buffers, count, channels);
+    
+    AIDitherState dither;
+    AIDitherStateInit(&dither, 1);
+    
+    double int16ToFloat = AITimeKernel([&] {
+        kernels->int16ToFloat(buffers.int16Input.data(), count, 1.0f / 32768.0f, buffers.floatOutput.data());
+    }, count, runs);
+    
+    double floatToInt16 = AITimeKernel([&] {
+        kernels->floatToInt16(buffers.floatInput.data(), count, buffers.int16Output.data());
+    }, count, runs);
+    
+    double dithered = AITimeKernel([&] {
+        kernels->floatToInt16Dithered(buffers.floatInput.data(), count, &dither, buffers.ditheredOutput.data());
+    }, count, runs);
+    
+    double downmix = AITimeKernel([&] {
+        kernels->downmixToMono(buffers.interleavedInput.data(), channels, count, buffers.monoOutput.data());
+    }, count, runs);
+    
+    double gain = AITimeKernel([&] {
+        kernels->applyGain(buffers.gainOutput.data(), count, AI_KERNEL_BENCHMARK_GAIN);
+    }, count, runs);
+    
+    printf("%-8s %10.1f %10.1f %10.1f %10.1f %10.1f\n", kernels->name, int16ToFloat, floatToInt16, dithered, downmix,
+           gain);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = 4096;
+    unsigned channels = 2;
+    int runs = 2000;
+    
+    int option;
+    while ((option = getopt(argc, argv, "n:c:r:")) != -1) {
+        switch (option) {
+            case 'n':
+                count = (size_t)atol(optarg);
+                break;
+            case 'c':
+                channels = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || count == 0 || channels == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    const AISampleKernels *implementations[AI_KERNEL_BENCHMARK_MAX_IMPLEMENTATIONS];
+    size_t implementationCount = AISampleKernelsGetAvailable(implementations, AI_KERNEL_BENCHMARK_MAX_IMPLEMENTATIONS);
+    
+    bool identical = AICheckImplementations(implementations, implementationCount);
+    
+    printf("default %s, %zu samples per call, %u-channel downmix, Msamples/s\n", AISampleKernelsGetDefault()->name,
+           count, channels);
+    printf("%-8s %10s %10s %10s %10s %10s\n", "", "int16>f32", "f32>int16", "dithered", "downmix", "gain");
+    
+    for (size_t i = 0; i < implementationCount; i++) {
+        AIBenchmarkImplementation(implementations[i], count, channels, runs);
+    }
+    
+    printf("outputs %s\n", identical ? "identical" : "DIFFERENT");
+    
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * level-meter-benchmark: checks AILevelMeter and AIMeterScaleValue against the per-sample meter and the truncating
+ * table AISoundRecorder used before, and times both meters.
+ *
+ *     level-meter-benchmark [-t trials] [-n samples per buffer] [-r runs]
+ *
+ * Random buffers of every level from full scale down to silence, and of lengths that leave every SIMD tail, go
+ * through the envelope mode and through a transcription of the old calculateLevel, which must agree within
+ * AI_LEVEL_METER_BENCHMARK_MAX_ENVELOPE_ERROR dB. The peak and RMS modes are compared with exact sums over the same
+ * buffers, and hold-decay with the level it must show while a peak is held and while it falls. The interpolated meter
+ * scale must stay within AI_LEVEL_METER_BENCHMARK_MAX_SCALE_ERROR of the exact curve from below its minimum to above
+ * 0 dB; the old table's error is printed for comparison. Exits with 1 otherwise. Builds on Linux and macOS from the
+ * SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP Tools/LevelMeterBenchmark/main.cpp ApiAI/Private/DSP/AILevelMeter.cpp \
+ *         ApiAI/Private/DSP/AIFrameFeatures.cpp -o level-meter-benchmark
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "AILevelMeter.hpp"
+
+#define AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE 16000
+#define AI_LEVEL_METER_BENCHMARK_MAX_LENGTH 1200
+
+// The scan adds the same terms as the per-sample filter in another order, so float rounding may differ slightly.
+#define AI_LEVEL_METER_BENCHMARK_MAX_ENVELOPE_ERROR 1e-3
+#define AI_LEVEL_METER_BENCHMARK_MAX_MODE_ERROR 1e-3
+
+// The falling level is rounded to float once per buffer, which is about 2e-6 dB in the meter's range.
+#define AI_LEVEL_METER_BENCHMARK_MAX_HOLD_ERROR_PER_BUFFER 4e-6
+
+// Linear interpolation between 400 points of a square root curve.
+#define AI_LEVEL_METER_BENCHMARK_MAX_SCALE_ERROR 5e-4
+#define AI_LEVEL_METER_BENCHMARK_SCALE_STEP 0.001
+
+// Distinct buffers the timing cycles through, and buffers per timed run.
+#define AI_LEVEL_METER_BENCHMARK_POOL_BUFFERS 16
+#define AI_LEVEL_METER_BENCHMARK_TIMED_BUFFERS 20000
+
+struct AILevelMeterCheck {
+    double envelopeError;
+    double peakError;
+    double rmsError;
+    double holdError;
+    double holdTolerance;
+    double scaleError;
+    double tableError;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-t trials] [-n samples per buffer] [-r runs]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// calculateLevel as AISoundRecorder had it: a low-pass filter and log10 for every sample, keeping the largest.
+static float AILegacyLevel(const int16_t *samples, size_t count)
+{
+    float decibels = -74.0;
+    float current = 0.f, previous = 0.f;
+    float peakValue = -74.0;
+    
+    for (size_t i = 0; i < count; i++) {
+        float magnitude = abs(samples[i]);
+        current = .001 * magnitude + (1.0 - .001) * previous;
+        previous = current;
+        
+        float sampleDecibels = 20.0 * log10(current) + -74.0;
+        if ((sampleDecibels == sampleDecibels) && (sampleDecibels != -DBL_MAX)) {
+            if (sampleDecibels > peakValue) {
+                peakValue = sampleDecibels;
+            }
+            decibels = peakValue;
+        }
+    }
+    
+    return decibels;
+}
+
+static double AIExactScale(double decibels)
+{
+    if (decibels < AI_METER_SCALE_MIN_DECIBELS) return 0;
+    if (decibels >= 0) return 1;
+    
+    double minAmplitude = pow(10, AI_METER_SCALE_MIN_DECIBELS / 20);
+    return sqrt((pow(10, decibels / 20) - minAmplitude) / (1 - minAmplitude));
+}
+
+// AIMeterTable's lookup, which truncated to the entry below.
+static double AILegacyScale(double decibels)
+{
+    double resolution = AI_METER_SCALE_MIN_DECIBELS / (AI_METER_SCALE_TABLE_SIZE - 1);
+    
+    if (decibels < AI_METER_SCALE_MIN_DECIBELS) return 0;
+    if (decibels >= 0) return 1;
+    
+    return AIExactScale((int)(decibels / resolution) * resolution);
+}
+
+// A buffer of uniform noise at level decibels below full scale, with the odd full-scale negative sample.
+static void AIMakeBuffer(uint32_t &seed, double decibels, int16_t *samples, size_t count)
+{
+    double amplitude = 32767.0 * pow(10, -decibels / 20);
+    
+    for (size_t i = 0; i < count; i++) {
+        uint32_t random = AINextRandom(seed);
+        samples[i] = (int16_t)(amplitude * ((double)(random % 20001) - 10000.0) / 10000.0);
+        if (random % 3001 == 0) samples[i] = INT16_MIN;
+    }
+}
+
+static void AICheckModes(unsigned trials, AILevelMeterCheck &check)
+{
+    uint32_t seed = 1;
+    std::vector<int16_t> samples(AI_LEVEL_METER_BENCHMARK_MAX_LENGTH);
+    
+    AILevelMeter envelope(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE);
+    AILevelMeter peak(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE, AILevelMeterModePeak);
+    AILevelMeter rms(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE, AILevelMeterModeRMS);
+    
+    for (unsigned trial = 0; trial < trials; trial++) {
+        size_t count = 1 + AINextRandom(seed) % AI_LEVEL_METER_BENCHMARK_MAX_LENGTH;
+        AIMakeBuffer(seed, (double)(AINextRandom(seed) % 100), &samples[0], count);
+        
+        int maxMagnitude = 0;
+        double sumOfSquares = 0;
+        for (size_t i = 0; i < count; i++) {
+            maxMagnitude = std::max(maxMagnitude, abs(samples[i]));
+            sumOfSquares += (double)samples[i] * samples[i];
+        }
+        
+        double exactPeak = maxMagnitude > 1 ? 20 * log10((double)maxMagnitude) + AI_LEVEL_METER_DB_OFFSET
+                                            : AI_LEVEL_METER_DB_OFFSET;
+        double level = sqrt(sumOfSquares / (double)count);
+        double exactRMS = level > 1 ? 20 * log10(level) + AI_LEVEL_METER_DB_OFFSET : AI_LEVEL_METER_DB_OFFSET;
+        
+        float legacy = AILegacyLevel(&samples[0], count);
+        float measured = envelope.process(&samples[0], count);
+        
+        check.envelopeError = std::max(check.envelopeError, fabs((double)measured - legacy));
+        check.peakError = std::max(check.peakError, fabs(peak.process(&samples[0], count) - exactPeak));
+        check.rmsError = std::max(check.rmsError, fabs(rms.process(&samples[0], count) - exactRMS));
+    }
+}
+
+// One loud buffer and then silence: the level must stay for the hold time, then fall at the decay rate to the floor.
+static void AICheckHoldDecay(size_t count, AILevelMeterCheck &check)
+{
+    uint32_t seed = 2;
+    std::vector<int16_t> loud(count);
+    std::vector<int16_t> silence(count, 0);
+    AIMakeBuffer(seed, 12.0, &loud[0], count);
+    
+    AILevelMeter meter(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE, AILevelMeterModeHoldDecay);
+    double held = meter.process(&loud[0], count);
+    
+    double holdSamples = AI_LEVEL_METER_HOLD_SECONDS * AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE;
+    double decayPerSample = AI_LEVEL_METER_DECAY_DECIBELS_PER_SECOND / AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE;
+    size_t buffers = (size_t)((holdSamples + (held - AI_LEVEL_METER_DB_OFFSET) / decayPerSample) / count) + 4;
+    check.holdTolerance = AI_LEVEL_METER_BENCHMARK_MAX_HOLD_ERROR_PER_BUFFER * (double)buffers;
+    
+    for (size_t buffer = 1; buffer <= buffers; buffer++) {
+        double elapsed = (double)(buffer * count);
+        double expected = held - std::max(0.0, elapsed - holdSamples) * decayPerSample;
+        expected = std::max(expected, (double)AI_LEVEL_METER_DB_OFFSET);
+        
+        check.holdError = std::max(check.holdError, fabs(meter.process(&silence[0], count) - expected));
+    }
+}
+
+static void AICheckScale(AILevelMeterCheck &check)
+{
+    double step = AI_LEVEL_METER_BENCHMARK_SCALE_STEP;
+    
+    for (double decibels = AI_METER_SCALE_MIN_DECIBELS - 5; decibels < 1; decibels += step) {
+        float value = (float)decibels;
+        double exact = AIExactScale(value);
+        
+        check.scaleError = std::max(check.scaleError, fabs(AIMeterScaleValue(value) - exact));
+        check.tableError = std::max(check.tableError, fabs(AILegacyScale(value) - exact));
+    }
+}
+
+// Best of runs, in nanoseconds per buffer.
+template <typename Measure>
+static double AITimeMeter(Measure measure, const std::vector<int16_t> &pool, size_t count, int runs)
+{
+    volatile float sink = 0;
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t buffer = 0; buffer < AI_LEVEL_METER_BENCHMARK_TIMED_BUFFERS; buffer++) {
+            sink = sink + measure(&pool[(buffer % AI_LEVEL_METER_BENCHMARK_POOL_BUFFERS) * count], count);
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / AI_LEVEL_METER_BENCHMARK_TIMED_BUFFERS;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned trials = 2000;
+    size_t count = 371;
+    int runs = 5;
+    
+    int option;
+    while ((option = getopt(argc, argv, "t:n:r:")) != -1) {
+        switch (option) {
+            case 't':
+                trials = (unsigned)atoi(optarg);
+                break;
+            case 'n':
+                count = (size_t)atol(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || count == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    AILevelMeterCheck check = {0, 0, 0, 0, 0, 0, 0};
+    AICheckModes(trials, check);
+    AICheckHoldDecay(count, check);
+    AICheckScale(check);
+    
+    bool levelsFailed = check.envelopeError > AI_LEVEL_METER_BENCHMARK_MAX_ENVELOPE_ERROR ||
+                        check.peakError > AI_LEVEL_METER_BENCHMARK_MAX_MODE_ERROR ||
+                        check.rmsError > AI_LEVEL_METER_BENCHMARK_MAX_MODE_ERROR;
+    bool holdFailed = check.holdError > check.holdTolerance;
+    bool scaleFailed = check.scaleError > AI_LEVEL_METER_BENCHMARK_MAX_SCALE_ERROR;
+    
+    printf("%u buffers: envelope within %.2g dB of calculateLevel, peak within %.2g dB, RMS within %.2g dB%s\n",
+           trials, check.envelopeError, check.peakError, check.rmsError, levelsFailed ? ", TOO FAR" : "");
+    printf("hold-decay within %.2g dB of %.1f s hold and %.0f dB/s decay%s\n", check.holdError,
+           AI_LEVEL_METER_HOLD_SECONDS, AI_LEVEL_METER_DECAY_DECIBELS_PER_SECOND, holdFailed ? ", TOO FAR" : "");
+    printf("meter scale within %.2g of the exact curve, truncating table within %.2g%s\n", check.scaleError,
+           check.tableError, scaleFailed ? ", TOO FAR" : "");
+    
+    std::vector<int16_t> pool(AI_LEVEL_METER_BENCHMARK_POOL_BUFFERS * count);
+    uint32_t seed = 3;
+    for (size_t buffer = 0; buffer < AI_LEVEL_METER_BENCHMARK_POOL_BUFFERS; buffer++) {
+        AIMakeBuffer(seed, (double)(buffer * 3), &pool[buffer * count], count);
+    }
+    
+    AILevelMeter envelope(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE);
+    AILevelMeter peak(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE, AILevelMeterModePeak);
+    AILevelMeter rms(AI_LEVEL_METER_BENCHMARK_SAMPLE_RATE, AILevelMeterModeRMS);
+    
+    double legacyTime = AITimeMeter(AILegacyLevel, pool, count, runs);
+    double envelopeTime = AITimeMeter([&](const int16_t *samples, size_t count) {
+        return envelope.process(samples, count);
+    }, pool, count, runs);
+    double peakTime = AITimeMeter([&](const int16_t *samples, size_t count) {
+        return peak.process(samples, count);
+    }, pool, count, runs);
+    double rmsTime = AITimeMeter([&](const int16_t *samples, size_t count) {
+        return rms.process(samples, count);
+    }, pool, count, runs);
+    
+    printf("%zu-sample buffers, ns per buffer\n", count);
+    printf("calculateLevel %8.1f ns\n", legacyTime);
+    printf("envelope       %8.1f ns, %.1fx\n", envelopeTime, legacyTime / envelopeTime);
+    printf("peak           %8.1f ns, %.1fx\n", peakTime, legacyTime / peakTime);
+    printf("RMS            %8.1f ns, %.1fx\n", rmsTime, legacyTime / rmsTime);
+    
+    return levelsFailed || holdFailed || scaleFailed ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * ring-buffer-stress: runs a producer and a consumer thread against one AIRingBuffer and checks every item that
+ * comes out of it.
+ *
+ *     ring-buffer-stress [-c capacity] [-w items per write] [-f items per frame] [-n items]
+ *
+ * The producer writes consecutive sequence numbers in blocks, as AISoundRecorder writes captured buffers. The
+ * consumer takes them frame by frame with peek and skip, as the detector does, and every few frames with read, and
+ * stalls now and then so that the ring fills up and reads wrap around the end of the storage. The tool runs twice:
+ * once with a producer that retries what did not fit, where every number must come out in order, and once with a
+ * producer that drops it, as the recorder does, where the numbers must still increase and the ones read and dropped
+ * must add up. Exits with 1 otherwise. Builds on Linux and macOS, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -pthread -IApiAI/Private/DSP Tools/RingBufferStress/main.cpp -o ring-buffer-stress
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "AIRingBuffer.hpp"
+
+// One frame in this many is followed by a stall long enough for the producer to fill the ring.
+#define AI_RING_STRESS_STALL_INTERVAL 997
+#define AI_RING_STRESS_STALL_MICROSECONDS 200
+
+// Frames taken with peek and skip between two taken with read.
+#define AI_RING_STRESS_READ_INTERVAL 7
+
+struct AIRingStressResult {
+    uint64_t read;
+    uint64_t dropped;
+    uint64_t fullWrites;
+    uint64_t wrappedFrames;
+    uint64_t errors;
+    double seconds;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-c capacity] [-w items per write] [-f items per frame] [-n items]\n", program);
+    return 2;
+}
+
+static void AIProduce(AIRingBuffer<uint32_t> &ring, size_t writeSize, uint64_t total, bool dropping,
+                      std::atomic<bool> &finished, AIRingStressResult &result)
+{
+    std::vector<uint32_t> block(writeSize);
+    uint64_t next = 0;
+    
+    while (next < total) {
+        size_t count = (size_t)std::min<uint64_t>(writeSize, total - next);
+        for (size_t i = 0; i < count; i++) {
+            block[i] = (uint32_t)(next + i);
+        }
+        
+        size_t written = ring.write(block.data(), count);
+        
+        if (written < count) {
+            result.fullWrites++;
+            
+            if (dropping) {
+                result.dropped += count - written;
+            } else {
+                count = written;
+            }
+            
+            std::this_thread::yield();
+        }
+        
+        next += count;
+    }
+    
+    finished.store(true, std::memory_order_release);
+}
+
+// Checks one frame against the number expected next; a dropping producer may have skipped ahead.
+static void AICheckFrame(const uint32_t *frame, size_t count, bool dropping, uint64_t &expected,
+                         AIRingStressResult &result)
+{
+    for (size_t i = 0; i < count; i++) {
+        bool valid = dropping ? frame[i] >= expected : frame[i] == expected;
+        if (!valid) {
+            if (result.errors == 0) {
+                printf("item %llu is %u, expected %s%llu\n", (unsigned long long)result.read, frame[i],
+                       dropping ? "at least " : "", (unsigned long long)expected);
+            }
+            result.errors++;
+        }
+        
+        expected = (uint64_t)frame[i] + 1;
+        result.read++;
+    }
+}
+
+static void AIConsume(AIRingBuffer<uint32_t> &ring, size_t frameSize, bool dropping, std::atomic<bool> &finished,
+                      AIRingStressResult &result)
+{
+    std::vector<uint32_t> scratch(frameSize);
+    uint64_t expected = 0;
+    uint64_t frames = 0;
+    
+    for (;;) {
+        bool done = finished.load(std::memory_order_acquire);
+        
+        if (ring.getReadAvailable() < frameSize) {
+            if (done) break;
+            std::this_thread::yield();
+            continue;
+        }
+        
+        if (frames % AI_RING_STRESS_READ_INTERVAL == 0) {
+            ring.read(scratch.data(), frameSize);
+            AICheckFrame(scratch.data(), frameSize, dropping, expected, result);
+        } else {
+            const uint32_t *frame = ring.peek(frameSize, scratch.data());
+            result.wrappedFrames += frame == scratch.data();
+            AICheckFrame(frame, frameSize, dropping, expected, result);
+            ring.skip(frameSize);
+        }
+        
+        if (++frames % AI_RING_STRESS_STALL_INTERVAL == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(AI_RING_STRESS_STALL_MICROSECONDS));
+        }
+    }
+    
+    // Whatever is left is shorter than a frame.
+    size_t left = ring.getReadAvailable();
+    ring.read(scratch.data(), left);
+    AICheckFrame(scratch.data(), left, dropping, expected, result);
+}
+
+static AIRingStressResult AIRunStress(size_t capacity, size_t writeSize, size_t frameSize, uint64_t total,
+                                      bool dropping)
+{
+    AIRingBuffer<uint32_t> ring(capacity);
+    AIRingStressResult produced = {0, 0, 0, 0, 0, 0};
+    AIRingStressResult consumed = {0, 0, 0, 0, 0, 0};
+    std::atomic<bool> finished(false);
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    
+    std::thread producer(AIProduce, std::ref(ring), writeSize, total, dropping, std::ref(finished),
+                         std::ref(produced));
+    AIConsume(ring, frameSize, dropping, finished, consumed);
+    producer.join();
+    
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    
+    consumed.dropped = produced.dropped;
+    consumed.fullWrites = produced.fullWrites;
+    consumed.seconds = std::chrono::duration<double>(end - start).count();
+    
+    if (consumed.read + consumed.dropped != total) {
+        printf("%llu items read and %llu dropped of %llu\n", (unsigned long long)consumed.read,
+               (unsigned long long)consumed.dropped, (unsigned long long)total);
+        consumed.errors++;
+    }
+    
+    return consumed;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t capacity = 16384;
+    size_t writeSize = 1024;
+    size_t frameSize = 160;
+    uint64_t total = 50000000;
+    
+    int option;
+    while ((option = getopt(argc, argv, "c:w:f:n:")) != -1) {
+        switch (option) {
+            case 'c':
+                capacity = (size_t)atol(optarg);
+                break;
+            case 'w':
+                writeSize = (size_t)atol(optarg);
+                break;
+            case 'f':
+                frameSize = (size_t)atol(optarg);
+                break;
+            case 'n':
+                total = (uint64_t)atoll(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    // Sequence numbers must not wrap, and a frame must fit in the ring.
+    if (optind != argc || capacity == 0 || writeSize == 0 || frameSize == 0 || frameSize > capacity ||
+        total == 0 || total > UINT32_MAX) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    size_t rounded = AIRingBuffer<uint32_t>(capacity).getCapacity();
+    printf("capacity %zu, %zu items per write, %zu items per frame, %llu items\n", rounded, writeSize, frameSize,
+           (unsigned long long)total);
+    
+    uint64_t errors = 0;
+    
+    for (int dropping = 0; dropping <= 1; dropping++) {
+        AIRingStressResult result = AIRunStress(capacity, writeSize, frameSize, total, dropping != 0);
+        errors += result.errors;
+        
+        printf("%-8s %6.1f Mitems/s, %llu read, %llu dropped, %llu full writes, %llu wrapped frames, %llu errors\n",
+               dropping ? "dropping" : "retrying", result.seconds > 0 ? (double)total / result.seconds / 1e6 : 0.0,
+               (unsigned long long)result.read, (unsigned long long)result.dropped,
+               (unsigned long long)result.fullWrites, (unsigned long long)result.wrappedFrames,
+               (unsigned long long)result.errors);
+    }
+    
+    return errors ? 1 : 0;
+}
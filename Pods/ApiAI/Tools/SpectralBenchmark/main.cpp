@@ -0,0 +1,248 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * spectral-benchmark: checks AIRealFFT against a direct DFT and times the Spectral detector per frame, next to the
+ * other registered algorithms.
+ *
+ *     spectral-benchmark [-s seconds] [-r runs]
+ *
+ * The FFT is compared bin by bin with a double-precision DFT of random input for every size up to 1024. Each
+ * algorithm then runs over a synthetic 16 kHz recording of 10 ms frames, through both entry points, and is reset
+ * whenever it decides. The Spectral detector's time per frame is compared with its budget of 20 µs on one core.
+ * Exits with 1 when the FFT is off. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/VoiceRequest/Private/VAD Tools/SpectralBenchmark/main.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AI*.cpp ApiAI/Private/DSP/AIFrameFeatures.cpp \
+ *         ApiAI/Private/DSP/AIRealFFT.cpp -o spectral-benchmark
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "AIRealFFT.hpp"
+#include "AIVoiceActivityDetectorRegistry.hpp"
+
+#define AI_SPECTRAL_BENCHMARK_SAMPLE_RATE 16000
+#define AI_SPECTRAL_BENCHMARK_FRAME_SIZE 160
+#define AI_SPECTRAL_BENCHMARK_FFT_SIZE 256
+#define AI_SPECTRAL_BENCHMARK_MAX_FFT_SIZE 1024
+#define AI_SPECTRAL_BENCHMARK_BUDGET_MICROSECONDS 20.0
+
+// Largest bin error allowed, relative to the largest bin magnitude, per stage of the transform.
+#define AI_SPECTRAL_BENCHMARK_FFT_TOLERANCE 1e-6
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-s seconds] [-r runs]\n", program);
+    return 2;
+}
+
+static float AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (float)(seed >> 8) / (float)(1 << 24) - 0.5f;
+}
+
+// Largest error of any bin relative to the largest magnitude, for random input of size samples.
+static double AIMeasureFFTError(size_t size)
+{
+    AIRealFFT fft(size);
+    std::vector<float> input(size), real(size / 2 + 1), imaginary(size / 2 + 1);
+    
+    uint32_t seed = (uint32_t)size;
+    for (size_t i = 0; i < size; i++) {
+        input[i] = AINextRandom(seed);
+    }
+    
+    fft.forward(input.data(), real.data(), imaginary.data());
+    
+    double error = 0, magnitude = 0;
+    
+    for (size_t bin = 0; bin <= size / 2; bin++) {
+        double expectedReal = 0, expectedImaginary = 0;
+        for (size_t i = 0; i < size; i++) {
+            double angle = -2.0 * M_PI * (double)((bin * i) % size) / (double)size;
+            expectedReal += input[i] * cos(angle);
+            expectedImaginary += input[i] * sin(angle);
+        }
+        
+        error = fmax(error, fmax(fabs(expectedReal - real[bin]), fabs(expectedImaginary - imaginary[bin])));
+        magnitude = fmax(magnitude, hypot(expectedReal, expectedImaginary));
+    }
+    
+    return magnitude > 0 ? error / magnitude : error;
+}
+
+// Syllable-like bursts of a voiced tone over low noise: 200 ms on, 100 ms off, for 1.5 s out of every 3.
+static std::vector<float> AIMakeRecording(size_t count)
+{
+    std::vector<float> samples(count);
+    uint32_t seed = 1;
+    
+    for (size_t i = 0; i < count; i++) {
+        double time = (double)i / AI_SPECTRAL_BENCHMARK_SAMPLE_RATE;
+        double syllable = fmod(time, 0.3);
+        bool speaking = fmod(time, 3.0) > 1.5 && syllable < 0.2;
+        
+        double voice = 0;
+        if (speaking) {
+            double envelope = sin(M_PI * syllable / 0.2);
+            for (int harmonic = 1; harmonic * 120.0 < 4000.0; harmonic++) {
+                double frequency = harmonic * 120.0;
+                double gain = exp(-pow((frequency - 700.0) / 300.0, 2)) + 0.6 * exp(-pow((frequency - 1500.0) / 400.0, 2));
+                voice += envelope * gain * sin(2 * M_PI * frequency * time + harmonic);
+            }
+        }
+        
+        samples[i] = (float)(0.05 * voice) + 0.01f * AINextRandom(seed);
+    }
+    
+    return samples;
+}
+
+// Best of runs, in microseconds per frame.
+template <typename Sample>
+static double AITimeDetector(AIVoiceActivityDetector &detector, const std::vector<Sample> &samples, int runs,
+                             unsigned &decisions)
+{
+    size_t frameSize = detector.getFrameSize();
+    size_t frames = samples.size() / frameSize;
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        detector.reset();
+        decisions = 0;
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++) {
+            if (detector.process(&samples[frame * frameSize], frameSize) != AIVoiceActivityResultContinue) {
+                detector.reset();
+                decisions++;
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / (double)frames;
+}
+
+int main(int argc, char *argv[])
+{
+    double seconds = 60.0;
+    int runs = 10;
+    
+    int option;
+    while ((option = getopt(argc, argv, "s:r:")) != -1) {
+        switch (option) {
+            case 's':
+                seconds = atof(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || seconds <= 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<float> floatSamples = AIMakeRecording((size_t)(seconds * AI_SPECTRAL_BENCHMARK_SAMPLE_RATE));
+    if (floatSamples.size() < AI_SPECTRAL_BENCHMARK_FRAME_SIZE) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<int16_t> int16Samples(floatSamples.size());
+    for (size_t i = 0; i < floatSamples.size(); i++) {
+        int16Samples[i] = (int16_t)lrintf(floatSamples[i] * 32767.f);
+    }
+    
+    bool accurate = true;
+    
+    for (size_t size = 4, stages = 2; size <= AI_SPECTRAL_BENCHMARK_MAX_FFT_SIZE; size <<= 1, stages++) {
+        double error = AIMeasureFFTError(size);
+        bool withinTolerance = error <= AI_SPECTRAL_BENCHMARK_FFT_TOLERANCE * (double)stages;
+        accurate = accurate && withinTolerance;
+        
+        printf("fft %4zu  relative error %.2e%s\n", size, error, withinTolerance ? "" : "  TOO LARGE");
+    }
+    
+    AIRealFFT fft(AI_SPECTRAL_BENCHMARK_FFT_SIZE);
+    std::vector<float> power(AI_SPECTRAL_BENCHMARK_FFT_SIZE / 2 + 1);
+    size_t transforms = floatSamples.size() / AI_SPECTRAL_BENCHMARK_FFT_SIZE;
+    double bestTransform = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < transforms; i++) {
+            fft.powerSpectrum(&floatSamples[i * AI_SPECTRAL_BENCHMARK_FFT_SIZE], power.data());
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        if (run == 0 || elapsed < bestTransform) bestTransform = elapsed;
+    }
+    
+    printf("%d-point power spectrum %.1f ns\n", AI_SPECTRAL_BENCHMARK_FFT_SIZE, bestTransform / (double)transforms);
+    printf("%.0f s at 16 kHz, us per 10 ms frame\n", seconds);
+    printf("%-28s %8s %8s %10s\n", "", "float", "int16", "decisions");
+    
+    for (size_t i = 0; i < AIGetVoiceActivityDetectorCount(); i++) {
+        const char *name = AIGetVoiceActivityDetectorName(i);
+        
+        std::unique_ptr<AIVoiceActivityDetector> detector(AICreateVoiceActivityDetector(name,
+                                                                                        AI_SPECTRAL_BENCHMARK_SAMPLE_RATE,
+                                                                                        10));
+        if (!detector || detector->getFrameSize() != AI_SPECTRAL_BENCHMARK_FRAME_SIZE) {
+            continue;
+        }
+        
+        unsigned decisions = 0;
+        double floatTime = AITimeDetector(*detector, floatSamples, runs, decisions);
+        double int16Time = AITimeDetector(*detector, int16Samples, runs, decisions);
+        
+        const char *budget = "";
+        if (strcmp(name, "Spectral") == 0) {
+            bool withinBudget = fmax(floatTime, int16Time) <= AI_SPECTRAL_BENCHMARK_BUDGET_MICROSECONDS;
+            budget = withinBudget ? "  within budget" : "  OVER BUDGET";
+        }
+        
+        printf("%-28s %8.3f %8.3f %10u%s\n", name, floatTime, int16Time, decisions, budget);
+    }
+    
+    return accurate ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * vad-formats: checks that every detector format AICreateVoiceActivityDetector dispatches to ends the same phrases as
+ * the 16 kHz / 10 ms reference, and times each format per second of audio.
+ *
+ *     vad-formats [-t trials] [-r runs]
+ *
+ * Each registered algorithm is asked for every format in AI_VOICE_ACTIVITY_FORMATS and for a few that are not
+ * instantiated. The formats it returns must have frames of rate × duration samples, the 16 kHz / 10 ms one must
+ * exist and the others must be NULL. Each trial is a phrase of random level, pitch and timing over noise, every other
+ * one with a tremolo, and every rate samples the same waveform. Where a format decides as the reference does, steady
+ * phrases must end within a few frames of it and modulated ones within two tremolo periods; a phrase that barely
+ * reaches a detector's minimum activity may flip between speech and no speech, in a few trials out of a thousand.
+ * Exits with 1 otherwise. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/VoiceRequest/Private/VAD Tools/VADFormats/main.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AI*.cpp ApiAI/Private/DSP/AIFrameFeatures.cpp \
+ *         ApiAI/Private/DSP/AIRealFFT.cpp -o vad-formats
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "AIVoiceActivityDetectorRegistry.hpp"
+
+#define AI_VAD_FORMATS_REFERENCE_RATE 16000
+#define AI_VAD_FORMATS_REFERENCE_MILLISECONDS 10
+#define AI_VAD_FORMATS_TRIAL_SECONDS 8.0
+#define AI_VAD_FORMATS_TIMED_SECONDS 60.0
+
+#define AI_VAD_FORMATS_TREMOLO_HERTZ 4.0
+
+// Largest endpoint shifts from the reference, in seconds. Frames of different lengths cut a tremolo at different
+// phases, and the troughs that fall below the threshold in one format but not in another add up to whole periods.
+#define AI_VAD_FORMATS_MAX_STEADY_SHIFT 0.1
+#define AI_VAD_FORMATS_MAX_MODULATED_SHIFT (2.0 / AI_VAD_FORMATS_TREMOLO_HERTZ)
+
+// Share of trials a format may decide otherwise than the reference, because minimum activity rounds to whole frames:
+// AdaptiveThresold needs 120 ms of it at 20 ms instead of 110 ms.
+#define AI_VAD_FORMATS_MAX_FLIPPED_SHARE 0.005
+
+// The noise is a sum of partials below 4 kHz, so that 8 kHz samples it as well as 48 kHz. Sampled white noise would
+// be a different waveform at every rate, with zero crossings in proportion to it.
+#define AI_VAD_FORMATS_NOISE_PARTIALS 12
+#define AI_VAD_FORMATS_NOISE_LOWEST_HERTZ 100
+#define AI_VAD_FORMATS_NOISE_HIGHEST_HERTZ 3900
+
+struct AIVADFormat {
+    unsigned sampleRate;
+    unsigned frameMilliseconds;
+};
+
+struct AIVADTrial {
+    double noise;
+    double level;
+    double pitch;
+    double start;
+    double end;
+    bool modulated;
+    double noiseFrequencies[AI_VAD_FORMATS_NOISE_PARTIALS];
+    double noisePhases[AI_VAD_FORMATS_NOISE_PARTIALS];
+};
+
+struct AIVADFormatTally {
+    unsigned long trials;
+    unsigned long decisions;
+    unsigned long flipped;
+    unsigned long moved;
+    double largestSteadyShift;
+    double largestModulatedShift;
+};
+
+#define AI_VAD_FORMATS_ENTRY(sampleRate, frameMilliseconds) { sampleRate, frameMilliseconds },
+
+static const AIVADFormat AIVADFormats[] = { AI_VOICE_ACTIVITY_FORMATS(AI_VAD_FORMATS_ENTRY) };
+
+// Formats no algorithm instantiates.
+static const AIVADFormat AIUnsupportedVADFormats[] = { { 44100, 10 }, { 16000, 30 }, { 16000, 5 }, { 0, 10 } };
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-t trials] [-r runs]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// Phrases stay clear of EnergyAndZeroCross's energy floor, near a level of 3400. Right at it, whether a frame clears
+// the floor depends on how much of a pitch period it cuts off, which differs between 10 and 20 ms frames.
+static AIVADTrial AIMakeTrial(unsigned trial)
+{
+    uint32_t seed = trial * 2654435761u + 1;
+    AIVADTrial parameters;
+    
+    parameters.noise = 5.0 + AINextRandom(seed) % 300;
+    parameters.level = 4000.0 + AINextRandom(seed) % 16000;
+    parameters.pitch = 280.0 + AINextRandom(seed) % 140;
+    parameters.start = 0.5 + (AINextRandom(seed) % 1000) / 1000.0;
+    parameters.end = parameters.start + 0.8 + (AINextRandom(seed) % 2500) / 1000.0;
+    parameters.modulated = trial % 2 == 1;
+    
+    for (int partial = 0; partial < AI_VAD_FORMATS_NOISE_PARTIALS; partial++) {
+        parameters.noiseFrequencies[partial] = AI_VAD_FORMATS_NOISE_LOWEST_HERTZ + AINextRandom(seed) %
+                                               (AI_VAD_FORMATS_NOISE_HIGHEST_HERTZ - AI_VAD_FORMATS_NOISE_LOWEST_HERTZ);
+        parameters.noisePhases[partial] = 2 * M_PI * (AINextRandom(seed) % 1000) / 1000.0;
+    }
+    
+    return parameters;
+}
+
+// The trial's waveform sampled at sampleRate. The noise partials turn by a fixed step every sample, which keeps their
+// sines off the per-sample cost.
+static std::vector<int16_t> AISampleTrial(const AIVADTrial &trial, unsigned sampleRate, double seconds)
+{
+    std::vector<int16_t> samples((size_t)(seconds * sampleRate));
+    
+    double cosines[AI_VAD_FORMATS_NOISE_PARTIALS], sines[AI_VAD_FORMATS_NOISE_PARTIALS];
+    double stepCosines[AI_VAD_FORMATS_NOISE_PARTIALS], stepSines[AI_VAD_FORMATS_NOISE_PARTIALS];
+    double amplitude = trial.noise * sqrt(2.0 / AI_VAD_FORMATS_NOISE_PARTIALS);
+    
+    for (int partial = 0; partial < AI_VAD_FORMATS_NOISE_PARTIALS; partial++) {
+        double step = 2 * M_PI * trial.noiseFrequencies[partial] / sampleRate;
+        cosines[partial] = cos(trial.noisePhases[partial]);
+        sines[partial] = sin(trial.noisePhases[partial]);
+        stepCosines[partial] = cos(step);
+        stepSines[partial] = sin(step);
+    }
+    
+    for (size_t i = 0; i < samples.size(); i++) {
+        double time = (double)i / sampleRate;
+        double value = 0;
+        
+        for (int partial = 0; partial < AI_VAD_FORMATS_NOISE_PARTIALS; partial++) {
+            value += amplitude * sines[partial];
+            
+            double turned = cosines[partial] * stepCosines[partial] - sines[partial] * stepSines[partial];
+            sines[partial] = sines[partial] * stepCosines[partial] + cosines[partial] * stepSines[partial];
+            cosines[partial] = turned;
+        }
+        
+        // Phrases repeat, so that the timed recordings keep deciding.
+        double phraseTime = fmod(time, AI_VAD_FORMATS_TRIAL_SECONDS);
+        if (phraseTime > trial.start && phraseTime < trial.end) {
+            double tremolo = trial.modulated ? 0.6 + 0.4 * sin(2 * M_PI * AI_VAD_FORMATS_TREMOLO_HERTZ * time) : 1.0;
+            value += trial.level * sin(2 * M_PI * trial.pitch * time) * tremolo;
+            value += 0.3 * trial.level * sin(2 * M_PI * 2.0 * trial.pitch * time);
+        }
+        
+        samples[i] = (int16_t)std::max(-32768.0, std::min(32767.0, value));
+    }
+    
+    return samples;
+}
+
+// Seconds of audio up to the end of the frame the detector decides on, or -1 if it does not decide.
+static double AIFindEndpoint(AIVoiceActivityDetector &detector, const std::vector<int16_t> &samples,
+                             unsigned sampleRate, AIVoiceActivityResult &result)
+{
+    size_t frameSize = detector.getFrameSize();
+    result = AIVoiceActivityResultContinue;
+    
+    for (size_t offset = 0; offset + frameSize <= samples.size(); offset += frameSize) {
+        result = detector.process(&samples[offset], frameSize);
+        if (result != AIVoiceActivityResultContinue) {
+            return (double)(offset + frameSize) / sampleRate;
+        }
+    }
+    
+    return -1;
+}
+
+// Best of runs, in microseconds per second of audio.
+static double AITimeDetector(AIVoiceActivityDetector &detector, const std::vector<int16_t> &samples,
+                             unsigned sampleRate, int runs)
+{
+    size_t frameSize = detector.getFrameSize();
+    size_t frames = samples.size() / frameSize;
+    double best = 0;
+    
+    for (int run = 0; run < runs; run++) {
+        detector.reset();
+        
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++) {
+            if (detector.process(&samples[frame * frameSize], frameSize) != AIVoiceActivityResultContinue) {
+                detector.reset();
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        
+        double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    
+    return best / ((double)(frames * frameSize) / sampleRate);
+}
+
+static AIVoiceActivityDetector *AICreateDetector(const char *name, const AIVADFormat &format)
+{
+    return AICreateVoiceActivityDetector(name, format.sampleRate, format.frameMilliseconds);
+}
+
+// Checks which formats the algorithm creates and fills supported with them.
+static unsigned long AICheckDispatch(const char *name, std::vector<bool> &supported)
+{
+    unsigned long failures = 0;
+    
+    for (size_t i = 0; i < sizeof(AIVADFormats) / sizeof(AIVADFormats[0]); i++) {
+        const AIVADFormat &format = AIVADFormats[i];
+        std::unique_ptr<AIVoiceActivityDetector> detector(AICreateDetector(name, format));
+        bool reference = format.sampleRate == AI_VAD_FORMATS_REFERENCE_RATE &&
+                         format.frameMilliseconds == AI_VAD_FORMATS_REFERENCE_MILLISECONDS;
+        
+        supported.push_back(detector != NULL);
+        
+        if (!detector) {
+            if (reference) {
+                printf("%s: no detector for %u Hz / %u ms\n", name, format.sampleRate, format.frameMilliseconds);
+                failures++;
+            }
+            continue;
+        }
+        
+        size_t frameSize = format.sampleRate * format.frameMilliseconds / 1000;
+        if (detector->getFrameSize() != frameSize) {
+            printf("%s: %u Hz / %u ms frames hold %zu samples, expected %zu\n", name, format.sampleRate,
+                   format.frameMilliseconds, detector->getFrameSize(), frameSize);
+            failures++;
+        }
+    }
+    
+    for (size_t i = 0; i < sizeof(AIUnsupportedVADFormats) / sizeof(AIUnsupportedVADFormats[0]); i++) {
+        const AIVADFormat &format = AIUnsupportedVADFormats[i];
+        std::unique_ptr<AIVoiceActivityDetector> detector(AICreateDetector(name, format));
+        
+        if (detector) {
+            printf("%s: unexpected detector for %u Hz / %u ms\n", name, format.sampleRate, format.frameMilliseconds);
+            failures++;
+        }
+    }
+    
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned trials = 200;
+    int runs = 5;
+    
+    int option;
+    while ((option = getopt(argc, argv, "t:r:")) != -1) {
+        switch (option) {
+            case 't':
+                trials = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc || trials == 0 || runs <= 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    size_t formatCount = sizeof(AIVADFormats) / sizeof(AIVADFormats[0]);
+    unsigned long failures = 0;
+    
+    printf("%u trials, endpoints against %u Hz / %u ms, us per second of int16 audio\n", trials,
+           AI_VAD_FORMATS_REFERENCE_RATE, AI_VAD_FORMATS_REFERENCE_MILLISECONDS);
+    printf("%-28s %12s %8s %10s %8s %8s %10s %10s %8s\n", "", "format", "trials", "decisions", "flipped", "moved",
+           "steady", "modulated", "us/s");
+    
+    for (size_t i = 0; i < AIGetVoiceActivityDetectorCount(); i++) {
+        const char *name = AIGetVoiceActivityDetectorName(i);
+        
+        std::vector<bool> supported;
+        failures += AICheckDispatch(name, supported);
+        
+        AIVADFormat referenceFormat = { AI_VAD_FORMATS_REFERENCE_RATE, AI_VAD_FORMATS_REFERENCE_MILLISECONDS };
+        std::unique_ptr<AIVoiceActivityDetector> reference(AICreateDetector(name, referenceFormat));
+        if (!reference) {
+            continue;
+        }
+        
+        std::vector<AIVADFormatTally> tallies(formatCount);
+        for (size_t format = 0; format < formatCount; format++) {
+            AIVADFormatTally tally = {0, 0, 0, 0, 0, 0};
+            tallies[format] = tally;
+        }
+        
+        for (unsigned trial = 0; trial < trials; trial++) {
+            AIVADTrial parameters = AIMakeTrial(trial);
+            std::map<unsigned, std::vector<int16_t> > recordings;
+            
+            AIVoiceActivityResult referenceResult;
+            std::vector<int16_t> &referenceSamples = recordings[AI_VAD_FORMATS_REFERENCE_RATE];
+            referenceSamples = AISampleTrial(parameters, AI_VAD_FORMATS_REFERENCE_RATE, AI_VAD_FORMATS_TRIAL_SECONDS);
+            reference->reset();
+            double referenceEnd = AIFindEndpoint(*reference, referenceSamples, AI_VAD_FORMATS_REFERENCE_RATE,
+                                                 referenceResult);
+            
+            for (size_t format = 0; format < formatCount; format++) {
+                if (!supported[format]) continue;
+                
+                const AIVADFormat &vadFormat = AIVADFormats[format];
+                std::unique_ptr<AIVoiceActivityDetector> detector(AICreateDetector(name, vadFormat));
+                
+                std::vector<int16_t> &samples = recordings[vadFormat.sampleRate];
+                if (samples.empty()) {
+                    samples = AISampleTrial(parameters, vadFormat.sampleRate, AI_VAD_FORMATS_TRIAL_SECONDS);
+                }
+                
+                AIVoiceActivityResult result;
+                double end = AIFindEndpoint(*detector, samples, vadFormat.sampleRate, result);
+                
+                AIVADFormatTally &tally = tallies[format];
+                tally.trials++;
+                tally.decisions += end >= 0;
+                
+                double shift = fabs(end - referenceEnd);
+                double tolerance = parameters.modulated ? AI_VAD_FORMATS_MAX_MODULATED_SHIFT :
+                                                          AI_VAD_FORMATS_MAX_STEADY_SHIFT;
+                
+                if (result != referenceResult) {
+                    tally.flipped++;
+                } else if (end >= 0) {
+                    double &largestShift = parameters.modulated ? tally.largestModulatedShift :
+                                                                  tally.largestSteadyShift;
+                    largestShift = std::max(largestShift, shift);
+                    tally.moved += shift > tolerance + 1e-9;
+                }
+                
+                if (result != referenceResult || shift > tolerance + 1e-9) {
+                    printf("%s %u Hz / %u ms, trial %u: ends with %d at %.2f s, the reference with %d at %.2f s\n",
+                           name, vadFormat.sampleRate, vadFormat.frameMilliseconds, trial, result, end,
+                           referenceResult, referenceEnd);
+                }
+            }
+        }
+        
+        for (size_t format = 0; format < formatCount; format++) {
+            if (!supported[format]) continue;
+            
+            const AIVADFormat &vadFormat = AIVADFormats[format];
+            std::unique_ptr<AIVoiceActivityDetector> detector(AICreateDetector(name, vadFormat));
+            std::vector<int16_t> samples = AISampleTrial(AIMakeTrial(0), vadFormat.sampleRate,
+                                                         AI_VAD_FORMATS_TIMED_SECONDS);
+            double time = AITimeDetector(*detector, samples, vadFormat.sampleRate, runs);
+            
+            const AIVADFormatTally &tally = tallies[format];
+            failures += tally.moved;
+            failures += tally.flipped > AI_VAD_FORMATS_MAX_FLIPPED_SHARE * tally.trials;
+            
+            printf("%-28s %6u/%-5u %8lu %10lu %8lu %8lu %8.2f s %8.2f s %8.1f\n", name, vadFormat.sampleRate,
+                   vadFormat.frameMilliseconds, tally.trials, tally.decisions, tally.flipped, tally.moved,
+                   tally.largestSteadyShift, tally.largestModulatedShift, time);
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,524 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * vad-regression: checks frame by frame that the C++ voice activity detectors decide exactly as the Objective-C
+ * AdaptiveThresold and EnergyAndZeroCross classes they replaced.
+ *
+ *     vad-regression file.wav|directory...
+ *
+ * Recordings must be 16 kHz mono 16-bit PCM, as AISoundRecorder captures them; directories are searched for .wav
+ * files. Each recording is cut into 160-sample frames and fed to a line-by-line transcription of the original
+ * Objective-C methods, boxed as the original AIRecordDetector boxed them, and to AIAdaptiveThresholdDetector and
+ * AIEnergyAndZeroCrossDetector through both their int16 and float entry points. Every frame's result must be the same
+ * up to the reference's decision.
+ *
+ * Frame energies are also checked against the arithmetic the detectors had when they were first ported, with sums
+ * taken in sample order. AIMeasureFrame adds the squares in eight interleaved partial sums and takes them exactly in
+ * double, so the energies may differ from it in the last bits, and by float rounding from EnergyAndZeroCross's
+ * squares; each must stay within its tolerance. Exits with 1 on any difference. Builds on Linux and macOS from the
+ * SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/Private/Codec -IApiAI/VoiceRequest/Private/VAD \
+ *         Tools/VADRegression/main.cpp ApiAI/VoiceRequest/Private/VAD/AIAdaptiveThresholdDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIEnergyAndZeroCrossDetector.cpp \
+ *         ApiAI/VoiceRequest/Private/VAD/AIVoiceActivityDetector.cpp ApiAI/Private/Codec/AIWAVReader.cpp \
+ *         ApiAI/Private/Codec/AIWAVHeader.cpp ApiAI/Private/DSP/AIFrameFeatures.cpp -o vad-regression
+ */
+
+#include <dirent.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "AIAdaptiveThresholdDetector.hpp"
+#include "AIEnergyAndZeroCrossDetector.hpp"
+#include "AIWAVReader.hpp"
+
+#define AI_REGRESSION_SAMPLE_RATE 16000
+#define AI_REGRESSION_FRAME_SIZE 160
+
+// Relative energy differences allowed. Reordering the additions of n non-negative terms moves the sum by at most
+// 2(n - 1) units in the last place; EnergyAndZeroCross also rounded every square to float.
+#define AI_REGRESSION_REORDERED_ENERGY_TOLERANCE 1e-13
+#define AI_REGRESSION_ROUNDED_ENERGY_TOLERANCE 1e-7
+
+// One NSNumber of the original frames: the recorder boxed (double)sample / SHRT_MAX, and the algorithms read it back
+// with doubleValue or floatValue.
+struct AIBoxedSample {
+    double doubleValue;
+    float floatValue;
+};
+
+// AdaptiveThresold.m as it was, without the delegate calls.
+class AIReferenceAdaptiveThresold {
+public:
+    
+    AIReferenceAdaptiveThresold()
+    {
+        isFirst = true;
+        activeFrameCount = 0;
+        inactiveFrameCount = 0;
+        energyMAX = 0.0;
+        energyMIN = 0.0;
+        energyMIN_INITIAL = 0.0;
+        wait = true;
+        delta = 1.01;
+        frameSize = 160;
+    }
+    
+    AIVoiceActivityResult processFrame(const std::vector<AIBoxedSample> &frame)
+    {
+        AIVoiceActivityResult state = AIVoiceActivityResultContinue;
+        
+        if (frame.empty()) return state;
+        
+        double energy = energyOf(frame);
+        
+        if (isFirst) {
+            isFirst = false;
+            
+            energyMAX = energy;
+            energyMIN_INITIAL = energy;
+            energyMIN = energyMIN_INITIAL;
+            
+            return state;
+        }
+        
+        if (energy > energyMAX) {
+            energyMAX = energy;
+        }
+        
+        if (energy < energyMIN) {
+            if (energy < 0.025) {
+                energyMIN = energyMIN_INITIAL;
+            } else {
+                energyMIN = energy;
+            }
+            
+            delta = 1.01;
+        }
+        
+        double lam = (fabs(energyMAX - energyMIN) / (energyMAX + 0.001));
+        
+        double thresold = (1.0 - lam) * energyMAX + lam * energyMIN;
+        
+        bool cz = czCalc(frame);
+        
+        if ((energy > thresold * 1.4) && (lam > 0.25) && cz) {
+            if (activeFrameCount > 10) {
+                inactiveFrameCount = 0;
+                wait = false;
+            }
+            
+            activeFrameCount += 1;
+        } else {
+            if (inactiveFrameCount > 150) {
+                state = AIVoiceActivityResultTerminate;
+                activeFrameCount = 0;
+            }
+            
+            inactiveFrameCount += 1;
+        }
+        
+        if (state == AIVoiceActivityResultTerminate && wait) {
+            if (inactiveFrameCount < 350) {
+                state = AIVoiceActivityResultContinue;
+            } else {
+                state = AIVoiceActivityResultNoSpeech;
+                wait = false;
+            }
+        }
+        
+        delta *= 1.001;
+        
+        energyMIN = energyMIN * delta;
+        
+        return state;
+    }
+    
+private:
+    
+    double energyOf(const std::vector<AIBoxedSample> &frame)
+    {
+        double result = 0;
+        
+        for (size_t i = 0; i < frame.size(); i++) {
+            result += frame[i].doubleValue * frame[i].doubleValue;
+        }
+        
+        return sqrt(result / (double)frame.size());
+    }
+    
+    // The energy the original also summed here was never used, and is left out.
+    bool czCalc(const std::vector<AIBoxedSample> &frame)
+    {
+        long lastsign = 0;
+        long czCount = 0;
+        
+        double minCZ = (int)(5. * 10. / 10.);
+        double maxCZ = minCZ * 3;
+        
+        for (size_t i = 0; i < frame.size(); i++) {
+            long sign = frame[i].floatValue > 0 ? 1 : -1;
+            
+            if (lastsign != 0 && sign != lastsign) {
+                czCount += 1;
+            }
+            lastsign = sign;
+        }
+        
+        return czCount >= minCZ && czCount <= maxCZ;
+    }
+    
+    bool isFirst;
+    bool wait;
+    double energyMAX;
+    double energyMIN;
+    double energyMIN_INITIAL;
+    double delta;
+    long inactiveFrameCount;
+    long activeFrameCount;
+    long frameSize;
+};
+
+// EnergyAndZeroCross.m as it was, without the delegate calls.
+class AIReferenceEnergyAndZeroCross {
+public:
+    
+    AIReferenceEnergyAndZeroCross()
+    {
+        sampleRate = 16000.f;
+        
+        frameLengthMilis = 10.0;
+        maxSilenceLengthMilis = 3.5;
+        minSilenceLengthMilis = 0.8;
+        silenceLengthMilis = maxSilenceLengthMilis;
+        sequenceLengthMilis = 0.03;
+        minSequenceCount = 3;
+        energyFactor = 3.1;
+        frameSize = (int)((sampleRate * frameLengthMilis) / 1000.0);
+        minCZ = (int)(5. * frameLengthMilis / 10.);
+        maxCZ = minCZ * 3;
+        
+        noiseFrames = (int)(150. / frameLengthMilis);
+        noiseEnergy = 0.0;
+        frameNumber = 0;
+        lastActiveTime = -1.0;
+        lastSequenceTime = 0.0;
+        sequenceCounter = 0;
+        time = 0.f;
+    }
+    
+    AIVoiceActivityResult processFrame(const std::vector<AIBoxedSample> &frame)
+    {
+        bool active = frameActive(frame);
+        time = frameNumber * frameSize / sampleRate;
+        
+        if (active) {
+            if (lastActiveTime >= 0 && (time - lastActiveTime) < sequenceLengthMilis) {
+                sequenceCounter += 1;
+                if (sequenceCounter >= minSequenceCount) {
+                    lastSequenceTime = time;
+                    silenceLengthMilis = std::max(minSilenceLengthMilis, silenceLengthMilis - (maxSilenceLengthMilis - minSilenceLengthMilis) / 4);
+                }
+            } else {
+                sequenceCounter = 1;
+            }
+            lastActiveTime = time;
+        } else {
+            if (time - lastSequenceTime > silenceLengthMilis) {
+                return lastSequenceTime > 0 ? AIVoiceActivityResultTerminate : AIVoiceActivityResultNoSpeech;
+            }
+        }
+        
+        return AIVoiceActivityResultContinue;
+    }
+    
+private:
+    
+    bool frameActive(const std::vector<AIBoxedSample> &frame)
+    {
+        long lastsign = 0;
+        long czCount = 0;
+        double energy = 0.0;
+        
+        for (size_t i = 0; i < frame.size(); i++) {
+            energy += frame[i].floatValue * frame[i].floatValue / (double)frameSize;
+            long sign = frame[i].floatValue > 0 ? 1 : -1;
+            
+            if (lastsign != 0 && sign != lastsign) {
+                czCount += 1;
+            }
+            lastsign = sign;
+        }
+        
+        frameNumber += 1;
+        
+        bool result = false;
+        if (frameNumber < noiseFrames) {
+            noiseEnergy = noiseEnergy + energy / (double)noiseFrames;
+        } else {
+            if (czCount >= minCZ && czCount <= maxCZ) {
+                if (energy > std::max(noiseEnergy, 0.001818) * energyFactor) {
+                    result = true;
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    double maxSilenceLengthMilis;
+    double minSilenceLengthMilis;
+    double silenceLengthMilis;
+    double sequenceLengthMilis;
+    int minSequenceCount;
+    double energyFactor;
+    int minCZ;
+    int maxCZ;
+    
+    int noiseFrames;
+    double noiseEnergy;
+    int frameNumber;
+    double lastActiveTime;
+    double lastSequenceTime;
+    int sequenceCounter;
+    double time;
+    
+    float sampleRate;
+    double frameLengthMilis;
+    long frameSize;
+};
+
+// Mean square of a frame as AIAdaptiveThresholdDetector first took it: exact squares added in sample order.
+static double AISequentialEnergy(const float *samples, size_t count)
+{
+    double result = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        result += (double)samples[i] * (double)samples[i];
+    }
+    
+    return result / (double)count;
+}
+
+// Mean square of a frame as AIEnergyAndZeroCrossDetector first took it: squares rounded to float, each divided by the
+// frame size, added in sample order.
+static double AIFloatSquaresEnergy(const float *samples, size_t count)
+{
+    double energy = 0.0;
+    
+    for (size_t i = 0; i < count; i++) {
+        energy += samples[i] * samples[i] / (double)count;
+    }
+    
+    return energy;
+}
+
+// Frames compared and frames that differed, for one algorithm over every recording.
+struct AIRegressionTally {
+    const char *algorithm;
+    unsigned long frames;
+    unsigned long differences;
+    unsigned long decisions;
+    
+    double (*baselineEnergy)(const float *samples, size_t count);
+    double energyTolerance;
+    double largestEnergyDifference;
+    unsigned long energyDifferences;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s file.wav|directory...\n", program);
+    return 2;
+}
+
+static bool AIReadRecording(const char *path, std::vector<int16_t> &samples, std::string &error)
+{
+    AIWAVReader reader(path);
+    if (!reader.isOpen()) {
+        error = strerror(reader.getError());
+        return false;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    if (format.formatTag != AI_WAV_FORMAT_PCM || format.bitsPerSample != 16 || format.channels != 1 ||
+        format.sampleRate != AI_REGRESSION_SAMPLE_RATE) {
+        error = "not 16 kHz mono 16-bit PCM";
+        return false;
+    }
+    
+    samples.resize((size_t)reader.getFrameCount());
+    samples.resize(samples.empty() ? 0 : reader.read(&samples[0], samples.size()));
+    
+    return true;
+}
+
+// Feeds the recording to the reference and to both entry points of the detector until the reference decides.
+template <typename Reference, typename Detector>
+static void AICompareRecording(const char *name, const std::vector<int16_t> &samples, AIRegressionTally &tally)
+{
+    Reference reference;
+    Detector int16Detector, floatDetector;
+    
+    std::vector<AIBoxedSample> boxed(AI_REGRESSION_FRAME_SIZE);
+    std::vector<float> converted(AI_REGRESSION_FRAME_SIZE);
+    
+    bool reported = false;
+    
+    for (size_t offset = 0; offset + AI_REGRESSION_FRAME_SIZE <= samples.size(); offset += AI_REGRESSION_FRAME_SIZE) {
+        const int16_t *frame = &samples[offset];
+        
+        for (size_t i = 0; i < AI_REGRESSION_FRAME_SIZE; i++) {
+            boxed[i].doubleValue = (double)frame[i] / (double)SHRT_MAX;
+            boxed[i].floatValue = (float)boxed[i].doubleValue;
+            converted[i] = (float)frame[i] * AI_VOICE_ACTIVITY_INT16_SCALE;
+        }
+        
+        AIVoiceActivityResult expected = reference.processFrame(boxed);
+        AIVoiceActivityResult fromInt16 = int16Detector.process(frame, AI_REGRESSION_FRAME_SIZE);
+        AIVoiceActivityResult fromFloat = floatDetector.process(&converted[0], AI_REGRESSION_FRAME_SIZE);
+        
+        tally.frames += 1;
+        
+        double baseline = tally.baselineEnergy(&converted[0], AI_REGRESSION_FRAME_SIZE);
+        double energy = AIMeasureVoiceFrame(frame, AI_REGRESSION_FRAME_SIZE).sumOfSquares / AI_REGRESSION_FRAME_SIZE;
+        double difference = baseline > 0 ? fabs(energy - baseline) / baseline : (energy > 0 ? 1.0 : 0.0);
+        
+        if (difference > tally.largestEnergyDifference) {
+            tally.largestEnergyDifference = difference;
+        }
+        
+        if (difference > tally.energyTolerance) {
+            tally.energyDifferences += 1;
+        }
+        
+        if (fromInt16 != expected || fromFloat != expected) {
+            tally.differences += 1;
+            
+            if (!reported) {
+                printf("%s: %s frame %zu is %d from int16 and %d from float, expected %d\n", name, tally.algorithm,
+                       offset / AI_REGRESSION_FRAME_SIZE, fromInt16, fromFloat, expected);
+                reported = true;
+            }
+        }
+        
+        if (expected != AIVoiceActivityResultContinue) {
+            tally.decisions += 1;
+            break;
+        }
+    }
+}
+
+static void AIAddRecordings(const char *path, std::vector<std::string> &paths)
+{
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        paths.push_back(path);
+        return;
+    }
+    
+    DIR *dir = opendir(path);
+    if (!dir) {
+        paths.push_back(path);
+        return;
+    }
+    
+    std::vector<std::string> names;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 4 && strcasecmp(entry->d_name + length - 4, ".wav") == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        paths.push_back(std::string(path) + "/" + names[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argv[1][0] == '-') {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        AIAddRecordings(argv[i], paths);
+    }
+    
+    AIRegressionTally adaptive = {"AdaptiveThresold", 0, 0, 0, AISequentialEnergy,
+                                  AI_REGRESSION_REORDERED_ENERGY_TOLERANCE, 0, 0};
+    AIRegressionTally energy = {"EnergyAndZeroCross", 0, 0, 0, AIFloatSquaresEnergy,
+                                AI_REGRESSION_ROUNDED_ENERGY_TOLERANCE, 0, 0};
+    
+    unsigned compared = 0;
+    
+    for (size_t i = 0; i < paths.size(); i++) {
+        const char *name = strrchr(paths[i].c_str(), '/');
+        name = name ? name + 1 : paths[i].c_str();
+        
+        std::vector<int16_t> samples;
+        std::string error;
+        
+        if (!AIReadRecording(paths[i].c_str(), samples, error)) {
+            printf("%s: skipped, %s\n", name, error.c_str());
+            continue;
+        }
+        
+        AICompareRecording<AIReferenceAdaptiveThresold, AIAdaptiveThresholdDetector>(name, samples, adaptive);
+        AICompareRecording<AIReferenceEnergyAndZeroCross, AIEnergyAndZeroCrossDetector>(name, samples, energy);
+        compared++;
+    }
+    
+    const AIRegressionTally *tallies[] = {&adaptive, &energy};
+    for (size_t i = 0; i < 2; i++) {
+        printf("%-18s %u recordings, %lu frames, %lu decisions, %lu frames differ\n", tallies[i]->algorithm, compared,
+               tallies[i]->frames, tallies[i]->decisions, tallies[i]->differences);
+        printf("%-18s %lu frame energies off by more than %.0e, largest difference %.2e\n", "",
+               tallies[i]->energyDifferences, tallies[i]->energyTolerance, tallies[i]->largestEnergyDifference);
+    }
+    
+    if (compared == 0) {
+        return 1;
+    }
+    
+    bool identical = adaptive.differences == 0 && energy.differences == 0;
+    bool withinTolerance = adaptive.energyDifferences == 0 && energy.energyDifferences == 0;
+    
+    return identical && withinTolerance ? 0 : 1;
+}
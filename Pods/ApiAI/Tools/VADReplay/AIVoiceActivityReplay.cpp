@@ -0,0 +1,385 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#include "AIVoiceActivityReplay.hpp"
+
+#include <dirent.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "AISampleKernels.h"
+#include "AIVoiceActivityDetectorRegistry.hpp"
+#include "AIWAVReader.hpp"
+
+// Rate every registered detector is tuned for.
+#define AI_REPLAY_SAMPLE_RATE 16000
+
+// Detector frames read from the file at a time.
+#define AI_REPLAY_FRAMES_PER_READ 64
+
+static double AIThreadCPUSeconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static const char *AIVoiceActivityResultName(AIVoiceActivityResult result)
+{
+    switch (result) {
+        case AIVoiceActivityResultNoSpeech:
+            return "NoSpeech";
+        case AIVoiceActivityResultTerminate:
+            return "Terminate";
+        default:
+            return "Continue";
+    }
+}
+
+static void AIWriteJSONString(FILE *output, const std::string &value)
+{
+    fputc('"', output);
+    
+    for (size_t i = 0; i < value.size(); i++) {
+        unsigned char c = (unsigned char)value[i];
+        if (c == '"' || c == '\\') {
+            fprintf(output, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(output, "\\u%04x", c);
+        } else {
+            fputc(c, output);
+        }
+    }
+    
+    fputc('"', output);
+}
+
+// Seconds at fraction of the way through sorted values, nearest rank.
+static double AIPercentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) return 0;
+    
+    size_t index = (size_t)ceil(fraction * (double)sorted.size());
+    return sorted[index > 0 ? index - 1 : 0];
+}
+
+bool AIReadVoiceActivityLabels(const char *path, AIVoiceActivityLabels &labels)
+{
+    labels.hasSpeech = false;
+    labels.speechStart = 0;
+    labels.speechEnd = 0;
+    
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        double start, end;
+        if (sscanf(line, "%lf %lf", &start, &end) != 2 || end <= start) {
+            continue;
+        }
+        
+        if (!labels.hasSpeech || start < labels.speechStart) labels.speechStart = start;
+        if (!labels.hasSpeech || end > labels.speechEnd) labels.speechEnd = end;
+        labels.hasSpeech = true;
+    }
+    
+    fclose(file);
+    return true;
+}
+
+AIVoiceActivityReplay::AIVoiceActivityReplay(const char *algorithmName) :
+    algorithmName(algorithmName),
+    detector(AICreateVoiceActivityDetector(algorithmName))
+{
+}
+
+AIVoiceActivityReplay::~AIVoiceActivityReplay()
+{
+}
+
+bool AIVoiceActivityReplay::isValid() const
+{
+    return detector.get() != NULL;
+}
+
+bool AIVoiceActivityReplay::setParameter(const char *name, double value)
+{
+    if (!detector || !detector->setParameter(name, value)) {
+        return false;
+    }
+    
+    parameters.push_back(std::make_pair(std::string(name), value));
+    return true;
+}
+
+bool AIVoiceActivityReplay::replayFile(const char *wavPath, const char *labelPath, std::string &error)
+{
+    if (!detector) {
+        error = "unknown algorithm";
+        return false;
+    }
+    
+    AIWAVReader reader(wavPath);
+    if (!reader.isOpen()) {
+        error = strerror(reader.getError());
+        return false;
+    }
+    
+    const AIWAVFormat &format = reader.getFormat();
+    bool isInt16 = format.formatTag == AI_WAV_FORMAT_PCM && format.bitsPerSample == 16;
+    bool isFloat = format.formatTag == AI_WAV_FORMAT_IEEE_FLOAT && format.bitsPerSample == 32;
+    
+    if (!isInt16 && !isFloat) {
+        error = "not 16-bit PCM or 32-bit float";
+        return false;
+    }
+    
+    if (format.sampleRate != AI_REPLAY_SAMPLE_RATE) {
+        error = "not 16 kHz";
+        return false;
+    }
+    
+    AIVoiceActivityReplayResult result;
+    
+    const char *name = strrchr(wavPath, '/');
+    result.name = name ? name + 1 : wavPath;
+    
+    if (!labelPath || !AIReadVoiceActivityLabels(labelPath, result.labels)) {
+        result.labels.hasSpeech = false;
+        result.labels.speechStart = 0;
+        result.labels.speechEnd = 0;
+    }
+    
+    const AISampleKernels *kernels = AISampleKernelsGetDefault();
+    
+    size_t frameSize = detector->getFrameSize();
+    size_t chunkFrames = frameSize * AI_REPLAY_FRAMES_PER_READ;
+    unsigned channels = format.channels;
+    
+    frameBytes.resize(chunkFrames * format.blockAlign);
+    interleaved.resize(chunkFrames * channels);
+    mono.resize(chunkFrames);
+    
+    detector->reset();
+    
+    result.result = AIVoiceActivityResultContinue;
+    result.frames = 0;
+    result.cpuSeconds = 0;
+    
+    // Mono 16-bit recordings go to the detector as they are, like the recorder's samples; everything else as floats.
+    bool passesInt16 = isInt16 && channels == 1;
+    
+    size_t count;
+    while (result.result == AIVoiceActivityResultContinue && (count = reader.read(&frameBytes[0], chunkFrames)) >= frameSize) {
+        const int16_t *int16Samples = (const int16_t *)&frameBytes[0];
+        const float *floatSamples = (const float *)&frameBytes[0];
+        
+        if (isInt16 && !passesInt16) {
+            kernels->int16ToFloat(int16Samples, count * channels, AI_VOICE_ACTIVITY_INT16_SCALE, &interleaved[0]);
+            floatSamples = &interleaved[0];
+        }
+        
+        if (channels > 1) {
+            kernels->downmixToMono(floatSamples, channels, count, &mono[0]);
+            floatSamples = &mono[0];
+        }
+        
+        double start = AIThreadCPUSeconds();
+        
+        for (size_t offset = 0; offset + frameSize <= count; offset += frameSize) {
+            if (passesInt16) {
+                result.result = detector->process(int16Samples + offset, frameSize);
+            } else {
+                result.result = detector->process(floatSamples + offset, frameSize);
+            }
+            
+            result.frames += 1;
+            
+            if (result.result != AIVoiceActivityResultContinue) {
+                break;
+            }
+        }
+        
+        result.cpuSeconds += AIThreadCPUSeconds() - start;
+    }
+    
+    result.decisionTime = (double)(result.frames * frameSize) / AI_REPLAY_SAMPLE_RATE;
+    results.push_back(result);
+    
+    return true;
+}
+
+bool AIVoiceActivityReplay::replayDirectory(const char *directory, std::string &error)
+{
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        error = strerror(errno);
+        return false;
+    }
+    
+    std::vector<std::string> names;
+    
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 4 && strcasecmp(entry->d_name + length - 4, ".wav") == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string wavPath = std::string(directory) + "/" + names[i];
+        std::string labelPath = wavPath.substr(0, wavPath.size() - 4) + ".txt";
+        
+        AIVoiceActivityLabels labels;
+        if (!AIReadVoiceActivityLabels(labelPath.c_str(), labels)) {
+            skipped.push_back(std::make_pair(names[i], std::string("no label file")));
+            continue;
+        }
+        
+        std::string fileError;
+        if (!replayFile(wavPath.c_str(), labelPath.c_str(), fileError)) {
+            skipped.push_back(std::make_pair(names[i], fileError));
+        }
+    }
+    
+    return true;
+}
+
+const std::vector<AIVoiceActivityReplayResult> &AIVoiceActivityReplay::getResults() const
+{
+    return results;
+}
+
+void AIVoiceActivityReplay::writeJSON(FILE *output) const
+{
+    size_t speechFiles = 0;
+    size_t falseNoSpeech = 0;
+    size_t earlyTerminations = 0;
+    size_t missedEndpoints = 0;
+    size_t silentFilesTerminated = 0;
+    
+    uint64_t frames = 0;
+    double cpuSeconds = 0;
+    
+    std::vector<double> latencies;
+    
+    for (size_t i = 0; i < results.size(); i++) {
+        const AIVoiceActivityReplayResult &result = results[i];
+        
+        frames += result.frames;
+        cpuSeconds += result.cpuSeconds;
+        
+        if (!result.labels.hasSpeech) {
+            if (result.result == AIVoiceActivityResultTerminate) silentFilesTerminated += 1;
+            continue;
+        }
+        
+        speechFiles += 1;
+        
+        if (result.result == AIVoiceActivityResultNoSpeech) {
+            falseNoSpeech += 1;
+        } else if (result.result == AIVoiceActivityResultContinue) {
+            missedEndpoints += 1;
+        } else if (result.decisionTime < result.labels.speechEnd) {
+            earlyTerminations += 1;
+        } else {
+            latencies.push_back(result.decisionTime - result.labels.speechEnd);
+        }
+    }
+    
+    std::sort(latencies.begin(), latencies.end());
+    
+    double latencySum = 0;
+    for (size_t i = 0; i < latencies.size(); i++) {
+        latencySum += latencies[i];
+    }
+    
+    fprintf(output, "{\n  \"algorithm\": ");
+    AIWriteJSONString(output, algorithmName);
+    
+    fprintf(output, ",\n  \"parameters\": {");
+    for (size_t i = 0; i < parameters.size(); i++) {
+        fprintf(output, "%s", i ? ", " : "");
+        AIWriteJSONString(output, parameters[i].first);
+        fprintf(output, ": %.17g", parameters[i].second);
+    }
+    fprintf(output, "},\n");
+    
+    fprintf(output, "  \"files\": %zu,\n", results.size());
+    fprintf(output, "  \"speechFiles\": %zu,\n", speechFiles);
+    fprintf(output, "  \"endpointLatency\": {\"count\": %zu, \"mean\": %.4f, \"median\": %.4f, \"p90\": %.4f, \"max\": %.4f},\n",
+            latencies.size(),
+            latencies.empty() ? 0 : latencySum / latencies.size(),
+            AIPercentile(latencies, 0.5),
+            AIPercentile(latencies, 0.9),
+            latencies.empty() ? 0 : latencies.back());
+    fprintf(output, "  \"falseNoSpeech\": %zu,\n", falseNoSpeech);
+    fprintf(output, "  \"falseNoSpeechRate\": %.4f,\n", speechFiles ? (double)falseNoSpeech / speechFiles : 0);
+    fprintf(output, "  \"earlyTerminations\": %zu,\n", earlyTerminations);
+    fprintf(output, "  \"missedEndpoints\": %zu,\n", missedEndpoints);
+    fprintf(output, "  \"silentFilesTerminated\": %zu,\n", silentFilesTerminated);
+    fprintf(output, "  \"frames\": %llu,\n", (unsigned long long)frames);
+    fprintf(output, "  \"framesPerSecond\": %.0f,\n", cpuSeconds > 0 ? frames / cpuSeconds : 0);
+    fprintf(output, "  \"frameCPUTimeNanoseconds\": %.1f,\n", frames ? cpuSeconds * 1e9 / frames : 0);
+    
+    fprintf(output, "  \"results\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        const AIVoiceActivityReplayResult &result = results[i];
+        
+        fprintf(output, "%s\n    {\"file\": ", i ? "," : "");
+        AIWriteJSONString(output, result.name);
+        fprintf(output, ", \"hasSpeech\": %s", result.labels.hasSpeech ? "true" : "false");
+        if (result.labels.hasSpeech) {
+            fprintf(output, ", \"speechStart\": %.4f, \"speechEnd\": %.4f", result.labels.speechStart, result.labels.speechEnd);
+        }
+        fprintf(output, ", \"result\": \"%s\", \"decisionTime\": %.4f", AIVoiceActivityResultName(result.result), result.decisionTime);
+        if (result.labels.hasSpeech && result.result == AIVoiceActivityResultTerminate) {
+            fprintf(output, ", \"latency\": %.4f", result.decisionTime - result.labels.speechEnd);
+        }
+        fprintf(output, ", \"frames\": %llu, \"frameCPUTimeNanoseconds\": %.1f}",
+                (unsigned long long)result.frames, result.frames ? result.cpuSeconds * 1e9 / result.frames : 0);
+    }
+    fprintf(output, "%s],\n", results.empty() ? "" : "\n  ");
+    
+    fprintf(output, "  \"skipped\": [");
+    for (size_t i = 0; i < skipped.size(); i++) {
+        fprintf(output, "%s\n    {\"file\": ", i ? "," : "");
+        AIWriteJSONString(output, skipped[i].first);
+        fprintf(output, ", \"reason\": ");
+        AIWriteJSONString(output, skipped[i].second);
+        fprintf(output, "}");
+    }
+    fprintf(output, "%s]\n}\n", skipped.empty() ? "" : "\n  ");
+}
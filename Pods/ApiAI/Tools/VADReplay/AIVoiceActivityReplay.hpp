@@ -0,0 +1,108 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+#ifndef VoiceActivityReplay_hpp
+#define VoiceActivityReplay_hpp
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AIVoiceActivityDetector.hpp"
+
+// Where speech is in a recording, in seconds, from an Audacity label track: one "start<TAB>end<TAB>text" line per
+// region. Files without regions hold no speech.
+struct AIVoiceActivityLabels {
+    bool hasSpeech;
+    double speechStart;
+    double speechEnd;
+};
+
+bool AIReadVoiceActivityLabels(const char *path, AIVoiceActivityLabels &labels);
+
+struct AIVoiceActivityReplayResult {
+    std::string name;
+    AIVoiceActivityLabels labels;
+    
+    // AIVoiceActivityResultContinue when the recording ended before the detector decided.
+    AIVoiceActivityResult result;
+    
+    // End of the deciding frame, or of the last frame, in seconds.
+    double decisionTime;
+    
+    uint64_t frames;
+    double cpuSeconds;
+};
+
+/*
+ * Offline replay of labelled 16 kHz WAV recordings through a registered detector.
+ *
+ * Every recording is streamed frame by frame through a freshly reset detector, as fast as it will go, until the
+ * detector decides or the recording ends. Only the detector calls are timed, on the thread CPU clock. The summary
+ * compares each decision with the labelled end of speech.
+ */
+class AIVoiceActivityReplay {
+public:
+    
+    AIVoiceActivityReplay(const char *algorithmName);
+    virtual ~AIVoiceActivityReplay();
+    
+    // False when no detector is registered under the name.
+    bool isValid() const;
+    
+    bool setParameter(const char *name, double value);
+    
+    // Replays one recording. Without a label file the recording counts as holding no speech.
+    bool replayFile(const char *wavPath, const char *labelPath, std::string &error);
+    
+    // Replays every .wav in directory, in name order, with the .txt label file of the same name. Recordings without
+    // one or that cannot be read are listed as skipped.
+    bool replayDirectory(const char *directory, std::string &error);
+    
+    const std::vector<AIVoiceActivityReplayResult> &getResults() const;
+    
+    // Summary and per-recording results as one JSON object.
+    void writeJSON(FILE *output) const;
+    
+private:
+    
+    std::string algorithmName;
+    std::unique_ptr<AIVoiceActivityDetector> detector;
+    std::vector<std::pair<std::string, double> > parameters;
+    
+    std::vector<AIVoiceActivityReplayResult> results;
+    std::vector<std::pair<std::string, std::string> > skipped;
+    
+    std::vector<uint8_t> frameBytes;
+    std::vector<float> interleaved;
+    std::vector<float> mono;
+    
+private:
+    AIVoiceActivityReplay( const AIVoiceActivityReplay& );
+    void operator=( const AIVoiceActivityReplay& );
+};
+
+#endif /* VoiceActivityReplay_hpp */
@@ -0,0 +1,107 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * vad-replay: scores a VAD algorithm against a directory of labelled recordings and prints the results as JSON.
+ *
+ *     vad-replay [-a algorithm] [-p name=value]... directory
+ *     vad-replay -l
+ *
+ * Every 16 kHz name.wav needs a name.txt Audacity label track marking the speech; an empty one marks a recording
+ * without speech. Builds on Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/DSP -IApiAI/Private/Codec -IApiAI/VoiceRequest/Private/VAD \
+ *         Tools/VADReplay/main.cpp Tools/VADReplay/AI*.cpp ApiAI/VoiceRequest/Private/VAD/AI*.cpp \
+ *         ApiAI/Private/Codec/AIWAVReader.cpp ApiAI/Private/DSP/AISampleKernels.cpp \
+ *         ApiAI/Private/DSP/AIFrameFeatures.cpp ApiAI/Private/DSP/AIRealFFT.cpp -o vad-replay
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "AIVoiceActivityDetectorRegistry.hpp"
+#include "AIVoiceActivityReplay.hpp"
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-a algorithm] [-p name=value]... directory\n       %s -l\n", program, program);
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *algorithm = "AdaptiveThresold";
+    std::string parameters;
+    
+    int option;
+    while ((option = getopt(argc, argv, "a:p:l")) != -1) {
+        switch (option) {
+            case 'a':
+                algorithm = optarg;
+                break;
+            case 'p':
+                parameters += optarg;
+                parameters += '\n';
+                break;
+            case 'l':
+                for (size_t i = 0; i < AIGetVoiceActivityDetectorCount(); i++) {
+                    printf("%s\n", AIGetVoiceActivityDetectorName(i));
+                }
+                return 0;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (optind != argc - 1) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    AIVoiceActivityReplay replay(algorithm);
+    if (!replay.isValid()) {
+        fprintf(stderr, "%s: unknown algorithm %s\n", argv[0], algorithm);
+        return 1;
+    }
+    
+    for (size_t start = 0, end; (end = parameters.find('\n', start)) != std::string::npos; start = end + 1) {
+        std::string parameter = parameters.substr(start, end - start);
+        size_t equals = parameter.find('=');
+        
+        if (equals == std::string::npos || !replay.setParameter(parameter.substr(0, equals).c_str(), atof(parameter.c_str() + equals + 1))) {
+            fprintf(stderr, "%s: %s does not take %s\n", argv[0], algorithm, parameter.c_str());
+            return 1;
+        }
+    }
+    
+    std::string error;
+    if (!replay.replayDirectory(argv[optind], error)) {
+        fprintf(stderr, "%s: %s: %s\n", argv[0], argv[optind], error.c_str());
+        return 1;
+    }
+    
+    replay.writeJSON(stdout);
+    return 0;
+}
@@ -0,0 +1,470 @@
+/***********************************************************************************************************************
+ *
+ * API.AI iOS SDK - client-side libraries for API.AI
+ * ==========================================
+ *
+ * Copyright (C) 2015 by Speaktoit, Inc. (https://www.speaktoit.com)
+ * https://www.api.ai
+ *
+ ***********************************************************************************************************************
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ ***********************************************************************************************************************/
+
+
+/*
+ * wav-writer-round-trip: writes random audio data through AIWAVWriter in pieces of random length and reads it back,
+ * both byte by byte and with AIWAVReader.
+ *
+ *     wav-writer-round-trip [-n trials] [-s seed]
+ *
+ * Each trial picks one of the upload formats (16-bit PCM, µ-law, IMA ADPCM), a buffer size and a data length, and
+ * writes the data one of four ways: appended to a file, whose header close() patches with the final sizes; appended
+ * to a stream that cannot seek back, as an upload is, whose RIFF, data and fact sizes must stay 0xFFFFFFFF and which
+ * must refuse writeAt without failing; appended and overwritten out of order with writeAt on a file, holes included;
+ * and appended without a header. Every output must hold the data exactly, padded to an even size after a header, with
+ * chunk sizes that match it, and the reader must return its whole frames. Exits with 1 if any trial fails. Builds on
+ * Linux and macOS from the SDK sources, for example from Pods/ApiAI:
+ *
+ *     c++ -std=gnu++0x -O2 -IApiAI/Private/Codec Tools/WAVWriterRoundTrip/main.cpp \
+ *         ApiAI/Private/Codec/AIWAVWriter.cpp ApiAI/Private/Codec/AIWAVReader.cpp ApiAI/Private/Codec/AIWAVHeader.cpp \
+ *         -o wav-writer-round-trip
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "AIWAVReader.hpp"
+#include "AIWAVWriter.hpp"
+
+#define AI_WAV_ROUND_TRIP_MAX_DATA_SIZE (256 * 1024)
+#define AI_WAV_ROUND_TRIP_MAX_PIECE 9000
+#define AI_WAV_ROUND_TRIP_MAX_BUFFER_SIZE 16384
+
+enum AIWAVRoundTripMode {
+    AIWAVRoundTripModeFile,
+    AIWAVRoundTripModeStream,
+    AIWAVRoundTripModeWriteAt,
+    AIWAVRoundTripModeNoHeader,
+    AIWAVRoundTripModeCount
+};
+
+static const char *AIWAVRoundTripModeNames[AIWAVRoundTripModeCount] = {"file", "stream", "writeAt", "no header"};
+
+// Output that only goes forward, as an upload does.
+class AIStreamWAVOutput : public AIWAVOutput {
+public:
+    
+    virtual bool write(const void *bytes, size_t length)
+    {
+        const uint8_t *data = (const uint8_t *)bytes;
+        written.insert(written.end(), data, data + length);
+        return true;
+    }
+    
+    std::vector<uint8_t> written;
+};
+
+// Where the chunks of a written file are, found without AIWAVReader.
+struct AIWAVLayout {
+    uint32_t riffSize;
+    uint32_t dataSize;
+    size_t dataOffset;
+    bool hasFact;
+    uint32_t factFrameCount;
+};
+
+static int AIPrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-n trials] [-s seed]\n", program);
+    return 2;
+}
+
+static uint32_t AINextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    
+    return seed;
+}
+
+static AIWAVFormat AIMakeFormat(unsigned index)
+{
+    AIWAVFormat format = {0, 0, 0, 0, 0, 0, 0};
+    format.channels = 1;
+    
+    switch (index) {
+        case 0:
+            format.formatTag = AI_WAV_FORMAT_PCM;
+            format.sampleRate = 16000;
+            format.bitsPerSample = 16;
+            format.blockAlign = 2;
+            format.bytesPerSecond = 32000;
+            break;
+        case 1:
+            format.formatTag = AI_WAV_FORMAT_MULAW;
+            format.sampleRate = 8000;
+            format.bitsPerSample = 8;
+            format.blockAlign = 1;
+            format.bytesPerSecond = 8000;
+            break;
+        default:
+            format.formatTag = AI_WAV_FORMAT_IMA_ADPCM;
+            format.sampleRate = 16000;
+            format.bitsPerSample = 4;
+            format.blockAlign = 256;
+            format.samplesPerBlock = 505;
+            format.bytesPerSecond = 16000 * 256 / 505;
+            break;
+    }
+    
+    return format;
+}
+
+static const char *AIFormatName(const AIWAVFormat &format)
+{
+    switch (format.formatTag) {
+        case AI_WAV_FORMAT_PCM:
+            return "PCM";
+        case AI_WAV_FORMAT_MULAW:
+            return "mu-law";
+        default:
+            return "IMA ADPCM";
+    }
+}
+
+static uint32_t AIReadLittleEndian(const uint8_t *bytes)
+{
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static bool AIParseLayout(const std::vector<uint8_t> &file, AIWAVLayout &layout)
+{
+    if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) != 0 || memcmp(&file[8], "WAVE", 4) != 0) {
+        return false;
+    }
+    
+    layout.riffSize = AIReadLittleEndian(&file[4]);
+    layout.hasFact = false;
+    layout.factFrameCount = 0;
+    
+    size_t offset = 12;
+    while (offset + 8 <= file.size()) {
+        uint32_t size = AIReadLittleEndian(&file[offset + 4]);
+        
+        if (memcmp(&file[offset], "data", 4) == 0) {
+            layout.dataSize = size;
+            layout.dataOffset = offset + 8;
+            return true;
+        }
+        
+        if (memcmp(&file[offset], "fact", 4) == 0 && size >= 4 && offset + 12 <= file.size()) {
+            layout.hasFact = true;
+            layout.factFrameCount = AIReadLittleEndian(&file[offset + 8]);
+        }
+        
+        offset += 8 + (size_t)size + (size & 1);
+    }
+    
+    return false;
+}
+
+static std::string AIMakeTemporaryPath()
+{
+    const char *directory = getenv("TMPDIR");
+    std::string path = std::string(directory && *directory ? directory : "/tmp") + "/wav-writer-round-trip-XXXXXX";
+    
+    int descriptor = mkstemp(&path[0]);
+    if (descriptor < 0) {
+        return std::string();
+    }
+    
+    close(descriptor);
+    return path;
+}
+
+static bool AIReadFile(const std::string &path, std::vector<uint8_t> &bytes)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    
+    bytes.clear();
+    uint8_t chunk[65536];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + length);
+    }
+    
+    bool read = !ferror(file);
+    fclose(file);
+    
+    return read;
+}
+
+static bool AIWriteFile(const std::string &path, const std::vector<uint8_t> &bytes)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    
+    bool written = bytes.empty() || fwrite(bytes.data(), bytes.size(), 1, file) == 1;
+    return fclose(file) == 0 && written;
+}
+
+// Appends data from done to its end in pieces of random length.
+static bool AIAppendPieces(AIWAVWriter &writer, const std::vector<uint8_t> &data, size_t done, uint32_t &seed)
+{
+    while (done < data.size()) {
+        size_t piece = std::min((size_t)(1 + AINextRandom(seed) % AI_WAV_ROUND_TRIP_MAX_PIECE), data.size() - done);
+        if (!writer.append(&data[done], piece)) {
+            return false;
+        }
+        done += piece;
+    }
+    
+    return true;
+}
+
+// Writes the pieces of data either after the last append or, one time in three, at a random offset that may lie past
+// the end. expected receives the data chunk this must produce, holes reading as zeros.
+static bool AIWritePiecesOutOfOrder(AIWAVWriter &writer, const std::vector<uint8_t> &data, uint32_t &seed,
+                                    std::vector<uint8_t> &expected)
+{
+    size_t appendOffset = 0;
+    
+    for (size_t done = 0; done < data.size(); ) {
+        size_t piece = std::min((size_t)(1 + AINextRandom(seed) % AI_WAV_ROUND_TRIP_MAX_PIECE), data.size() - done);
+        
+        size_t offset = appendOffset;
+        if (AINextRandom(seed) % 3 == 0) {
+            offset = AINextRandom(seed) % (expected.size() + AI_WAV_ROUND_TRIP_MAX_PIECE);
+            if (!writer.writeAt(offset, &data[done], piece)) {
+                return false;
+            }
+        } else {
+            if (!writer.append(&data[done], piece)) {
+                return false;
+            }
+            appendOffset += piece;
+        }
+        
+        if (expected.size() < offset + piece) {
+            expected.resize(offset + piece, 0);
+        }
+        memcpy(&expected[offset], &data[done], piece);
+        
+        done += piece;
+    }
+    
+    return true;
+}
+
+// The data chunk, its sizes and the reader's view of a file written with a header.
+static bool AICheckWAVFile(const std::string &path, const std::vector<uint8_t> &file, const AIWAVFormat &format,
+                           bool streamed, const std::vector<uint8_t> &expected, std::string &error)
+{
+    AIWAVLayout layout;
+    if (!AIParseLayout(file, layout)) {
+        error = "no data chunk";
+        return false;
+    }
+    
+    size_t padding = expected.size() % 2;
+    if (file.size() != layout.dataOffset + expected.size() + padding ||
+        !std::equal(expected.begin(), expected.end(), file.begin() + layout.dataOffset) ||
+        (padding && file.back() != 0)) {
+        error = "data chunk differs";
+        return false;
+    }
+    
+    uint32_t frameCount = (uint32_t)(expected.size() / format.blockAlign *
+                                     (format.samplesPerBlock ? format.samplesPerBlock : 1));
+    bool extended = format.formatTag != AI_WAV_FORMAT_PCM;
+    
+    if (streamed) {
+        if (layout.riffSize != AI_WAV_UNKNOWN_SIZE || layout.dataSize != AI_WAV_UNKNOWN_SIZE ||
+            layout.hasFact != extended || (extended && layout.factFrameCount != AI_WAV_UNKNOWN_SIZE)) {
+            error = "streamed sizes are not 0xFFFFFFFF";
+            return false;
+        }
+    } else if (layout.riffSize != file.size() - 8 || layout.dataSize != expected.size() ||
+               layout.hasFact != extended || (extended && layout.factFrameCount != frameCount)) {
+        error = "patched sizes are wrong";
+        return false;
+    }
+    
+    AIWAVReader reader(path.c_str());
+    if (!reader.isOpen()) {
+        error = "the reader cannot open it";
+        return false;
+    }
+    
+    const AIWAVFormat &read = reader.getFormat();
+    if (read.formatTag != format.formatTag || read.channels != format.channels ||
+        read.sampleRate != format.sampleRate || read.blockAlign != format.blockAlign ||
+        read.bitsPerSample != format.bitsPerSample) {
+        error = "the reader sees another format";
+        return false;
+    }
+    
+    // A streamed data chunk runs to the end of the file, so the reader takes the pad byte for data.
+    size_t wholeFrames = expected.size() / format.blockAlign;
+    size_t readableFrames = streamed ? (expected.size() + padding) / format.blockAlign : wholeFrames;
+    
+    std::vector<uint8_t> frames((readableFrames + 1) * format.blockAlign);
+    size_t framesRead = reader.read(frames.data(), readableFrames + 1);
+    
+    if (framesRead != readableFrames ||
+        !std::equal(expected.begin(), expected.begin() + wholeFrames * format.blockAlign, frames.begin())) {
+        error = "the reader returns other frames";
+        return false;
+    }
+    
+    return true;
+}
+
+static bool AIRunTrial(AIWAVRoundTripMode mode, const AIWAVFormat &format, size_t bufferSize,
+                       const std::vector<uint8_t> &data, uint32_t &seed, std::string &error)
+{
+    std::string path = AIMakeTemporaryPath();
+    if (path.empty()) {
+        error = "cannot create a temporary file";
+        return false;
+    }
+    
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> file;
+    bool passed = false;
+    
+    if (mode == AIWAVRoundTripModeStream) {
+        AIStreamWAVOutput output;
+        AIWAVWriter writer(output, format, true, bufferSize);
+        
+        size_t half = data.size() / 2;
+        std::vector<uint8_t> first(data.begin(), data.begin() + half);
+        
+        if (!AIAppendPieces(writer, first, 0, seed)) {
+            error = "append failed";
+        } else if (writer.writeAt(0, data.data(), std::min(data.size(), (size_t)1))) {
+            error = "writeAt succeeded on a stream";
+        } else if (writer.hasFailed() || !AIAppendPieces(writer, data, half, seed)) {
+            error = "a refused writeAt failed the writer";
+        } else if (!writer.close()) {
+            error = "close failed";
+        } else if (!AIWriteFile(path, output.written)) {
+            error = "cannot write the temporary file";
+        } else {
+            expected = data;
+            file = output.written;
+            passed = AICheckWAVFile(path, file, format, true, expected, error);
+        }
+    } else {
+        bool written;
+        {
+            AIWAVFileOutput output(path.c_str());
+            AIWAVWriter writer(output, format, mode != AIWAVRoundTripModeNoHeader, bufferSize);
+            
+            if (mode == AIWAVRoundTripModeWriteAt) {
+                written = AIWritePiecesOutOfOrder(writer, data, seed, expected);
+            } else {
+                written = AIAppendPieces(writer, data, 0, seed);
+                expected = data;
+            }
+            
+            written = written && writer.close() && writer.getDataSize() == expected.size();
+        }
+        
+        if (!written) {
+            error = "writing failed";
+        } else if (!AIReadFile(path, file)) {
+            error = "cannot read the file back";
+        } else if (mode == AIWAVRoundTripModeNoHeader) {
+            passed = file == expected;
+            if (!passed) error = "output differs from the data";
+        } else {
+            passed = AICheckWAVFile(path, file, format, false, expected, error);
+        }
+    }
+    
+    unlink(path.c_str());
+    return passed;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned trials = 1000;
+    uint32_t seed = 1;
+    
+    int option;
+    while ((option = getopt(argc, argv, "n:s:")) != -1) {
+        switch (option) {
+            case 'n':
+                trials = (unsigned)atol(optarg);
+                break;
+            case 's':
+                seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                return AIPrintUsage(argv[0]);
+        }
+    }
+    
+    if (seed == 0) {
+        return AIPrintUsage(argv[0]);
+    }
+    
+    unsigned runs[AIWAVRoundTripModeCount] = {0};
+    unsigned failed[AIWAVRoundTripModeCount] = {0};
+    uint64_t bytes = 0;
+    
+    for (unsigned trial = 0; trial < trials; trial++) {
+        AIWAVRoundTripMode mode = (AIWAVRoundTripMode)(trial % AIWAVRoundTripModeCount);
+        AIWAVFormat format = AIMakeFormat(AINextRandom(seed) % 3);
+        size_t bufferSize = 1 + AINextRandom(seed) % AI_WAV_ROUND_TRIP_MAX_BUFFER_SIZE;
+        
+        std::vector<uint8_t> data(AINextRandom(seed) % (AI_WAV_ROUND_TRIP_MAX_DATA_SIZE + 1));
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (uint8_t)(AINextRandom(seed) >> 24);
+        }
+        
+        std::string error;
+        if (!AIRunTrial(mode, format, bufferSize, data, seed, error)) {
+            if (failed[mode] == 0) {
+                printf("trial %u, %s, %s, %zu bytes through a %zu-byte buffer: %s\n", trial,
+                       AIWAVRoundTripModeNames[mode], AIFormatName(format), data.size(), bufferSize, error.c_str());
+            }
+            failed[mode]++;
+        }
+        
+        runs[mode]++;
+        bytes += data.size();
+    }
+    
+    unsigned failures = 0;
+    for (unsigned mode = 0; mode < AIWAVRoundTripModeCount; mode++) {
+        printf("%-10s %5u trials, %u failed\n", AIWAVRoundTripModeNames[mode], runs[mode], failed[mode]);
+        failures += failed[mode];
+    }
+    
+    printf("%.1f MB written in %u trials\n", bytes / 1e6, trials);
+    
+    return failures ? 1 : 0;
+}
@@ -10,6 +10,7 @@
 #endif
 #endif
 
+#import "AIAudioFileBatchConverter.h"
 #import "AIAudioFileConvertOperation.h"
 #import "AIConfiguration.h"
 #import "AIDefaultConfiguration.h"
@@ -22,6 +23,8 @@
 #import "AIRequestEntry.h"
 #import "AIResponseConstants.h"
 #import "AITextRequest.h"
+#import "AIVoiceAudioFormat.h"
+#import "AIVoiceCaptureConversion.h"
 #import "ApiAI.h"
 #import "AIEvent.h"
 #import "AIEventRequest.h"